@@ -31,6 +31,7 @@
 #define BT_VENDOR_BRCM_H
 
 #include "bt_vendor_lib.h"
+#include "vnd_ctx.h"
 
 /******************************************************************************
 **  Constants & Macros
@@ -53,7 +54,35 @@
 #define VENDOR_LIB_CONF_FILE "/vendor/etc/bluetooth/bt_vendor.conf"
 #endif
 
-/* Device port name where Bluetooth controller attached */
+/* Values learned at run time (e.g. firmware settle time) persisted across boots */
+#ifndef VENDOR_LIB_STATE_FILE
+#define VENDOR_LIB_STATE_FILE "/data/vendor/bluetooth/bt_vendor.state"
+#endif
+
+/* Effective values of the conf file tunables, rewritten when they change */
+#ifndef VENDOR_LIB_TUNE_FILE
+#define VENDOR_LIB_TUNE_FILE "/data/vendor/bluetooth/bt_vendor.tune"
+#endif
+
+/* Watch VENDOR_LIB_CONF_FILE and reload it when it is rewritten. Reloaded
+ * typed values apply at the next power cycle or LPM toggle, the entries
+ * handled by an action function need a restart of the stack.
+ */
+#ifndef VENDOR_LIB_CONF_RELOAD
+#define VENDOR_LIB_CONF_RELOAD TRUE
+#endif
+
+/* Board profile used when the device tree matches none, see vnd_board.c */
+#ifndef VND_BOARD_DEFAULT
+#define VND_BOARD_DEFAULT "rk3568"
+#endif
+
+/* Device tree compatible strings the board profile is selected from */
+#ifndef VND_BOARD_DT_COMPATIBLE
+#define VND_BOARD_DT_COMPATIBLE "/proc/device-tree/compatible"
+#endif
+
+/* Device port name where Bluetooth controller attached on rk3568 boards */
 #ifndef BLUETOOTH_UART_DEVICE_PORT
 #define BLUETOOTH_UART_DEVICE_PORT "/dev/ttyS8" /* maguro */
 #endif
@@ -63,28 +92,148 @@
 #define FW_PATCHFILE_LOCATION "/vendor/etc/firmware/" /* maguro */
 #endif
 
+/* Fastest UART baud rate tried, 3M unless the board profile (max_baud) or
+ * the UartTargetBaudRate conf entry opt in to 4M for wiring that was
+ * validated at that rate. The controller configuration steps down
+ * through 4M, 3M, 2M and 1.5M when a rate is not answered within
+ * UART_BAUD_VERIFY_TIMEOUT_MS, and the highest stable rate is persisted in
+ * VENDOR_LIB_STATE_FILE. Once Bluetooth is up, the UART framing and overrun
+ * counters are sampled every UART_ERR_CHECK_INTERVAL_MS; when more than
+ * UART_ERR_RATE_THRESHOLD_PPM of at least UART_ERR_MIN_RX_BYTES received
+ * bytes were in error, the link drops one step. After UART_ERR_CLEAN_WINDOW_MS
+ * without errors it climbs one step back toward UART_TARGET_BAUD_RATE; the
+ * window doubles, up to UART_ERR_CLEAN_WINDOW_MAX_MS, each time such a step
+ * up is taken back. A run-time rate change waits for an idle link: nothing
+ * received for a sample interval and BT_WAKE deasserted.
+ */
 #ifndef UART_TARGET_BAUD_RATE
 #define UART_TARGET_BAUD_RATE 3000000
 #endif
 
-/* The millisecond delay pauses on HCI transport after firmware patches
- * were downloaded. This gives some time for firmware to restart with
- * patches before host attempts to send down any HCI commands.
+#ifndef UART_BAUD_VERIFY_TIMEOUT_MS
+#define UART_BAUD_VERIFY_TIMEOUT_MS 200
+#endif
+
+#ifndef UART_ERR_CHECK_INTERVAL_MS
+#define UART_ERR_CHECK_INTERVAL_MS 1000
+#endif
+
+#ifndef UART_ERR_RATE_THRESHOLD_PPM
+#define UART_ERR_RATE_THRESHOLD_PPM 1000
+#endif
+
+#ifndef UART_ERR_MIN_RX_BYTES
+#define UART_ERR_MIN_RX_BYTES 16384
+#endif
+
+#ifndef UART_ERR_CLEAN_WINDOW_MS
+#define UART_ERR_CLEAN_WINDOW_MS 60000
+#endif
+
+#ifndef UART_ERR_CLEAN_WINDOW_MAX_MS
+#define UART_ERR_CLEAN_WINDOW_MAX_MS 960000
+#endif
+
+/* After firmware patches were launched the controller restarts and drops
+ * any HCI command it receives meanwhile. Instead of pausing blindly, the
+ * host probes it with HCI_RESET, re-sent every FW_READY_PROBE_INTERVAL_MS
+ * (doubling up to FW_READY_PROBE_MAX_INTERVAL_MS) until it is answered or
+ * FW_READY_PROBE_BUDGET_MS has elapsed. The measured settle time is
+ * persisted per chipset so that later boots send the first probe shortly
+ * before the controller is expected back.
  *
- * Note: It has been discovered that BCM43241B0 needs at least 200ms
- * settlement delay in here. Without the delay, a Hardware Error event
- * from BCM43241B0 had been seen in HCI upstream path right after the
- * host sent the HCI_VSC_SET_BDADDR commad to the controller at higher
- * baud.
+ * A non-zero FW_PATCH_SETTLEMENT_DELAY_MS forces the first probe to be
+ * sent that many milliseconds after the launch instead.
  */
 #ifndef FW_PATCH_SETTLEMENT_DELAY_MS
 #define FW_PATCH_SETTLEMENT_DELAY_MS 0
 #endif
 
+#ifndef FW_READY_PROBE_INTERVAL_MS
+#define FW_READY_PROBE_INTERVAL_MS 10
+#endif
+
+#ifndef FW_READY_PROBE_MAX_INTERVAL_MS
+#define FW_READY_PROBE_MAX_INTERVAL_MS 40
+#endif
+
+#ifndef FW_READY_PROBE_BUDGET_MS
+#define FW_READY_PROBE_BUDGET_MS 2000
+#endif
+
+/* A controller that was not power cycled (e.g. on a stack restart) still
+ * runs at its working baud rate. If the first HCI_RESET is not answered
+ * within FW_START_PROBE_TIMEOUT_MS, it is re-sent alternating the host baud
+ * rate between 115200 and the negotiated working rate.
+ */
+#ifndef FW_START_PROBE_TIMEOUT_MS
+#define FW_START_PROBE_TIMEOUT_MS 200
+#endif
+
+/* Time given to the minidriver for placing the controller in download mode.
+ * The minidriver accepts patch records only, and a repeated record cannot be
+ * told apart from the next one by its command complete, so this one stays a
+ * timed wait; it no longer blocks the HCI event thread though.
+ */
+#ifndef FW_MINIDRV_SETTLE_MS
+#define FW_MINIDRV_SETTLE_MS 50
+#endif
+
+/* Number of firmware patch records kept in flight during download. The
+ * effective window is also capped by the Num_HCI_Command_Packets credits
+ * reported by the controller; 1 selects plain stop-and-wait.
+ */
+#ifndef FW_PATCH_DL_WINDOW
+#define FW_PATCH_DL_WINDOW 4
+#endif
+
+/* A configuration command not answered within the timeout of its state
+ * (FW_CFG_CMD_TIMEOUT_MS, FW_CFG_RECORD_TIMEOUT_MS for patch records), or
+ * answered with an error, is retried up to FW_CFG_MAX_RETRIES times. Each
+ * retry waits FW_CFG_RETRY_BACKOFF_MS, doubling every time, and drops the
+ * late answers meanwhile. A baud rate switch is repeated, alternating the
+ * host rate; a patch download resumes at the oldest record not
+ * acknowledged. Once the retries are used up, the controller is power
+ * cycled and configured again, at most FW_CFG_MAX_RESTARTS times.
+ */
+#ifndef FW_CFG_CMD_TIMEOUT_MS
+#define FW_CFG_CMD_TIMEOUT_MS 200
+#endif
+
+#ifndef FW_CFG_RECORD_TIMEOUT_MS
+#define FW_CFG_RECORD_TIMEOUT_MS 100
+#endif
+
+#ifndef FW_CFG_MAX_RETRIES
+#define FW_CFG_MAX_RETRIES 3
+#endif
+
+#ifndef FW_CFG_RETRY_BACKOFF_MS
+#define FW_CFG_RETRY_BACKOFF_MS 10
+#endif
+
+#ifndef FW_CFG_MAX_RESTARTS
+#define FW_CFG_MAX_RESTARTS 1
+#endif
+
 #ifndef USERIAL_VENDOR_SET_BAUD_DELAY_US
 #define USERIAL_VENDOR_SET_BAUD_DELAY_US 0
 #endif
 
+/* USERIAL_RX_ENGINE
+
+    Build the H4 receive engine of userial_vendor. It only runs once an
+    in-process consumer starts it with userial_vendor_rx_start.
+*/
+#ifndef USERIAL_RX_ENGINE
+#define USERIAL_RX_ENGINE TRUE
+#endif
+
+/* Number of preallocated receive packet slots */
+#ifndef USERIAL_RX_SLOTS
+#define USERIAL_RX_SLOTS 32
+#endif
+
 #ifndef FW_AUTO_DETECTION
 #define FW_AUTO_DETECTION FALSE
 #endif
@@ -200,6 +349,46 @@
 #define LPM_IDLE_TIMEOUT_MULTIPLE 10
 #endif
 
+/* LPM_ADAPTIVE_IDLE
+
+    Adapt the idle timeout reported to the stack (and the idle thresholds of
+    the controller) to the gaps observed between traffic bursts, within
+    LPM_IDLE_TIMEOUT_MIN_MS and LPM_IDLE_TIMEOUT_MAX_MS. A maximum of 0 means
+    the fixed timeout derived from LPM_IDLE_THRESHOLD.
+*/
+#ifndef LPM_ADAPTIVE_IDLE
+#define LPM_ADAPTIVE_IDLE TRUE
+#endif
+
+#ifndef LPM_IDLE_TIMEOUT_MIN_MS
+#define LPM_IDLE_TIMEOUT_MIN_MS 100
+#endif
+
+#ifndef LPM_IDLE_TIMEOUT_MAX_MS
+#define LPM_IDLE_TIMEOUT_MAX_MS 0
+#endif
+
+/* HOST_WAKE_MONITOR
+
+    Follow the HOST_WAKE line through its GPIO character device while LPM is
+    enabled (host_wake.c): an assertion takes the HOST_WAKE_LOCK_NAME
+    wakelock, dropped HOST_WAKE_HOLD_MS after the line is released, and its
+    edge time feeds the adaptive idle timeout. The line is the one of the
+    board profile or HostWakeGpio ("<gpiochip>:<offset>") in the conf file;
+    none is followed where a kernel driver owns it.
+*/
+#ifndef HOST_WAKE_MONITOR
+#define HOST_WAKE_MONITOR TRUE
+#endif
+
+#ifndef HOST_WAKE_HOLD_MS
+#define HOST_WAKE_HOLD_MS 500
+#endif
+
+#ifndef HOST_WAKE_LOCK_NAME
+#define HOST_WAKE_LOCK_NAME "bt_host_wake"
+#endif
+
 /* BT_WAKE_VIA_USERIAL_IOCTL
 
     Use userial ioctl function to control BT_WAKE signal
@@ -431,13 +620,68 @@
 #define HW_END_WITH_HCI_RESET TRUE
 #endif
 
+/* BRCM_A2DP_OFFLOAD
+
+    Let the controller encode and packetise the A2DP media stream it reads
+    from the I2S/PCM port, driven over UIPC through HCI_VSC_UIPC_OVER_HCI.
+    The host stack starts and stops it through brcm_vnd_a2dp_start/stop.
+    Needs a firmware patch with the offload encoder.
+*/
+#ifndef BRCM_A2DP_OFFLOAD
+#define BRCM_A2DP_OFFLOAD FALSE
+#endif
+
+/* HCI_SNOOP_INCLUDED
+
+    Record the HCI commands and events crossing xmit_cb and hw_process_event
+    into a lock-free ring (hci_snoop.c), dumped in btsnoop format on
+    HciSnoopSignal, on HciSnoopDump or through hci_snoop_dump.
+*/
+#ifndef HCI_SNOOP_INCLUDED
+#define HCI_SNOOP_INCLUDED TRUE
+#endif
+
+/* VND_MAX_CONTROLLERS
+
+    Controllers one process drives at the same time, each on its own UART
+    and through its own vendor interface: BLUETOOTH_VENDOR_LIB_INTERFACE for
+    the first one, BLUETOOTH_VENDOR_LIB_INTERFACE_<n> for the others. The
+    UART of controller n is set with UartPort.<n> in the conf file.
+*/
+#ifndef VND_MAX_CONTROLLERS
+#define VND_MAX_CONTROLLERS 2
+#endif
+
+/* VND_EVT_TRACE
+
+    Log every event on the event path. Each line costs a hilog call on the
+    HCI thread, the snoop ring keeps the same information for a fraction of
+    it, so the trace points compile out by default.
+*/
+#ifndef VND_EVT_TRACE
+#define VND_EVT_TRACE FALSE
+#endif
+
+#if (VND_EVT_TRACE == TRUE)
+#define VNDEVTTRACE(param, ...) HILOGI(param, ##__VA_ARGS__)
+#else
+#define VNDEVTTRACE(param, ...)
+#endif
+
 #define BD_ADDR_LEN 6
 #define BT_VENDOR_TIME_RAIDX 1000
 /******************************************************************************
 **  Extern variables and functions
 ******************************************************************************/
 
-extern bt_vendor_callbacks_t *bt_vendor_cbacks;
+/* Stack callbacks and local address of every controller. bt_vendor_cbacks
+ * and vnd_local_bd_addr are the ones of the calling thread's controller.
+ */
+extern bt_vendor_callbacks_t *vnd_cbacks[VND_MAX_CONTROLLERS];
+extern uint8_t vnd_local_bd_addrs[VND_MAX_CONTROLLERS][BD_ADDR_LEN];
+#define bt_vendor_cbacks (vnd_cbacks[vnd_ctx_id()])
+#define vnd_local_bd_addr (vnd_local_bd_addrs[vnd_ctx_id()])
+
 /** audio (SCO) state changes triggering VS commands for configuration */
 typedef struct {
     uint16_t handle;
@@ -446,8 +690,12 @@ typedef struct {
 } bt_vendor_op_audio_state_t;
 
 extern int hw_set_audio_state(bt_vendor_op_audio_state_t *p_state);
-extern uint8_t vnd_local_bd_addr[BD_ADDR_LEN];
 
 extern void hw_process_event(HC_BT_HDR *);
+extern uint64_t get_monotonic_time_us(void);
+extern int vnd_state_get(const char *p_name, char *p_value, size_t len);
+extern int vnd_state_set(const char *p_name, const char *p_value);
+extern int vnd_state_get_int(const char *p_name, int def_value);
+extern int vnd_state_set_int(const char *p_name, int value);
 
 #endif /* BT_VENDOR_BRCM_H */
@@ -0,0 +1,193 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      bt_vendor_brcm_a2dp.h
+ *
+ *  Description:   Contains definitions used for the A2DP offload, where
+ *                 the controller encodes the media stream read from the
+ *                 I2S/PCM port and sends it on the L2CAP channel itself
+ *
+ ******************************************************************************/
+
+#ifndef BT_VENDOR_BRCM_A2DP_H
+#define BT_VENDOR_BRCM_A2DP_H
+
+#include "bt_vendor_brcm.h"
+#include "uipc_msg.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* Vendor specific command carrying a UIPC message to the controller */
+#define HCI_VSC_UIPC_OVER_HCI 0xFC8B
+
+/* UIPC message classes, first two bytes of HCI_VSC_UIPC_OVER_HCI */
+#define BT_EVT_BTU_IPC_EVT 0x9000
+#define BT_EVT_BTU_IPC_L2C_EVT (0x0003 | BT_EVT_BTU_IPC_EVT)
+#define BT_EVT_BTU_IPC_BTM_EVT (0x0005 | BT_EVT_BTU_IPC_EVT)
+#define BT_EVT_BTU_IPC_AVDT_EVT (0x0006 | BT_EVT_BTU_IPC_EVT)
+#define BT_EVT_BTU_IPC_MGMT_EVT (0x0008 | BT_EVT_BTU_IPC_EVT)
+
+/* Multi-AV queue sizes given to the controller L2CAP */
+#ifndef BRCM_A2DP_OFFLOAD_CONG_START
+#define BRCM_A2DP_OFFLOAD_CONG_START 8
+#endif
+
+#ifndef BRCM_A2DP_OFFLOAD_CONG_END
+#define BRCM_A2DP_OFFLOAD_CONG_END 4
+#endif
+
+#ifndef BRCM_A2DP_OFFLOAD_CONG_DISCARD
+#define BRCM_A2DP_OFFLOAD_CONG_DISCARD 16
+#endif
+
+/* Offload states */
+enum {
+    BRCM_VND_A2DP_IDLE,
+    BRCM_VND_A2DP_STARTING,
+    BRCM_VND_A2DP_STREAMING,
+    BRCM_VND_A2DP_SUSPENDING,
+    BRCM_VND_A2DP_SUSPENDED,
+    BRCM_VND_A2DP_STOPPING
+};
+
+/******************************************************************************
+**  Type definitions
+******************************************************************************/
+
+/* Stream handed over to the controller */
+typedef struct {
+    uint16_t lm_handle;     /* ACL connection handle */
+    uint16_t local_cid;     /* L2CAP channel of the media transport */
+    uint16_t remote_cid;
+    uint16_t stream_mtu;
+    uint16_t acl_data_size; /* largest ACL payload across HCI */
+    uint16_t xmit_quota;    /* ACL packets the controller may keep outstanding */
+    uint8_t is_flushable;
+    uint32_t stream_source; /* RTP SSRC */
+    uint16_t codec_type;    /* AUDIO_CODEC_SBC_ENC or AUDIO_CODEC_AAC_ENC */
+    tCODEC_INFO codec_info;
+    uint8_t sample_rate;    /* AUDIO_ROUTE_SF_xxx of the I2S input */
+} brcm_vnd_a2dp_offload_t;
+
+/* Result of brcm_vnd_a2dp_start/suspend/stop, req is A2DP_START_REQ,
+ * A2DP_SUSPEND_REQ or A2DP_STOP_REQ
+ */
+typedef void (*brcm_vnd_a2dp_cback_t)(uint8_t req, uint8_t status, uint16_t lcid);
+
+/* Offload statistics */
+typedef struct {
+    uint32_t starts;
+    uint32_t failures;
+    uint32_t stops;
+    uint32_t last_start_us; /* request to A2DP_START_RESP */
+    uint32_t max_start_us;
+} brcm_vnd_a2dp_stats_t;
+
+/******************************************************************************
+**  Functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_init
+**
+** Description     Reset the offload state
+**
+** Returns         None
+**
+*******************************************************************************/
+void brcm_vnd_a2dp_init(bt_vendor_callbacks_t *p_cb);
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_start
+**
+** Description     Hand a media stream over to the controller, or resume a
+**                 suspended one. The result comes through p_cback.
+**
+** Returns         0 : Started
+**                 -1 : Another stream is offloaded or a request is running
+**
+*******************************************************************************/
+int brcm_vnd_a2dp_start(const brcm_vnd_a2dp_offload_t *p_offload, brcm_vnd_a2dp_cback_t p_cback);
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_suspend
+**
+** Description     Pause the offloaded stream, the channel stays with the
+**                 controller
+**
+** Returns         0 : Started
+**                 -1 : Not streaming
+**
+*******************************************************************************/
+int brcm_vnd_a2dp_suspend(uint16_t lcid);
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_stop
+**
+** Description     Take the stream back from the controller. A stop during
+**                 a start runs once the start finished.
+**
+** Returns         0 : Started
+**                 -1 : Nothing offloaded
+**
+*******************************************************************************/
+int brcm_vnd_a2dp_stop(uint16_t lcid);
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_get_state
+**
+** Description     Current offload state
+**
+** Returns         BRCM_VND_A2DP_xxx
+**
+*******************************************************************************/
+uint8_t brcm_vnd_a2dp_get_state(void);
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_get_stats
+**
+** Description     Copy the offload statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void brcm_vnd_a2dp_get_stats(brcm_vnd_a2dp_stats_t *p_stats);
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_cleanup
+**
+** Description     Forget the offloaded stream when the controller goes down,
+**                 log and reset the statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void brcm_vnd_a2dp_cleanup(void);
+
+#endif /* BT_VENDOR_BRCM_A2DP_H */
@@ -0,0 +1,149 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      cfg_trace.h
+ *
+ *  Description:   Contains definitions used for timing the controller
+ *                 configuration (hw_cfg) state machine
+ *
+ ******************************************************************************/
+
+#ifndef CFG_TRACE_H
+#define CFG_TRACE_H
+
+#include <stdint.h>
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* Number of events kept in the trace ring, the oldest ones are overwritten */
+#ifndef CFG_TRACE_RING_SIZE
+#define CFG_TRACE_RING_SIZE 64
+#endif
+
+/* Highest state number accounted separately */
+#define CFG_TRACE_MAX_STATES 16
+
+/* Trace event types */
+enum {
+    CFG_TRACE_EVT_STATE = 0, /* state transition */
+    CFG_TRACE_EVT_CMD,       /* HCI command handed to xmit_cb */
+    CFG_TRACE_EVT_CMPL,      /* command complete received */
+    CFG_TRACE_EVT_RETRY      /* command re-sent or configuration restarted */
+};
+
+/******************************************************************************
+**  Type definitions
+******************************************************************************/
+
+/* One trace ring entry */
+typedef struct {
+    uint32_t t_us;   /* time since cfg_trace_start */
+    uint16_t opcode; /* HCI opcode, 0 for state transitions */
+    uint8_t type;    /* CFG_TRACE_EVT_xxx */
+    uint8_t state;   /* state entered, or current state */
+    uint8_t status;  /* command complete status */
+} cfg_trace_entry_t;
+
+/******************************************************************************
+**  Functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        cfg_trace_start
+**
+** Description     Start a trace session. A session already running (e.g.
+**                 across a configuration restart) is kept.
+**
+** Returns         None
+**
+*******************************************************************************/
+void cfg_trace_start(void);
+
+/*******************************************************************************
+**
+** Function        cfg_trace_state
+**
+** Description     Account a state transition
+**
+** Returns         None
+**
+*******************************************************************************/
+void cfg_trace_state(uint8_t state);
+
+/*******************************************************************************
+**
+** Function        cfg_trace_cmd
+**
+** Description     Account an HCI command handed to xmit_cb
+**
+** Returns         None
+**
+*******************************************************************************/
+void cfg_trace_cmd(uint16_t opcode);
+
+/*******************************************************************************
+**
+** Function        cfg_trace_cmpl
+**
+** Description     Account a command complete
+**
+** Returns         None
+**
+*******************************************************************************/
+void cfg_trace_cmpl(uint16_t opcode, uint8_t status);
+
+/*******************************************************************************
+**
+** Function        cfg_trace_retry
+**
+** Description     Account a re-sent command or a configuration restart
+**
+** Returns         None
+**
+*******************************************************************************/
+void cfg_trace_retry(uint16_t opcode);
+
+/*******************************************************************************
+**
+** Function        cfg_trace_patch
+**
+** Description     Account the firmware patch records and bytes downloaded
+**
+** Returns         None
+**
+*******************************************************************************/
+void cfg_trace_patch(uint32_t records, uint32_t bytes);
+
+/*******************************************************************************
+**
+** Function        cfg_trace_dump
+**
+** Description     Log the session summary, the time spent per state and the
+**                 trace ring, then end the session
+**
+** Returns         None
+**
+*******************************************************************************/
+void cfg_trace_dump(const char *const *p_state_names, uint8_t num_states);
+
+#endif /* CFG_TRACE_H */
@@ -0,0 +1,179 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      cmd_sched.h
+ *
+ *  Description:   Contains definitions used for scheduling the vendor
+ *                 specific commands sent outside the configuration sequence
+ *
+ ******************************************************************************/
+
+#ifndef CMD_SCHED_H
+#define CMD_SCHED_H
+
+#include "bt_vendor_brcm.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* Commands queued or waiting for their Command Complete */
+#ifndef CMD_SCHED_QUEUE_SIZE
+#define CMD_SCHED_QUEUE_SIZE 8
+#endif
+
+/* Time a sent command waits for its Command Complete */
+#ifndef CMD_SCHED_TIMEOUT_MS
+#define CMD_SCHED_TIMEOUT_MS 1000
+#endif
+
+/* Times a timed out command is sent again before it is given up */
+#ifndef CMD_SCHED_MAX_RETRY
+#define CMD_SCHED_MAX_RETRY 2
+#endif
+
+/* Priorities, a lower value is sent first */
+enum {
+    CMD_SCHED_PRIO_AUDIO, /* SCO and I2S/PCM path */
+    CMD_SCHED_PRIO_CTRL,  /* low power mode */
+    CMD_SCHED_PRIO_BULK,  /* UART rate and other maintenance */
+    CMD_SCHED_PRIO_NUM
+};
+
+/******************************************************************************
+**  Type definitions
+******************************************************************************/
+
+/* Completion callback, p_mem is the Command Complete event or NULL when the
+ * command was given up
+ */
+typedef void (*cmd_sched_cback_t)(void *p_mem);
+
+/* Handler of the Command Complete events of commands sent outside the
+ * scheduler, looked up by opcode
+ */
+typedef struct {
+    uint16_t opcode;
+    cmd_sched_cback_t p_cback;
+} cmd_sched_handler_t;
+
+/* Scheduler statistics */
+typedef struct {
+    uint32_t sent;                         /* commands sent, retries excluded */
+    uint32_t coalesced;                    /* queued commands replaced by a newer one */
+    uint32_t retries;                      /* commands sent again after a timeout */
+    uint32_t failures;                     /* commands given up */
+    uint32_t credit_waits;                 /* sends held back for a command credit */
+    uint32_t max_wait_us[CMD_SCHED_PRIO_NUM]; /* longest queue to completion time */
+} cmd_sched_stats_t;
+
+/******************************************************************************
+**  Functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        cmd_sched_init
+**
+** Description     Reset the scheduler for a new configuration sequence.
+**                 Pending commands are given up. p_handlers stays referenced
+**                 and receives the completions no scheduled command waits for.
+**
+** Returns         None
+**
+*******************************************************************************/
+void cmd_sched_init(const cmd_sched_handler_t *p_handlers, uint8_t num_handlers);
+
+/*******************************************************************************
+**
+** Function        cmd_sched_hold
+**
+** Description     Hold queued commands back while the configuration sequence
+**                 owns the command channel, and send them once it is released
+**
+** Returns         None
+**
+*******************************************************************************/
+void cmd_sched_hold(uint8_t hold);
+
+/*******************************************************************************
+**
+** Function        cmd_sched_send
+**
+** Description     Queue a command. A queued command with the same opcode that
+**                 is not sent yet is replaced, the commands scheduled here all
+**                 write controller settings. A NULL p_param sends param_len
+**                 zero bytes.
+**
+** Returns         TRUE if the command was queued
+**
+*******************************************************************************/
+uint8_t cmd_sched_send(uint16_t opcode, const uint8_t *p_param, uint8_t param_len, uint8_t prio,
+    cmd_sched_cback_t p_cback);
+
+/*******************************************************************************
+**
+** Function        cmd_sched_xmit
+**
+** Description     Account a command sent outside the scheduler against the
+**                 controller command credits
+**
+** Returns         None
+**
+*******************************************************************************/
+void cmd_sched_xmit(void);
+
+/*******************************************************************************
+**
+** Function        cmd_sched_complete
+**
+** Description     Take the credits of a Command Complete event, hand it to
+**                 the scheduled command or handler waiting for its opcode and
+**                 send what the new credits allow
+**
+** Returns         TRUE if a scheduled command or a handler took the event
+**
+*******************************************************************************/
+uint8_t cmd_sched_complete(HC_BT_HDR *p_evt);
+
+/*******************************************************************************
+**
+** Function        cmd_sched_get_stats
+**
+** Description     Copy the scheduler statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void cmd_sched_get_stats(cmd_sched_stats_t *p_stats);
+
+/*******************************************************************************
+**
+** Function        cmd_sched_cleanup
+**
+** Description     Give pending commands up, release the timer and log the
+**                 statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void cmd_sched_cleanup(void);
+
+#endif /* CMD_SCHED_H */
@@ -0,0 +1,197 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      hcd_patch.h
+ *
+ *  Description:   Contains definitions used for the in-memory firmware patch
+ *                 (.hcd) image and its record index
+ *
+ ******************************************************************************/
+
+#ifndef HCD_PATCH_H
+#define HCD_PATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* Each .hcd record is a raw HCI command: opcode(2) + parameter length(1) */
+#define HCD_REC_HDR_SIZE 3
+
+#define HCD_OPCODE_WRITE_RAM 0xFC4C
+#define HCD_OPCODE_LAUNCH_RAM 0xFC4E
+
+/* Vendor specific commands only (OGF 0x3F) are expected in a patch file */
+#define HCD_OPCODE_VSC_MASK 0xFC00
+
+/******************************************************************************
+**  Type definitions
+******************************************************************************/
+
+/* One HCI command record of the patch image */
+typedef struct {
+    uint32_t offset;  /* offset of the record header in the image */
+    uint16_t opcode;  /* HCI opcode of the record */
+    uint8_t plen;     /* parameter length */
+    uint32_t tx_us;   /* time the record was handed to xmit_cb */
+    uint32_t rtt_us;  /* xmit to command complete time */
+} hcd_record_t;
+
+/* In-memory patch image */
+typedef struct {
+    uint8_t *p_data;        /* image base (mmap'ed or heap) */
+    size_t size;            /* image size in bytes */
+    uint8_t mapped;         /* TRUE if p_data is an mmap'ed region */
+    hcd_record_t *p_rec;    /* record index */
+    uint32_t rec_count;     /* number of records to be downloaded */
+    uint64_t digest;        /* FNV-1a digest of the whole image */
+    uint32_t next;          /* next record to be sent */
+    uint32_t acked;         /* number of records acknowledged */
+    uint32_t sent;          /* number of records sent at least once */
+    uint64_t load_us;       /* time spent on mapping and indexing */
+    uint64_t dl_start_us;   /* time the first record was sent */
+    uint64_t dl_end_us;     /* time the last record was acknowledged */
+    uint32_t bytes_sent;    /* HCI command bytes handed to xmit_cb, resends excluded */
+    uint32_t max_in_flight; /* peak number of unacknowledged records */
+} hcd_patch_t;
+
+/******************************************************************************
+**  Functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        hcd_patch_load
+**
+** Description     Map (or read once) the patch file, build its record index
+**                 and digest. The image is validated before it is accepted.
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int hcd_patch_load(hcd_patch_t *p_img, const char *p_path);
+
+/*******************************************************************************
+**
+** Function        hcd_patch_unload
+**
+** Description     Release the image and its record index
+**
+** Returns         None
+**
+*******************************************************************************/
+void hcd_patch_unload(hcd_patch_t *p_img);
+
+/*******************************************************************************
+**
+** Function        hcd_patch_is_loaded
+**
+** Description     Check whether an image is ready for download
+**
+** Returns         TRUE/FALSE
+**
+*******************************************************************************/
+uint8_t hcd_patch_is_loaded(const hcd_patch_t *p_img);
+
+/*******************************************************************************
+**
+** Function        hcd_patch_rewind
+**
+** Description     Restart the download from the first record
+**
+** Returns         None
+**
+*******************************************************************************/
+void hcd_patch_rewind(hcd_patch_t *p_img);
+
+/*******************************************************************************
+**
+** Function        hcd_patch_resume
+**
+** Description     Resume the download at the oldest record not acknowledged,
+**                 the records in flight are sent again
+**
+** Returns         Number of records to be sent again
+**
+*******************************************************************************/
+uint32_t hcd_patch_resume(hcd_patch_t *p_img);
+
+/*******************************************************************************
+**
+** Function        hcd_patch_in_flight
+**
+** Description     Number of records sent but not acknowledged yet
+**
+** Returns         Records in flight
+**
+*******************************************************************************/
+uint32_t hcd_patch_in_flight(const hcd_patch_t *p_img);
+
+/*******************************************************************************
+**
+** Function        hcd_patch_peek_opcode
+**
+** Description     Opcode of the next record to be sent
+**
+** Returns         HCI opcode, 0 if the image is exhausted
+**
+*******************************************************************************/
+uint16_t hcd_patch_peek_opcode(const hcd_patch_t *p_img);
+
+/*******************************************************************************
+**
+** Function        hcd_patch_fill_next
+**
+** Description     Copy the next record into an HCI command buffer and mark it
+**                 as sent
+**
+** Returns         Length of the command copied into p_cmd, 0 if the image is
+**                 exhausted
+**
+*******************************************************************************/
+uint16_t hcd_patch_fill_next(hcd_patch_t *p_img, uint8_t *p_cmd, uint16_t max_len, uint16_t *p_opcode);
+
+/*******************************************************************************
+**
+** Function        hcd_patch_record_acked
+**
+** Description     Account the command complete of the oldest record in flight
+**
+** Returns         None
+**
+*******************************************************************************/
+void hcd_patch_record_acked(hcd_patch_t *p_img);
+
+/*******************************************************************************
+**
+** Function        hcd_patch_report
+**
+** Description     Log per-record and total download timing
+**
+** Returns         None
+**
+*******************************************************************************/
+void hcd_patch_report(const hcd_patch_t *p_img);
+
+#endif /* HCD_PATCH_H */
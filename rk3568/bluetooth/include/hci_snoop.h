@@ -0,0 +1,174 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      hci_snoop.h
+ *
+ *  Description:   Contains definitions used for recording the HCI commands
+ *                 and events crossing the vendor library into a lock-free
+ *                 ring, dumped in btsnoop format on demand
+ *
+ ******************************************************************************/
+
+#ifndef HCI_SNOOP_H
+#define HCI_SNOOP_H
+
+#include <stdint.h>
+#include "bt_vendor_lib.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* Number of packets kept in the ring, a power of two. The oldest ones are
+ * overwritten.
+ */
+#ifndef HCI_SNOOP_RING_SIZE
+#define HCI_SNOOP_RING_SIZE 256
+#endif
+
+/* Bytes kept of each packet, longer ones (firmware records) are truncated */
+#ifndef HCI_SNOOP_DATA_LEN
+#define HCI_SNOOP_DATA_LEN 64
+#endif
+
+/* Default btsnoop dump file, HciSnoopFile in the conf file overrides it */
+#ifndef HCI_SNOOP_FILE
+#define HCI_SNOOP_FILE "/data/log/bluetooth/bt_vendor_snoop.log"
+#endif
+
+#define HCI_SNOOP_PATH_LEN 256
+
+/* Opcodes with their own latency histogram */
+#define HCI_SNOOP_MAX_OPCODES 24
+
+/* Latency buckets: below 64 us, then doubling up to 256 ms and above */
+#define HCI_SNOOP_LAT_BUCKETS 14
+#define HCI_SNOOP_LAT_BASE_US 64U
+
+/* Packet directions */
+enum {
+    HCI_SNOOP_DIR_SENT = 0,
+    HCI_SNOOP_DIR_RECEIVED
+};
+
+/******************************************************************************
+**  Type definitions
+******************************************************************************/
+
+/* Command to Command Complete/Status latency of one opcode */
+typedef struct {
+    uint16_t opcode;
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t hist[HCI_SNOOP_LAT_BUCKETS];
+} hci_snoop_lat_t;
+
+/******************************************************************************
+**  Functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        hci_snoop_init
+**
+** Description     Start a session of the calling thread's controller and
+**                 arm the HciSnoopSignal dump trigger. Recording needs no
+**                 initialisation and runs from the first packet on.
+**
+** Returns         None
+**
+*******************************************************************************/
+void hci_snoop_init(void);
+
+/*******************************************************************************
+**
+** Function        hci_snoop_record
+**
+** Description     Record a packet of the calling thread's controller, H4
+**                 type first. Lock-free, safe from any thread.
+**
+** Returns         None
+**
+*******************************************************************************/
+void hci_snoop_record(uint8_t type, uint8_t dir, const uint8_t *p_data, uint16_t len);
+
+/*******************************************************************************
+**
+** Function        hci_snoop_cmd
+**
+** Description     Record an HCI command handed to xmit_cb
+**
+** Returns         None
+**
+*******************************************************************************/
+void hci_snoop_cmd(const HC_BT_HDR *p_buf);
+
+/*******************************************************************************
+**
+** Function        hci_snoop_evt
+**
+** Description     Record an HCI event received through hw_process_event
+**
+** Returns         None
+**
+*******************************************************************************/
+void hci_snoop_evt(const HC_BT_HDR *p_buf);
+
+/*******************************************************************************
+**
+** Function        hci_snoop_dump
+**
+** Description     Write the ring to btsnoop files (H4 datalink), one per
+**                 controller, and log the per-opcode latency histograms.
+**                 NULL p_path uses HciSnoopFile; controller n > 0 gets the
+**                 path suffixed with .<n>.
+**
+** Returns         Number of packets written, -1 on failure
+**
+*******************************************************************************/
+int hci_snoop_dump(const char *p_path);
+
+/*******************************************************************************
+**
+** Function        hci_snoop_latency
+**
+** Description     Compute the per-opcode command latency histograms of the
+**                 calling thread's controller from the packets in the ring
+**
+** Returns         Number of opcodes filled in p_lat
+**
+*******************************************************************************/
+uint32_t hci_snoop_latency(hci_snoop_lat_t *p_lat, uint32_t max);
+
+/*******************************************************************************
+**
+** Function        hci_snoop_cleanup
+**
+** Description     Dump the ring if HciSnoopDump asks for it on close and
+**                 disarm the signal trigger. The ring itself is kept.
+**
+** Returns         None
+**
+*******************************************************************************/
+void hci_snoop_cleanup(void);
+
+#endif /* HCI_SNOOP_H */
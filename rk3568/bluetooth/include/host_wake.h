@@ -0,0 +1,106 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      host_wake.h
+ *
+ *  Description:   Contains definitions used for following the HOST_WAKE
+ *                 line of the controller
+ *
+ ******************************************************************************/
+
+#ifndef HOST_WAKE_H
+#define HOST_WAKE_H
+
+#include <stdint.h>
+
+/******************************************************************************
+**  Type definitions
+******************************************************************************/
+
+/* HOST_WAKE transition, edge_us is the CLOCK_MONOTONIC time of the edge.
+ * Runs on the monitor thread, or in host_wake_start for a line found asserted.
+ */
+typedef void (*host_wake_cback_t)(uint8_t asserted, uint64_t edge_us);
+
+/* HOST_WAKE statistics */
+typedef struct {
+    uint32_t wakes;         /* assertions */
+    uint32_t spurious;      /* edges leaving the line state unchanged */
+    uint64_t asserted_ms;   /* time the line was asserted */
+    uint32_t locks;         /* wakelock acquisitions */
+    uint64_t locked_ms;     /* time the wakelock was held */
+    uint32_t lat_max_us;    /* edge to monitor thread */
+    uint64_t lat_sum_us;
+} host_wake_stats_t;
+
+/******************************************************************************
+**  Functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        host_wake_start
+**
+** Description     Request the HOST_WAKE line from its GPIO character device
+**                 and follow its edges on the monitor thread. polarity is
+**                 the host_wake_polarity sent to the controller.
+**
+** Returns         0 : Success
+**                 Otherwise : no line configured, or it cannot be requested
+**
+*******************************************************************************/
+int host_wake_start(uint8_t polarity, host_wake_cback_t p_cback);
+
+/*******************************************************************************
+**
+** Function        host_wake_stop
+**
+** Description     Stop the monitor, release the line and the wakelock, and
+**                 log the statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void host_wake_stop(void);
+
+/*******************************************************************************
+**
+** Function        host_wake_is_running
+**
+** Description     Check whether the HOST_WAKE line is followed, so that an
+**                 idle host can rely on it to learn about inbound traffic
+**
+** Returns         TRUE/FALSE
+**
+*******************************************************************************/
+uint8_t host_wake_is_running(void);
+
+/*******************************************************************************
+**
+** Function        host_wake_get_stats
+**
+** Description     Copy the statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void host_wake_get_stats(host_wake_stats_t *p_stats);
+
+#endif /* HOST_WAKE_H */
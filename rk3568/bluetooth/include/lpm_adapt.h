@@ -0,0 +1,134 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      lpm_adapt.h
+ *
+ *  Description:   Contains definitions used for adapting the LPM idle
+ *                 timeout to the observed traffic
+ *
+ ******************************************************************************/
+
+#ifndef LPM_ADAPT_H
+#define LPM_ADAPT_H
+
+#include <stdint.h>
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* Inter-packet gaps are binned in powers of two from 8 ms to 16 s */
+#define LPM_ADAPT_BUCKET_BASE_MS 8
+#define LPM_ADAPT_BUCKETS 12
+
+/******************************************************************************
+**  Type definitions
+******************************************************************************/
+
+/* Adaptive idle timeout statistics */
+typedef struct {
+    uint32_t timeout_ms;           /* idle timeout in use */
+    uint32_t min_ms;               /* configured bounds */
+    uint32_t max_ms;
+    uint32_t fixed_ms;             /* timeout the stack would use otherwise */
+    uint32_t gaps;                 /* unlock to lock gaps observed */
+    uint32_t host_wakes;           /* gaps ended by HOST_WAKE */
+    uint32_t updates;              /* timeout changes */
+    uint32_t transitions;          /* gaps longer than the timeout in use */
+    uint32_t transitions_fixed;    /* same with the fixed timeout */
+    uint64_t idle_awake_ms;        /* awake time spent waiting for the timeout */
+    uint64_t idle_awake_fixed_ms;  /* same with the fixed timeout */
+    uint32_t hist[LPM_ADAPT_BUCKETS + 1];
+} lpm_adapt_stats_t;
+
+/******************************************************************************
+**  Functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        lpm_adapt_init
+**
+** Description     Reset the traffic history. fixed_ms is the timeout used
+**                 until enough traffic was seen.
+**
+** Returns         None
+**
+*******************************************************************************/
+void lpm_adapt_init(uint32_t min_ms, uint32_t max_ms, uint32_t fixed_ms);
+
+/*******************************************************************************
+**
+** Function        lpm_adapt_wake
+**
+** Description     Account a BT_WAKE assert (start of traffic) or deassert
+**                 (end of traffic) requested by the stack
+**
+** Returns         TRUE if the idle timeout changed
+**
+*******************************************************************************/
+uint8_t lpm_adapt_wake(uint8_t asserted);
+
+/*******************************************************************************
+**
+** Function        lpm_adapt_host_wake
+**
+** Description     Account a HOST_WAKE assert (traffic from the controller)
+**                 or deassert at the time of its edge
+**
+** Returns         TRUE if the idle timeout changed
+**
+*******************************************************************************/
+uint8_t lpm_adapt_host_wake(uint8_t asserted, uint64_t edge_us);
+
+/*******************************************************************************
+**
+** Function        lpm_adapt_timeout
+**
+** Description     Idle timeout to use
+**
+** Returns         Timeout in milliseconds
+**
+*******************************************************************************/
+uint32_t lpm_adapt_timeout(void);
+
+/*******************************************************************************
+**
+** Function        lpm_adapt_get_stats
+**
+** Description     Copy the statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void lpm_adapt_get_stats(lpm_adapt_stats_t *p_stats);
+
+/*******************************************************************************
+**
+** Function        lpm_adapt_dump
+**
+** Description     Log the statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void lpm_adapt_dump(void);
+
+#endif /* LPM_ADAPT_H */
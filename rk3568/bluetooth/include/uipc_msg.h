@@ -25,7 +25,10 @@
 #ifndef BT_VENDOR_UIPC_MSG_H
 #define BT_VENDOR_UIPC_MSG_H
 
-#include "bt_types.h"
+#include <stdbool.h>
+#include "bt_vendor_brcm.h"
+
+typedef uint8_t BD_ADDR[BD_ADDR_LEN];
 
 /****************************************************************************/
 /*                            UIPC version number: 1.0                      */
@@ -103,6 +103,15 @@
 #endif
 #endif // (BT_WAKE_VIA_USERIAL_IOCTL==TRUE)
 
+#if (USERIAL_RX_ENGINE == TRUE)
+/* H4 packet indicators, also the receive engine channel numbers */
+#define USERIAL_H4_CMD 0x01
+#define USERIAL_H4_ACL 0x02
+#define USERIAL_H4_SCO 0x03
+#define USERIAL_H4_EVT 0x04
+#define USERIAL_H4_TYPES 5
+#endif
+
 /******************************************************************************
 **  Type definitions
 ******************************************************************************/
@@ -122,6 +131,37 @@ typedef enum {
     USERIAL_OP_NOP,
 } userial_vendor_ioctl_op_t;
 
+#if (USERIAL_RX_ENGINE == TRUE)
+/* Received packet, held by its consumer until userial_vendor_rx_release */
+typedef struct {
+    uint8_t type;    /* H4 packet indicator */
+    uint16_t len;    /* length of HCI header and payload */
+    uint8_t *p_data; /* HCI header and payload, without the indicator */
+    uint64_t rx_us;  /* time the last byte was read */
+} userial_rx_pkt_t;
+
+/* Per-channel packet consumer, called on the reader thread */
+typedef void (*userial_rx_cback_t)(void *p_data, userial_rx_pkt_t *p_pkt);
+
+/* Receive engine counters */
+typedef struct {
+    uint32_t packets[USERIAL_H4_TYPES]; /* delivered, by H4 indicator */
+    uint64_t bytes;                     /* read from the tty */
+    uint64_t direct;                    /* of them read straight into a slot */
+    uint32_t reads;
+    uint32_t unclaimed;                 /* dropped, no consumer for the channel */
+    uint32_t oversize;                  /* dropped, larger than a slot */
+    uint32_t resync;                    /* bytes skipped looking for an indicator */
+    uint32_t stalls;                    /* reads held back by a full ring */
+    uint32_t depth;                     /* slots held by consumers */
+    uint32_t depth_max;
+    uint32_t lat_samples;               /* RX latency probe, see UartRxLatencyProbe */
+    uint32_t lat_min_us;
+    uint32_t lat_max_us;
+    uint64_t lat_sum_us;
+} userial_rx_stats_t;
+#endif
+
 /******************************************************************************
 **  Extern variables and functions
 ******************************************************************************/
@@ -174,6 +214,30 @@ void userial_vendor_close(void);
 *******************************************************************************/
 void userial_vendor_set_baud(uint8_t userial_baud);
 
+/*******************************************************************************
+**
+** Function        userial_vendor_apply_profile
+**
+** Description     Switch on the read batching of the UartProfile selected
+**                 in bt_vendor.conf, once the controller is configured
+**
+** Returns         None
+**
+*******************************************************************************/
+void userial_vendor_apply_profile(void);
+
+/*******************************************************************************
+**
+** Function        userial_vendor_get_icount
+**
+** Description     Read the UART driver's line error and receive counters
+**
+** Returns         0 : Success
+**                 Otherwise : Fail (e.g. not supported by the driver)
+**
+*******************************************************************************/
+int userial_vendor_get_icount(uint32_t *p_frame, uint32_t *p_overrun, uint32_t *p_rx);
+
 /*******************************************************************************
 **
 ** Function        userial_vendor_ioctl
@@ -185,4 +249,68 @@ void userial_vendor_set_baud(uint8_t userial_baud);
 *******************************************************************************/
 void userial_vendor_ioctl(userial_vendor_ioctl_op_t op, void *p_data);
 
+#if (USERIAL_RX_ENGINE == TRUE)
+/*******************************************************************************
+**
+** Function        userial_vendor_rx_register
+**
+** Description     Set the consumer of one H4 channel. Packets of channels
+**                 without a consumer are dropped. Consumers are cleared
+**                 when the engine stops.
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int userial_vendor_rx_register(uint8_t type, userial_rx_cback_t p_cback, void *p_data);
+
+/*******************************************************************************
+**
+** Function        userial_vendor_rx_start
+**
+** Description     Start reading the opened port on the receive engine
+**                 thread. The port fd must not be read by anyone else
+**                 while the engine runs.
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int userial_vendor_rx_start(void);
+
+/*******************************************************************************
+**
+** Function        userial_vendor_rx_stop
+**
+** Description     Stop the receive engine, also done by userial_vendor_close
+**
+** Returns         None
+**
+*******************************************************************************/
+void userial_vendor_rx_stop(void);
+
+/*******************************************************************************
+**
+** Function        userial_vendor_rx_release
+**
+** Description     Hand a delivered packet slot back to the engine. May be
+**                 called from any thread.
+**
+** Returns         None
+**
+*******************************************************************************/
+void userial_vendor_rx_release(userial_rx_pkt_t *p_pkt);
+
+/*******************************************************************************
+**
+** Function        userial_vendor_rx_get_stats
+**
+** Description     Read the receive engine counters
+**
+** Returns         None
+**
+*******************************************************************************/
+void userial_vendor_rx_get_stats(userial_rx_stats_t *p_stats);
+#endif
+
 #endif /* USERIAL_VENDOR_H */
@@ -0,0 +1,110 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      vnd_board.h
+ *
+ *  Description:   Contains definitions of the board profiles: the settings
+ *                 that differ between the boards sharing this library
+ *
+ ******************************************************************************/
+
+#ifndef VND_BOARD_H
+#define VND_BOARD_H
+
+#include <stdint.h>
+
+/******************************************************************************
+**  Type definitions
+******************************************************************************/
+
+/* low power mode parameters, the HCI_VSC_WRITE_SLEEP_MODE parameter block */
+typedef struct {
+    uint8_t sleep_mode;                     /* 0(disable),1(UART),9(H5) */
+    uint8_t host_stack_idle_threshold;      /* Unit scale 300ms/25ms */
+    uint8_t host_controller_idle_threshold; /* Unit scale 300ms/25ms */
+    uint8_t bt_wake_polarity;               /* 0=Active Low, 1= Active High */
+    uint8_t host_wake_polarity;             /* 0=Active Low, 1= Active High */
+    uint8_t allow_host_sleep_during_sco;
+    uint8_t combine_sleep_mode_and_lpm;
+    uint8_t enable_uart_txd_tri_state; /* UART_TXD Tri-State */
+    uint8_t sleep_guard_time;          /* sleep guard time in 12.5ms */
+    uint8_t wakeup_guard_time;         /* wakeup guard time in 12.5ms */
+    uint8_t txd_config;                /* TXD is high in sleep state */
+    uint8_t pulsed_host_wake;          /* pulsed host wake if mode = 1 */
+} bt_lpm_param_t;
+
+/* Firmware settle time expected on a chipset before one was measured */
+typedef struct {
+    const char *p_chip_name; /* prefix of the controller local name */
+    uint32_t settle_ms;
+} vnd_board_settle_t;
+
+/* Board profile */
+typedef struct {
+    const char *p_name;
+    const char *p_compatible;  /* device tree compatible string of the SoC */
+    const char *p_uart_port;   /* UART the controller is attached to */
+    const char *p_patch_name;  /* firmware patch file, NULL: found from the chipset name */
+    uint32_t max_baud;         /* fastest UART rate the board routing carries */
+    const vnd_board_settle_t *p_settle; /* NULL terminated, NULL: none */
+    const char *p_host_wake;   /* HOST_WAKE "<gpiochip>:<offset>", NULL: owned by the kernel */
+    bt_lpm_param_t lpm;
+} vnd_board_profile_t;
+
+/******************************************************************************
+**  Functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        vnd_board_init
+**
+** Description     Select the profile of the board running the library: the
+**                 one matching the device tree compatible strings, else
+**                 VND_BOARD_DEFAULT
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_board_init(void);
+
+/*******************************************************************************
+**
+** Function        vnd_board_get
+**
+** Description     Profile of the board running the library
+**
+** Returns         Board profile
+**
+*******************************************************************************/
+const vnd_board_profile_t *vnd_board_get(void);
+
+/*******************************************************************************
+**
+** Function        vnd_board_settle_time
+**
+** Description     Firmware settle time the profile expects on a chipset
+**
+** Returns         Settle time in milliseconds, 0 if not known
+**
+*******************************************************************************/
+uint32_t vnd_board_settle_time(const char *p_chip_name);
+
+#endif /* VND_BOARD_H */
@@ -0,0 +1,122 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      vnd_cmd.h
+ *
+ *  Description:   Contains definitions used for building HCI commands in
+ *                 buffers owned by the vendor library
+ *
+ ******************************************************************************/
+
+#ifndef VND_CMD_H
+#define VND_CMD_H
+
+#include "bt_vendor_brcm.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* Opcode(2) and parameter length(1) */
+#define HCI_CMD_PREAMBLE_SIZE 3
+
+/* Largest HCI command: preamble and 255 parameter bytes */
+#define HCI_CMD_MAX_LEN 258
+
+/* Command buffers preallocated by the vendor library, at most 32 */
+#ifndef VND_CMD_POOL_SIZE
+#define VND_CMD_POOL_SIZE 8
+#endif
+
+/******************************************************************************
+**  Type definitions
+******************************************************************************/
+
+/* Command buffer pool statistics */
+typedef struct {
+    uint32_t gets;       /* buffers handed out */
+    uint32_t fallbacks;  /* pool empty, served by the stack allocator */
+    uint32_t in_use;     /* pool buffers currently handed out */
+    uint32_t high_water; /* most pool buffers handed out at once */
+} vnd_cmd_stats_t;
+
+/******************************************************************************
+**  Functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        vnd_cmd_get
+**
+** Description     Take a command buffer able to hold HCI_CMD_MAX_LEN bytes.
+**                 The header is set up for a command with len 0. When the
+**                 pool is empty the buffer comes from the stack allocator.
+**
+** Returns         Buffer, NULL if none is available
+**
+*******************************************************************************/
+HC_BT_HDR *vnd_cmd_get(void);
+
+/*******************************************************************************
+**
+** Function        vnd_cmd_build
+**
+** Description     Take a command buffer and fill in opcode and parameters.
+**                 A NULL p_param gives param_len zero bytes.
+**
+** Returns         Buffer, NULL if none is available
+**
+*******************************************************************************/
+HC_BT_HDR *vnd_cmd_build(uint16_t opcode, const uint8_t *p_param, uint8_t param_len);
+
+/*******************************************************************************
+**
+** Function        vnd_cmd_put
+**
+** Description     Give back a buffer from vnd_cmd_get or vnd_cmd_build
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_cmd_put(HC_BT_HDR *p_buf);
+
+/*******************************************************************************
+**
+** Function        vnd_cmd_get_stats
+**
+** Description     Copy the pool statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_cmd_get_stats(vnd_cmd_stats_t *p_stats);
+
+/*******************************************************************************
+**
+** Function        vnd_cmd_dump
+**
+** Description     Log the pool statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_cmd_dump(void);
+
+#endif /* VND_CMD_H */
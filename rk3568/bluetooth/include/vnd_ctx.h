@@ -0,0 +1,139 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      vnd_ctx.h
+ *
+ *  Description:   Contains definitions used to serve several controllers
+ *                 from one process. Each controller has its own control
+ *                 blocks in every layer; a thread entering the library
+ *                 through a controller's vendor interface, or running on
+ *                 its behalf (timers, reader threads), is bound to that
+ *                 controller and the layers pick its control blocks.
+ *
+ ******************************************************************************/
+
+#ifndef VND_CTX_H
+#define VND_CTX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* Binding of a thread serving no controller (the timer service, the conf
+ * watch, threads of the stack calling in without a vendor interface)
+ */
+#define VND_CTX_UNBOUND 0xFF
+
+/* Thread start argument carrying the controller of the creating thread */
+#define VND_CTX_THREAD_ARG() ((void *)(uintptr_t)vnd_ctx_binding())
+
+/******************************************************************************
+**  Functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_id
+**
+** Description     Controller the calling thread is bound to. A thread never
+**                 bound has no controller state of its own: its access is
+**                 logged once and falls back to the first controller so it
+**                 stays within bounds. With a single controller every
+**                 thread serves it.
+**
+** Returns         Controller index
+**
+*******************************************************************************/
+uint8_t vnd_ctx_id(void);
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_binding
+**
+** Description     Binding of the calling thread, for handing it over to the
+**                 threads and timers started on its behalf
+**
+** Returns         Controller index, VND_CTX_UNBOUND if not bound
+**
+*******************************************************************************/
+uint8_t vnd_ctx_binding(void);
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_bind
+**
+** Description     Bind the calling thread to a controller, or unbind it with
+**                 VND_CTX_UNBOUND
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_ctx_bind(uint8_t id);
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_bind_thread
+**
+** Description     Bind a thread started with VND_CTX_THREAD_ARG() to the
+**                 controller of its creator
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_ctx_bind_thread(void *arg);
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_open
+**
+** Description     Mark the calling thread's controller open
+**
+** Returns         TRUE if no other controller is open
+**
+*******************************************************************************/
+uint8_t vnd_ctx_open(void);
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_close
+**
+** Description     Mark the calling thread's controller closed
+**
+** Returns         TRUE if no other controller is still open
+**
+*******************************************************************************/
+uint8_t vnd_ctx_close(void);
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_name
+**
+** Description     Name of a value kept per controller: p_name itself for the
+**                 first controller, p_name.<n> for controller n
+**
+** Returns         p_buf
+**
+*******************************************************************************/
+const char *vnd_ctx_name(const char *p_name, char *p_buf, size_t len);
+
+#endif /* VND_CTX_H */
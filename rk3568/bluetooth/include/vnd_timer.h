@@ -1,6 +1,6 @@
 /******************************************************************************
  *
- *  Copyright (C) 2009-2012 Broadcom Corporation
+ *  Copyright (C) 2026 HiHope Open Source Organization.
  *
  *  Licensed under the Apache License, Version 2.0 (the "License");
  *  you may not use this file except in compliance with the License.
@@ -18,91 +18,99 @@
 
 /******************************************************************************
  *
- *  Filename:      upio.h
+ *  Filename:      vnd_timer.h
  *
- *  Description:   Contains definitions used for I/O controls
+ *  Description:   Contains definitions used for the vendor library timer
+ *                 service
  *
  ******************************************************************************/
 
-#ifndef UPIO_H
-#define UPIO_H
+#ifndef VND_TIMER_H
+#define VND_TIMER_H
 
 #include <stdint.h>
+
 /******************************************************************************
 **  Constants & Macros
 ******************************************************************************/
 
-#define UPIO_BT_POWER_OFF 0
-#define UPIO_BT_POWER_ON  1
-
-/* UPIO signals */
-enum {
-    UPIO_BT_WAKE = 0,
-    UPIO_HOST_WAKE,
-    UPIO_LPM_MODE,
-    UPIO_MAX_COUNT
-};
-
-/* UPIO assertion/deassertion */
-enum {
-    UPIO_UNKNOWN = 0,
-    UPIO_DEASSERT,
-    UPIO_ASSERT
-};
+/* Number of timers each controller can own at the same time */
+#ifndef VND_TIMER_MAX
+#define VND_TIMER_MAX 8
+#endif
 
 /******************************************************************************
-**  Extern variables and functions
+**  Type definitions
 ******************************************************************************/
 
+/* Expiry callback, run on the timer service thread */
+typedef void (*vnd_timer_cback_t)(void *p_data);
+
+/* Timer handle */
+typedef struct vnd_timer vnd_timer_t;
+
 /******************************************************************************
 **  Functions
 ******************************************************************************/
 
 /*******************************************************************************
 **
-** Function        upio_init
+** Function        vnd_timer_alloc
 **
-** Description     Initialization
+** Description     Allocate a disarmed timer. The service thread is started
+**                 with the first timer. The callback runs bound to the
+**                 controller of the allocating thread.
 **
-** Returns         None
+** Returns         Timer handle, NULL if none is available
 **
 *******************************************************************************/
-void upio_init(void);
+vnd_timer_t *vnd_timer_alloc(vnd_timer_cback_t p_cback, void *p_data);
 
 /*******************************************************************************
 **
-** Function        upio_cleanup
+** Function        vnd_timer_free
 **
-** Description     Clean up
+** Description     Disarm and release a timer. Safe from its own callback.
 **
 ** Returns         None
 **
 *******************************************************************************/
-void upio_cleanup(void);
+void vnd_timer_free(vnd_timer_t *p_timer);
 
 /*******************************************************************************
 **
-** Function        upio_set_bluetooth_power
+** Function        vnd_timer_start
 **
-** Description     Interact with low layer driver to set Bluetooth power
-**                 on/off.
+** Description     (Re-)arm a timer. A periodic timer fires every msec
+**                 milliseconds until it is stopped.
 **
-** Returns         0  : SUCCESS or Not-Applicable
-**                 <0 : ERROR
+** Returns         0 : Success
+**                 Otherwise : Fail
 **
 *******************************************************************************/
-int upio_set_bluetooth_power(int on);
+int vnd_timer_start(vnd_timer_t *p_timer, uint32_t msec, uint8_t periodic);
 
 /*******************************************************************************
 **
-** Function        upio_set
+** Function        vnd_timer_stop
 **
-** Description     Set i/o based on polarity
+** Description     Disarm a timer. An expiry not dispatched yet is dropped.
 **
 ** Returns         None
 **
 *******************************************************************************/
-void upio_set(uint8_t pio, uint8_t action, uint8_t polarity);
+void vnd_timer_stop(vnd_timer_t *p_timer);
 
-#endif /* UPIO_H */
+/*******************************************************************************
+**
+** Function        vnd_timer_cleanup
+**
+** Description     Stop the service thread and release the timers still
+**                 allocated
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_timer_cleanup(void);
 
+#endif /* VND_TIMER_H */
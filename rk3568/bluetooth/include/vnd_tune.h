@@ -0,0 +1,168 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      vnd_tune.h
+ *
+ *  Description:   Contains definitions used for the run-time tunables: the
+ *                 conf file entries indexed by a hash, typed values staged
+ *                 when the conf file is read and applied at a safe point
+ *
+ ******************************************************************************/
+
+#ifndef VND_TUNE_H
+#define VND_TUNE_H
+
+#include <stdint.h>
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* Hash slots, a power of two larger than the number of entries */
+#define VND_TUNE_HASH_SIZE 64
+
+/* Largest typed value in bytes */
+#define VND_TUNE_MAX_BYTES 8
+
+/* Value types */
+enum {
+    VND_TUNE_U8 = 0,
+    VND_TUNE_U16,
+    VND_TUNE_U32,
+    VND_TUNE_U8_ARRAY /* comma separated, count elements */
+};
+
+/* Points where staged values take effect */
+#define VND_TUNE_AT_POWER 0x01 /* controller power cycle (BT_OP_INIT) */
+#define VND_TUNE_AT_LPM 0x02   /* low power mode enabled or disabled */
+
+/******************************************************************************
+**  Type definitions
+******************************************************************************/
+
+typedef int(vnd_tune_action_t)(char *p_conf_name, char *p_conf_value, int param);
+
+/* A typed tunable. p_value is the effective value the owning module uses,
+ * min and max bound every element. A value kept per controller has the one
+ * of controller n stride * n bytes after p_value and is staged, applied and
+ * dumped (as Name.<n>) for each controller on its own.
+ */
+typedef struct {
+    const char *p_name;
+    uint8_t type;  /* VND_TUNE_xxx */
+    uint8_t count; /* elements of a VND_TUNE_U8_ARRAY */
+    uint8_t when;  /* VND_TUNE_AT_xxx mask */
+    uint32_t min;
+    uint32_t max;
+    void *p_value;
+    uint32_t stride; /* bytes between the values of two controllers, 0: one value for all */
+} vnd_tune_t;
+
+/******************************************************************************
+**  Functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        vnd_tune_register
+**
+** Description     Index typed tunables. Registering a table again is a no-op.
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_tune_register(const vnd_tune_t *p_tunes, uint32_t num);
+
+/*******************************************************************************
+**
+** Function        vnd_tune_register_action
+**
+** Description     Index a conf entry handled by an action function
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_tune_register_action(const char *p_name, vnd_tune_action_t *p_action, int param);
+
+/*******************************************************************************
+**
+** Function        vnd_tune_set
+**
+** Description     Handle a conf file entry: run its action, or check and
+**                 stage a typed value for the calling thread's controller.
+**                 Actions only run when reload is FALSE, they are not safe
+**                 while the stack is up.
+**
+** Returns         0 : Success
+**                 Otherwise : Unknown entry or invalid value
+**
+*******************************************************************************/
+int vnd_tune_set(char *p_name, char *p_value, uint8_t reload);
+
+/*******************************************************************************
+**
+** Function        vnd_tune_apply
+**
+** Description     Make the staged values of the tunables taking effect at
+**                 this point effective for the calling thread's controller
+**
+** Returns         Number of values changed
+**
+*******************************************************************************/
+uint32_t vnd_tune_apply(uint8_t when);
+
+/*******************************************************************************
+**
+** Function        vnd_tune_dump
+**
+** Description     Write the effective values in conf file syntax to p_path,
+**                 or to the log when p_path is NULL. Values staged but not
+**                 applied yet are shown as pending.
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int vnd_tune_dump(const char *p_path);
+
+/*******************************************************************************
+**
+** Function        vnd_tune_watch_start
+**
+** Description     Reload p_path whenever it is rewritten. The new values are
+**                 staged, they apply at the next power cycle or LPM toggle.
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_tune_watch_start(const char *p_path);
+
+/*******************************************************************************
+**
+** Function        vnd_tune_watch_stop
+**
+** Description     Stop watching the conf file
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_tune_watch_stop(void);
+
+#endif /* VND_TUNE_H */
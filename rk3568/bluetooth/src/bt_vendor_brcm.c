@@ -28,9 +28,17 @@
 
 #include <utils/Log.h>
 #include <string.h>
+#include <pthread.h>
 #include "upio.h"
+#include "vnd_timer.h"
 #include "userial_vendor.h"
 #include "bt_vendor_brcm.h"
+#include "hci_snoop.h"
+#include "vnd_tune.h"
+#include "vnd_board.h"
+#if (BRCM_A2DP_OFFLOAD == TRUE)
+#include "bt_vendor_brcm_a2dp.h"
+#endif
 
 #ifndef BTVND_DBG
 #define BTVND_DBG FALSE
@@ -53,6 +61,10 @@
 ******************************************************************************/
 
 void hw_config_start(void);
+void hw_config_prefetch_start(void);
+uint8_t hw_config_prefetch_wait(void);
+void hw_uart_monitor_stop(void);
+void hw_cleanup(void);
 uint8_t hw_lpm_enable(uint8_t turn_on);
 uint32_t hw_lpm_get_idle_timeout(void);
 void hw_lpm_set_wake_state(uint8_t wake_assert);
@@ -68,8 +80,8 @@ void hw_epilog_process(void);
 **  Variables
 ******************************************************************************/
 
-bt_vendor_callbacks_t *bt_vendor_cbacks = NULL;
-uint8_t vnd_local_bd_addr[BD_ADDR_LEN] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+bt_vendor_callbacks_t *vnd_cbacks[VND_MAX_CONTROLLERS];
+uint8_t vnd_local_bd_addrs[VND_MAX_CONTROLLERS][BD_ADDR_LEN];
 
 /******************************************************************************
 **  Local type definitions
@@ -84,6 +96,9 @@ static const tUSERIAL_CFG userial_init_cfg = {
     USERIAL_BAUD_115200
 };
 
+/* init and cleanup of the controllers share the process wide services */
+static pthread_mutex_t vnd_if_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /******************************************************************************
 **  Functions
 ******************************************************************************/
@@ -101,14 +116,20 @@ typedef enum {
 
 static int init(const bt_vendor_callbacks_t *p_cb, unsigned char *local_bdaddr)
 {
-    HILOGI("init, bdaddr:%02x%02x:%02x%02x:%02x%02x", local_bdaddr[0], local_bdaddr[1], local_bdaddr[2],
-        local_bdaddr[3], local_bdaddr[4], local_bdaddr[5]);
+    uint8_t first;
+    int ret;
+
+    HILOGI("init controller %u, bdaddr:%02x%02x:%02x%02x:%02x%02x", vnd_ctx_id(), local_bdaddr[0],
+        local_bdaddr[1], local_bdaddr[2], local_bdaddr[3], local_bdaddr[4], local_bdaddr[5]);
 
     if (p_cb == NULL) {
         HILOGE("init failed with no user callbacks!");
         return -1;
     }
 
+    pthread_mutex_lock(&vnd_if_lock);
+    first = vnd_ctx_open();
+
 #if (VENDOR_LIB_RUNTIME_TUNING_ENABLED == TRUE)
     HILOGW("*****************************************************************");
     HILOGW("*****************************************************************");
@@ -122,20 +143,36 @@ static int init(const bt_vendor_callbacks_t *p_cb, unsigned char *local_bdaddr)
     HILOGW("*****************************************************************");
 #endif
 
+    if (first) {
+        vnd_board_init();
+    }
     userial_vendor_init();
     upio_init();
 
     vnd_load_conf(VENDOR_LIB_CONF_FILE);
+#if (VENDOR_LIB_CONF_RELOAD == TRUE)
+    if (first) {
+        vnd_tune_watch_start(VENDOR_LIB_CONF_FILE);
+    }
+#endif
+#if (HCI_SNOOP_INCLUDED == TRUE)
+    hci_snoop_init();
+#endif
 
     /* store reference to user callbacks */
     bt_vendor_cbacks = (bt_vendor_callbacks_t *)p_cb;
 
 #if (BRCM_A2DP_OFFLOAD == TRUE)
-    brcm_vnd_a2dp_init(bt_vendor_cbacks);
+    /* the audio path is wired to the first controller */
+    if (vnd_ctx_id() == 0) {
+        brcm_vnd_a2dp_init(bt_vendor_cbacks);
+    }
 #endif
 
     /* This is handed over from the stack */
-    return memcpy_s(vnd_local_bd_addr, BD_ADDR_LEN, local_bdaddr, BD_ADDR_LEN);
+    ret = memcpy_s(vnd_local_bd_addr, BD_ADDR_LEN, local_bdaddr, BD_ADDR_LEN);
+    pthread_mutex_unlock(&vnd_if_lock);
+    return ret;
 }
 
 /** Requested operations */
@@ -145,11 +182,19 @@ static int op(bt_opcode_t opcode, void *param)
     
     switch (opcode) {
         case BT_OP_POWER_ON: // BT_VND_OP_POWER_CTRL
-            upio_set_bluetooth_power(UPIO_BT_POWER_OFF);
+            /* load the firmware patch while the controller powers up */
+            hw_config_prefetch_start();
+            /* a controller left powered is taken over by the readiness probe */
             upio_set_bluetooth_power(UPIO_BT_POWER_ON);
             break;
 
         case BT_OP_POWER_OFF: // BT_VND_OP_POWER_CTRL
+            hw_uart_monitor_stop();
+#if (BRCM_A2DP_OFFLOAD == TRUE)
+            if (vnd_ctx_id() == 0) {
+                brcm_vnd_a2dp_cleanup();
+            }
+#endif
             upio_set_bluetooth_power(UPIO_BT_POWER_OFF);
             hw_lpm_set_wake_state(false);
             break;
@@ -168,6 +213,7 @@ static int op(bt_opcode_t opcode, void *param)
             break;
         }
         case BT_OP_HCI_CHANNEL_CLOSE: // BT_VND_OP_USERIAL_CLOSE
+            hw_uart_monitor_stop();
             userial_vendor_close();
             break;
 
@@ -206,14 +252,68 @@ static int op(bt_opcode_t opcode, void *param)
 /** Closes the interface */
 static void cleanup(void)
 {
-    BTVNDDBG("cleanup");
+    uint8_t last;
+
+    BTVNDDBG("cleanup controller %u", vnd_ctx_id());
+    pthread_mutex_lock(&vnd_if_lock);
+    hw_config_prefetch_wait();
+#if (BRCM_A2DP_OFFLOAD == TRUE)
+    if (vnd_ctx_id() == 0) {
+        brcm_vnd_a2dp_cleanup();
+    }
+#endif
+    hw_cleanup();
+    last = vnd_ctx_close();
+    if (last) {
+#if (VENDOR_LIB_CONF_RELOAD == TRUE)
+        vnd_tune_watch_stop();
+#endif
+#if (HCI_SNOOP_INCLUDED == TRUE)
+        hci_snoop_cleanup();
+#endif
+    }
     upio_cleanup();
+    if (last) {
+        vnd_timer_cleanup();
+    }
     bt_vendor_cbacks = NULL;
+    pthread_mutex_unlock(&vnd_if_lock);
 }
 
+/* Vendor interface of controller n: the calling thread is bound to it first */
+#define VND_INTERFACE(n)                                                                  \
+    static int init_##n(const bt_vendor_callbacks_t *p_cb, unsigned char *local_bdaddr) \
+    {                                                                                   \
+        vnd_ctx_bind(n);                                                                \
+        return init(p_cb, local_bdaddr);                                                \
+    }                                                                                   \
+    static int op_##n(bt_opcode_t opcode, void *param)                                  \
+    {                                                                                   \
+        vnd_ctx_bind(n);                                                                \
+        return op(opcode, param);                                                       \
+    }                                                                                   \
+    static void cleanup_##n(void)                                                       \
+    {                                                                                   \
+        vnd_ctx_bind(n);                                                                \
+        cleanup();                                                                      \
+    }
+
+VND_INTERFACE(0)
+
 // Entry point of DLib
 const bt_vendor_interface_t BLUETOOTH_VENDOR_LIB_INTERFACE = {
     sizeof(bt_vendor_interface_t),
-    init,
-    op,
-    cleanup};
+    init_0,
+    op_0,
+    cleanup_0};
+
+#if (VND_MAX_CONTROLLERS > 1)
+VND_INTERFACE(1)
+
+// Entry point of the second controller
+const bt_vendor_interface_t BLUETOOTH_VENDOR_LIB_INTERFACE_1 = {
+    sizeof(bt_vendor_interface_t),
+    init_1,
+    op_1,
+    cleanup_1};
+#endif
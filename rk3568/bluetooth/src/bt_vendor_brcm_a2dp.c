@@ -0,0 +1,741 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      bt_vendor_brcm_a2dp.c
+ *
+ *  Description:   Contains the A2DP offload. The stream is handed over to
+ *                 the controller with the UIPC messages of uipc_msg.h, one
+ *                 HCI_VSC_UIPC_OVER_HCI each: open UIPC, sync the L2CAP
+ *                 channel and the AVDTP stream, configure the encoder and
+ *                 the I2S route, start. From then on the controller reads
+ *                 PCM from the I2S port, encodes and sends the media packets
+ *                 itself, the host neither encodes nor moves ACL data.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_vnd_a2dp"
+
+#include <utils/Log.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
+#include "bt_vendor_brcm.h"
+#include "bt_hci_bdroid.h"
+#include "cmd_sched.h"
+#include "bt_vendor_brcm_a2dp.h"
+
+#if (BRCM_A2DP_OFFLOAD == TRUE)
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* Command Complete of HCI_VSC_UIPC_OVER_HCI: status, class, response */
+#define A2DP_EVT_STATUS 5
+#define A2DP_EVT_UIPC_CLASS 6
+#define A2DP_EVT_UIPC_MSG 8
+#define A2DP_EVT_MIN_LEN (A2DP_EVT_UIPC_MSG + 1)
+
+#define A2DP_UIPC_PARAM_MAX 64
+
+/* L2CAP packet boundary flags of the offloaded channel */
+#define A2DP_L2CAP_PKT_START_NON_FLUSHABLE 0
+#define A2DP_L2CAP_PKT_START 2
+
+/* UIPC messages, in the order they are sent */
+enum {
+    A2DP_STEP_UIPC_OPEN,
+    A2DP_STEP_L2C_SYNC,
+    A2DP_STEP_AVDT_SYNC,
+    A2DP_STEP_CODEC_CONFIG,
+    A2DP_STEP_ROUTE_CONFIG,
+    A2DP_STEP_START,
+    A2DP_STEP_SUSPEND,
+    A2DP_STEP_STOP,
+    A2DP_STEP_ROUTE_RESET,
+    A2DP_STEP_L2C_REMOVE,
+    A2DP_STEP_UIPC_CLOSE,
+    A2DP_STEP_NUM
+};
+
+/* No status byte in the response */
+#define A2DP_NO_STATUS 0xFF
+
+/******************************************************************************
+**  Local type definitions
+******************************************************************************/
+
+/* Response expected for a UIPC message */
+typedef struct {
+    uint16_t uipc_class;
+    uint8_t rsp;        /* response opcode */
+    uint8_t status_off; /* offset of the status in the response, A2DP_NO_STATUS: none */
+} brcm_vnd_a2dp_step_t;
+
+/* Offload control block */
+typedef struct {
+    uint8_t state;
+    const uint8_t *p_seq; /* steps of the running request, A2DP_STEP_NUM terminated */
+    uint8_t pos;
+    uint8_t req;          /* request reported when the sequence ends, 0: internal */
+    uint8_t failed;
+    uint8_t stop_pending; /* stop asked for while a request was running */
+    uint8_t opened;       /* UIPC channel open on the controller */
+    uint8_t report;       /* a result waits for brcm_vnd_a2dp_report */
+    uint8_t report_req;
+    uint8_t report_status;
+    brcm_vnd_a2dp_offload_t offload;
+    brcm_vnd_a2dp_cback_t p_cback;
+    uint64_t start_us;
+    brcm_vnd_a2dp_stats_t stats;
+} brcm_vnd_a2dp_cb_t;
+
+/******************************************************************************
+**  Externs
+******************************************************************************/
+
+#if (SCO_CFG_INCLUDED == TRUE)
+void hw_sco_forget(void);
+#endif
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+static const brcm_vnd_a2dp_step_t brcm_vnd_a2dp_steps[A2DP_STEP_NUM] = {
+    {BT_EVT_BTU_IPC_MGMT_EVT, UIPC_OPEN_RSP, offsetof(tUIPC_OPEN_RSP, status)},
+    {BT_EVT_BTU_IPC_L2C_EVT, L2C_SYNC_TO_LITE_RESP,
+        offsetof(tL2C_SYNC_TO_LITE_RESP, stream) + offsetof(tL2C_SYNC_TO_LITE_RESP_STREAM, status)},
+    {BT_EVT_BTU_IPC_AVDT_EVT, AVDT_SYNC_TO_BTC_LITE_RESP, offsetof(tAVDT_SYNC_TO_BTC_LITE_RESP, status)},
+    {BT_EVT_BTU_IPC_BTM_EVT, AUDIO_CODEC_CONFIG_RESP, offsetof(tAUDIO_CODEC_CONFIG_RESP, status)},
+    {BT_EVT_BTU_IPC_BTM_EVT, AUDIO_ROUTE_CONFIG_RESP, offsetof(tAUDIO_ROUTE_CONFIG_RESP, status)},
+    {BT_EVT_BTU_IPC_BTM_EVT, A2DP_START_RESP, A2DP_NO_STATUS},
+    {BT_EVT_BTU_IPC_BTM_EVT, A2DP_SUSPEND_RESP, A2DP_NO_STATUS},
+    {BT_EVT_BTU_IPC_BTM_EVT, A2DP_STOP_RESP, A2DP_NO_STATUS},
+    {BT_EVT_BTU_IPC_BTM_EVT, AUDIO_ROUTE_CONFIG_RESP, offsetof(tAUDIO_ROUTE_CONFIG_RESP, status)},
+    {BT_EVT_BTU_IPC_L2C_EVT, L2C_REMOVE_TO_LITE_RESP,
+        offsetof(tL2C_REMOVE_TO_LITE_RESP, stream) + offsetof(tL2C_SYNC_TO_LITE_RESP_STREAM, status)},
+    {BT_EVT_BTU_IPC_MGMT_EVT, UIPC_CLOSE_RSP, A2DP_NO_STATUS},
+};
+
+static const uint8_t brcm_vnd_a2dp_seq_start[] = {
+    A2DP_STEP_UIPC_OPEN, A2DP_STEP_L2C_SYNC, A2DP_STEP_AVDT_SYNC, A2DP_STEP_CODEC_CONFIG,
+    A2DP_STEP_ROUTE_CONFIG, A2DP_STEP_START, A2DP_STEP_NUM
+};
+static const uint8_t brcm_vnd_a2dp_seq_resume[] = {A2DP_STEP_START, A2DP_STEP_NUM};
+static const uint8_t brcm_vnd_a2dp_seq_suspend[] = {A2DP_STEP_SUSPEND, A2DP_STEP_NUM};
+
+/* every step runs even when one fails, the controller is left clean */
+static const uint8_t brcm_vnd_a2dp_seq_stop[] = {
+    A2DP_STEP_STOP, A2DP_STEP_ROUTE_RESET, A2DP_STEP_L2C_REMOVE, A2DP_STEP_UIPC_CLOSE, A2DP_STEP_NUM
+};
+
+static brcm_vnd_a2dp_cb_t brcm_vnd_a2dp_cb;
+static pthread_mutex_t brcm_vnd_a2dp_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/******************************************************************************
+**  Static functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_build
+**
+** Description     Build the UIPC message of a step behind its class
+**
+** Returns         Parameter length of HCI_VSC_UIPC_OVER_HCI
+**
+*******************************************************************************/
+static uint8_t brcm_vnd_a2dp_build(uint8_t step, uint8_t *p_param)
+{
+    const brcm_vnd_a2dp_offload_t *p_off = &brcm_vnd_a2dp_cb.offload;
+    uint8_t *p_msg = p_param + sizeof(uint16_t);
+    size_t max = A2DP_UIPC_PARAM_MAX - sizeof(uint16_t);
+    size_t len;
+
+    p_param[0] = (uint8_t)brcm_vnd_a2dp_steps[step].uipc_class;
+    p_param[1] = (uint8_t)(brcm_vnd_a2dp_steps[step].uipc_class >> 8);
+    (void)memset_s(p_msg, max, 0, max);
+
+    switch (step) {
+        case A2DP_STEP_UIPC_OPEN: {
+            tUIPC_OPEN_REQ *p_req = (tUIPC_OPEN_REQ *)p_msg;
+            p_req->opcode = UIPC_OPEN_REQ;
+            len = sizeof(*p_req);
+            break;
+        }
+
+        case A2DP_STEP_L2C_SYNC: {
+            tL2C_SYNC_TO_LITE_REQ *p_req = (tL2C_SYNC_TO_LITE_REQ *)p_msg;
+            p_req->op_code = L2C_SYNC_TO_LITE_REQ;
+            p_req->light_xmit_quota = p_off->xmit_quota;
+            p_req->acl_data_size = p_off->acl_data_size;
+            p_req->non_flushable_pbf = p_off->is_flushable ? A2DP_L2CAP_PKT_START :
+                A2DP_L2CAP_PKT_START_NON_FLUSHABLE;
+            p_req->multi_av_data_cong_start = BRCM_A2DP_OFFLOAD_CONG_START;
+            p_req->multi_av_data_cong_end = BRCM_A2DP_OFFLOAD_CONG_END;
+            p_req->multi_av_data_cong_discard = BRCM_A2DP_OFFLOAD_CONG_DISCARD;
+            p_req->num_stream = 1;
+            p_req->stream.local_cid = p_off->local_cid;
+            p_req->stream.remote_cid = p_off->remote_cid;
+            p_req->stream.out_mtu = p_off->stream_mtu;
+            p_req->stream.handle = p_off->lm_handle;
+            p_req->stream.link_xmit_quota = p_off->xmit_quota;
+            p_req->stream.is_flushable = p_off->is_flushable;
+            len = sizeof(*p_req);
+            break;
+        }
+
+        case A2DP_STEP_AVDT_SYNC: {
+            tAVDT_SYNC_TO_BTC_LITE_REQ *p_req = (tAVDT_SYNC_TO_BTC_LITE_REQ *)p_msg;
+            p_req->opcode = AVDT_SYNC_TO_BTC_LITE_REQ;
+            p_req->num_stream = 1;
+            p_req->stream.lcid = p_off->local_cid;
+            p_req->stream.ssrc = p_off->stream_source;
+            len = sizeof(*p_req);
+            break;
+        }
+
+        case A2DP_STEP_CODEC_CONFIG: {
+            tAUDIO_CODEC_CONFIG_REQ *p_req = (tAUDIO_CODEC_CONFIG_REQ *)p_msg;
+            p_req->opcode = AUDIO_CODEC_CONFIG_REQ;
+            p_req->codec_type = p_off->codec_type;
+            p_req->codec_info = p_off->codec_info;
+            len = sizeof(*p_req);
+            break;
+        }
+
+        case A2DP_STEP_ROUTE_CONFIG:
+        case A2DP_STEP_ROUTE_RESET: {
+            tAUDIO_ROUTE_CONFIG_REQ *p_req = (tAUDIO_ROUTE_CONFIG_REQ *)p_msg;
+            p_req->opcode = AUDIO_ROUTE_CONFIG_REQ;
+            if (step == A2DP_STEP_ROUTE_CONFIG) {
+                p_req->src = AUDIO_ROUTE_SRC_I2S;
+                p_req->src_sf = p_off->sample_rate;
+                p_req->out = AUDIO_ROUTE_OUT_BTA2DP;
+                p_req->out_codec_sf = p_off->sample_rate;
+            } else {
+                p_req->src = AUDIO_ROUTE_SRC_NONE;
+                p_req->src_sf = AUDIO_ROUTE_SF_NA;
+                p_req->out = AUDIO_ROUTE_OUT_NONE;
+                p_req->out_codec_sf = AUDIO_ROUTE_SF_NA;
+            }
+            p_req->out_i2s_sf = AUDIO_ROUTE_SF_NA;
+            p_req->eq_mode = AUDIO_ROUTE_EQ_BYPASS;
+            len = sizeof(*p_req);
+            break;
+        }
+
+        case A2DP_STEP_START: {
+            tA2DP_START_REQ *p_req = (tA2DP_START_REQ *)p_msg;
+            p_req->opcode = A2DP_START_REQ;
+            p_req->lcid = p_off->local_cid;
+            p_req->curr_mtu = p_off->stream_mtu;
+            len = sizeof(*p_req);
+            break;
+        }
+
+        case A2DP_STEP_SUSPEND: {
+            tA2DP_SUSPEND_REQ *p_req = (tA2DP_SUSPEND_REQ *)p_msg;
+            p_req->opcode = A2DP_SUSPEND_REQ;
+            p_req->lcid = p_off->local_cid;
+            len = sizeof(*p_req);
+            break;
+        }
+
+        case A2DP_STEP_STOP: {
+            tA2DP_STOP_REQ *p_req = (tA2DP_STOP_REQ *)p_msg;
+            p_req->opcode = A2DP_STOP_REQ;
+            p_req->lcid = p_off->local_cid;
+            len = sizeof(*p_req);
+            break;
+        }
+
+        case A2DP_STEP_L2C_REMOVE: {
+            tL2C_REMOVE_TO_LITE_REQ *p_req = (tL2C_REMOVE_TO_LITE_REQ *)p_msg;
+            p_req->op_code = L2C_REMOVE_TO_LITE_REQ;
+            p_req->light_xmit_quota = 0;
+            p_req->num_stream = 1;
+            p_req->lcid = p_off->local_cid;
+            len = sizeof(*p_req);
+            break;
+        }
+
+        default: {
+            tUIPC_CLOSE_REQ *p_req = (tUIPC_CLOSE_REQ *)p_msg;
+            p_req->opcode = UIPC_CLOSE_REQ;
+            len = sizeof(*p_req);
+            break;
+        }
+    }
+
+    return (uint8_t)(sizeof(uint16_t) + len);
+}
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_set_report
+**
+** Description     Keep the result of a request for the caller to report
+**                 once brcm_vnd_a2dp_lock is dropped. Must be called with
+**                 brcm_vnd_a2dp_lock held.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void brcm_vnd_a2dp_set_report(uint8_t req, uint8_t failed)
+{
+    if (req == 0) {
+        return;
+    }
+    brcm_vnd_a2dp_cb.report = TRUE;
+    brcm_vnd_a2dp_cb.report_req = req;
+    brcm_vnd_a2dp_cb.report_status = failed ? BTC_OP_RESULT_FAIL : BTC_OP_RESULT_SUCCESS;
+}
+
+static void brcm_vnd_a2dp_run(const uint8_t *p_seq, uint8_t req);
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_finish
+**
+** Description     Move to the state reached by the ended sequence and start
+**                 a stop asked for meanwhile. Must be called with
+**                 brcm_vnd_a2dp_lock held.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void brcm_vnd_a2dp_finish(void)
+{
+    uint8_t failed = brcm_vnd_a2dp_cb.failed;
+    uint32_t elapsed_us;
+
+    brcm_vnd_a2dp_cb.p_seq = NULL;
+
+    switch (brcm_vnd_a2dp_cb.state) {
+        case BRCM_VND_A2DP_STARTING:
+            brcm_vnd_a2dp_set_report(A2DP_START_REQ, failed);
+            if (!failed) {
+                elapsed_us = (uint32_t)(get_monotonic_time_us() - brcm_vnd_a2dp_cb.start_us);
+                brcm_vnd_a2dp_cb.stats.starts++;
+                brcm_vnd_a2dp_cb.stats.last_start_us = elapsed_us;
+                if (elapsed_us > brcm_vnd_a2dp_cb.stats.max_start_us) {
+                    brcm_vnd_a2dp_cb.stats.max_start_us = elapsed_us;
+                }
+                brcm_vnd_a2dp_cb.state = BRCM_VND_A2DP_STREAMING;
+                HILOGI("a2dp offload streaming lcid 0x%04x, started in %u us", brcm_vnd_a2dp_cb.offload.local_cid,
+                    elapsed_us);
+                break;
+            }
+
+            brcm_vnd_a2dp_cb.stats.failures++;
+            HILOGE("a2dp offload start failed");
+            if (brcm_vnd_a2dp_cb.opened) {
+                /* take back what the controller already set up */
+                brcm_vnd_a2dp_cb.stop_pending = FALSE;
+                brcm_vnd_a2dp_run(brcm_vnd_a2dp_seq_stop, 0);
+                return;
+            }
+            brcm_vnd_a2dp_cb.state = BRCM_VND_A2DP_IDLE;
+            break;
+
+        case BRCM_VND_A2DP_SUSPENDING:
+            brcm_vnd_a2dp_set_report(A2DP_SUSPEND_REQ, failed);
+            brcm_vnd_a2dp_cb.state = failed ? BRCM_VND_A2DP_STREAMING : BRCM_VND_A2DP_SUSPENDED;
+            break;
+
+        default:
+            brcm_vnd_a2dp_set_report(brcm_vnd_a2dp_cb.req, failed);
+            if (brcm_vnd_a2dp_cb.req == A2DP_STOP_REQ) {
+                brcm_vnd_a2dp_cb.stats.stops++;
+            }
+            brcm_vnd_a2dp_cb.state = BRCM_VND_A2DP_IDLE;
+            brcm_vnd_a2dp_cb.stop_pending = FALSE;
+            HILOGI("a2dp offload stopped");
+            break;
+    }
+
+    if (brcm_vnd_a2dp_cb.stop_pending) {
+        brcm_vnd_a2dp_cb.stop_pending = FALSE;
+        brcm_vnd_a2dp_cb.state = BRCM_VND_A2DP_STOPPING;
+        brcm_vnd_a2dp_run(brcm_vnd_a2dp_seq_stop, A2DP_STOP_REQ);
+    }
+}
+
+static void brcm_vnd_a2dp_cback(void *p_mem);
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_send
+**
+** Description     Send the current step, skipping over the steps that cannot
+**                 be sent. Must be called with brcm_vnd_a2dp_lock held.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void brcm_vnd_a2dp_send(void)
+{
+    uint8_t param[A2DP_UIPC_PARAM_MAX];
+    uint8_t step;
+    uint8_t len;
+
+    while ((step = brcm_vnd_a2dp_cb.p_seq[brcm_vnd_a2dp_cb.pos]) != A2DP_STEP_NUM) {
+        len = brcm_vnd_a2dp_build(step, param);
+        if (cmd_sched_send(HCI_VSC_UIPC_OVER_HCI, param, len, CMD_SCHED_PRIO_AUDIO, brcm_vnd_a2dp_cback)) {
+            return;
+        }
+
+        brcm_vnd_a2dp_cb.failed = TRUE;
+        if (brcm_vnd_a2dp_cb.p_seq != brcm_vnd_a2dp_seq_stop) {
+            break;
+        }
+        brcm_vnd_a2dp_cb.pos++;
+    }
+
+    brcm_vnd_a2dp_finish();
+}
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_run
+**
+** Description     Start a sequence. Must be called with brcm_vnd_a2dp_lock
+**                 held.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void brcm_vnd_a2dp_run(const uint8_t *p_seq, uint8_t req)
+{
+    brcm_vnd_a2dp_cb.p_seq = p_seq;
+    brcm_vnd_a2dp_cb.pos = 0;
+    brcm_vnd_a2dp_cb.req = req;
+    brcm_vnd_a2dp_cb.failed = FALSE;
+    brcm_vnd_a2dp_send();
+}
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_check
+**
+** Description     Check the Command Complete of a step
+**
+** Returns         TRUE if the controller accepted the UIPC message
+**
+*******************************************************************************/
+static uint8_t brcm_vnd_a2dp_check(uint8_t step, HC_BT_HDR *p_evt_buf)
+{
+    const brcm_vnd_a2dp_step_t *p_step = &brcm_vnd_a2dp_steps[step];
+    uint8_t *p = (uint8_t *)(p_evt_buf + 1);
+    uint16_t uipc_class;
+
+    if ((p_evt_buf->len < A2DP_EVT_MIN_LEN) || (p[A2DP_EVT_STATUS] != 0)) {
+        return FALSE;
+    }
+
+    uipc_class = (uint16_t)(p[A2DP_EVT_UIPC_CLASS] | (p[A2DP_EVT_UIPC_CLASS + 1] << 8));
+    if ((uipc_class != p_step->uipc_class) || (p[A2DP_EVT_UIPC_MSG] != p_step->rsp)) {
+        return FALSE;
+    }
+
+    if (p_step->status_off == A2DP_NO_STATUS) {
+        return TRUE;
+    }
+
+    return (p_evt_buf->len > A2DP_EVT_UIPC_MSG + p_step->status_off) &&
+        (p[A2DP_EVT_UIPC_MSG + p_step->status_off] == 0);
+}
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_report
+**
+** Description     Hand a kept result to the stack
+**
+** Returns         None
+**
+*******************************************************************************/
+static void brcm_vnd_a2dp_report(void)
+{
+    brcm_vnd_a2dp_cback_t p_cback = NULL;
+    uint8_t req = 0;
+    uint8_t status = 0;
+    uint16_t lcid = 0;
+
+    pthread_mutex_lock(&brcm_vnd_a2dp_lock);
+    if (brcm_vnd_a2dp_cb.report) {
+        brcm_vnd_a2dp_cb.report = FALSE;
+        p_cback = brcm_vnd_a2dp_cb.p_cback;
+        req = brcm_vnd_a2dp_cb.report_req;
+        status = brcm_vnd_a2dp_cb.report_status;
+        lcid = brcm_vnd_a2dp_cb.offload.local_cid;
+    }
+    pthread_mutex_unlock(&brcm_vnd_a2dp_lock);
+
+    if (p_cback != NULL) {
+        p_cback(req, status, lcid);
+    }
+}
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_cback
+**
+** Description     Command Complete of HCI_VSC_UIPC_OVER_HCI, NULL when the
+**                 scheduler gave the command up
+**
+** Returns         None
+**
+*******************************************************************************/
+static void brcm_vnd_a2dp_cback(void *p_mem)
+{
+    uint8_t step;
+    uint8_t ok;
+
+    pthread_mutex_lock(&brcm_vnd_a2dp_lock);
+    if (brcm_vnd_a2dp_cb.p_seq == NULL) {
+        pthread_mutex_unlock(&brcm_vnd_a2dp_lock);
+        return;
+    }
+
+    step = brcm_vnd_a2dp_cb.p_seq[brcm_vnd_a2dp_cb.pos];
+    ok = (p_mem != NULL) && brcm_vnd_a2dp_check(step, (HC_BT_HDR *)p_mem);
+    if (!ok) {
+        HILOGE("a2dp offload step %u failed", step);
+        brcm_vnd_a2dp_cb.failed = TRUE;
+    }
+
+    if (step == A2DP_STEP_UIPC_OPEN) {
+        brcm_vnd_a2dp_cb.opened = ok;
+    } else if (step == A2DP_STEP_UIPC_CLOSE) {
+        brcm_vnd_a2dp_cb.opened = FALSE;
+    }
+
+#if (SCO_CFG_INCLUDED == TRUE)
+    if ((step == A2DP_STEP_ROUTE_CONFIG) || (step == A2DP_STEP_ROUTE_RESET)) {
+        /* the I2S/PCM port changed behind the SCO path */
+        hw_sco_forget();
+    }
+#endif
+
+    if (ok || (brcm_vnd_a2dp_cb.p_seq == brcm_vnd_a2dp_seq_stop)) {
+        brcm_vnd_a2dp_cb.pos++;
+        brcm_vnd_a2dp_send();
+    } else {
+        brcm_vnd_a2dp_finish();
+    }
+    pthread_mutex_unlock(&brcm_vnd_a2dp_lock);
+
+    brcm_vnd_a2dp_report();
+}
+
+/******************************************************************************
+**  Interface functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_init
+**
+** Description     Reset the offload state
+**
+** Returns         None
+**
+*******************************************************************************/
+void brcm_vnd_a2dp_init(bt_vendor_callbacks_t *p_cb)
+{
+    pthread_mutex_lock(&brcm_vnd_a2dp_lock);
+    brcm_vnd_a2dp_cb.state = BRCM_VND_A2DP_IDLE;
+    brcm_vnd_a2dp_cb.p_seq = NULL;
+    brcm_vnd_a2dp_cb.opened = FALSE;
+    brcm_vnd_a2dp_cb.stop_pending = FALSE;
+    brcm_vnd_a2dp_cb.report = FALSE;
+    pthread_mutex_unlock(&brcm_vnd_a2dp_lock);
+}
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_start
+**
+** Description     Hand a media stream over to the controller, or resume a
+**                 suspended one
+**
+** Returns         0 : Started
+**                 -1 : Another stream is offloaded or a request is running
+**
+*******************************************************************************/
+int brcm_vnd_a2dp_start(const brcm_vnd_a2dp_offload_t *p_offload, brcm_vnd_a2dp_cback_t p_cback)
+{
+    int ret = 0;
+
+    if ((p_offload == NULL) || (bt_vendor_cbacks == NULL)) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&brcm_vnd_a2dp_lock);
+    if (brcm_vnd_a2dp_cb.state == BRCM_VND_A2DP_IDLE) {
+        brcm_vnd_a2dp_cb.offload = *p_offload;
+        brcm_vnd_a2dp_cb.p_cback = p_cback;
+        brcm_vnd_a2dp_cb.start_us = get_monotonic_time_us();
+        brcm_vnd_a2dp_cb.state = BRCM_VND_A2DP_STARTING;
+        HILOGI("a2dp offload start lcid 0x%04x codec 0x%04x", p_offload->local_cid, p_offload->codec_type);
+        brcm_vnd_a2dp_run(brcm_vnd_a2dp_seq_start, A2DP_START_REQ);
+    } else if ((brcm_vnd_a2dp_cb.state == BRCM_VND_A2DP_SUSPENDED) &&
+        (brcm_vnd_a2dp_cb.offload.local_cid == p_offload->local_cid)) {
+        brcm_vnd_a2dp_cb.p_cback = p_cback;
+        brcm_vnd_a2dp_cb.start_us = get_monotonic_time_us();
+        brcm_vnd_a2dp_cb.state = BRCM_VND_A2DP_STARTING;
+        brcm_vnd_a2dp_run(brcm_vnd_a2dp_seq_resume, A2DP_START_REQ);
+    } else {
+        HILOGW("a2dp offload start refused in state %u", brcm_vnd_a2dp_cb.state);
+        ret = -1;
+    }
+    pthread_mutex_unlock(&brcm_vnd_a2dp_lock);
+
+    brcm_vnd_a2dp_report();
+    return ret;
+}
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_suspend
+**
+** Description     Pause the offloaded stream
+**
+** Returns         0 : Started
+**                 -1 : Not streaming
+**
+*******************************************************************************/
+int brcm_vnd_a2dp_suspend(uint16_t lcid)
+{
+    int ret = -1;
+
+    pthread_mutex_lock(&brcm_vnd_a2dp_lock);
+    if ((brcm_vnd_a2dp_cb.state == BRCM_VND_A2DP_STREAMING) && (brcm_vnd_a2dp_cb.offload.local_cid == lcid)) {
+        brcm_vnd_a2dp_cb.state = BRCM_VND_A2DP_SUSPENDING;
+        brcm_vnd_a2dp_run(brcm_vnd_a2dp_seq_suspend, A2DP_SUSPEND_REQ);
+        ret = 0;
+    }
+    pthread_mutex_unlock(&brcm_vnd_a2dp_lock);
+
+    brcm_vnd_a2dp_report();
+    return ret;
+}
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_stop
+**
+** Description     Take the stream back from the controller
+**
+** Returns         0 : Started
+**                 -1 : Nothing offloaded
+**
+*******************************************************************************/
+int brcm_vnd_a2dp_stop(uint16_t lcid)
+{
+    int ret = 0;
+
+    pthread_mutex_lock(&brcm_vnd_a2dp_lock);
+    if ((brcm_vnd_a2dp_cb.state == BRCM_VND_A2DP_IDLE) || (brcm_vnd_a2dp_cb.offload.local_cid != lcid)) {
+        ret = -1;
+    } else if ((brcm_vnd_a2dp_cb.state == BRCM_VND_A2DP_STARTING) ||
+        (brcm_vnd_a2dp_cb.state == BRCM_VND_A2DP_SUSPENDING)) {
+        brcm_vnd_a2dp_cb.stop_pending = TRUE;
+    } else if (brcm_vnd_a2dp_cb.state != BRCM_VND_A2DP_STOPPING) {
+        brcm_vnd_a2dp_cb.state = BRCM_VND_A2DP_STOPPING;
+        brcm_vnd_a2dp_run(brcm_vnd_a2dp_seq_stop, A2DP_STOP_REQ);
+    }
+    pthread_mutex_unlock(&brcm_vnd_a2dp_lock);
+
+    brcm_vnd_a2dp_report();
+    return ret;
+}
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_get_state
+**
+** Description     Current offload state
+**
+** Returns         BRCM_VND_A2DP_xxx
+**
+*******************************************************************************/
+uint8_t brcm_vnd_a2dp_get_state(void)
+{
+    uint8_t state;
+
+    pthread_mutex_lock(&brcm_vnd_a2dp_lock);
+    state = brcm_vnd_a2dp_cb.state;
+    pthread_mutex_unlock(&brcm_vnd_a2dp_lock);
+    return state;
+}
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_get_stats
+**
+** Description     Copy the offload statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void brcm_vnd_a2dp_get_stats(brcm_vnd_a2dp_stats_t *p_stats)
+{
+    pthread_mutex_lock(&brcm_vnd_a2dp_lock);
+    (void)memcpy_s(p_stats, sizeof(brcm_vnd_a2dp_stats_t), &brcm_vnd_a2dp_cb.stats, sizeof(brcm_vnd_a2dp_stats_t));
+    pthread_mutex_unlock(&brcm_vnd_a2dp_lock);
+}
+
+/*******************************************************************************
+**
+** Function        brcm_vnd_a2dp_cleanup
+**
+** Description     Forget the offloaded stream, log and reset the statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void brcm_vnd_a2dp_cleanup(void)
+{
+    brcm_vnd_a2dp_stats_t stats;
+
+    pthread_mutex_lock(&brcm_vnd_a2dp_lock);
+    if (brcm_vnd_a2dp_cb.state != BRCM_VND_A2DP_IDLE) {
+        HILOGW("a2dp offload dropped in state %u", brcm_vnd_a2dp_cb.state);
+    }
+    brcm_vnd_a2dp_cb.state = BRCM_VND_A2DP_IDLE;
+    brcm_vnd_a2dp_cb.p_seq = NULL;
+    brcm_vnd_a2dp_cb.opened = FALSE;
+    brcm_vnd_a2dp_cb.stop_pending = FALSE;
+    brcm_vnd_a2dp_cb.report = FALSE;
+    stats = brcm_vnd_a2dp_cb.stats;
+    (void)memset_s(&brcm_vnd_a2dp_cb.stats, sizeof(brcm_vnd_a2dp_stats_t), 0, sizeof(brcm_vnd_a2dp_stats_t));
+    pthread_mutex_unlock(&brcm_vnd_a2dp_lock);
+
+    if (stats.starts + stats.failures > 0) {
+        HILOGI("a2dp offload: %u starts, %u failures, %u stops, start last %u us max %u us", stats.starts,
+            stats.failures, stats.stops, stats.last_start_us, stats.max_start_us);
+    }
+}
+
+#endif // BRCM_A2DP_OFFLOAD
@@ -0,0 +1,262 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      cfg_trace.c
+ *
+ *  Description:   Contains the controller configuration trace: monotonic
+ *                 timestamps of state transitions, HCI commands and command
+ *                 completes collected into a fixed-size ring, plus per-state
+ *                 totals
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_cfg_trace"
+
+#include <utils/Log.h>
+#include <pthread.h>
+#include <string.h>
+#include "bt_vendor_brcm.h"
+#include "cfg_trace.h"
+#include "hcd_patch.h"
+
+/******************************************************************************
+**  Local type definitions
+******************************************************************************/
+
+/* Totals of one state */
+typedef struct {
+    uint64_t time_us;
+    uint32_t cmds;
+    uint32_t cmpls;
+    uint32_t retries;
+} cfg_trace_state_stat_t;
+
+/* Trace session control block */
+typedef struct {
+    uint8_t active;
+    uint8_t state;          /* current state */
+    uint64_t start_us;      /* session start */
+    uint64_t state_us;      /* current state entered */
+    uint32_t head;          /* next ring slot */
+    uint32_t count;         /* events ever recorded */
+    uint32_t cmds;
+    uint32_t cmpls;
+    uint32_t retries;
+    uint32_t patch_records;
+    uint32_t patch_bytes;
+    cfg_trace_state_stat_t stat[CFG_TRACE_MAX_STATES];
+    cfg_trace_entry_t ring[CFG_TRACE_RING_SIZE];
+} cfg_trace_cb_t;
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+static cfg_trace_cb_t cfg_trace_cbs[VND_MAX_CONTROLLERS];
+static pthread_mutex_t cfg_trace_locks[VND_MAX_CONTROLLERS] = {
+    [0 ... VND_MAX_CONTROLLERS - 1] = PTHREAD_MUTEX_INITIALIZER
+};
+
+/* trace session of the calling thread's controller */
+#define cfg_trace_cb (cfg_trace_cbs[vnd_ctx_id()])
+#define cfg_trace_lock (cfg_trace_locks[vnd_ctx_id()])
+
+/*****************************************************************************
+**   Helper Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        cfg_trace_add
+**
+** Description     Put one event in the ring. Must be called with
+**                 cfg_trace_lock held.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void cfg_trace_add(uint64_t now, uint8_t type, uint16_t opcode, uint8_t status)
+{
+    cfg_trace_entry_t *p_entry = &cfg_trace_cb.ring[cfg_trace_cb.head];
+
+    p_entry->t_us = (uint32_t)(now - cfg_trace_cb.start_us);
+    p_entry->type = type;
+    p_entry->opcode = opcode;
+    p_entry->state = cfg_trace_cb.state;
+    p_entry->status = status;
+
+    cfg_trace_cb.head = (cfg_trace_cb.head + 1) % CFG_TRACE_RING_SIZE;
+    cfg_trace_cb.count++;
+}
+
+/*******************************************************************************
+**
+** Function        cfg_trace_stat
+**
+** Description     Totals of the current state
+**
+** Returns         Pointer to the totals, NULL if the state is out of range
+**
+*******************************************************************************/
+static cfg_trace_state_stat_t *cfg_trace_stat(void)
+{
+    return (cfg_trace_cb.state < CFG_TRACE_MAX_STATES) ? &cfg_trace_cb.stat[cfg_trace_cb.state] : NULL;
+}
+
+/*****************************************************************************
+**   Configuration Trace Interface Functions
+*****************************************************************************/
+
+void cfg_trace_start(void)
+{
+    pthread_mutex_lock(&cfg_trace_lock);
+    if (!cfg_trace_cb.active) {
+        (void)memset_s(&cfg_trace_cb, sizeof(cfg_trace_cb), 0, sizeof(cfg_trace_cb));
+        cfg_trace_cb.active = TRUE;
+        cfg_trace_cb.start_us = get_monotonic_time_us();
+        cfg_trace_cb.state_us = cfg_trace_cb.start_us;
+    }
+    pthread_mutex_unlock(&cfg_trace_lock);
+}
+
+void cfg_trace_state(uint8_t state)
+{
+    cfg_trace_state_stat_t *p_stat;
+    uint64_t now = get_monotonic_time_us();
+
+    pthread_mutex_lock(&cfg_trace_lock);
+    if (cfg_trace_cb.active && (state != cfg_trace_cb.state)) {
+        if ((p_stat = cfg_trace_stat()) != NULL) {
+            p_stat->time_us += now - cfg_trace_cb.state_us;
+        }
+        cfg_trace_cb.state = state;
+        cfg_trace_cb.state_us = now;
+        cfg_trace_add(now, CFG_TRACE_EVT_STATE, 0, 0);
+    }
+    pthread_mutex_unlock(&cfg_trace_lock);
+}
+
+void cfg_trace_cmd(uint16_t opcode)
+{
+    cfg_trace_state_stat_t *p_stat;
+
+    pthread_mutex_lock(&cfg_trace_lock);
+    if (cfg_trace_cb.active) {
+        cfg_trace_cb.cmds++;
+        if ((p_stat = cfg_trace_stat()) != NULL) {
+            p_stat->cmds++;
+        }
+        /* patch records are only counted, they would flush the ring otherwise */
+        if (opcode != HCD_OPCODE_WRITE_RAM) {
+            cfg_trace_add(get_monotonic_time_us(), CFG_TRACE_EVT_CMD, opcode, 0);
+        }
+    }
+    pthread_mutex_unlock(&cfg_trace_lock);
+}
+
+void cfg_trace_cmpl(uint16_t opcode, uint8_t status)
+{
+    cfg_trace_state_stat_t *p_stat;
+
+    pthread_mutex_lock(&cfg_trace_lock);
+    if (cfg_trace_cb.active) {
+        cfg_trace_cb.cmpls++;
+        if ((p_stat = cfg_trace_stat()) != NULL) {
+            p_stat->cmpls++;
+        }
+        if ((opcode != HCD_OPCODE_WRITE_RAM) || (status != 0)) {
+            cfg_trace_add(get_monotonic_time_us(), CFG_TRACE_EVT_CMPL, opcode, status);
+        }
+    }
+    pthread_mutex_unlock(&cfg_trace_lock);
+}
+
+void cfg_trace_retry(uint16_t opcode)
+{
+    cfg_trace_state_stat_t *p_stat;
+
+    pthread_mutex_lock(&cfg_trace_lock);
+    if (cfg_trace_cb.active) {
+        cfg_trace_cb.retries++;
+        if ((p_stat = cfg_trace_stat()) != NULL) {
+            p_stat->retries++;
+        }
+        cfg_trace_add(get_monotonic_time_us(), CFG_TRACE_EVT_RETRY, opcode, 0);
+    }
+    pthread_mutex_unlock(&cfg_trace_lock);
+}
+
+void cfg_trace_patch(uint32_t records, uint32_t bytes)
+{
+    pthread_mutex_lock(&cfg_trace_lock);
+    cfg_trace_cb.patch_records += records;
+    cfg_trace_cb.patch_bytes += bytes;
+    pthread_mutex_unlock(&cfg_trace_lock);
+}
+
+void cfg_trace_dump(const char *const *p_state_names, uint8_t num_states)
+{
+    static const char *const evt_names[] = {"state", "cmd", "cmpl", "retry"};
+    cfg_trace_state_stat_t *p_stat;
+    cfg_trace_entry_t *p_entry;
+    const char *p_name;
+    uint64_t now = get_monotonic_time_us();
+    uint32_t i, n, idx;
+
+    pthread_mutex_lock(&cfg_trace_lock);
+    if (!cfg_trace_cb.active) {
+        pthread_mutex_unlock(&cfg_trace_lock);
+        return;
+    }
+
+    if ((p_stat = cfg_trace_stat()) != NULL) {
+        p_stat->time_us += now - cfg_trace_cb.state_us;
+    }
+
+    HILOGI("cfg trace: total %llu us, %u cmds, %u cmpls, %u retries, patch %u records %u bytes",
+        (unsigned long long)(now - cfg_trace_cb.start_us), cfg_trace_cb.cmds, cfg_trace_cb.cmpls,
+        cfg_trace_cb.retries, cfg_trace_cb.patch_records, cfg_trace_cb.patch_bytes);
+
+    for (i = 0; i < CFG_TRACE_MAX_STATES; i++) {
+        p_stat = &cfg_trace_cb.stat[i];
+        if ((p_stat->time_us == 0) && (p_stat->cmds == 0) && (p_stat->cmpls == 0)) {
+            continue;
+        }
+        p_name = (i < num_states) ? p_state_names[i] : "?";
+        HILOGI("cfg trace: state %-20s %8llu us, %u cmds, %u cmpls, %u retries", p_name,
+            (unsigned long long)p_stat->time_us, p_stat->cmds, p_stat->cmpls, p_stat->retries);
+    }
+
+    /* oldest event first */
+    n = (cfg_trace_cb.count < CFG_TRACE_RING_SIZE) ? cfg_trace_cb.count : CFG_TRACE_RING_SIZE;
+    if (cfg_trace_cb.count > n) {
+        HILOGI("cfg trace: %u older events overwritten", cfg_trace_cb.count - n);
+    }
+    for (i = 0; i < n; i++) {
+        idx = (cfg_trace_cb.head + CFG_TRACE_RING_SIZE - n + i) % CFG_TRACE_RING_SIZE;
+        p_entry = &cfg_trace_cb.ring[idx];
+        p_name = (p_entry->state < num_states) ? p_state_names[p_entry->state] : "?";
+        HILOGI("cfg trace: +%8u us %-5s %-20s opcode 0x%04x status 0x%02x", p_entry->t_us,
+            evt_names[p_entry->type], p_name, p_entry->opcode, p_entry->status);
+    }
+
+    cfg_trace_cb.active = FALSE;
+    pthread_mutex_unlock(&cfg_trace_lock);
+}
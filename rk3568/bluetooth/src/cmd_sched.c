@@ -0,0 +1,551 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      cmd_sched.c
+ *
+ *  Description:   Contains the scheduler of the vendor specific commands
+ *                 sent outside the configuration sequence, LPM, SCO and UART
+ *                 rate changes. They wait in a priority queue while the
+ *                 configuration sequence owns the command channel or the
+ *                 controller has no command credit left, are sent again
+ *                 when their Command Complete does not come, and get their
+ *                 completion routed back by opcode.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_cmd_sched"
+
+#include <utils/Log.h>
+#include <pthread.h>
+#include <string.h>
+#include "bt_vendor_brcm.h"
+#include "bt_hci_bdroid.h"
+#include "cfg_trace.h"
+#include "hci_snoop.h"
+#include "vnd_timer.h"
+#include "vnd_cmd.h"
+#include "cmd_sched.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* Command Complete event layout */
+#define CMD_SCHED_EVT_CREDITS 2
+#define CMD_SCHED_EVT_OPCODE 3
+
+/* Entry states */
+enum {
+    CMD_SCHED_FREE,
+    CMD_SCHED_QUEUED,
+    CMD_SCHED_SENT
+};
+
+/******************************************************************************
+**  Local type definitions
+******************************************************************************/
+
+/* Scheduled command */
+typedef struct {
+    uint8_t state;
+    uint8_t prio;
+    uint8_t tries;
+    uint16_t opcode;
+    uint16_t len;             /* command length, restored before each send */
+    uint32_t seq;             /* queue order within a priority */
+    uint64_t queued_us;
+    uint64_t deadline_us;
+    HC_BT_HDR *p_buf;
+    cmd_sched_cback_t p_cback;
+} cmd_sched_entry_t;
+
+/* Scheduler control block */
+typedef struct {
+    cmd_sched_entry_t entry[CMD_SCHED_QUEUE_SIZE];
+    const cmd_sched_handler_t *p_handlers;
+    uint8_t num_handlers;
+    uint8_t credits;          /* commands the controller accepts now */
+    uint8_t hold;             /* configuration sequence in flight */
+    uint32_t seq;
+    vnd_timer_t *p_timer;
+    cmd_sched_stats_t stats;
+} cmd_sched_cb_t;
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+static cmd_sched_cb_t cmd_sched_cbs[VND_MAX_CONTROLLERS] = {
+    [0 ... VND_MAX_CONTROLLERS - 1] = {
+        .credits = 1,
+    }
+};
+static pthread_mutex_t cmd_sched_locks[VND_MAX_CONTROLLERS] = {
+    [0 ... VND_MAX_CONTROLLERS - 1] = PTHREAD_MUTEX_INITIALIZER
+};
+
+/* scheduler of the calling thread's controller */
+#define cmd_sched_cb (cmd_sched_cbs[vnd_ctx_id()])
+#define cmd_sched_lock (cmd_sched_locks[vnd_ctx_id()])
+
+/******************************************************************************
+**  Static functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        cmd_sched_release
+**
+** Description     Free an entry and keep its callback for the caller to run
+**                 once cmd_sched_lock is dropped. Must be called with
+**                 cmd_sched_lock held.
+**
+** Returns         Callback of the entry
+**
+*******************************************************************************/
+static cmd_sched_cback_t cmd_sched_release(cmd_sched_entry_t *p_entry)
+{
+    cmd_sched_cback_t p_cback = p_entry->p_cback;
+
+    vnd_cmd_put(p_entry->p_buf);
+    p_entry->p_buf = NULL;
+    p_entry->p_cback = NULL;
+    p_entry->state = CMD_SCHED_FREE;
+    return p_cback;
+}
+
+/*******************************************************************************
+**
+** Function        cmd_sched_xmit_entry
+**
+** Description     Send the command of an entry. xmit_cb does not keep the
+**                 buffer, so it stays with the entry for a retry. Must be
+**                 called with cmd_sched_lock held.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void cmd_sched_xmit_entry(cmd_sched_entry_t *p_entry, uint64_t now_us)
+{
+    p_entry->p_buf->event = MSG_STACK_TO_HC_HCI_CMD;
+    p_entry->p_buf->offset = 0;
+    p_entry->p_buf->len = p_entry->len;
+    p_entry->p_buf->layer_specific = 0;
+
+    p_entry->state = CMD_SCHED_SENT;
+    p_entry->tries++;
+    p_entry->deadline_us = now_us + (uint64_t)CMD_SCHED_TIMEOUT_MS * BT_VENDOR_TIME_RAIDX;
+    if (cmd_sched_cb.credits > 0) {
+        cmd_sched_cb.credits--;
+    }
+
+    cfg_trace_cmd(p_entry->opcode);
+#if (HCI_SNOOP_INCLUDED == TRUE)
+    hci_snoop_cmd(p_entry->p_buf);
+#endif
+    if ((bt_vendor_cbacks == NULL) || (bt_vendor_cbacks->xmit_cb(p_entry->opcode, p_entry->p_buf) == 0)) {
+        /* the timeout sends it again */
+        HILOGW("cmd_sched: 0x%04x not taken by the stack", p_entry->opcode);
+    }
+}
+
+/*******************************************************************************
+**
+** Function        cmd_sched_kick
+**
+** Description     Send queued commands by priority as long as the controller
+**                 has credits, and arm the timer for the earliest pending
+**                 completion. Must be called with cmd_sched_lock held.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void cmd_sched_kick(void)
+{
+    cmd_sched_entry_t *p_next;
+    uint64_t now_us = get_monotonic_time_us();
+    uint64_t deadline_us = 0;
+    uint32_t i;
+
+    while (!cmd_sched_cb.hold) {
+        p_next = NULL;
+        for (i = 0; i < CMD_SCHED_QUEUE_SIZE; i++) {
+            cmd_sched_entry_t *p_entry = &cmd_sched_cb.entry[i];
+            if ((p_entry->state == CMD_SCHED_QUEUED) && ((p_next == NULL) || (p_entry->prio < p_next->prio) ||
+                ((p_entry->prio == p_next->prio) && ((int32_t)(p_entry->seq - p_next->seq) < 0)))) {
+                p_next = p_entry;
+            }
+        }
+
+        if (p_next == NULL) {
+            break;
+        }
+        if (cmd_sched_cb.credits == 0) {
+            cmd_sched_cb.stats.credit_waits++;
+            break;
+        }
+
+        cmd_sched_cb.stats.sent++;
+        cmd_sched_xmit_entry(p_next, now_us);
+    }
+
+    for (i = 0; i < CMD_SCHED_QUEUE_SIZE; i++) {
+        if ((cmd_sched_cb.entry[i].state == CMD_SCHED_SENT) &&
+            ((deadline_us == 0) || (cmd_sched_cb.entry[i].deadline_us < deadline_us))) {
+            deadline_us = cmd_sched_cb.entry[i].deadline_us;
+        }
+    }
+
+    if (deadline_us == 0) {
+        vnd_timer_stop(cmd_sched_cb.p_timer);
+    } else {
+        (void)vnd_timer_start(cmd_sched_cb.p_timer,
+            (deadline_us > now_us) ? (uint32_t)((deadline_us - now_us) / BT_VENDOR_TIME_RAIDX) + 1 : 1, FALSE);
+    }
+}
+
+/*******************************************************************************
+**
+** Function        cmd_sched_give_up_all
+**
+** Description     Free every entry. Must be called with cmd_sched_lock held.
+**
+** Returns         Number of callbacks stored in p_cbacks
+**
+*******************************************************************************/
+static uint32_t cmd_sched_give_up_all(cmd_sched_cback_t *p_cbacks)
+{
+    uint32_t num = 0;
+    uint32_t i;
+
+    for (i = 0; i < CMD_SCHED_QUEUE_SIZE; i++) {
+        if (cmd_sched_cb.entry[i].state != CMD_SCHED_FREE) {
+            cmd_sched_cb.stats.failures++;
+            p_cbacks[num] = cmd_sched_release(&cmd_sched_cb.entry[i]);
+            if (p_cbacks[num] != NULL) {
+                num++;
+            }
+        }
+    }
+
+    return num;
+}
+
+/*******************************************************************************
+**
+** Function        cmd_sched_timeout
+**
+** Description     Send the commands whose Command Complete is overdue again,
+**                 or give them up after CMD_SCHED_MAX_RETRY retries
+**
+** Returns         None
+**
+*******************************************************************************/
+static void cmd_sched_timeout(void *p_data)
+{
+    cmd_sched_cback_t cbacks[CMD_SCHED_QUEUE_SIZE];
+    uint64_t now_us = get_monotonic_time_us();
+    uint32_t num = 0;
+    uint32_t i;
+
+    pthread_mutex_lock(&cmd_sched_lock);
+    for (i = 0; i < CMD_SCHED_QUEUE_SIZE; i++) {
+        cmd_sched_entry_t *p_entry = &cmd_sched_cb.entry[i];
+        if ((p_entry->state != CMD_SCHED_SENT) || (p_entry->deadline_us > now_us)) {
+            continue;
+        }
+
+        /* a command the controller lost gives its credit back */
+        if (cmd_sched_cb.credits == 0) {
+            cmd_sched_cb.credits = 1;
+        }
+
+        if (p_entry->tries <= CMD_SCHED_MAX_RETRY) {
+            HILOGW("cmd_sched: 0x%04x timed out, try %u", p_entry->opcode, p_entry->tries + 1);
+            cmd_sched_cb.stats.retries++;
+            cmd_sched_xmit_entry(p_entry, now_us);
+        } else {
+            HILOGE("cmd_sched: 0x%04x given up after %u tries", p_entry->opcode, p_entry->tries);
+            cmd_sched_cb.stats.failures++;
+            cbacks[num] = cmd_sched_release(p_entry);
+            if (cbacks[num] != NULL) {
+                num++;
+            }
+        }
+    }
+    cmd_sched_kick();
+    pthread_mutex_unlock(&cmd_sched_lock);
+
+    for (i = 0; i < num; i++) {
+        cbacks[i](NULL);
+    }
+}
+
+/******************************************************************************
+**  Interface functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function        cmd_sched_init
+**
+** Description     Reset the scheduler for a new configuration sequence
+**
+** Returns         None
+**
+*******************************************************************************/
+void cmd_sched_init(const cmd_sched_handler_t *p_handlers, uint8_t num_handlers)
+{
+    cmd_sched_cback_t cbacks[CMD_SCHED_QUEUE_SIZE];
+    uint32_t num;
+    uint32_t i;
+
+    pthread_mutex_lock(&cmd_sched_lock);
+    num = cmd_sched_give_up_all(cbacks);
+    cmd_sched_cb.p_handlers = p_handlers;
+    cmd_sched_cb.num_handlers = num_handlers;
+    cmd_sched_cb.credits = 1;
+    cmd_sched_cb.hold = FALSE;
+    if (cmd_sched_cb.p_timer == NULL) {
+        cmd_sched_cb.p_timer = vnd_timer_alloc(cmd_sched_timeout, NULL);
+    }
+    vnd_timer_stop(cmd_sched_cb.p_timer);
+    pthread_mutex_unlock(&cmd_sched_lock);
+
+    for (i = 0; i < num; i++) {
+        cbacks[i](NULL);
+    }
+}
+
+/*******************************************************************************
+**
+** Function        cmd_sched_hold
+**
+** Description     Hold queued commands back while the configuration sequence
+**                 owns the command channel
+**
+** Returns         None
+**
+*******************************************************************************/
+void cmd_sched_hold(uint8_t hold)
+{
+    pthread_mutex_lock(&cmd_sched_lock);
+    if (cmd_sched_cb.hold != hold) {
+        cmd_sched_cb.hold = hold;
+        if (!hold) {
+            cmd_sched_kick();
+        }
+    }
+    pthread_mutex_unlock(&cmd_sched_lock);
+}
+
+/*******************************************************************************
+**
+** Function        cmd_sched_send
+**
+** Description     Queue a command, replacing a queued one with the same
+**                 opcode that is not sent yet
+**
+** Returns         TRUE if the command was queued
+**
+*******************************************************************************/
+uint8_t cmd_sched_send(uint16_t opcode, const uint8_t *p_param, uint8_t param_len, uint8_t prio,
+    cmd_sched_cback_t p_cback)
+{
+    HC_BT_HDR *p_buf = vnd_cmd_build(opcode, p_param, param_len);
+    HC_BT_HDR *p_stale = NULL;
+    cmd_sched_entry_t *p_entry = NULL;
+    uint32_t i;
+
+    if (p_buf == NULL) {
+        HILOGE("cmd_sched: no command buffer for opcode 0x%04x", opcode);
+        return FALSE;
+    }
+
+    if (prio >= CMD_SCHED_PRIO_NUM) {
+        prio = CMD_SCHED_PRIO_BULK;
+    }
+
+    pthread_mutex_lock(&cmd_sched_lock);
+    for (i = 0; i < CMD_SCHED_QUEUE_SIZE; i++) {
+        if ((cmd_sched_cb.entry[i].state == CMD_SCHED_QUEUED) && (cmd_sched_cb.entry[i].opcode == opcode)) {
+            p_entry = &cmd_sched_cb.entry[i];
+            p_stale = p_entry->p_buf;
+            cmd_sched_cb.stats.coalesced++;
+            break;
+        }
+    }
+
+    for (i = 0; (p_entry == NULL) && (i < CMD_SCHED_QUEUE_SIZE); i++) {
+        if (cmd_sched_cb.entry[i].state == CMD_SCHED_FREE) {
+            p_entry = &cmd_sched_cb.entry[i];
+            p_entry->state = CMD_SCHED_QUEUED;
+            p_entry->seq = cmd_sched_cb.seq++;
+            p_entry->queued_us = get_monotonic_time_us();
+            p_entry->tries = 0;
+        }
+    }
+
+    if (p_entry == NULL) {
+        pthread_mutex_unlock(&cmd_sched_lock);
+        HILOGE("cmd_sched: queue full, opcode 0x%04x dropped", opcode);
+        vnd_cmd_put(p_buf);
+        return FALSE;
+    }
+
+    p_entry->opcode = opcode;
+    p_entry->prio = (p_stale != NULL) && (p_entry->prio < prio) ? p_entry->prio : prio;
+    p_entry->len = p_buf->len;
+    p_entry->p_buf = p_buf;
+    p_entry->p_cback = p_cback;
+    cmd_sched_kick();
+    pthread_mutex_unlock(&cmd_sched_lock);
+
+    vnd_cmd_put(p_stale);
+    return TRUE;
+}
+
+/*******************************************************************************
+**
+** Function        cmd_sched_xmit
+**
+** Description     Account a command sent outside the scheduler
+**
+** Returns         None
+**
+*******************************************************************************/
+void cmd_sched_xmit(void)
+{
+    pthread_mutex_lock(&cmd_sched_lock);
+    if (cmd_sched_cb.credits > 0) {
+        cmd_sched_cb.credits--;
+    }
+    pthread_mutex_unlock(&cmd_sched_lock);
+}
+
+/*******************************************************************************
+**
+** Function        cmd_sched_complete
+**
+** Description     Route a Command Complete event and send what its credits
+**                 allow
+**
+** Returns         TRUE if a scheduled command or a handler took the event
+**
+*******************************************************************************/
+uint8_t cmd_sched_complete(HC_BT_HDR *p_evt)
+{
+    uint8_t *p = (uint8_t *)(p_evt + 1);
+    cmd_sched_entry_t *p_done = NULL;
+    cmd_sched_cback_t p_cback = NULL;
+    uint64_t wait_us;
+    uint16_t opcode;
+    uint32_t i;
+
+    opcode = (uint16_t)(p[CMD_SCHED_EVT_OPCODE] | (p[CMD_SCHED_EVT_OPCODE + 1] << 8));
+
+    pthread_mutex_lock(&cmd_sched_lock);
+    cmd_sched_cb.credits = p[CMD_SCHED_EVT_CREDITS];
+
+    for (i = 0; i < CMD_SCHED_QUEUE_SIZE; i++) {
+        cmd_sched_entry_t *p_entry = &cmd_sched_cb.entry[i];
+        if ((p_entry->state == CMD_SCHED_SENT) && (p_entry->opcode == opcode) &&
+            ((p_done == NULL) || ((int32_t)(p_entry->seq - p_done->seq) < 0))) {
+            p_done = p_entry;
+        }
+    }
+
+    if (p_done != NULL) {
+        wait_us = get_monotonic_time_us() - p_done->queued_us;
+        if (wait_us > cmd_sched_cb.stats.max_wait_us[p_done->prio]) {
+            cmd_sched_cb.stats.max_wait_us[p_done->prio] = (uint32_t)wait_us;
+        }
+        p_cback = cmd_sched_release(p_done);
+    } else {
+        for (i = 0; i < cmd_sched_cb.num_handlers; i++) {
+            if (cmd_sched_cb.p_handlers[i].opcode == opcode) {
+                p_cback = cmd_sched_cb.p_handlers[i].p_cback;
+                break;
+            }
+        }
+    }
+
+    cmd_sched_kick();
+    pthread_mutex_unlock(&cmd_sched_lock);
+
+    if (p_cback != NULL) {
+        p_cback(p_evt);
+        return TRUE;
+    }
+    return (p_done != NULL);
+}
+
+/*******************************************************************************
+**
+** Function        cmd_sched_get_stats
+**
+** Description     Copy the scheduler statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void cmd_sched_get_stats(cmd_sched_stats_t *p_stats)
+{
+    pthread_mutex_lock(&cmd_sched_lock);
+    (void)memcpy_s(p_stats, sizeof(cmd_sched_stats_t), &cmd_sched_cb.stats, sizeof(cmd_sched_stats_t));
+    pthread_mutex_unlock(&cmd_sched_lock);
+}
+
+/*******************************************************************************
+**
+** Function        cmd_sched_cleanup
+**
+** Description     Give pending commands up, release the timer and log the
+**                 statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void cmd_sched_cleanup(void)
+{
+    cmd_sched_cback_t cbacks[CMD_SCHED_QUEUE_SIZE];
+    cmd_sched_stats_t stats;
+    uint32_t num;
+    uint32_t i;
+
+    pthread_mutex_lock(&cmd_sched_lock);
+    num = cmd_sched_give_up_all(cbacks);
+    vnd_timer_free(cmd_sched_cb.p_timer);
+    cmd_sched_cb.p_timer = NULL;
+    cmd_sched_cb.p_handlers = NULL;
+    cmd_sched_cb.num_handlers = 0;
+    (void)memcpy_s(&stats, sizeof(stats), &cmd_sched_cb.stats, sizeof(stats));
+    pthread_mutex_unlock(&cmd_sched_lock);
+
+    for (i = 0; i < num; i++) {
+        cbacks[i](NULL);
+    }
+
+    HILOGI("cmd_sched: sent %u, coalesced %u, retries %u, failures %u, credit waits %u",
+        stats.sent, stats.coalesced, stats.retries, stats.failures, stats.credit_waits);
+    HILOGI("cmd_sched: max wait audio %u us, ctrl %u us, bulk %u us",
+        stats.max_wait_us[CMD_SCHED_PRIO_AUDIO], stats.max_wait_us[CMD_SCHED_PRIO_CTRL],
+        stats.max_wait_us[CMD_SCHED_PRIO_BULK]);
+}
@@ -29,15 +29,39 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
 #include <utils/Log.h>
 #include "bt_vendor_brcm.h"
+#include "vnd_tune.h"
 
 /******************************************************************************
 **  Externs
 ******************************************************************************/
+void hw_tune_init(void);
+void userial_tune_init(void);
 int userial_set_port(char *p_conf_name, char *p_conf_value, int param);
+int userial_set_profile(char *p_conf_name, char *p_conf_value, int param);
+#if (USERIAL_RX_ENGINE == TRUE)
+int userial_set_rx_latency_probe(char *p_conf_name, char *p_conf_value, int param);
+#endif
 int hw_set_patch_file_path(char *p_conf_name, char *p_conf_value, int param);
 int hw_set_patch_file_name(char *p_conf_name, char *p_conf_value, int param);
+int hw_set_patch_download_window(char *p_conf_name, char *p_conf_value, int param);
+#if (LPM_ADAPTIVE_IDLE == TRUE)
+int hw_set_lpm_idle_bound(char *p_conf_name, char *p_conf_value, int param);
+#endif
+#if (HOST_WAKE_MONITOR == TRUE)
+int host_wake_set_gpio(char *p_conf_name, char *p_conf_value, int param);
+#endif
+#if (BT_WAKE_VIA_PROC == TRUE)
+int upio_set_btwrite_hold_window(char *p_conf_name, char *p_conf_value, int param);
+#endif
+#if (HCI_SNOOP_INCLUDED == TRUE)
+int hci_snoop_set_file(char *p_conf_name, char *p_conf_value, int param);
+int hci_snoop_set_signal(char *p_conf_name, char *p_conf_value, int param);
+int hci_snoop_set_dump(char *p_conf_name, char *p_conf_value, int param);
+#endif
 #if (VENDOR_LIB_RUNTIME_TUNING_ENABLED == TRUE)
 int hw_set_patch_settlement_delay(char *p_conf_name, char *p_conf_value, int param);
 #endif
@@ -50,6 +74,7 @@ int hw_set_patch_settlement_delay(char *p_conf_name, char *p_conf_value, int par
 #define CONF_DELIMITERS " =\n\r\t"
 #define CONF_VALUES_DELIMITERS "=\n\r\t"
 #define CONF_MAX_LINE_LEN 255
+#define CONF_CTX_SEPARATOR '.' /* Name.<n>: entry of controller n only */
 
 typedef int(conf_action_t)(char *p_conf_name, char *p_conf_value, int param);
 
@@ -59,6 +84,16 @@ typedef struct {
     int param;
 } conf_entry_t;
 
+#define VND_STATE_MAX_ENTRIES 16
+#define VND_STATE_NAME_LEN 64
+#define VND_STATE_VALUE_LEN 96
+
+/* One learned value kept across boots */
+typedef struct {
+    char name[VND_STATE_NAME_LEN];
+    char value[VND_STATE_VALUE_LEN];
+} vnd_state_entry_t;
+
 /******************************************************************************
 **  Static variables
 ******************************************************************************/
@@ -68,69 +103,399 @@ typedef struct {
  */
 static const conf_entry_t conf_table[] = {
     {"UartPort", userial_set_port, 0},
+    {"UartProfile", userial_set_profile, 0},
+#if (USERIAL_RX_ENGINE == TRUE)
+    {"UartRxLatencyProbe", userial_set_rx_latency_probe, 0},
+#endif
     {"FwPatchFilePath", hw_set_patch_file_path, 0},
     {"FwPatchFileName", hw_set_patch_file_name, 0},
+    {"FwPatchDownloadWindow", hw_set_patch_download_window, 0},
+#if (LPM_ADAPTIVE_IDLE == TRUE)
+    {"LpmIdleTimeoutMin", hw_set_lpm_idle_bound, 0},
+    {"LpmIdleTimeoutMax", hw_set_lpm_idle_bound, 1},
+#endif
+#if (HOST_WAKE_MONITOR == TRUE)
+    {"HostWakeGpio", host_wake_set_gpio, 0},
+#endif
+#if (BT_WAKE_VIA_PROC == TRUE)
+    {"LpmBtWriteHoldWindow", upio_set_btwrite_hold_window, 0},
+#endif
+#if (HCI_SNOOP_INCLUDED == TRUE)
+    {"HciSnoopFile", hci_snoop_set_file, 0},
+    {"HciSnoopSignal", hci_snoop_set_signal, 0},
+    {"HciSnoopDump", hci_snoop_set_dump, 0},
+#endif
 #if (VENDOR_LIB_RUNTIME_TUNING_ENABLED == TRUE)
     {"FwPatchSettlementDelay", hw_set_patch_settlement_delay, 0},
 #endif
     {(const char *)NULL, NULL, 0}
 };
 
-/*****************************************************************************
-**   CONF INTERFACE FUNCTIONS
-*****************************************************************************/
+/*
+ * Values measured at run time and persisted in VENDOR_LIB_STATE_FILE
+ */
+static vnd_state_entry_t vnd_state[VND_STATE_MAX_ENTRIES];
+static int vnd_state_count = -1; /* -1: state file not read yet */
+static pthread_mutex_t vnd_state_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/******************************************************************************
+**  Static functions
+******************************************************************************/
 
 /*******************************************************************************
 **
-** Function        vnd_load_conf
+** Function        vnd_state_load
 **
-** Description     Read conf entry from p_path file one by one and call
-**                 the corresponding config function
+** Description     Read the persisted state file once. Must be called with
+**                 vnd_state_lock held.
 **
 ** Returns         None
 **
 *******************************************************************************/
-void vnd_load_conf(const char *p_path)
+static void vnd_state_load(void)
 {
     FILE *p_file;
     char *p_name;
     char *p_value;
-    conf_entry_t *p_entry;
+    char *p_save = NULL;
     char line[CONF_MAX_LINE_LEN + 1]; /* add 1 for \0 char */
 
-    HILOGI("Attempt to load conf from %s", p_path);
-    if ((p_file = fopen(p_path, "r")) == NULL) {
-        HILOGI("vnd_load_conf file >%s< not found", p_path);
+    if (vnd_state_count >= 0) {
+        return;
+    }
+
+    vnd_state_count = 0;
+    if ((p_file = fopen(VENDOR_LIB_STATE_FILE, "r")) == NULL) {
         return;
     }
 
-    /* read line by line */
-    while (fgets(line, CONF_MAX_LINE_LEN + 1, p_file) != NULL) {
+    while ((vnd_state_count < VND_STATE_MAX_ENTRIES) && (fgets(line, CONF_MAX_LINE_LEN + 1, p_file) != NULL)) {
         if (line[0] == CONF_COMMENT) {
             continue;
         }
 
-        p_name = strtok(line, CONF_DELIMITERS);
-        if (p_name == NULL) {
+        p_name = strtok_r(line, CONF_DELIMITERS, &p_save);
+        p_value = (p_name != NULL) ? strtok_r(NULL, CONF_DELIMITERS, &p_save) : NULL;
+        if (p_value == NULL) {
             continue;
         }
 
-        p_value = strtok(NULL, CONF_DELIMITERS);
-        if (p_value == NULL) {
-            HILOGW("vnd_load_conf: missing value for name: %s", p_name);
+        if ((snprintf_s(vnd_state[vnd_state_count].name, VND_STATE_NAME_LEN, VND_STATE_NAME_LEN - 1, "%s",
+            p_name) < 0) ||
+            (snprintf_s(vnd_state[vnd_state_count].value, VND_STATE_VALUE_LEN, VND_STATE_VALUE_LEN - 1, "%s",
+            p_value) < 0)) {
             continue;
         }
+        vnd_state_count++;
+    }
+
+    (void)fclose(p_file);
+}
 
-        p_entry = (conf_entry_t *)conf_table;
-        while (p_entry->conf_entry != NULL) {
-            if (strcmp(p_entry->conf_entry, (const char *)p_name) == 0) {
-                p_entry->p_action(p_name, p_value, p_entry->param);
-                break;
+/*******************************************************************************
+**
+** Function        vnd_state_save
+**
+** Description     Rewrite the state file. The new content is written to a
+**                 temporary file first so a power cut never leaves a torn
+**                 state file behind. Must be called with vnd_state_lock held.
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+static int vnd_state_save(void)
+{
+    FILE *p_file;
+    int i;
+
+    if ((p_file = fopen(VENDOR_LIB_STATE_FILE ".tmp", "w")) == NULL) {
+        HILOGW("vnd_state_save: cannot open %s", VENDOR_LIB_STATE_FILE ".tmp");
+        return -1;
+    }
+
+    fprintf(p_file, "%c Learned by the vendor library, do not edit\n", CONF_COMMENT);
+    for (i = 0; i < vnd_state_count; i++) {
+        fprintf(p_file, "%s = %s\n", vnd_state[i].name, vnd_state[i].value);
+    }
+
+    if (fclose(p_file) != 0) {
+        return -1;
+    }
+
+    if (rename(VENDOR_LIB_STATE_FILE ".tmp", VENDOR_LIB_STATE_FILE) != 0) {
+        HILOGW("vnd_state_save: cannot update %s", VENDOR_LIB_STATE_FILE);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_conf_index
+**
+** Description     Index the conf entries and the typed tunables once
+**
+** Returns         None
+**
+*******************************************************************************/
+static void vnd_conf_index(void)
+{
+    const conf_entry_t *p_entry;
+
+    for (p_entry = conf_table; p_entry->conf_entry != NULL; p_entry++) {
+        vnd_tune_register_action(p_entry->conf_entry, p_entry->p_action, p_entry->param);
+    }
+    hw_tune_init();
+    userial_tune_init();
+}
+
+/*******************************************************************************
+**
+** Function        vnd_conf_ctx_entry
+**
+** Description     Check for a controller suffix (Name.<n>) and strip it
+**
+** Returns         Controller index, -1 for an entry of every controller
+**
+*******************************************************************************/
+static int vnd_conf_ctx_entry(char *p_name)
+{
+    char *p_sep = strrchr(p_name, CONF_CTX_SEPARATOR);
+    char *p_end = NULL;
+    long id;
+
+    if ((p_sep == NULL) || (p_sep[1] == 0)) {
+        return -1;
+    }
+
+    id = strtol(p_sep + 1, &p_end, 10);
+    if ((*p_end != 0) || (id < 0) || (id >= VND_MAX_CONTROLLERS)) {
+        return -1;
+    }
+
+    *p_sep = 0;
+    return (int)id;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_conf_parse
+**
+** Description     Read conf entry from p_path file one by one and hand each
+**                 of them to the tunables. Plain entries are read first and
+**                 the entries of the calling thread's controller (Name.<n>)
+**                 then override them.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void vnd_conf_parse(const char *p_path, uint8_t reload)
+{
+    FILE *p_file;
+    char *p_name;
+    char *p_value;
+    char *p_save = NULL;
+    char line[CONF_MAX_LINE_LEN + 1]; /* add 1 for \0 char */
+    int pass;
+    int id;
+
+    HILOGI("Attempt to load conf from %s", p_path);
+    if ((p_file = fopen(p_path, "r")) == NULL) {
+        HILOGI("vnd_load_conf file >%s< not found", p_path);
+        return;
+    }
+
+    /* 2 passes: plain entries, then the controller's own ones */
+    for (pass = 0; pass < 2; pass++) {
+        rewind(p_file);
+
+        /* read line by line */
+        while (fgets(line, CONF_MAX_LINE_LEN + 1, p_file) != NULL) {
+            if (line[0] == CONF_COMMENT) {
+                continue;
+            }
+
+            p_name = strtok_r(line, CONF_DELIMITERS, &p_save);
+            if (p_name == NULL) {
+                continue;
+            }
+
+            id = vnd_conf_ctx_entry(p_name);
+            if ((pass == 0) ? (id >= 0) : (id != (int)vnd_ctx_id())) {
+                continue;
             }
 
-            p_entry++;
+            p_value = strtok_r(NULL, CONF_DELIMITERS, &p_save);
+            if (p_value == NULL) {
+                HILOGW("vnd_load_conf: missing value for name: %s", p_name);
+                continue;
+            }
+
+            if (vnd_tune_set(p_name, p_value, reload) != 0) {
+                HILOGW("vnd_load_conf: %s = %s not applied", p_name, p_value);
+            }
         }
     }
 
     (void)fclose(p_file);
 }
+
+/*****************************************************************************
+**   CONF INTERFACE FUNCTIONS
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        vnd_load_conf
+**
+** Description     Read conf entry from p_path file one by one and call
+**                 the corresponding config function
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_load_conf(const char *p_path)
+{
+    static pthread_once_t indexed = PTHREAD_ONCE_INIT;
+
+    (void)pthread_once(&indexed, vnd_conf_index);
+    vnd_conf_parse(p_path, FALSE);
+}
+
+/*******************************************************************************
+**
+** Function        vnd_reload_conf
+**
+** Description     Read p_path again while the stack is up, on behalf of
+**                 each controller in turn. Typed values are staged for their
+**                 next safe point, the other entries keep the value read by
+**                 vnd_load_conf. The calling thread's binding is restored.
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_reload_conf(const char *p_path)
+{
+    uint8_t prev = vnd_ctx_binding();
+    uint8_t id;
+
+    for (id = 0; id < VND_MAX_CONTROLLERS; id++) {
+        vnd_ctx_bind(id);
+        vnd_conf_parse(p_path, TRUE);
+    }
+    vnd_ctx_bind(prev);
+}
+
+/*******************************************************************************
+**
+** Function        vnd_state_get
+**
+** Description     Look up a value persisted by a previous run
+**
+** Returns         0 : Success
+**                 Otherwise : Not found
+**
+*******************************************************************************/
+int vnd_state_get(const char *p_name, char *p_value, size_t len)
+{
+    int i;
+    int ret = -1;
+
+    pthread_mutex_lock(&vnd_state_lock);
+    vnd_state_load();
+    for (i = 0; i < vnd_state_count; i++) {
+        if (strcmp(vnd_state[i].name, p_name) == 0) {
+            ret = (snprintf_s(p_value, len, len - 1, "%s", vnd_state[i].value) < 0) ? -1 : 0;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&vnd_state_lock);
+
+    return ret;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_state_set
+**
+** Description     Persist a value for the next runs. The state file is only
+**                 rewritten when the value actually changed.
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int vnd_state_set(const char *p_name, const char *p_value)
+{
+    int i;
+    int ret = 0;
+
+    pthread_mutex_lock(&vnd_state_lock);
+    vnd_state_load();
+    for (i = 0; i < vnd_state_count; i++) {
+        if (strcmp(vnd_state[i].name, p_name) == 0) {
+            break;
+        }
+    }
+
+    if (i == VND_STATE_MAX_ENTRIES) {
+        HILOGW("vnd_state_set: no room for %s", p_name);
+        ret = -1;
+    } else if ((i < vnd_state_count) && (strcmp(vnd_state[i].value, p_value) == 0)) {
+        ret = 0;
+    } else if ((snprintf_s(vnd_state[i].name, VND_STATE_NAME_LEN, VND_STATE_NAME_LEN - 1, "%s", p_name) < 0) ||
+        (snprintf_s(vnd_state[i].value, VND_STATE_VALUE_LEN, VND_STATE_VALUE_LEN - 1, "%s", p_value) < 0)) {
+        ret = -1;
+    } else {
+        if (i == vnd_state_count) {
+            vnd_state_count++;
+        }
+        ret = vnd_state_save();
+    }
+    pthread_mutex_unlock(&vnd_state_lock);
+
+    return ret;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_state_get_int
+**
+** Description     Look up a persisted integer value
+**
+** Returns         Persisted value, def_value if not found
+**
+*******************************************************************************/
+int vnd_state_get_int(const char *p_name, int def_value)
+{
+    char value[VND_STATE_VALUE_LEN];
+
+    if (vnd_state_get(p_name, value, sizeof(value)) != 0) {
+        return def_value;
+    }
+
+    return atoi(value);
+}
+
+/*******************************************************************************
+**
+** Function        vnd_state_set_int
+**
+** Description     Persist an integer value
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int vnd_state_set_int(const char *p_name, int value)
+{
+    char str[VND_STATE_VALUE_LEN];
+
+    if (snprintf_s(str, sizeof(str), sizeof(str) - 1, "%d", value) < 0) {
+        return -1;
+    }
+
+    return vnd_state_set(p_name, str);
+}
@@ -42,12 +42,25 @@
 #include <string.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <pthread.h>
 #include "bt_hci_bdroid.h"
 #include "bt_vendor_brcm.h"
 #include "esco_parameters.h"
 #include "userial.h"
 #include "userial_vendor.h"
 #include "upio.h"
+#include "hcd_patch.h"
+#include "cfg_trace.h"
+#include "hci_snoop.h"
+#include "vnd_timer.h"
+#include "lpm_adapt.h"
+#include "vnd_cmd.h"
+#include "cmd_sched.h"
+#include "vnd_tune.h"
+#include "vnd_board.h"
+#if (HOST_WAKE_MONITOR == TRUE)
+#include "host_wake.h"
+#endif
 
 /******************************************************************************
 **  Constants & Macros
@@ -74,8 +87,6 @@
 #define FW_PATCHFILE_PATH_MAXLEN 248 /* Local_Name length of return of \
                                         HCI_Read_Local_Name */
 
-#define HCI_CMD_MAX_LEN 258
-
 #define HCI_RESET 0x0C03
 #define HCI_VSC_WRITE_UART_CLOCK_SETTING 0xFC45
 #define HCI_VSC_UPDATE_BAUDRATE 0xFC18
@@ -90,17 +101,21 @@
 #define HCI_VSC_ENABLE_WBS 0xFC7E
 #define HCI_VSC_LAUNCH_RAM 0xFC4E
 #define HCI_READ_LOCAL_BDADDR 0x1009
+#define HCI_READ_LOCAL_VERSION_INFO 0x1001
 
+#define HCI_EVT_CMD_CMPL_NUM_PACKETS 2
 #define HCI_EVT_CMD_CMPL_STATUS_RET_BYTE 5
 #define HCI_EVT_CMD_CMPL_LOCAL_NAME_STRING 6
 #define HCI_EVT_CMD_CMPL_LOCAL_BDADDR_ARRAY 6
+#define HCI_EVT_CMD_CMPL_HCI_REVISION 7
+#define HCI_EVT_CMD_CMPL_LMP_SUBVERSION 12
 #define HCI_EVT_CMD_CMPL_OPCODE 3
 #define LPM_CMD_PARAM_SIZE 12
 #define UPDATE_BAUDRATE_CMD_PARAM_SIZE 6
-#define HCI_CMD_PREAMBLE_SIZE 3
-#define HCD_REC_PAYLOAD_LEN_BYTE 2
 #define LOCAL_NAME_BUFFER_LEN 32
+#define HCI_LOCAL_NAME_LEN 248
 #define LOCAL_BDADDR_PATH_BUFFER_LEN 256
+#define HW_STATE_KEY_LEN 32 /* persisted per controller value names */
 
 #define STREAM_TO_UINT16(u16, p)                                \
 do                                                              \
@@ -151,38 +166,167 @@ enum {
     HW_CFG_DL_FW_PATCH,
     HW_CFG_SET_UART_BAUD_2,
     HW_CFG_SET_BD_ADDR,
-    HW_CFG_READ_BD_ADDR
+    HW_CFG_READ_BD_ADDR,
+    HW_CFG_READ_LOCAL_VERSION,
+    HW_CFG_READ_PATCHED_VERSION,
+    HW_CFG_STATE_NUM
 };
 
 /* h/w config control block */
 typedef struct {
     uint8_t state;        /* Hardware configuration state */
-    int fw_fd;            /* FW patch file fd */
+    hcd_patch_t fw_image; /* FW patch image and record index */
     uint8_t f_set_baud_2; /* Baud rate switch state */
     char local_chip_name[LOCAL_NAME_BUFFER_LEN];
+    char patch_file[FW_PATCHFILE_PATH_MAXLEN]; /* path of the loaded patch image */
+    uint64_t fw_digest;   /* digest of the patch image being downloaded */
+    uint32_t rom_version; /* HCI revision and LMP subversion before patching */
 } bt_hw_cfg_cb_t;
 
-/* low power mode parameters */
+/* Controller readiness probe phase */
+enum {
+    HW_PROBE_IDLE = 0,
+    HW_PROBE_START,   /* first HCI_RESET, alternating the host baud rate */
+    HW_PROBE_MINIDRV, /* waiting for download mode, then send first record */
+    HW_PROBE_RESET,   /* polling the relaunched firmware with HCI_RESET */
+    HW_PROBE_BAUD     /* waiting for the first answer at a new baud rate */
+};
+
+/* Background patch prefetch control block */
+typedef struct {
+    pthread_t thread;
+    uint8_t running;   /* thread started and not joined yet */
+    uint64_t start_us; /* time the prefetch started */
+    uint64_t done_us;  /* time the patch was resident */
+} hw_prefetch_cb_t;
+
+/* UART rate control block */
+typedef struct {
+    uint32_t baud;         /* working line speed */
+    uint32_t pending_baud; /* run-time rate change waiting for its command complete */
+    uint32_t want_baud;    /* run-time rate change waiting for an idle link */
+    uint32_t frame;        /* framing errors at the last sample */
+    uint32_t overrun;      /* overruns at the last sample */
+    uint32_t rx;           /* received bytes at the last sample */
+    uint32_t last_rx;      /* received bytes at the last tick */
+    uint32_t window_ms;    /* error free time before a step up */
+    uint64_t clean_us;     /* time of the last error or rate change */
+    uint8_t stepped_up;    /* the last rate change was a step up */
+    uint8_t bt_wake;       /* BT_WAKE asserted by the stack */
+    uint8_t paused;        /* monitor idle until the link wakes up */
+    vnd_timer_t *p_timer;  /* error counter monitor */
+} hw_uart_cb_t;
+
+/* Controller readiness probe control block */
+typedef struct {
+    uint8_t phase;        /* HW_PROBE_xxx */
+    uint32_t interval_ms; /* current re-send interval */
+    uint32_t sent;        /* probes sent in this phase */
+    uint64_t start_us;    /* time the phase was entered */
+    uint8_t alt_baud;     /* HW_PROBE_START: host at the working baud rate */
+    vnd_timer_t *p_timer;
+} hw_probe_cb_t;
+
+/* Configuration recovery control block */
+typedef struct {
+    vnd_timer_t *p_timer; /* answer timeout of the current state, or retry backoff */
+    uint8_t armed;        /* p_timer is running */
+    uint64_t due_us;      /* deadline p_timer stands for, 0: none */
+    uint8_t backoff;      /* waiting to retry, late answers are dropped */
+    uint8_t retries;      /* retries spent in the current state */
+    uint8_t restarts;     /* power cycles spent on this initialization */
+    uint16_t opcode;      /* last configuration command, sent again on retry */
+    uint16_t len;
+    uint8_t cmd[HCI_CMD_MAX_LEN];
+    /* recovery counts since the library was loaded */
+    uint32_t timeouts;     /* commands not answered in time */
+    uint32_t errors;       /* commands answered with an error or not sent */
+    uint32_t resends;      /* commands sent again */
+    uint32_t resumes;      /* patch downloads resumed */
+    uint32_t power_cycles; /* configurations restarted from power-on */
+    uint32_t failures;     /* configurations given up */
+} hw_recov_cb_t;
+
+#if (SCO_CFG_INCLUDED == TRUE)
+/* Commands of a SCO reconfiguration, in sending order */
+enum {
+    HW_SCO_STEP_WBS,     /* HCI_VSC_ENABLE_WBS */
+    HW_SCO_STEP_I2SPCM,  /* HCI_VSC_WRITE_I2SPCM_INTERFACE_PARAM */
+    HW_SCO_STEP_PCM_INT, /* HCI_VSC_WRITE_SCO_PCM_INT_PARAM, PCM bus only */
+    HW_SCO_STEP_PCM_FMT, /* HCI_VSC_WRITE_PCM_DATA_FORMAT_PARAM, PCM bus only */
+    HW_SCO_STEP_NUM
+};
+
+/* Precomputed command sequences */
+enum {
+    HW_SCO_SEQ_CVSD,
+    HW_SCO_SEQ_MSBC,
+    HW_SCO_SEQ_NUM
+};
+
+#define HW_SCO_STEP_PARAM_MAX 5
+
+/* One command of a sequence */
+typedef struct {
+    uint16_t opcode;
+    uint8_t len; /* 0: not sent on this bus, or controller setting unknown */
+    uint8_t param[HW_SCO_STEP_PARAM_MAX];
+} hw_sco_step_t;
+
+/* SCO reconfiguration control block */
+typedef struct {
+    hw_sco_step_t seq[HW_SCO_SEQ_NUM][HW_SCO_STEP_NUM];
+    hw_sco_step_t ctrl[HW_SCO_STEP_NUM]; /* settings the controller acknowledged */
+    uint8_t pending;                     /* steps waiting for their command complete */
+    uint8_t active;                      /* sequence being applied */
+    uint8_t next;                        /* sequence requested meanwhile, HW_SCO_SEQ_NUM: none */
+    uint8_t failed;                      /* a step of the active sequence failed */
+    uint64_t start_us;                   /* request time of the active sequence */
+    uint64_t next_us;                    /* request time of the next sequence */
+    uint32_t switches;
+    uint32_t cmds;                       /* commands sent */
+    uint32_t skipped;                    /* commands matching the controller setting */
+    uint32_t last_us;
+    uint32_t max_us;
+} hw_sco_cb_t;
+#endif
+
+/* SCO/PCM interface parameters of one controller */
 typedef struct {
-    uint8_t sleep_mode;                     /* 0(disable),1(UART),9(H5) */
-    uint8_t host_stack_idle_threshold;      /* Unit scale 300ms/25ms */
-    uint8_t host_controller_idle_threshold; /* Unit scale 300ms/25ms */
-    uint8_t bt_wake_polarity;               /* 0=Active Low, 1= Active High */
-    uint8_t host_wake_polarity;             /* 0=Active Low, 1= Active High */
-    uint8_t allow_host_sleep_during_sco;
-    uint8_t combine_sleep_mode_and_lpm;
-    uint8_t enable_uart_txd_tri_state; /* UART_TXD Tri-State */
-    uint8_t sleep_guard_time;          /* sleep guard time in 12.5ms */
-    uint8_t wakeup_guard_time;         /* wakeup guard time in 12.5ms */
-    uint8_t txd_config;                /* TXD is high in sleep state */
-    uint8_t pulsed_host_wake;          /* pulsed host wake if mode = 1 */
-} bt_lpm_param_t;
-
-/* Firmware re-launch settlement time */
+    /* need to update the i2spcm as well, it will be used for WBS setting */
+    uint8_t pcm[SCO_PCM_PARAM_SIZE];
+    uint8_t pcm_data_fmt[PCM_DATA_FORMAT_PARAM_SIZE];
+    uint8_t i2spcm[SCO_I2SPCM_PARAM_SIZE];
+    uint8_t bus_interface;
+    uint8_t bus_clock_rate;
+    uint8_t bus_wbs_clock_rate;
+} hw_sco_param_t;
+
+/* Hardware layer state of one controller */
 typedef struct {
-    const char *chipset_name;
-    const uint32_t delay_time;
-} fw_settlement_entry_t;
+    bt_hw_cfg_cb_t cfg;
+    hw_prefetch_cb_t prefetch;
+    hw_uart_cb_t uart;
+    hw_probe_cb_t probe;
+    pthread_mutex_t probe_lock;
+    hw_recov_cb_t recov;
+    pthread_mutex_t cfg_lock;  /* configuration events against its timers */
+    vnd_timer_t *p_fwcfg_timer;
+    uint32_t target_baud;      /* from the board profile, tunable */
+    bt_lpm_param_t lpm_cfg;    /* configured sleep mode parameters, tunable */
+    bt_lpm_param_t lpm;        /* sleep mode parameters sent to this controller */
+#if (LPM_ADAPTIVE_IDLE == TRUE)
+    uint8_t lpm_on;
+    uint8_t lpm_idle_threshold; /* adapted idle thresholds, 0: configured ones */
+    uint32_t lpm_idle_min_ms;
+    uint32_t lpm_idle_max_ms;
+#endif
+    hw_sco_param_t sco_param;  /* tunable */
+#if (SCO_CFG_INCLUDED == TRUE)
+    hw_sco_cb_t sco;
+    pthread_mutex_t sco_lock;
+#endif
+} hw_ctx_t;
 
 #if (FW_AUTO_DETECTION == TRUE)
 /* AMPAK FW auto detection table */
@@ -197,6 +341,7 @@ typedef struct {
 ******************************************************************************/
 
 void hw_config_cback(void *p_mem);
+void hw_config_start(void);
 
 /******************************************************************************
 **  Static variables
@@ -207,59 +352,49 @@ static char fw_patchfile_name[128] = {0};
 #if (VENDOR_LIB_RUNTIME_TUNING_ENABLED == TRUE)
 static int fw_patch_settlement_delay = -1;
 #endif
+static uint32_t fw_patch_dl_window = FW_PATCH_DL_WINDOW;
 
 static int wbs_sample_rate = SCO_WBS_SAMPLE_RATE;
-static bt_hw_cfg_cb_t hw_cfg_cb;
-
-static bt_lpm_param_t lpm_param = {
-    LPM_SLEEP_MODE,
-    LPM_IDLE_THRESHOLD,
-    LPM_HC_IDLE_THRESHOLD,
-    LPM_BT_WAKE_POLARITY,
-    LPM_HOST_WAKE_POLARITY,
-    LPM_ALLOW_HOST_SLEEP_DURING_SCO,
-    LPM_COMBINE_SLEEP_MODE_AND_LPM,
-    LPM_ENABLE_UART_TXD_TRI_STATE,
-    0, /* not applicable */
-    0, /* not applicable */
-    0, /* not applicable */
-    LPM_PULSED_HOST_WAKE
-};
-
-/* need to update the bt_sco_i2spcm_param as well
-   bt_sco_i2spcm_param will be used for WBS setting
-   update the bt_sco_param and bt_sco_i2spcm_param */
-static uint8_t bt_sco_param[SCO_PCM_PARAM_SIZE] = {
-    SCO_PCM_ROUTING,
-    SCO_PCM_IF_CLOCK_RATE,
-    SCO_PCM_IF_FRAME_TYPE,
-    SCO_PCM_IF_SYNC_MODE,
-    SCO_PCM_IF_CLOCK_MODE
-};
 
-static uint8_t bt_pcm_data_fmt_param[PCM_DATA_FORMAT_PARAM_SIZE] = {
-    PCM_DATA_FMT_SHIFT_MODE,
-    PCM_DATA_FMT_FILL_BITS,
-    PCM_DATA_FMT_FILL_METHOD,
-    PCM_DATA_FMT_FILL_NUM,
-    PCM_DATA_FMT_JUSTIFY_MODE
+/* Configuration state names for the boot trace */
+static const char *const hw_cfg_state_names[HW_CFG_STATE_NUM] = {
+    "IDLE",
+    "START",
+    "SET_UART_CLOCK",
+    "SET_UART_BAUD_1",
+    "READ_LOCAL_NAME",
+    "DL_MINIDRIVER",
+    "DL_FW_PATCH",
+    "SET_UART_BAUD_2",
+    "SET_BD_ADDR",
+    "READ_BD_ADDR",
+    "READ_LOCAL_VERSION",
+    "READ_PATCHED_VERSION"
 };
 
-static uint8_t bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_SIZE] = {
-    SCO_I2SPCM_IF_MODE,
-    SCO_I2SPCM_IF_ROLE,
-    SCO_I2SPCM_IF_SAMPLE_RATE,
-    SCO_I2SPCM_IF_CLOCK_RATE
+/* Answer timeout of the command sent in each configuration state */
+static const uint16_t hw_cfg_state_timeouts[HW_CFG_STATE_NUM] = {
+    [HW_CFG_START] = FW_START_PROBE_TIMEOUT_MS,
+    [HW_CFG_SET_UART_CLOCK] = FW_CFG_CMD_TIMEOUT_MS,
+    [HW_CFG_SET_UART_BAUD_1] = FW_CFG_CMD_TIMEOUT_MS,
+    [HW_CFG_READ_LOCAL_NAME] = UART_BAUD_VERIFY_TIMEOUT_MS,
+    [HW_CFG_DL_MINIDRIVER] = FW_CFG_CMD_TIMEOUT_MS,
+    [HW_CFG_DL_FW_PATCH] = FW_CFG_RECORD_TIMEOUT_MS,
+    [HW_CFG_SET_UART_BAUD_2] = FW_CFG_CMD_TIMEOUT_MS,
+    [HW_CFG_SET_BD_ADDR] = FW_CFG_CMD_TIMEOUT_MS,
+    [HW_CFG_READ_BD_ADDR] = FW_CFG_CMD_TIMEOUT_MS,
+    [HW_CFG_READ_LOCAL_VERSION] = FW_CFG_CMD_TIMEOUT_MS,
+    [HW_CFG_READ_PATCHED_VERSION] = UART_BAUD_VERIFY_TIMEOUT_MS
 };
 
-/*
- * The look-up table of recommended firmware settlement delay (milliseconds) on
- * known chipsets.
- */
-static const fw_settlement_entry_t fw_settlement_table[] = {
-    {"BCM43241", 200},
-    {"BCM43341", 100},
-    {(const char *)NULL, 200} // Giving the generic fw settlement delay setting.
+/* complete block, sent as is by HCI_VSC_WRITE_SLEEP_MODE */
+_Static_assert(sizeof(bt_lpm_param_t) == LPM_CMD_PARAM_SIZE, "LPM parameter block size");
+/* UART baud rates tried by the negotiation, fastest first */
+static const uint32_t uart_baud_ladder[] = {
+    USERIAL_LINESPEED_4M,
+    USERIAL_LINESPEED_3M,
+    USERIAL_LINESPEED_2M,
+    USERIAL_LINESPEED_1_5M
 };
 
 /*
@@ -272,14 +407,117 @@ static const fw_settlement_entry_t fw_settlement_table[] = {
  *     port.
  */
 #if (defined(SCO_USE_I2S_INTERFACE) && SCO_USE_I2S_INTERFACE == TRUE)
-static uint8_t sco_bus_interface = SCO_INTERFACE_I2S;
+#define SCO_BUS_INTERFACE SCO_INTERFACE_I2S
 #else
-static uint8_t sco_bus_interface = SCO_INTERFACE_PCM;
+#define SCO_BUS_INTERFACE SCO_INTERFACE_PCM
 #endif
 
 #define INVALID_SCO_CLOCK_RATE 0xFF
-static uint8_t sco_bus_clock_rate = INVALID_SCO_CLOCK_RATE;
-static uint8_t sco_bus_wbs_clock_rate = INVALID_SCO_CLOCK_RATE;
+
+static hw_ctx_t hw_ctxs[VND_MAX_CONTROLLERS] = {
+    [0 ... VND_MAX_CONTROLLERS - 1] = {
+        .probe_lock = PTHREAD_MUTEX_INITIALIZER,
+        .cfg_lock = PTHREAD_MUTEX_INITIALIZER,
+        .target_baud = UART_TARGET_BAUD_RATE,
+#if (LPM_ADAPTIVE_IDLE == TRUE)
+        .lpm_idle_min_ms = LPM_IDLE_TIMEOUT_MIN_MS,
+        .lpm_idle_max_ms = LPM_IDLE_TIMEOUT_MAX_MS,
+#endif
+        .sco_param = {
+            .pcm = {
+                SCO_PCM_ROUTING,
+                SCO_PCM_IF_CLOCK_RATE,
+                SCO_PCM_IF_FRAME_TYPE,
+                SCO_PCM_IF_SYNC_MODE,
+                SCO_PCM_IF_CLOCK_MODE
+            },
+            .pcm_data_fmt = {
+                PCM_DATA_FMT_SHIFT_MODE,
+                PCM_DATA_FMT_FILL_BITS,
+                PCM_DATA_FMT_FILL_METHOD,
+                PCM_DATA_FMT_FILL_NUM,
+                PCM_DATA_FMT_JUSTIFY_MODE
+            },
+            .i2spcm = {
+                SCO_I2SPCM_IF_MODE,
+                SCO_I2SPCM_IF_ROLE,
+                SCO_I2SPCM_IF_SAMPLE_RATE,
+                SCO_I2SPCM_IF_CLOCK_RATE
+            },
+            .bus_interface = SCO_BUS_INTERFACE,
+            .bus_clock_rate = INVALID_SCO_CLOCK_RATE,
+            .bus_wbs_clock_rate = INVALID_SCO_CLOCK_RATE,
+        },
+#if (SCO_CFG_INCLUDED == TRUE)
+        .sco = {.next = HW_SCO_SEQ_NUM},
+        .sco_lock = PTHREAD_MUTEX_INITIALIZER,
+#endif
+    }
+};
+
+/* control blocks of the calling thread's controller */
+#define hw_cfg_cb (hw_ctxs[vnd_ctx_id()].cfg)
+#define hw_prefetch_cb (hw_ctxs[vnd_ctx_id()].prefetch)
+#define hw_uart_cb (hw_ctxs[vnd_ctx_id()].uart)
+#define hw_probe_cb (hw_ctxs[vnd_ctx_id()].probe)
+#define hw_probe_lock (hw_ctxs[vnd_ctx_id()].probe_lock)
+#define hw_recov_cb (hw_ctxs[vnd_ctx_id()].recov)
+#define hw_cfg_lock (hw_ctxs[vnd_ctx_id()].cfg_lock)
+#define fwcfg_timer (hw_ctxs[vnd_ctx_id()].p_fwcfg_timer)
+#define hw_uart_target_baud (hw_ctxs[vnd_ctx_id()].target_baud)
+#define lpm_param (hw_ctxs[vnd_ctx_id()].lpm_cfg)
+#define lpm_ctx_param (hw_ctxs[vnd_ctx_id()].lpm)
+#if (LPM_ADAPTIVE_IDLE == TRUE)
+#define lpm_enabled (hw_ctxs[vnd_ctx_id()].lpm_on)
+#define lpm_idle_threshold (hw_ctxs[vnd_ctx_id()].lpm_idle_threshold)
+#define lpm_idle_min_ms (hw_ctxs[vnd_ctx_id()].lpm_idle_min_ms)
+#define lpm_idle_max_ms (hw_ctxs[vnd_ctx_id()].lpm_idle_max_ms)
+#endif
+#define bt_sco_param (hw_ctxs[vnd_ctx_id()].sco_param.pcm)
+#define bt_pcm_data_fmt_param (hw_ctxs[vnd_ctx_id()].sco_param.pcm_data_fmt)
+#define bt_sco_i2spcm_param (hw_ctxs[vnd_ctx_id()].sco_param.i2spcm)
+#define sco_bus_interface (hw_ctxs[vnd_ctx_id()].sco_param.bus_interface)
+#define sco_bus_clock_rate (hw_ctxs[vnd_ctx_id()].sco_param.bus_clock_rate)
+#define sco_bus_wbs_clock_rate (hw_ctxs[vnd_ctx_id()].sco_param.bus_wbs_clock_rate)
+#if (SCO_CFG_INCLUDED == TRUE)
+#define hw_sco_cb (hw_ctxs[vnd_ctx_id()].sco)
+#define hw_sco_lock (hw_ctxs[vnd_ctx_id()].sco_lock)
+#endif
+
+/* value of the first controller and the distance to the next one */
+#define HW_TUNE_CTX(field) &hw_ctxs[0].field, sizeof(hw_ctx_t)
+
+/* Values tunable from the conf file, the LPM ones also apply on LPM toggles. Each
+ * controller has its own, set with Name.<n>.
+ */
+static const vnd_tune_t hw_tunes[] = {
+    {"LpmSleepMode", VND_TUNE_U8, 1, VND_TUNE_AT_POWER | VND_TUNE_AT_LPM, 0, UINT8_MAX,
+        HW_TUNE_CTX(lpm_cfg.sleep_mode)},
+    {"LpmIdleThreshold", VND_TUNE_U8, 1, VND_TUNE_AT_POWER | VND_TUNE_AT_LPM, 1, UINT8_MAX,
+        HW_TUNE_CTX(lpm_cfg.host_stack_idle_threshold)},
+    {"LpmHcIdleThreshold", VND_TUNE_U8, 1, VND_TUNE_AT_POWER | VND_TUNE_AT_LPM, 1, UINT8_MAX,
+        HW_TUNE_CTX(lpm_cfg.host_controller_idle_threshold)},
+    {"LpmBtWakePolarity", VND_TUNE_U8, 1, VND_TUNE_AT_POWER | VND_TUNE_AT_LPM, 0, 1,
+        HW_TUNE_CTX(lpm_cfg.bt_wake_polarity)},
+    {"LpmHostWakePolarity", VND_TUNE_U8, 1, VND_TUNE_AT_POWER | VND_TUNE_AT_LPM, 0, 1,
+        HW_TUNE_CTX(lpm_cfg.host_wake_polarity)},
+    {"LpmAllowHostSleepDuringSco", VND_TUNE_U8, 1, VND_TUNE_AT_POWER | VND_TUNE_AT_LPM, 0, 1,
+        HW_TUNE_CTX(lpm_cfg.allow_host_sleep_during_sco)},
+    {"LpmCombineSleepModeAndLpm", VND_TUNE_U8, 1, VND_TUNE_AT_POWER | VND_TUNE_AT_LPM, 0, 1,
+        HW_TUNE_CTX(lpm_cfg.combine_sleep_mode_and_lpm)},
+    {"LpmEnableUartTxdTriState", VND_TUNE_U8, 1, VND_TUNE_AT_POWER | VND_TUNE_AT_LPM, 0, 1,
+        HW_TUNE_CTX(lpm_cfg.enable_uart_txd_tri_state)},
+    {"LpmPulsedHostWake", VND_TUNE_U8, 1, VND_TUNE_AT_POWER | VND_TUNE_AT_LPM, 0, 1,
+        HW_TUNE_CTX(lpm_cfg.pulsed_host_wake)},
+    {"ScoPcmParam", VND_TUNE_U8_ARRAY, SCO_PCM_PARAM_SIZE, VND_TUNE_AT_POWER, 0, UINT8_MAX,
+        HW_TUNE_CTX(sco_param.pcm)},
+    {"PcmDataFmtParam", VND_TUNE_U8_ARRAY, PCM_DATA_FORMAT_PARAM_SIZE, VND_TUNE_AT_POWER, 0, UINT8_MAX,
+        HW_TUNE_CTX(sco_param.pcm_data_fmt)},
+    {"ScoI2sPcmParam", VND_TUNE_U8_ARRAY, SCO_I2SPCM_PARAM_SIZE, VND_TUNE_AT_POWER, 0, UINT8_MAX,
+        HW_TUNE_CTX(sco_param.i2spcm)},
+    {"UartTargetBaudRate", VND_TUNE_U32, 1, VND_TUNE_AT_POWER, USERIAL_LINESPEED_115200, USERIAL_LINESPEED_4M,
+        HW_TUNE_CTX(target_baud)},
+};
 
 #if (FW_AUTO_DETECTION == TRUE)
 #define FW_TABLE_VERSION "v1.1 20161117"
@@ -297,6 +535,7 @@ static const fw_auto_detection_entry_t fw_auto_detection_table[] = {
     {"BCM43430B0", "BCM4343B0"},  // AP6236
     {"BCM4359C0", "BCM4359C0"},   // AP6359
     {"BCM4349B1", "BCM4359B1"},   // AP6359
+    {"BCM4362A2", "BCM4362A2"},   // AP6275
     {NULL, NULL}
 };
 #endif
@@ -304,8 +543,7 @@ static const fw_auto_detection_entry_t fw_auto_detection_table[] = {
 /******************************************************************************
 **  Static functions
 ******************************************************************************/
-static void hw_sco_i2spcm_config(uint16_t codec);
-static void hw_sco_i2spcm_config_from_command(void *p_mem, uint16_t codec);
+uint8_t hw_config_prefetch_wait(void);
 
 /******************************************************************************
 **  Controller Initialization Static Functions
@@ -313,23 +551,113 @@ static void hw_sco_i2spcm_config_from_command(void *p_mem, uint16_t codec);
 
 /*******************************************************************************
 **
-** Function        look_up_fw_settlement_delay
+** Function        hw_config_set_state
+**
+** Description     Move the configuration state machine and time the
+**                 transition
+**
+** Returns         None
+**
+*******************************************************************************/
+static void hw_config_set_state(uint8_t state)
+{
+    /* retries are counted per state */
+    if (state != hw_cfg_cb.state) {
+        hw_recov_cb.retries = 0;
+    }
+    hw_cfg_cb.state = state;
+    cfg_trace_state(state);
+    /* scheduled commands wait while the sequence owns the command channel */
+    cmd_sched_hold(state != 0);
+}
+
+/*******************************************************************************
+**
+** Function        hw_xmit
+**
+** Description     Hand an HCI command to the stack and trace it. A
+**                 configuration command is kept for a retry, patch records
+**                 are sent again from the image.
+**
+** Returns         Return value of xmit_cb
+**
+*******************************************************************************/
+static size_t hw_xmit(uint16_t opcode, HC_BT_HDR *p_buf)
+{
+    if ((hw_cfg_cb.state != 0) && (hw_cfg_cb.state != HW_CFG_DL_FW_PATCH) &&
+        (memcpy_s(hw_recov_cb.cmd, sizeof(hw_recov_cb.cmd), p_buf + 1, p_buf->len) == 0)) {
+        hw_recov_cb.opcode = opcode;
+        hw_recov_cb.len = p_buf->len;
+    }
+
+    cfg_trace_cmd(opcode);
+#if (HCI_SNOOP_INCLUDED == TRUE)
+    hci_snoop_cmd(p_buf);
+#endif
+    cmd_sched_xmit();
+    return bt_vendor_cbacks->xmit_cb(opcode, p_buf);
+}
+
+/*******************************************************************************
+**
+** Function        hw_send_cmd
+**
+** Description     Build an HCI command in a pool buffer and send it down.
+**                 A NULL p_param sends param_len zero bytes.
+**
+** Returns         Number of bytes handed to xmit_cb, 0 on failure
+**
+*******************************************************************************/
+static size_t hw_send_cmd(uint16_t opcode, const uint8_t *p_param, uint8_t param_len)
+{
+    HC_BT_HDR *p_buf = vnd_cmd_build(opcode, p_param, param_len);
+    size_t xmit_bytes;
+
+    if (p_buf == NULL) {
+        HILOGE("no command buffer for opcode 0x%04x", opcode);
+        return 0;
+    }
+
+    xmit_bytes = hw_xmit(opcode, p_buf);
+    vnd_cmd_put(p_buf);
+    return xmit_bytes;
+}
+
+/*******************************************************************************
+**
+** Function        fw_settle_state_name
+**
+** Description     Name under which the settle time of the current chipset is
+**                 persisted
+**
+** Returns         None
+**
+*******************************************************************************/
+static void fw_settle_state_name(char *p_name, size_t len)
+{
+    (void)snprintf_s(p_name, len, len - 1, "FwSettleTime.%s",
+        (hw_cfg_cb.local_chip_name[0] != 0) ? hw_cfg_cb.local_chip_name : "UNKNOWN");
+}
+
+/*******************************************************************************
 **
-** Description     If FW_PATCH_SETTLEMENT_DELAY_MS has not been explicitly
-**                 re-defined in the platform specific build-time configuration
-**                 file, we will search into the look-up table for a
-**                 recommended firmware settlement delay value.
+** Function        look_up_fw_settlement_delay
 **
-**                 Although the settlement time might be also related to board
-**                 configurations such as the crystal clocking speed.
+** Description     Work out when the first readiness probe is sent after the
+**                 firmware patch was launched. An explicit
+**                 FW_PATCH_SETTLEMENT_DELAY_MS (or run-time tuned value) wins,
+**                 otherwise the settle time measured on this chipset by a
+**                 previous boot, or else the one the board profile expects,
+**                 is used, less one probe interval.
 **
-** Returns         Firmware settlement delay
+** Returns         Delay before the first probe in milliseconds
 **
 *******************************************************************************/
 uint32_t look_up_fw_settlement_delay(void)
 {
     uint32_t ret_value;
-    fw_settlement_entry_t *p_entry;
+    char name[LOCAL_NAME_BUFFER_LEN + 16];
+    int learned;
 
     if (FW_PATCH_SETTLEMENT_DELAY_MS > 0)
         ret_value = FW_PATCH_SETTLEMENT_DELAY_MS;
@@ -339,17 +667,9 @@ uint32_t look_up_fw_settlement_delay(void)
     }
 #endif
     else {
-        p_entry = (fw_settlement_entry_t *)fw_settlement_table;
-
-        while (p_entry->chipset_name != NULL) {
-            if (strstr(hw_cfg_cb.local_chip_name, p_entry->chipset_name) != NULL) {
-                break;
-            }
-
-            p_entry++;
-        }
-
-        ret_value = p_entry->delay_time;
+        fw_settle_state_name(name, sizeof(name));
+        learned = vnd_state_get_int(name, (int)vnd_board_settle_time(hw_cfg_cb.local_chip_name));
+        ret_value = (learned > FW_READY_PROBE_INTERVAL_MS) ? (learned - FW_READY_PROBE_INTERVAL_MS) : 0;
     }
 
     BTHWDBG("Settlement delay -- %d ms", ret_value);
@@ -383,6 +703,24 @@ void ms_delay(uint32_t timeout)
     } while (err < 0 && errno == EINTR);
 }
 
+/*******************************************************************************
+**
+** Function        get_monotonic_time_us
+**
+** Description     Read the monotonic clock
+**
+** Returns         Current CLOCK_MONOTONIC time in microseconds
+**
+*******************************************************************************/
+uint64_t get_monotonic_time_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * BT_VENDOR_TIME_RAIDX * BT_VENDOR_TIME_RAIDX +
+        (uint64_t)ts.tv_nsec / BT_VENDOR_TIME_RAIDX;
+}
+
 /*******************************************************************************
 **
 ** Function        line_speed_to_userial_baud
@@ -484,9 +822,9 @@ static ssize_t hw_config_set_bdaddr(HC_BT_HDR *p_buf)
     *p = vnd_local_bd_addr[--i];
 
     p_buf->len = HCI_CMD_PREAMBLE_SIZE + BD_ADDR_LEN;
-    hw_cfg_cb.state = HW_CFG_SET_BD_ADDR;
+    hw_config_set_state(HW_CFG_SET_BD_ADDR);
 
-    retval = bt_vendor_cbacks->xmit_cb(HCI_VSC_WRITE_BD_ADDR, p_buf);
+    retval = hw_xmit(HCI_VSC_WRITE_BD_ADDR, p_buf);
 
     return (retval);
 }
@@ -510,221 +848,1200 @@ static ssize_t hw_config_read_bdaddr(HC_BT_HDR *p_buf)
     *p = 0; /* parameter length */
 
     p_buf->len = HCI_CMD_PREAMBLE_SIZE;
-    hw_cfg_cb.state = HW_CFG_READ_BD_ADDR;
+    hw_config_set_state(HW_CFG_READ_BD_ADDR);
 
-    retval = bt_vendor_cbacks->xmit_cb(HCI_READ_LOCAL_BDADDR, p_buf);
+    retval = hw_xmit(HCI_READ_LOCAL_BDADDR, p_buf);
 
     return (retval);
 }
 #endif // (USE_CONTROLLER_BDADDR == TRUE)
 
-typedef void (*tTIMER_HANDLE_CBACK)(union sigval sigval_value);
-
-static timer_t OsAllocateTimer(tTIMER_HANDLE_CBACK timer_callback)
+/*******************************************************************************
+**
+** Function         hw_config_read_local_version
+**
+** Description      Read controller's local version information
+**
+** Returns          xmit bytes
+**
+*******************************************************************************/
+static ssize_t hw_config_read_local_version(HC_BT_HDR *p_buf, uint8_t next_state)
 {
-    struct sigevent sigev;
-    timer_t timerid;
+    uint8_t retval = FALSE;
+    uint8_t *p = (uint8_t *)(p_buf + 1);
+
+    UINT16_TO_STREAM(p, HCI_READ_LOCAL_VERSION_INFO);
+    *p = 0; /* parameter length */
 
-    (void)memset_s(&sigev, sizeof(struct sigevent), 0, sizeof(struct sigevent));
-    // Create the POSIX timer to generate signo
-    sigev.sigev_notify = SIGEV_THREAD;
-    sigev.sigev_notify_function = timer_callback;
-    sigev.sigev_value.sival_ptr = &timerid;
+    p_buf->len = HCI_CMD_PREAMBLE_SIZE;
+    hw_config_set_state(next_state);
 
-    // Create the Timer using timer_create signal
+    retval = hw_xmit(HCI_READ_LOCAL_VERSION_INFO, p_buf);
 
-    if (timer_create(CLOCK_REALTIME, &sigev, &timerid) == 0) {
-        return timerid;
-    } else {
-        HILOGE("timer_create error!");
-        return (timer_t)-1;
-    }
+    return (retval);
 }
 
-int OsFreeTimer(timer_t timerid)
+/*******************************************************************************
+**
+** Function         hw_config_parse_version
+**
+** Description      Extract the firmware identity from a Read Local Version
+**                  Information command complete. Broadcom firmware reports
+**                  the patch build in the HCI revision.
+**
+** Returns          HCI revision << 16 | LMP subversion
+**
+*******************************************************************************/
+static uint32_t hw_config_parse_version(HC_BT_HDR *p_evt_buf)
 {
-    int ret = 0;
-    ret = timer_delete(timerid);
-    if (ret != 0) {
-        HILOGE("timer_delete fail with errno(%d)", errno);
-    }
+    uint8_t *p = (uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_HCI_REVISION;
+    uint16_t hci_rev, lmp_subver;
 
-    return ret;
+    STREAM_TO_UINT16(hci_rev, p);
+    p = (uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_LMP_SUBVERSION;
+    STREAM_TO_UINT16(lmp_subver, p);
+
+    return ((uint32_t)hci_rev << 16) | lmp_subver; /* 16: HCI revision in the upper half */
 }
 
-static int OsStartTimer(timer_t timerid, int msec, int mode)
+/*******************************************************************************
+**
+** Function         fw_patch_state_name
+**
+** Description      Name under which the version of the last patched firmware
+**                  of the current chipset is persisted
+**
+** Returns          None
+**
+*******************************************************************************/
+static void fw_patch_state_name(char *p_name, size_t len)
 {
-    struct itimerspec itval;
-
-    itval.it_value.tv_sec = msec / BT_VENDOR_TIME_RAIDX;
-    itval.it_value.tv_nsec = (long)(msec % BT_VENDOR_TIME_RAIDX) * (BT_VENDOR_TIME_RAIDX * BT_VENDOR_TIME_RAIDX);
+    (void)snprintf_s(p_name, len, len - 1, "FwPatchState.%s",
+        (hw_cfg_cb.local_chip_name[0] != 0) ? hw_cfg_cb.local_chip_name : "UNKNOWN");
+}
 
-    if (mode == 1) {
-        itval.it_interval.tv_sec = itval.it_value.tv_sec;
-        itval.it_interval.tv_nsec = itval.it_value.tv_nsec;
-    } else {
-        itval.it_interval.tv_sec = 0;
-        itval.it_interval.tv_nsec = 0;
+/*******************************************************************************
+**
+** Function         hw_config_is_patched
+**
+** Description      Check whether the controller already runs a patch built
+**                  from the image about to be downloaded. The persisted state
+**                  holds "<image digest>:<rom version>:<patched version>" as
+**                  recorded right after the last download.
+**
+** Returns          TRUE/FALSE
+**
+*******************************************************************************/
+static uint8_t hw_config_is_patched(uint32_t version)
+{
+    char name[LOCAL_NAME_BUFFER_LEN + 16];
+    char value[64];
+    char *p_end = NULL;
+    uint64_t digest;
+    uint32_t rom_version, patched_version;
+
+    fw_patch_state_name(name, sizeof(name));
+    if (vnd_state_get(name, value, sizeof(value)) != 0) {
+        return FALSE;
     }
 
-    // Set the Timer when to expire through timer_settime
-
-    if (timer_settime(timerid, 0, &itval, NULL) != 0) {
-        HILOGE("time_settime error!");
-        return -1;
+    digest = strtoull(value, &p_end, 16); /* 16: hex */
+    if ((p_end == NULL) || (*p_end != ':')) {
+        return FALSE;
     }
+    rom_version = (uint32_t)strtoul(p_end + 1, &p_end, 16); /* 16: hex */
+    if ((p_end == NULL) || (*p_end != ':')) {
+        return FALSE;
+    }
+    patched_version = (uint32_t)strtoul(p_end + 1, &p_end, 16); /* 16: hex */
 
-    return 0;
-}
+    HILOGI("controller version %08x, last patched %08x (rom %08x, digest %016llx, image %016llx)", version,
+        patched_version, rom_version, (unsigned long long)digest, (unsigned long long)hw_cfg_cb.fw_digest);
 
-static timer_t localtimer = 0;
-static void local_timer_handler(union sigval sigev_value)
-{
-    bt_vendor_cbacks->init_cb(BTC_OP_RESULT_SUCCESS);
-    OsFreeTimer(localtimer);
+    /* a patch that does not change the version cannot be told from the rom */
+    return (digest == hw_cfg_cb.fw_digest) && (version == patched_version) && (version != rom_version);
 }
-static void start_fwcfg_cbtimer(void)
+
+/*******************************************************************************
+**
+** Function         hw_config_save_patched_version
+**
+** Description      Record the version reported by the freshly patched
+**                  firmware together with the image digest
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_save_patched_version(uint32_t version)
 {
-    if (localtimer == 0) {
-        localtimer = OsAllocateTimer(local_timer_handler);
+    char name[LOCAL_NAME_BUFFER_LEN + 16];
+    char value[64];
+
+    if (version == hw_cfg_cb.rom_version) {
+        HILOGW("patched firmware reports the rom version %08x, no warm restart", version);
+        return;
     }
-    OsStartTimer(localtimer, BT_VENDOR_CFG_TIMEDELAY_, 0);
-}
 
-void hw_sco_config(void);
+    fw_patch_state_name(name, sizeof(name));
+    if (snprintf_s(value, sizeof(value), sizeof(value) - 1, "%016llx:%08x:%08x",
+        (unsigned long long)hw_cfg_cb.fw_digest, hw_cfg_cb.rom_version, version) > 0) {
+        vnd_state_set(name, value);
+    }
+}
 
 /*******************************************************************************
 **
-** Function         hw_config_cback
+** Function         hw_config_findpatch
 **
-** Description      Callback function for controller configuration
+** Description      Search for a proper firmware patch file
+**                  The selected firmware patch file name with full path
+**                  will be stored in the input string parameter, i.e.
+**                  p_chip_id_str, when returns.
 **
-** Returns          None
+** Returns          TRUE when found the target patch file, otherwise FALSE
 **
 *******************************************************************************/
-void hw_config_cback(void *p_mem)
+static uint8_t hw_config_findpatch(char *p_chip_id_str)
 {
-    HC_BT_HDR *p_evt_buf = (HC_BT_HDR *)p_mem;
-    char *p_name, *p_tmp;
-    uint8_t *p, status;
-    uint16_t opcode;
-    HC_BT_HDR *p_buf = NULL;
-    ssize_t xmit_bytes = 0;
-    int i;
-    int delay = 100;
-#if (USE_CONTROLLER_BDADDR == TRUE)
-    const uint8_t null_bdaddr[BD_ADDR_LEN] = {0, 0, 0, 0, 0, 0};
-#endif
-
-    status = *((uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_STATUS_RET_BYTE);
-    p = (uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_OPCODE;
-    STREAM_TO_UINT16(opcode, p);
+    DIR *dirp;
+    struct dirent *dp;
+    size_t filenamelen;
+    size_t len;
+    uint8_t retval = FALSE;
+    size_t path_len = strlen(fw_patchfile_path);
+    const char *p_sep = ((path_len > 0) && (fw_patchfile_path[path_len - 1] != '/')) ? "/" : "";
+
+    BTHWDBG("Target name = [%s]", p_chip_id_str);
+
+    if (strlen(fw_patchfile_name) > 0) {
+        /* If specific filepath and filename have been given in run-time
+         * configuration bt_vendor.conf file, we will use them to concatenate
+         * the filename to open rather than searching a file matching to
+         * chipset name in the fw_patchfile_path folder.
+         */
+        return (snprintf_s(p_chip_id_str, FW_PATCHFILE_PATH_MAXLEN, FW_PATCHFILE_PATH_MAXLEN - 1, "%s%s%s",
+            fw_patchfile_path, p_sep, fw_patchfile_name) > 0) ? TRUE : FALSE;
+    }
 
-    /* Ask a new buffer big enough to hold any HCI commands sent in here */
-    if ((status == 0) && bt_vendor_cbacks)
-        p_buf = (HC_BT_HDR *)bt_vendor_cbacks->alloc(BT_HC_HDR_SIZE + HCI_CMD_MAX_LEN);
+    if ((dirp = opendir(fw_patchfile_path)) == NULL) {
+        HILOGE("Could not open %s", fw_patchfile_path);
+        return FALSE;
+    }
 
-    if (p_buf != NULL) {
-        p_buf->event = MSG_STACK_TO_HC_HCI_CMD;
-        p_buf->offset = 0;
-        p_buf->len = 0;
-        p_buf->layer_specific = 0;
+    /* Fetch next filename in patchfile directory */
+    while ((dp = readdir(dirp)) != NULL) {
+        /* Check if filename starts with chip-id name and has .hcd extension */
+        filenamelen = strlen(dp->d_name);
+        if ((hw_strncmp(dp->d_name, p_chip_id_str, strlen(p_chip_id_str)) != 0) ||
+            (filenamelen < FW_PATCHFILE_EXTENSION_LEN) ||
+            (hw_strncmp(&dp->d_name[filenamelen - FW_PATCHFILE_EXTENSION_LEN], FW_PATCHFILE_EXTENSION,
+            FW_PATCHFILE_EXTENSION_LEN) != 0)) {
+            continue;
+        }
 
-        p = (uint8_t *)(p_buf + 1);
-        switch (hw_cfg_cb.state) {
-            case HW_CFG_SET_UART_BAUD_1:
-                /* update baud rate of host's UART port */
-                HILOGI("bt vendor lib: set UART baud %i", UART_TARGET_BAUD_RATE);
-                userial_vendor_set_baud(line_speed_to_userial_baud(UART_TARGET_BAUD_RATE));
-#if 0
-                /* read local name */
-                UINT16_TO_STREAM(p, HCI_READ_LOCAL_NAME);
-                *p = 0; /* parameter length */
+        HILOGI("Found patchfile: %s%s%s", fw_patchfile_path, p_sep, dp->d_name);
+        if (snprintf_s(p_chip_id_str, FW_PATCHFILE_PATH_MAXLEN, FW_PATCHFILE_PATH_MAXLEN - 1, "%s%s%s",
+            fw_patchfile_path, p_sep, dp->d_name) < 0) {
+            HILOGE("Invalid patchfile name (too long)");
+        } else {
+            retval = TRUE;
+        }
+        break;
+    }
 
-                p_buf->len = HCI_CMD_PREAMBLE_SIZE;
-                hw_cfg_cb.state = HW_CFG_READ_LOCAL_NAME;
+    (void)closedir(dirp);
 
-                xmit_bytes = bt_vendor_cbacks->xmit_cb(HCI_READ_LOCAL_NAME, p_buf);
+    if (retval == FALSE) {
+        /* Try again chip name without revision info, scan backward and look
+         * for the first alphabet which is not M or m
+         */
+        len = strlen(p_chip_id_str);
+        while (len > 3) { /* 3: BCM prefix */
+            if (!isdigit(p_chip_id_str[len - 1]) && (toupper(p_chip_id_str[len - 1]) != 'M')) {
                 break;
-#endif
-            case HW_CFG_READ_LOCAL_NAME:
-#if 0
-                p_tmp = p_name = (char *)(p_evt_buf + 1) +
-                                 HCI_EVT_CMD_CMPL_LOCAL_NAME_STRING;
-
-                for (i = 0; (i < LOCAL_NAME_BUFFER_LEN) || (*(p_name + i) != 0); i++)
-                    *(p_name + i) = toupper(*(p_name + i));
-
-                if ((p_name = strstr(p_name, "BCM")) != NULL) {
-                    strncpy(hw_cfg_cb.local_chip_name, p_name,
-                            LOCAL_NAME_BUFFER_LEN - 1);
-#ifdef USE_BLUETOOTH_BCM4343
-                } else if ((p_name = strstr(p_tmp, "4343")) != NULL) {
-                    snprintf(hw_cfg_cb.local_chip_name,
-                             LOCAL_NAME_BUFFER_LEN - 1, "BCM%s", p_name);
-                    strncpy(p_name, hw_cfg_cb.local_chip_name,
-                            LOCAL_NAME_BUFFER_LEN - 1);
-                }
-#endif
-                else {
-                    strncpy(hw_cfg_cb.local_chip_name, "UNKNOWN",
-                        LOCAL_NAME_BUFFER_LEN - 1);
-                    p_name = p_tmp;
-                }
-
-                hw_cfg_cb.local_chip_name[LOCAL_NAME_BUFFER_LEN - 1] = 0;
+            }
+            len--;
+        }
 
-                BTHWDBG("Chipset %s", hw_cfg_cb.local_chip_name);
-#endif
-            {
-                // /vendor/etc/firmware
-                p_name = FW_PATCHFILE_LOCATION "BCM4362A2.hcd";
-                if ((hw_cfg_cb.fw_fd = open(p_name, O_RDONLY)) == -1) {
-                    HILOGE("vendor lib preload failed to open [%s]", p_name);
-                } else {
-                    /* vsc_download_minidriver */
-                    UINT16_TO_STREAM(p, HCI_VSC_DOWNLOAD_MINIDRV);
-                    *p = 0; /* parameter length */
+        if (len > 3) { /* 3: BCM prefix */
+            p_chip_id_str[len - 1] = 0;
+            retval = hw_config_findpatch(p_chip_id_str);
+        }
+    }
 
-                    p_buf->len = HCI_CMD_PREAMBLE_SIZE;
-                    hw_cfg_cb.state = HW_CFG_DL_MINIDRIVER;
+    return (retval);
+}
 
-                    xmit_bytes = bt_vendor_cbacks->xmit_cb(HCI_VSC_DOWNLOAD_MINIDRV, p_buf);
-                }
-            }
+/*******************************************************************************
+**
+** Function         hw_config_load_patch
+**
+** Description      Map and index the given patch file unless it is the one
+**                  already loaded
+**
+** Returns          0 : Success
+**                  Otherwise : Fail
+**
+*******************************************************************************/
+static int hw_config_load_patch(const char *p_path)
+{
+    if (hcd_patch_is_loaded(&hw_cfg_cb.fw_image) && (strcmp(hw_cfg_cb.patch_file, p_path) == 0)) {
+        hcd_patch_rewind(&hw_cfg_cb.fw_image);
+        return 0;
+    }
 
-                if (xmit_bytes <= 0) {
-                    HILOGE("vendor lib preload failed to locate firmware patch file and set bdaddr");
-                    xmit_bytes = hw_config_set_bdaddr(p_buf);
-                }
-                break;
+    hw_cfg_cb.patch_file[0] = 0;
+    hw_cfg_cb.fw_digest = 0;
+    if (hcd_patch_load(&hw_cfg_cb.fw_image, p_path) != 0) {
+        HILOGE("vendor lib failed to load firmware patch image %s", p_path);
+        return -1;
+    }
 
-            case HW_CFG_DL_MINIDRIVER:
-                /* give time for placing firmware in download mode */
-                ms_delay(50);
-                hw_cfg_cb.state = HW_CFG_DL_FW_PATCH;
-                /* fall through intentionally */
-            case HW_CFG_DL_FW_PATCH:
-                // HILOGD("HW_CFG_DL_FW_PATCH, opcode:0x%02x", opcode);
-                p_buf->len = read(hw_cfg_cb.fw_fd, p, HCI_CMD_PREAMBLE_SIZE);
-                if (p_buf->len > 0) {
-                    if ((p_buf->len < HCI_CMD_PREAMBLE_SIZE) ||
-                        (opcode == HCI_VSC_LAUNCH_RAM)) {
-                        HILOGW("firmware patch file might be altered!");
-                    } else {
-                        p_buf->len += read(hw_cfg_cb.fw_fd,
-                                           p + HCI_CMD_PREAMBLE_SIZE,
-                                           *(p + HCD_REC_PAYLOAD_LEN_BYTE));
-                        STREAM_TO_UINT16(opcode, p);
-                        xmit_bytes = bt_vendor_cbacks->xmit_cb(opcode, p_buf);
-                        break;
-                    }
-                }
+    if (strcpy_s(hw_cfg_cb.patch_file, sizeof(hw_cfg_cb.patch_file), p_path) != 0) {
+        hcd_patch_unload(&hw_cfg_cb.fw_image);
+        return -1;
+    }
+    hw_cfg_cb.fw_digest = hw_cfg_cb.fw_image.digest;
 
-                close(hw_cfg_cb.fw_fd);
-                hw_cfg_cb.fw_fd = -1;
+    return 0;
+}
 
-                /* Normally the firmware patch configuration file
+/*******************************************************************************
+**
+** Function         hw_config_prefetch_patch
+**
+** Description      Load the patch file resolved for the chipset detected on
+**                  the previous boot, before the controller even answers
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_prefetch_patch(void)
+{
+    char name[LOCAL_NAME_BUFFER_LEN + 16];
+    char path[FW_PATCHFILE_PATH_MAXLEN];
+    char key[HW_STATE_KEY_LEN];
+
+    hw_cfg_cb.local_chip_name[0] = 0;
+    if (vnd_state_get(vnd_ctx_name("FwChip", key, sizeof(key)), hw_cfg_cb.local_chip_name,
+        LOCAL_NAME_BUFFER_LEN) != 0) {
+        return;
+    }
+
+    (void)snprintf_s(name, sizeof(name), sizeof(name) - 1, "FwPatchFile.%s", hw_cfg_cb.local_chip_name);
+    if (vnd_state_get(name, path, sizeof(path)) == 0) {
+        HILOGI("prefetch %s for %s", path, hw_cfg_cb.local_chip_name);
+        (void)hw_config_load_patch(path);
+    }
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_prefetch_thread
+**
+** Description      Prefetch thread body
+**
+** Returns          None
+**
+*******************************************************************************/
+static void *hw_config_prefetch_thread(void *arg)
+{
+    vnd_ctx_bind_thread(arg);
+    hw_config_prefetch_patch();
+    hw_prefetch_cb.done_us = get_monotonic_time_us();
+
+    return NULL;
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_prefetch_start
+**
+** Description      Start loading the firmware patch in the background, called
+**                  at power-on so that the storage read overlaps with the
+**                  controller power-up
+**
+** Returns          None
+**
+*******************************************************************************/
+void hw_config_prefetch_start(void)
+{
+    hw_config_prefetch_wait();
+
+    hw_prefetch_cb.start_us = get_monotonic_time_us();
+    hw_prefetch_cb.done_us = 0;
+    if (pthread_create(&hw_prefetch_cb.thread, NULL, hw_config_prefetch_thread, VND_CTX_THREAD_ARG()) != 0) {
+        HILOGW("patch prefetch thread not started (%d), patch loaded at init", errno);
+        return;
+    }
+    hw_prefetch_cb.running = TRUE;
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_prefetch_wait
+**
+** Description      Wait for a background prefetch to complete and report how
+**                  much of the loading was hidden behind the power-up
+**
+** Returns          TRUE if a prefetch ran, FALSE otherwise
+**
+*******************************************************************************/
+uint8_t hw_config_prefetch_wait(void)
+{
+    uint64_t wait_us = get_monotonic_time_us();
+    uint64_t load_us;
+
+    if (!hw_prefetch_cb.running) {
+        return FALSE;
+    }
+
+    pthread_join(hw_prefetch_cb.thread, NULL);
+    hw_prefetch_cb.running = FALSE;
+
+    wait_us = get_monotonic_time_us() - wait_us;
+    load_us = hw_prefetch_cb.done_us - hw_prefetch_cb.start_us;
+    HILOGI("patch prefetch: %llu us of loading, %llu us hidden behind power-up, waited %llu us",
+        (unsigned long long)load_us, (unsigned long long)((load_us > wait_us) ? (load_us - wait_us) : 0),
+        (unsigned long long)wait_us);
+
+    return TRUE;
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_detect_chip
+**
+** Description      Work out the chipset from its HCI local name, map it
+**                  through the module auto detection table and load the
+**                  matching patch file. The resolved chip to patch file
+**                  mapping is persisted for the next boots. The name is
+**                  read from a copy, the event buffer is left untouched.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_detect_chip(const HC_BT_HDR *p_evt_buf)
+{
+    char local_name[HCI_LOCAL_NAME_LEN];
+    char *p_local_name = local_name;
+    char name[LOCAL_NAME_BUFFER_LEN + 16];
+    char path[FW_PATCHFILE_PATH_MAXLEN];
+    char key[HW_STATE_KEY_LEN];
+    char *p_name;
+    uint16_t len = 0;
+    int i;
+
+    /* a short or truncated event carries less than the full name */
+    if (p_evt_buf->len > HCI_EVT_CMD_CMPL_LOCAL_NAME_STRING) {
+        len = p_evt_buf->len - HCI_EVT_CMD_CMPL_LOCAL_NAME_STRING;
+    }
+    if (len > HCI_LOCAL_NAME_LEN - 1) {
+        len = HCI_LOCAL_NAME_LEN - 1;
+    }
+    if ((len > 0) && (memcpy_s(local_name, sizeof(local_name),
+        (const uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_LOCAL_NAME_STRING, len) != 0)) {
+        len = 0;
+    }
+    local_name[len] = 0;
+
+    for (i = 0; local_name[i] != 0; i++) {
+        local_name[i] = toupper((unsigned char)local_name[i]);
+    }
+
+    if ((p_name = strstr(p_local_name, "BCM")) != NULL) {
+        (void)snprintf_s(hw_cfg_cb.local_chip_name, LOCAL_NAME_BUFFER_LEN, LOCAL_NAME_BUFFER_LEN - 1, "%s", p_name);
+    } else if ((p_name = strstr(p_local_name, "4343")) != NULL) {
+        (void)snprintf_s(hw_cfg_cb.local_chip_name, LOCAL_NAME_BUFFER_LEN, LOCAL_NAME_BUFFER_LEN - 1, "BCM%s", p_name);
+    } else {
+        (void)snprintf_s(hw_cfg_cb.local_chip_name, LOCAL_NAME_BUFFER_LEN, LOCAL_NAME_BUFFER_LEN - 1, "UNKNOWN");
+    }
+
+    /* the local name may carry more than the chip id, e.g. "BCM4345C0 26MHz" */
+    p_name = strpbrk(hw_cfg_cb.local_chip_name, " \t");
+    if (p_name != NULL) {
+        *p_name = 0;
+    }
+
+#if (FW_AUTO_DETECTION == TRUE)
+    for (i = 0; fw_auto_detection_table[i].chip_id != NULL; i++) {
+        if (strstr(p_local_name, fw_auto_detection_table[i].chip_id) != NULL) {
+            HILOGI("detect %s as %s (table %s)", fw_auto_detection_table[i].chip_id,
+                fw_auto_detection_table[i].updated_chip_id, FW_TABLE_VERSION);
+            (void)snprintf_s(hw_cfg_cb.local_chip_name, LOCAL_NAME_BUFFER_LEN, LOCAL_NAME_BUFFER_LEN - 1, "%s",
+                fw_auto_detection_table[i].updated_chip_id);
+            break;
+        }
+    }
+#endif
+
+    HILOGI("Chipset %s", hw_cfg_cb.local_chip_name);
+
+    if (strcpy_s(path, sizeof(path), hw_cfg_cb.local_chip_name) != 0 || !hw_config_findpatch(path) ||
+        (hw_config_load_patch(path) != 0)) {
+        HILOGE("no firmware patch for %s", hw_cfg_cb.local_chip_name);
+        hcd_patch_unload(&hw_cfg_cb.fw_image);
+        return;
+    }
+
+    (void)snprintf_s(name, sizeof(name), sizeof(name) - 1, "FwPatchFile.%s", hw_cfg_cb.local_chip_name);
+    vnd_state_set(vnd_ctx_name("FwChip", key, sizeof(key)), hw_cfg_cb.local_chip_name);
+    vnd_state_set(name, path);
+}
+
+static void fwcfg_timer_handler(void *p_data)
+{
+    cfg_trace_dump(hw_cfg_state_names, HW_CFG_STATE_NUM);
+    userial_vendor_apply_profile();
+    bt_vendor_cbacks->init_cb(BTC_OP_RESULT_SUCCESS);
+}
+static void start_fwcfg_cbtimer(void)
+{
+    /* the timer is kept and only re-armed by the next initialization */
+    if (fwcfg_timer == NULL) {
+        fwcfg_timer = vnd_timer_alloc(fwcfg_timer_handler, NULL);
+    }
+
+    if (vnd_timer_start(fwcfg_timer, BT_VENDOR_CFG_TIMEDELAY_, FALSE) != 0) {
+        fwcfg_timer_handler(NULL);
+    }
+}
+
+void hw_sco_config(void);
+static uint8_t hw_probe_stop(void);
+static int hw_uart_step_down(const char *p_reason);
+static void hw_config_begin(void);
+static void hw_config_restart(void);
+static void hw_config_guard_timeout(void);
+static void hw_config_escalate(void);
+static void hw_config_recover(void);
+static void hw_config_resend(void);
+static void hw_uart_monitor_start(void);
+#if (HOST_WAKE_MONITOR == TRUE)
+static void hw_lpm_host_wake(uint8_t asserted, uint64_t edge_us);
+#endif
+static void hw_uart_rate_cback(void *p_mem);
+
+/*******************************************************************************
+**
+** Function         hw_config_dl_patch_records
+**
+** Description      Keep up to fw_patch_dl_window firmware records in flight.
+**                  The window is capped by the Num_HCI_Command_Packets credits
+**                  of the last command complete, so a controller advertising
+**                  a single credit is driven stop-and-wait.
+**
+** Returns          Number of records sent, -1 if xmit failed
+**
+*******************************************************************************/
+static int hw_config_dl_patch_records(HC_BT_HDR *p_buf, uint8_t credits)
+{
+    hcd_patch_t *p_img = &hw_cfg_cb.fw_image;
+    uint8_t *p = (uint8_t *)(p_buf + 1);
+    uint32_t window = fw_patch_dl_window;
+    uint16_t opcode;
+    int sent = 0;
+
+    if (credits < window) {
+        window = credits;
+    }
+
+    /* never stall with nothing outstanding, even if no credit was reported */
+    if (window == 0) {
+        window = 1;
+    }
+
+    while (hcd_patch_in_flight(p_img) < window) {
+        /* launch RAM only once every patch record has been written */
+        if ((hcd_patch_peek_opcode(p_img) == HCI_VSC_LAUNCH_RAM) && (hcd_patch_in_flight(p_img) > 0)) {
+            break;
+        }
+
+        p_buf->len = hcd_patch_fill_next(p_img, p, HCI_CMD_MAX_LEN, &opcode);
+        if (p_buf->len == 0) {
+            break;
+        }
+
+        if (hw_xmit(opcode, p_buf) == 0) {
+            return -1;
+        }
+        sent++;
+    }
+
+    return sent;
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_send_reset
+**
+** Description      Send down an HCI_RESET
+**
+** Returns          Number of bytes handed to xmit_cb
+**
+*******************************************************************************/
+static int hw_config_send_reset(void)
+{
+    return (int)hw_send_cmd(HCI_RESET, NULL, 0);
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_send_first_record
+**
+** Description      Send the first firmware patch record once the minidriver
+**                  had time to enter download mode. The rest of the image is
+**                  pipelined from hw_config_cback.
+**
+** Returns          Number of bytes handed to xmit_cb
+**
+*******************************************************************************/
+static int hw_config_send_first_record(void)
+{
+    HC_BT_HDR *p_buf = vnd_cmd_get();
+    uint16_t opcode;
+    int xmit_bytes = 0;
+
+    if (p_buf) {
+        p_buf->len = hcd_patch_fill_next(&hw_cfg_cb.fw_image, (uint8_t *)(p_buf + 1), HCI_CMD_MAX_LEN, &opcode);
+
+        if (p_buf->len > 0) {
+            xmit_bytes = hw_xmit(opcode, p_buf);
+        }
+        vnd_cmd_put(p_buf);
+    }
+
+    return xmit_bytes;
+}
+
+/*******************************************************************************
+**
+** Function         hw_probe_timer_handler
+**
+** Description      Readiness probe timer expiry. Either ends the minidriver
+**                  settle wait, re-sends HCI_RESET until the controller
+**                  answers, or restarts the configuration at a lower baud
+**                  rate when a new rate was not answered. The probe sends
+**                  move the configuration cursor too, so hw_cfg_lock is
+**                  taken first, in the order hw_config_event uses.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_probe_timer_handler(void *p_data)
+{
+    uint32_t elapsed_ms;
+    int xmit_bytes = 1;
+    uint8_t restart = FALSE;
+    uint8_t first_record = FALSE;
+
+    pthread_mutex_lock(&hw_cfg_lock);
+    pthread_mutex_lock(&hw_probe_lock);
+    switch (hw_probe_cb.phase) {
+        case HW_PROBE_START:
+            elapsed_ms = (uint32_t)((get_monotonic_time_us() - hw_probe_cb.start_us) / BT_VENDOR_TIME_RAIDX);
+            if (elapsed_ms >= FW_READY_PROBE_BUDGET_MS) {
+                HILOGE("controller does not answer HCI_RESET, %u probes", hw_probe_cb.sent);
+                hw_probe_cb.phase = HW_PROBE_IDLE;
+                xmit_bytes = 0;
+                break;
+            }
+
+            /* a controller left running by a previous session keeps its
+             * working baud rate across HCI_RESET
+             */
+            hw_probe_cb.alt_baud = !hw_probe_cb.alt_baud;
+            userial_vendor_set_baud(hw_probe_cb.alt_baud ? line_speed_to_userial_baud(hw_uart_cb.baud) :
+                USERIAL_BAUD_115200);
+
+            cfg_trace_retry(HCI_RESET);
+            xmit_bytes = hw_config_send_reset();
+            hw_probe_cb.sent++;
+            vnd_timer_start(hw_probe_cb.p_timer, hw_probe_cb.interval_ms, FALSE);
+            break;
+
+        case HW_PROBE_MINIDRV:
+            hw_probe_cb.phase = HW_PROBE_IDLE;
+            xmit_bytes = hw_config_send_first_record();
+            first_record = TRUE;
+            break;
+
+        case HW_PROBE_RESET:
+            elapsed_ms = (uint32_t)((get_monotonic_time_us() - hw_probe_cb.start_us) / BT_VENDOR_TIME_RAIDX);
+            if (elapsed_ms >= FW_READY_PROBE_BUDGET_MS) {
+                HILOGE("controller not ready %u ms after firmware launch, %u probes", elapsed_ms,
+                    hw_probe_cb.sent);
+                hw_probe_cb.phase = HW_PROBE_IDLE;
+                xmit_bytes = 0;
+                break;
+            }
+
+            if (hw_probe_cb.sent > 0) {
+                cfg_trace_retry(HCI_RESET);
+            }
+            xmit_bytes = hw_config_send_reset();
+            hw_probe_cb.sent++;
+            vnd_timer_start(hw_probe_cb.p_timer, hw_probe_cb.interval_ms, FALSE);
+
+            hw_probe_cb.interval_ms *= 2; /* 2: backoff factor */
+            if (hw_probe_cb.interval_ms > FW_READY_PROBE_MAX_INTERVAL_MS) {
+                hw_probe_cb.interval_ms = FW_READY_PROBE_MAX_INTERVAL_MS;
+            }
+            break;
+
+        case HW_PROBE_BAUD:
+            hw_probe_cb.phase = HW_PROBE_IDLE;
+            restart = TRUE;
+            break;
+
+        default:
+            break;
+    }
+    pthread_mutex_unlock(&hw_probe_lock);
+
+    if (restart) {
+        if (hw_uart_step_down("not answered") == 0) {
+            cfg_trace_retry(HCI_VSC_UPDATE_BAUDRATE);
+            hw_config_restart();
+            pthread_mutex_unlock(&hw_cfg_lock);
+            return;
+        }
+        xmit_bytes = 0;
+    }
+
+    if (xmit_bytes <= 0) {
+        /* the probe has retried on its own already */
+        hw_probe_stop();
+        hw_config_escalate();
+    } else if (first_record) {
+        hw_config_guard_timeout();
+    }
+    pthread_mutex_unlock(&hw_cfg_lock);
+}
+
+/*******************************************************************************
+**
+** Function         hw_probe_start
+**
+** Description      Enter a readiness probe phase. The first probe (or the
+**                  end of the minidriver wait) happens after delay_ms.
+**
+** Returns          0 : Success
+**                  Otherwise : Fail
+**
+*******************************************************************************/
+static int hw_probe_start(uint8_t phase, uint32_t delay_ms)
+{
+    int ret = 0;
+
+    pthread_mutex_lock(&hw_probe_lock);
+    if (hw_probe_cb.p_timer == NULL) {
+        hw_probe_cb.p_timer = vnd_timer_alloc(hw_probe_timer_handler, NULL);
+    }
+
+    hw_probe_cb.phase = phase;
+    hw_probe_cb.interval_ms = (phase == HW_PROBE_START) ? FW_START_PROBE_TIMEOUT_MS : FW_READY_PROBE_INTERVAL_MS;
+    hw_probe_cb.sent = 0;
+    hw_probe_cb.alt_baud = FALSE;
+    hw_probe_cb.start_us = get_monotonic_time_us();
+
+    if (vnd_timer_start(hw_probe_cb.p_timer, delay_ms, FALSE) != 0) {
+        hw_probe_cb.phase = HW_PROBE_IDLE;
+        ret = -1;
+    }
+    pthread_mutex_unlock(&hw_probe_lock);
+
+    return ret;
+}
+
+/*******************************************************************************
+**
+** Function         hw_probe_stop
+**
+** Description      Leave the current readiness probe phase. If the relaunched
+**                  firmware just answered, its settle time is logged and
+**                  persisted for the next boots.
+**
+** Returns          The phase that was left
+**
+*******************************************************************************/
+static uint8_t hw_probe_stop(void)
+{
+    char name[LOCAL_NAME_BUFFER_LEN + 16];
+    uint32_t settle_ms;
+    int learned;
+    uint8_t phase;
+
+    pthread_mutex_lock(&hw_probe_lock);
+    phase = hw_probe_cb.phase;
+    hw_probe_cb.phase = HW_PROBE_IDLE;
+    vnd_timer_stop(hw_probe_cb.p_timer);
+    settle_ms = (uint32_t)((get_monotonic_time_us() - hw_probe_cb.start_us) / BT_VENDOR_TIME_RAIDX);
+    pthread_mutex_unlock(&hw_probe_lock);
+
+    if ((phase == HW_PROBE_START) && hw_probe_cb.alt_baud) {
+        HILOGI("controller answered at %u baud", hw_uart_cb.baud);
+    }
+
+    if (phase != HW_PROBE_RESET) {
+        return phase;
+    }
+
+    HILOGI("controller ready %u ms after firmware launch, %u probes", settle_ms, hw_probe_cb.sent);
+
+    /* The first probe being answered only tells the firmware was back
+     * earlier, so move the next boot's first probe one interval closer.
+     */
+    if ((hw_probe_cb.sent <= 1) && (settle_ms > FW_READY_PROBE_INTERVAL_MS)) {
+        settle_ms -= FW_READY_PROBE_INTERVAL_MS;
+    }
+
+    /* keep the state file stable while the measure stays within a probe interval */
+    fw_settle_state_name(name, sizeof(name));
+    learned = vnd_state_get_int(name, -1);
+    if ((learned < 0) || (abs((int)settle_ms - learned) >= FW_READY_PROBE_INTERVAL_MS)) {
+        vnd_state_set_int(name, (int)settle_ms);
+    }
+
+    return phase;
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_guard_handler
+**
+** Description      Configuration timer expiry: either the backoff before a
+**                  retry ended, or the current state was not answered in
+**                  time. An expiry standing for an older deadline follows
+**                  the deadline instead.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_guard_handler(void *p_data)
+{
+    uint64_t now = get_monotonic_time_us();
+    uint8_t phase;
+
+    pthread_mutex_lock(&hw_cfg_lock);
+    hw_recov_cb.armed = FALSE;
+    if ((hw_cfg_cb.state == 0) || (hw_recov_cb.due_us == 0)) {
+        pthread_mutex_unlock(&hw_cfg_lock);
+        return;
+    }
+
+    /* the deadline moved on while the timer ran, 1000: timer slack in us */
+    if (now + 1000 < hw_recov_cb.due_us) {
+        hw_recov_cb.armed = (vnd_timer_start(hw_recov_cb.p_timer,
+            (uint32_t)((hw_recov_cb.due_us - now + BT_VENDOR_TIME_RAIDX - 1) / BT_VENDOR_TIME_RAIDX), FALSE) == 0);
+        pthread_mutex_unlock(&hw_cfg_lock);
+        return;
+    }
+    hw_recov_cb.due_us = 0;
+
+    if (hw_recov_cb.backoff) {
+        hw_recov_cb.backoff = FALSE;
+        hw_config_resend();
+        pthread_mutex_unlock(&hw_cfg_lock);
+        return;
+    }
+
+    pthread_mutex_lock(&hw_probe_lock);
+    phase = hw_probe_cb.phase;
+    pthread_mutex_unlock(&hw_probe_lock);
+
+    if (phase != HW_PROBE_IDLE) {
+        /* the readiness probe keeps its own time meanwhile */
+        hw_config_guard_timeout();
+    } else {
+        hw_recov_cb.timeouts++;
+        HILOGW("configuration not answered in state %s", hw_cfg_state_names[hw_cfg_cb.state]);
+        hw_config_recover();
+    }
+    pthread_mutex_unlock(&hw_cfg_lock);
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_guard_arm
+**
+** Description      Set the configuration deadline. A running timer expiring
+**                  earlier is left alone, so that patch records answered in
+**                  a row do not re-arm it every time.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_guard_arm(uint32_t ms)
+{
+    uint64_t due_us = get_monotonic_time_us() + (uint64_t)ms * BT_VENDOR_TIME_RAIDX;
+
+    if (hw_recov_cb.p_timer == NULL) {
+        hw_recov_cb.p_timer = vnd_timer_alloc(hw_config_guard_handler, NULL);
+    }
+
+    if (!hw_recov_cb.armed || (due_us < hw_recov_cb.due_us)) {
+        hw_recov_cb.armed = (vnd_timer_start(hw_recov_cb.p_timer, ms, FALSE) == 0);
+    }
+    hw_recov_cb.due_us = due_us;
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_guard_timeout
+**
+** Description      Wait for the answer of the current state, the timeout
+**                  doubles with every retry
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_guard_timeout(void)
+{
+    hw_config_guard_arm((uint32_t)hw_cfg_state_timeouts[hw_cfg_cb.state] << hw_recov_cb.retries);
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_guard_stop
+**
+** Description      Stop the configuration timer and forget any pending retry
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_guard_stop(void)
+{
+    hw_recov_cb.backoff = FALSE;
+    hw_recov_cb.due_us = 0;
+    hw_recov_cb.armed = FALSE;
+    vnd_timer_stop(hw_recov_cb.p_timer);
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_abort
+**
+** Description      Give the configuration up and report it to the stack
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_abort(void)
+{
+    hw_recov_cb.failures++;
+    hw_config_guard_stop();
+    hw_probe_stop();
+
+    HILOGE("vendor lib fwcfg aborted!!!");
+    cfg_trace_dump(hw_cfg_state_names, HW_CFG_STATE_NUM);
+    if (bt_vendor_cbacks) {
+        bt_vendor_cbacks->init_cb(BTC_OP_RESULT_FAIL);
+    }
+
+    hcd_patch_unload(&hw_cfg_cb.fw_image);
+
+    hw_config_set_state(0);
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_escalate
+**
+** Description      Retrying in place did not help: power cycle the controller
+**                  and configure it again, or give up once the restarts are
+**                  used up
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_escalate(void)
+{
+    if ((hw_recov_cb.restarts >= FW_CFG_MAX_RESTARTS) || (bt_vendor_cbacks == NULL)) {
+        hw_config_abort();
+        return;
+    }
+
+    hw_recov_cb.restarts++;
+    hw_recov_cb.power_cycles++;
+    HILOGW("configuration stuck in state %s, power cycle %u", hw_cfg_state_names[hw_cfg_cb.state],
+        hw_recov_cb.restarts);
+    cfg_trace_retry(HCI_RESET);
+    hw_config_restart();
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_recover
+**
+** Description      Retry the current state after a backoff, the answers
+**                  still on their way meanwhile are dropped. Escalates once
+**                  the retries are used up.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_recover(void)
+{
+    uint32_t backoff_ms;
+
+    if ((hw_recov_cb.retries >= FW_CFG_MAX_RETRIES) || (bt_vendor_cbacks == NULL)) {
+        hw_config_escalate();
+        return;
+    }
+
+    backoff_ms = (uint32_t)FW_CFG_RETRY_BACKOFF_MS << hw_recov_cb.retries;
+    hw_recov_cb.retries++;
+    hw_recov_cb.backoff = TRUE;
+    hw_recov_cb.armed = FALSE; /* the backoff always takes over the timer */
+    hw_config_guard_arm(backoff_ms);
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_resume_patch
+**
+** Description      Send the patch records again from the oldest one not
+**                  acknowledged. Records are plain memory writes, so one
+**                  executed twice does no harm. The window reopens with the
+**                  credits of the next command complete.
+**
+** Returns          Number of records sent, -1 if xmit failed
+**
+*******************************************************************************/
+static int hw_config_resume_patch(HC_BT_HDR *p_buf)
+{
+    hcd_patch_t *p_img = &hw_cfg_cb.fw_image;
+    uint32_t lost = hcd_patch_resume(p_img);
+
+    HILOGW("resume patch download at record %u of %u, %u records again", p_img->acked, p_img->rec_count, lost);
+    hw_recov_cb.resumes++;
+    cfg_trace_retry(hcd_patch_peek_opcode(p_img));
+
+    return hw_config_dl_patch_records(p_buf, 1);
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_resend
+**
+** Description      Retry the current configuration state from its cheapest
+**                  safe point: the patch download resumes, any other command
+**                  is sent again. The controller may have switched its baud
+**                  rate with only the answer lost, and a switch to the rate
+**                  it runs at is harmless, so a baud rate switch is repeated
+**                  alternately at the old and the new rate.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_resend(void)
+{
+    HC_BT_HDR *p_buf = vnd_cmd_get();
+    int xmit_bytes = 0;
+
+    if (p_buf == NULL) {
+        hw_config_escalate();
+        return;
+    }
+
+    switch (hw_cfg_cb.state) {
+        case HW_CFG_DL_FW_PATCH:
+            xmit_bytes = hw_config_resume_patch(p_buf);
+            break;
+
+        case HW_CFG_SET_UART_BAUD_1:
+        case HW_CFG_SET_UART_BAUD_2:
+            userial_vendor_set_baud((hw_recov_cb.retries & 1) ? USERIAL_BAUD_115200 :
+                line_speed_to_userial_baud(hw_uart_cb.baud));
+            /* fall through intentionally */
+        default:
+            if (memcpy_s(p_buf + 1, HCI_CMD_MAX_LEN, hw_recov_cb.cmd, hw_recov_cb.len) != 0) {
+                break;
+            }
+            p_buf->len = hw_recov_cb.len;
+
+            HILOGW("send 0x%04x again in state %s", hw_recov_cb.opcode, hw_cfg_state_names[hw_cfg_cb.state]);
+            hw_recov_cb.resends++;
+            cfg_trace_retry(hw_recov_cb.opcode);
+            xmit_bytes = (int)hw_xmit(hw_recov_cb.opcode, p_buf);
+
+            /* the answer verifies the new baud rate again */
+            if ((xmit_bytes > 0) && ((hw_cfg_cb.state == HW_CFG_READ_LOCAL_NAME) ||
+                (hw_cfg_cb.state == HW_CFG_READ_PATCHED_VERSION)) &&
+                (hw_probe_start(HW_PROBE_BAUD, UART_BAUD_VERIFY_TIMEOUT_MS) != 0)) {
+                xmit_bytes = 0;
+            }
+            break;
+    }
+    vnd_cmd_put(p_buf);
+
+    if (xmit_bytes <= 0) {
+        hw_recov_cb.errors++;
+        hw_config_recover();
+        return;
+    }
+    hw_config_guard_timeout();
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_event
+**
+** Description      Move the controller configuration on with a command
+**                  complete
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_event(HC_BT_HDR *p_evt_buf)
+{
+    char *p_name, *p_tmp;
+    uint8_t *p, status, credits;
+    uint16_t opcode;
+    HC_BT_HDR *p_buf = NULL;
+    ssize_t xmit_bytes = 0;
+    int i;
+    int delay = 100;
+#if (USE_CONTROLLER_BDADDR == TRUE)
+    const uint8_t null_bdaddr[BD_ADDR_LEN] = {0, 0, 0, 0, 0, 0};
+#endif
+
+    status = *((uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_STATUS_RET_BYTE);
+    credits = *((uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_NUM_PACKETS);
+    p = (uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_OPCODE;
+    STREAM_TO_UINT16(opcode, p);
+
+    /* an answer to a command sent before the timeout, or a repeated one */
+    if (hw_recov_cb.backoff) {
+        HILOGW("drop 0x%04x complete while waiting to retry", opcode);
+        return;
+    }
+
+    if (opcode == HCI_RESET) {
+        /* a readiness probe may be answered more than once, only the first
+         * command complete moves the configuration on
+         */
+        if (hw_cfg_cb.state != HW_CFG_START) {
+            HILOGW("ignore HCI_RESET complete in state %d", hw_cfg_cb.state);
+            return;
+        }
+        hw_probe_stop();
+    }
+
+    /* the first answer at a new baud rate verifies it, unless the verify
+     * timeout has already stepped the rate down
+     */
+    if (((hw_cfg_cb.state == HW_CFG_READ_LOCAL_NAME) || (hw_cfg_cb.state == HW_CFG_READ_PATCHED_VERSION)) &&
+        (hw_probe_stop() != HW_PROBE_BAUD)) {
+        HILOGW("ignore late answer at %u baud", hw_uart_cb.baud);
+        return;
+    }
+
+    /* Take a pool buffer big enough to hold any HCI commands sent in here */
+    if ((status == 0) && bt_vendor_cbacks)
+        p_buf = vnd_cmd_get();
+
+    if (p_buf != NULL) {
+        p = (uint8_t *)(p_buf + 1);
+        switch (hw_cfg_cb.state) {
+            case HW_CFG_SET_UART_BAUD_1:
+                /* update baud rate of host's UART port */
+                HILOGI("bt vendor lib: set UART baud %u", hw_uart_cb.baud);
+                userial_vendor_set_baud(line_speed_to_userial_baud(hw_uart_cb.baud));
+
+                /* read local name, its answer also verifies the new rate */
+                UINT16_TO_STREAM(p, HCI_READ_LOCAL_NAME);
+                *p = 0; /* parameter length */
+
+                p_buf->len = HCI_CMD_PREAMBLE_SIZE;
+                hw_config_set_state(HW_CFG_READ_LOCAL_NAME);
+
+                xmit_bytes = hw_xmit(HCI_READ_LOCAL_NAME, p_buf);
+                if ((xmit_bytes > 0) && (hw_probe_start(HW_PROBE_BAUD, UART_BAUD_VERIFY_TIMEOUT_MS) != 0)) {
+                    xmit_bytes = 0;
+                }
+                break;
+
+            case HW_CFG_READ_LOCAL_NAME:
+                hw_config_detect_chip(p_evt_buf);
+
+                /* find out whether the controller still runs our patch */
+                if (hcd_patch_is_loaded(&hw_cfg_cb.fw_image) &&
+                    (xmit_bytes = hw_config_read_local_version(p_buf, HW_CFG_READ_LOCAL_VERSION)) > 0) {
+                    break;
+                }
+                /* fall through intentionally */
+            case HW_CFG_READ_LOCAL_VERSION:
+                if (hw_cfg_cb.state == HW_CFG_READ_LOCAL_VERSION) {
+                    hw_cfg_cb.rom_version = hw_config_parse_version(p_evt_buf);
+                    if (hw_config_is_patched(hw_cfg_cb.rom_version)) {
+                        /* warm restart: go straight to BD_ADDR programming */
+                        HILOGI("controller already runs the firmware patch, skip download");
+                        hcd_patch_unload(&hw_cfg_cb.fw_image);
+#if (USE_CONTROLLER_BDADDR == TRUE)
+                        xmit_bytes = hw_config_read_bdaddr(p_buf);
+#else
+                        xmit_bytes = hw_config_set_bdaddr(p_buf);
+#endif
+                        break;
+                    }
+                }
+            {
+                /* the patch image has been mapped and indexed beforehand */
+                if (!hcd_patch_is_loaded(&hw_cfg_cb.fw_image)) {
+                    HILOGE("vendor lib preload failed, no valid firmware patch image");
+                } else {
+                    /* vsc_download_minidriver */
+                    UINT16_TO_STREAM(p, HCI_VSC_DOWNLOAD_MINIDRV);
+                    *p = 0; /* parameter length */
+
+                    p_buf->len = HCI_CMD_PREAMBLE_SIZE;
+                    hw_config_set_state(HW_CFG_DL_MINIDRIVER);
+
+                    xmit_bytes = hw_xmit(HCI_VSC_DOWNLOAD_MINIDRV, p_buf);
+                }
+            }
+
+                if (xmit_bytes <= 0) {
+                    HILOGE("vendor lib preload failed to locate firmware patch file and set bdaddr");
+                    xmit_bytes = hw_config_set_bdaddr(p_buf);
+                }
+                break;
+
+            case HW_CFG_DL_MINIDRIVER:
+                /* give time for placing firmware in download mode, the first
+                 * record is sent from the probe timer
+                 */
+                hw_config_set_state(HW_CFG_DL_FW_PATCH);
+                xmit_bytes = (hw_probe_start(HW_PROBE_MINIDRV, FW_MINIDRV_SETTLE_MS) == 0) ? 1 : 0;
+                break;
+
+            case HW_CFG_DL_FW_PATCH:
+                if (opcode == HCI_VSC_WRITE_FIRMWARE || opcode == HCI_VSC_LAUNCH_RAM) {
+                    hcd_patch_record_acked(&hw_cfg_cb.fw_image);
+                    hw_recov_cb.retries = 0; /* the download moves on */
+                }
+
+                /* records are fed straight out of the in-memory index */
+                if (opcode != HCI_VSC_LAUNCH_RAM) {
+                    if (hw_config_dl_patch_records(p_buf, credits) < 0) {
+                        xmit_bytes = 0;
+                        break;
+                    }
+
+                    /* wait for the command complete of the records in flight */
+                    if (hcd_patch_in_flight(&hw_cfg_cb.fw_image) > 0) {
+                        xmit_bytes = 1;
+                        break;
+                    }
+                }
+
+                hcd_patch_report(&hw_cfg_cb.fw_image);
+                cfg_trace_patch(hw_cfg_cb.fw_image.acked, hw_cfg_cb.fw_image.bytes_sent);
+                hcd_patch_unload(&hw_cfg_cb.fw_image);
+
+                /* Normally the firmware patch configuration file
                  * sets the new starting baud rate at 115200.
                  * So, we need update host's baud rate accordingly.
                  */
@@ -736,144 +2053,511 @@ void hw_config_cback(void *p_mem)
                 */
                 hw_cfg_cb.f_set_baud_2 = TRUE;
 
-                /* Check if we need to pause a few hundred milliseconds
-                * before sending down any HCI command.
-                */
-                delay = look_up_fw_settlement_delay();
-                HILOGI("Setting fw settlement delay to %d ", delay);
-                ms_delay(delay);
+                /* Poll the relaunched firmware with HCI_RESET until it
+                * answers, starting when it is expected back.
+                */
+                delay = look_up_fw_settlement_delay();
+                HILOGI("First readiness probe in %d ms", delay);
+                hw_config_set_state(HW_CFG_START);
+                xmit_bytes = (hw_probe_start(HW_PROBE_RESET, delay) == 0) ? 1 : 0;
+                break;
+
+            case HW_CFG_START:
+                if (hw_uart_cb.baud > USERIAL_LINESPEED_3M) {
+                    /* set UART clock to 48MHz */
+                    UINT16_TO_STREAM(p, HCI_VSC_WRITE_UART_CLOCK_SETTING);
+                    *p++ = 1; /* parameter length */
+                    *p = 1;   /* (1,"UART CLOCK 48 MHz")(2,"UART CLOCK 24 MHz") */
+
+                    p_buf->len = HCI_CMD_PREAMBLE_SIZE + 1;
+                    hw_config_set_state(HW_CFG_SET_UART_CLOCK);
+
+                    xmit_bytes = hw_xmit(HCI_VSC_WRITE_UART_CLOCK_SETTING, p_buf);
+                    break;
+                }
+                /* fall through intentionally */
+            case HW_CFG_SET_UART_CLOCK:
+                /* set controller's UART baud rate to 3M */
+                UINT16_TO_STREAM(p, HCI_VSC_UPDATE_BAUDRATE);
+                *p++ = UPDATE_BAUDRATE_CMD_PARAM_SIZE; /* parameter length */
+                *p++ = 0;                              /* encoded baud rate */
+                *p++ = 0;                              /* use encoded form */
+                UINT32_TO_STREAM(p, hw_uart_cb.baud);
+
+                p_buf->len = HCI_CMD_PREAMBLE_SIZE +
+                             UPDATE_BAUDRATE_CMD_PARAM_SIZE;
+                hw_config_set_state((hw_cfg_cb.f_set_baud_2) ? HW_CFG_SET_UART_BAUD_2 : HW_CFG_SET_UART_BAUD_1);
+
+                xmit_bytes = hw_xmit(HCI_VSC_UPDATE_BAUDRATE, p_buf);
+                break;
+
+            case HW_CFG_SET_UART_BAUD_2:
+                /* update baud rate of host's UART port */
+                HILOGI("bt vendor lib: set UART baud %u", hw_uart_cb.baud);
+                userial_vendor_set_baud(
+                    line_speed_to_userial_baud(hw_uart_cb.baud));
+
+                /* remember what the freshly patched firmware reports, the
+                 * answer also verifies the new rate
+                 */
+                if ((xmit_bytes = hw_config_read_local_version(p_buf, HW_CFG_READ_PATCHED_VERSION)) > 0) {
+                    if (hw_probe_start(HW_PROBE_BAUD, UART_BAUD_VERIFY_TIMEOUT_MS) != 0) {
+                        xmit_bytes = 0;
+                    }
+                    break;
+                }
+                /* fall through intentionally */
+            case HW_CFG_READ_PATCHED_VERSION:
+                if (hw_cfg_cb.state == HW_CFG_READ_PATCHED_VERSION) {
+                    hw_config_save_patched_version(hw_config_parse_version(p_evt_buf));
+                }
+
+#if (USE_CONTROLLER_BDADDR == TRUE)
+                if ((xmit_bytes = hw_config_read_bdaddr(p_buf)) > 0)
+                    break;
+#else
+                if ((xmit_bytes = hw_config_set_bdaddr(p_buf)) > 0)
+                    break;
+#endif
+                /* fall through intentionally */
+            case HW_CFG_SET_BD_ADDR:
+                HILOGI("vendor lib fwcfg completed");
+                // bt_vendor_cbacks->fwcfg_cb(BT_VND_OP_RESULT_SUCCESS);
+                hw_sco_config();
+                hw_uart_monitor_start();
+                start_fwcfg_cbtimer();
+
+                hw_config_set_state(0);
+
+                hcd_patch_unload(&hw_cfg_cb.fw_image);
+
+                xmit_bytes = 1;
+                break;
+
+#if (USE_CONTROLLER_BDADDR == TRUE)
+            case HW_CFG_READ_BD_ADDR:
+                p_tmp = (char *)(p_evt_buf + 1) +
+                        HCI_EVT_CMD_CMPL_LOCAL_BDADDR_ARRAY;
+                HILOGI("entering HW_CFG_READ_BD_ADDR");
+                if (memcmp(p_tmp, null_bdaddr, BD_ADDR_LEN) == 0) {
+                    HILOGI("entering HW_CFG_READ_BD_ADDR");
+                    // Controller does not have a valid OTP BDADDR!
+                    // Set the BTIF initial BDADDR instead.
+                    if ((xmit_bytes = hw_config_set_bdaddr(p_buf)) > 0)
+                        break;
+                } else {
+                    HILOGI("Controller OTP bdaddr %02X:%02X:%02X:%02X:%02X:%02X",
+                           *(p_tmp + 5), *(p_tmp + 4), *(p_tmp + 3),
+                           *(p_tmp + 2), *(p_tmp + 1), *p_tmp);
+                }
+
+                HILOGI("vendor lib fwcfg completed2");
+                // bt_vendor_cbacks->fwcfg_cb(BT_VND_OP_RESULT_SUCCESS);
+                hw_sco_config();
+                hw_uart_monitor_start();
+                start_fwcfg_cbtimer();
+
+                hw_config_set_state(0);
+
+                hcd_patch_unload(&hw_cfg_cb.fw_image);
+
+                xmit_bytes = 1;
+                break;
+#endif      // (USE_CONTROLLER_BDADDR == TRUE)
+        } // switch(hw_cfg_cb.state)
+
+        vnd_cmd_put(p_buf);
+    }     // if (p_buf != NULL)
+
+    /* Free the RX event buffer */
+    // if (bt_vendor_cbacks)
+    //  bt_vendor_cbacks->dealloc(p_evt_buf);
+
+    if (xmit_bytes <= 0) {
+        HILOGW("configuration 0x%04x failed in state %s, status 0x%02x", opcode,
+            hw_cfg_state_names[hw_cfg_cb.state], status);
+        hw_recov_cb.errors++;
+        hw_config_recover();
+    } else if (hw_cfg_cb.state != 0) {
+        hw_config_guard_timeout();
+    } else {
+        hw_config_guard_stop();
+    }
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_cback
+**
+** Description      Callback function for controller configuration
+**
+** Returns          None
+**
+*******************************************************************************/
+void hw_config_cback(void *p_mem)
+{
+    pthread_mutex_lock(&hw_cfg_lock);
+    hw_config_event((HC_BT_HDR *)p_mem);
+    pthread_mutex_unlock(&hw_cfg_lock);
+}
+
+/******************************************************************************
+**   UART Rate Functions
+******************************************************************************/
+
+/*******************************************************************************
+**
+** Function         hw_uart_next_baud
+**
+** Description      Next rate of the negotiation ladder below the given one
+**
+** Returns          Line speed, 0 if the ladder is exhausted
+**
+*******************************************************************************/
+static uint32_t hw_uart_next_baud(uint32_t baud)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(uart_baud_ladder) / sizeof(uart_baud_ladder[0]); i++) {
+        if (uart_baud_ladder[i] < baud) {
+            return uart_baud_ladder[i];
+        }
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function         hw_uart_prev_baud
+**
+** Description      Next faster rate of the ladder, capped by the
+**                  UartTargetBaudRate tunable
+**
+** Returns          The rate, 0 when the given rate is the fastest allowed
+**
+*******************************************************************************/
+static uint32_t hw_uart_prev_baud(uint32_t baud)
+{
+    uint32_t i = sizeof(uart_baud_ladder) / sizeof(uart_baud_ladder[0]);
+
+    while (i-- > 0) {
+        if ((uart_baud_ladder[i] > baud) && (uart_baud_ladder[i] <= hw_uart_target_baud)) {
+            return uart_baud_ladder[i];
+        }
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function         hw_uart_baud_init
+**
+** Description      Pick the working rate: the highest rate found stable on
+**                  this device by a previous run, capped by the
+**                  UartTargetBaudRate tunable
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_uart_baud_init(void)
+{
+    char key[HW_STATE_KEY_LEN];
+    int learned = vnd_state_get_int(vnd_ctx_name("UartBaudRate", key, sizeof(key)), 0);
+
+    hw_uart_cb.baud = hw_uart_target_baud;
+    hw_uart_cb.pending_baud = 0;
+    if ((learned > 0) && ((uint32_t)learned < hw_uart_cb.baud)) {
+        hw_uart_cb.baud = (uint32_t)learned;
+    }
+
+    HILOGI("UART working rate %u (max %u)", hw_uart_cb.baud, hw_uart_target_baud);
+}
+
+/*******************************************************************************
+**
+** Function         hw_uart_step_down
+**
+** Description      Drop the working rate one step and persist it
+**
+** Returns          0 : Success
+**                  Otherwise : no lower rate left
+**
+*******************************************************************************/
+static int hw_uart_step_down(const char *p_reason)
+{
+    uint32_t next = hw_uart_next_baud(hw_uart_cb.baud);
+    char key[HW_STATE_KEY_LEN];
+
+    if (next == 0) {
+        HILOGE("UART %s at %u baud, no lower rate left", p_reason, hw_uart_cb.baud);
+        return -1;
+    }
+
+    HILOGW("UART %s at %u baud, stepping down to %u", p_reason, hw_uart_cb.baud, next);
+    hw_uart_cb.baud = next;
+    vnd_state_set_int(vnd_ctx_name("UartBaudRate", key, sizeof(key)), (int)next);
+
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function         hw_config_restart
+**
+** Description      Power cycle the controller and run the configuration
+**                  again from 115200 baud. Broadcom controllers keep their
+**                  baud rate across HCI_RESET, so this is the only way back
+**                  from a rate the wiring does not carry.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_config_restart(void)
+{
+    HILOGW("restart controller configuration at %u baud", hw_uart_cb.baud);
+
+    upio_set_bluetooth_power(UPIO_BT_POWER_OFF);
+    upio_set_bluetooth_power(UPIO_BT_POWER_ON);
+    userial_vendor_set_baud(USERIAL_BAUD_115200);
 
-                p_buf->len = HCI_CMD_PREAMBLE_SIZE;
-                UINT16_TO_STREAM(p, HCI_RESET);
-                *p = 0; /* parameter length */
-                hw_cfg_cb.state = HW_CFG_START;
-                xmit_bytes = bt_vendor_cbacks->xmit_cb(HCI_RESET, p_buf);
-                break;
+    hw_config_begin();
+}
 
-            case HW_CFG_START:
-                if (UART_TARGET_BAUD_RATE > 3000000) {  /* 3000000 */
-                    /* set UART clock to 48MHz */
-                    UINT16_TO_STREAM(p, HCI_VSC_WRITE_UART_CLOCK_SETTING);
-                    *p++ = 1; /* parameter length */
-                    *p = 1;   /* (1,"UART CLOCK 48 MHz")(2,"UART CLOCK 24 MHz") */
+/*******************************************************************************
+**
+** Function         hw_uart_send_baud
+**
+** Description      Ask the controller to switch to the given rate, the host
+**                  follows on its command complete. Frames in flight meanwhile
+**                  are garbled, so the monitor only calls it on an idle link.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_uart_send_baud(uint32_t baud)
+{
+    uint8_t param[UPDATE_BAUDRATE_CMD_PARAM_SIZE];
+    uint8_t *p = param;
 
-                    p_buf->len = HCI_CMD_PREAMBLE_SIZE + 1;
-                    hw_cfg_cb.state = HW_CFG_SET_UART_CLOCK;
+    *p++ = 0; /* encoded baud rate */
+    *p++ = 0; /* use encoded form */
+    UINT32_TO_STREAM(p, baud);
 
-                    xmit_bytes = bt_vendor_cbacks->xmit_cb(HCI_VSC_WRITE_UART_CLOCK_SETTING, p_buf);
-                    break;
-                }
-                /* fall through intentionally */
-            case HW_CFG_SET_UART_CLOCK:
-                /* set controller's UART baud rate to 3M */
-                UINT16_TO_STREAM(p, HCI_VSC_UPDATE_BAUDRATE);
-                *p++ = UPDATE_BAUDRATE_CMD_PARAM_SIZE; /* parameter length */
-                *p++ = 0;                              /* encoded baud rate */
-                *p++ = 0;                              /* use encoded form */
-                UINT32_TO_STREAM(p, UART_TARGET_BAUD_RATE);
+    hw_uart_cb.pending_baud = baud;
+    if (!cmd_sched_send(HCI_VSC_UPDATE_BAUDRATE, param, UPDATE_BAUDRATE_CMD_PARAM_SIZE, CMD_SCHED_PRIO_BULK,
+        hw_uart_rate_cback)) {
+        hw_uart_cb.pending_baud = 0;
+    }
+}
 
-                p_buf->len = HCI_CMD_PREAMBLE_SIZE +
-                             UPDATE_BAUDRATE_CMD_PARAM_SIZE;
-                hw_cfg_cb.state = (hw_cfg_cb.f_set_baud_2) ? HW_CFG_SET_UART_BAUD_2 : HW_CFG_SET_UART_BAUD_1;
+/*******************************************************************************
+**
+** Function         hw_uart_rate_cback
+**
+** Description      Command complete of a run-time rate change, NULL when
+**                  the scheduler gave the command up
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_uart_rate_cback(void *p_mem)
+{
+    HC_BT_HDR *p_evt_buf = (HC_BT_HDR *)p_mem;
+    char key[HW_STATE_KEY_LEN];
+    uint8_t status = 0xFF;
 
-                xmit_bytes = bt_vendor_cbacks->xmit_cb(HCI_VSC_UPDATE_BAUDRATE, p_buf);
-                break;
+    if (hw_uart_cb.pending_baud == 0) {
+        return;
+    }
 
-            case HW_CFG_SET_UART_BAUD_2:
-                /* update baud rate of host's UART port */
-                HILOGI("bt vendor lib: set UART baud %i", UART_TARGET_BAUD_RATE);
-                userial_vendor_set_baud(
-                    line_speed_to_userial_baud(UART_TARGET_BAUD_RATE));
+    if (p_evt_buf != NULL) {
+        status = *((uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_STATUS_RET_BYTE);
+    }
 
-#if (USE_CONTROLLER_BDADDR == TRUE)
-                if ((xmit_bytes = hw_config_read_bdaddr(p_buf)) > 0)
-                    break;
-#else
-                if ((xmit_bytes = hw_config_set_bdaddr(p_buf)) > 0)
-                    break;
-#endif
-                /* fall through intentionally */
-            case HW_CFG_SET_BD_ADDR:
-                HILOGI("vendor lib fwcfg completed");
-                // bt_vendor_cbacks->fwcfg_cb(BT_VND_OP_RESULT_SUCCESS);
-                hw_sco_config();
-                start_fwcfg_cbtimer();
+    if (status == 0) {
+        userial_vendor_set_baud(line_speed_to_userial_baud(hw_uart_cb.pending_baud));
+        hw_uart_cb.stepped_up = (hw_uart_cb.pending_baud > hw_uart_cb.baud);
+        hw_uart_cb.baud = hw_uart_cb.pending_baud;
+        vnd_state_set_int(vnd_ctx_name("UartBaudRate", key, sizeof(key)), (int)hw_uart_cb.baud);
+        HILOGI("UART now at %u baud", hw_uart_cb.baud);
+    } else {
+        HILOGE("UART change to %u refused (0x%02x)", hw_uart_cb.pending_baud, status);
+    }
 
-                hw_cfg_cb.state = 0;
+    hw_uart_cb.pending_baud = 0;
+    hw_uart_cb.clean_us = get_monotonic_time_us();
+    (void)userial_vendor_get_icount(&hw_uart_cb.frame, &hw_uart_cb.overrun, &hw_uart_cb.rx);
+}
 
-                if (hw_cfg_cb.fw_fd != -1) {
-                    close(hw_cfg_cb.fw_fd);
-                    hw_cfg_cb.fw_fd = -1;
-                }
+/*******************************************************************************
+**
+** Function         hw_uart_monitor_cback
+**
+** Description      Sample the UART error counters. Plan a step down when the
+**                  error rate passes UART_ERR_RATE_THRESHOLD_PPM, a step up
+**                  after an error free window, and send the planned change
+**                  once the link is idle.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_uart_monitor_cback(void *p_data)
+{
+    uint32_t frame, overrun, rx;
+    uint32_t errors, bytes;
+    uint32_t next;
+    uint64_t now;
+    uint8_t idle;
 
-                xmit_bytes = 1;
-                break;
+    if ((hw_uart_cb.pending_baud != 0) || (userial_vendor_get_icount(&frame, &overrun, &rx) != 0)) {
+        return;
+    }
 
-#if (USE_CONTROLLER_BDADDR == TRUE)
-            case HW_CFG_READ_BD_ADDR:
-                p_tmp = (char *)(p_evt_buf + 1) +
-                        HCI_EVT_CMD_CMPL_LOCAL_BDADDR_ARRAY;
-                HILOGI("entering HW_CFG_READ_BD_ADDR");
-                if (memcmp(p_tmp, null_bdaddr, BD_ADDR_LEN) == 0) {
-                    HILOGI("entering HW_CFG_READ_BD_ADDR");
-                    // Controller does not have a valid OTP BDADDR!
-                    // Set the BTIF initial BDADDR instead.
-                    if ((xmit_bytes = hw_config_set_bdaddr(p_buf)) > 0)
-                        break;
-                } else {
-                    HILOGI("Controller OTP bdaddr %02X:%02X:%02X:%02X:%02X:%02X",
-                           *(p_tmp + 5), *(p_tmp + 4), *(p_tmp + 3),
-                           *(p_tmp + 2), *(p_tmp + 1), *p_tmp);
-                }
+    /* nothing received since the last tick and the stack not sending */
+    idle = (rx == hw_uart_cb.last_rx) && !hw_uart_cb.bt_wake;
+    hw_uart_cb.last_rx = rx;
+    if (idle && (hw_uart_cb.want_baud != 0)) {
+        hw_uart_send_baud(hw_uart_cb.want_baud);
+        hw_uart_cb.want_baud = 0;
+        return;
+    }
 
-                HILOGI("vendor lib fwcfg completed2");
-                // bt_vendor_cbacks->fwcfg_cb(BT_VND_OP_RESULT_SUCCESS);
-                hw_sco_config();
-                start_fwcfg_cbtimer();
+#if (HOST_WAKE_MONITOR == TRUE)
+    /* sleep until HOST_WAKE or BT_WAKE signals traffic */
+    if (idle && host_wake_is_running()) {
+        hw_uart_cb.paused = TRUE;
+        vnd_timer_stop(hw_uart_cb.p_timer);
+        return;
+    }
+#endif
 
-                hw_cfg_cb.state = 0;
+    /* judge over enough traffic, counters keep accumulating meanwhile */
+    bytes = rx - hw_uart_cb.rx;
+    if (bytes < UART_ERR_MIN_RX_BYTES) {
+        return;
+    }
 
-                if (hw_cfg_cb.fw_fd != -1) {
-                    close(hw_cfg_cb.fw_fd);
-                    hw_cfg_cb.fw_fd = -1;
-                }
+    errors = (frame - hw_uart_cb.frame) + (overrun - hw_uart_cb.overrun);
+    hw_uart_cb.frame = frame;
+    hw_uart_cb.overrun = overrun;
+    hw_uart_cb.rx = rx;
+
+    now = get_monotonic_time_us();
+    if ((uint64_t)errors * 1000000 > (uint64_t)bytes * UART_ERR_RATE_THRESHOLD_PPM) { /* 1000000: ppm */
+        HILOGW("UART %u errors in %u bytes at %u baud", errors, bytes, hw_uart_cb.baud);
+        hw_uart_cb.clean_us = now;
+        if (hw_uart_cb.stepped_up) {
+            /* the faster rate did not hold, wait longer before the next try */
+            hw_uart_cb.stepped_up = FALSE;
+            hw_uart_cb.window_ms *= 2; /* 2: backoff factor */
+            if (hw_uart_cb.window_ms > UART_ERR_CLEAN_WINDOW_MAX_MS) {
+                hw_uart_cb.window_ms = UART_ERR_CLEAN_WINDOW_MAX_MS;
+            }
+        }
+        next = hw_uart_next_baud(hw_uart_cb.baud);
+        if (next != 0) {
+            hw_uart_cb.want_baud = next;
+        }
+    } else if ((now - hw_uart_cb.clean_us) / BT_VENDOR_TIME_RAIDX >= hw_uart_cb.window_ms) {
+        hw_uart_cb.stepped_up = FALSE;
+        hw_uart_cb.want_baud = hw_uart_prev_baud(hw_uart_cb.baud);
+    }
+}
 
-                xmit_bytes = 1;
-                break;
-#endif      // (USE_CONTROLLER_BDADDR == TRUE)
-        } // switch(hw_cfg_cb.state)
+/*******************************************************************************
+**
+** Function         hw_uart_monitor_start
+**
+** Description      Start sampling the UART error counters
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_uart_monitor_start(void)
+{
+    if (userial_vendor_get_icount(&hw_uart_cb.frame, &hw_uart_cb.overrun, &hw_uart_cb.rx) != 0) {
+        HILOGI("UART error counters not available, no run-time rate fallback");
+        return;
+    }
 
-        bt_vendor_cbacks->dealloc(p_buf);
-    }     // if (p_buf != NULL)
+    if (hw_uart_cb.p_timer == NULL) {
+        hw_uart_cb.p_timer = vnd_timer_alloc(hw_uart_monitor_cback, NULL);
+    }
 
-    /* Free the RX event buffer */
-    // if (bt_vendor_cbacks)
-    //  bt_vendor_cbacks->dealloc(p_evt_buf);
+    hw_uart_cb.last_rx = hw_uart_cb.rx;
+    hw_uart_cb.want_baud = 0;
+    hw_uart_cb.window_ms = UART_ERR_CLEAN_WINDOW_MS;
+    hw_uart_cb.clean_us = get_monotonic_time_us();
+    hw_uart_cb.stepped_up = FALSE;
+    hw_uart_cb.paused = FALSE;
 
-    if (xmit_bytes <= 0) {
-        HILOGE("vendor lib fwcfg aborted!!!");
-        if (bt_vendor_cbacks) {
-            bt_vendor_cbacks->init_cb(BTC_OP_RESULT_FAIL);
-        }
+    (void)vnd_timer_start(hw_uart_cb.p_timer, UART_ERR_CHECK_INTERVAL_MS, TRUE);
+}
 
-        if (hw_cfg_cb.fw_fd != -1) {
-            close(hw_cfg_cb.fw_fd);
-            hw_cfg_cb.fw_fd = -1;
-        }
+/*******************************************************************************
+**
+** Function         hw_uart_monitor_stop
+**
+** Description      Stop sampling the UART error counters
+**
+** Returns          None
+**
+*******************************************************************************/
+void hw_uart_monitor_stop(void)
+{
+    hw_uart_cb.paused = FALSE;
+    vnd_timer_stop(hw_uart_cb.p_timer);
+}
 
-        hw_cfg_cb.state = 0;
+#if (HOST_WAKE_MONITOR == TRUE)
+/*******************************************************************************
+**
+** Function         hw_uart_monitor_resume
+**
+** Description      Re-arm a monitor paused on an idle link
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_uart_monitor_resume(void)
+{
+    if (hw_uart_cb.paused) {
+        hw_uart_cb.paused = FALSE;
+        (void)vnd_timer_start(hw_uart_cb.p_timer, UART_ERR_CHECK_INTERVAL_MS, TRUE);
     }
 }
+#endif
 
 /******************************************************************************
 **   LPM Static Functions
 ******************************************************************************/
 
+/*******************************************************************************
+**
+** Function         hw_lpm_fixed_idle_timeout
+**
+** Description      Idle timeout derived from the configured host stack idle
+**                  threshold
+**
+** Returns          Timeout in milliseconds
+**
+*******************************************************************************/
+static uint32_t hw_lpm_fixed_idle_timeout(void)
+{
+    /* set idle time to be LPM_IDLE_TIMEOUT_MULTIPLE times of
+     * host stack idle threshold (in 300ms/25ms)
+     */
+    return (uint32_t)lpm_param.host_stack_idle_threshold * LPM_IDLE_TIMEOUT_MULTIPLE * BT_VENDOR_LDM_DEFAULT_IDLE;
+}
+
 /*******************************************************************************
 **
 ** Function         hw_lpm_ctrl_cback
 **
-** Description      Callback function for lpm enable/disable request
+** Description      Callback function for lpm enable/disable request, NULL
+**                  when the scheduler gave the command up
 **
 ** Returns          None
 **
@@ -883,8 +2567,10 @@ void hw_lpm_ctrl_cback(void *p_mem)
     HC_BT_HDR *p_evt_buf = (HC_BT_HDR *)p_mem;
     bt_op_result_t status = BTC_OP_RESULT_FAIL;
 
-    if (*((uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_STATUS_RET_BYTE) == 0) {
+    if ((p_evt_buf != NULL) && (*((uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_STATUS_RET_BYTE) == 0)) {
         status = BTC_OP_RESULT_SUCCESS;
+    } else {
+        HILOGE("lpm sleep mode command failed");
     }
 
     if (bt_vendor_cbacks) {
@@ -897,145 +2583,287 @@ void hw_lpm_ctrl_cback(void *p_mem)
 **   SCO Configuration Static Functions
 *****************************************************************************/
 
-static void hw_sco_i2spcm_proc_interface_param(void)
+/*******************************************************************************
+**
+** Function         hw_sco_set_step
+**
+** Description      Fill in one command of a sequence
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_sco_set_step(hw_sco_step_t *p_step, uint16_t opcode, const uint8_t *p_param, uint8_t len)
 {
-    bt_op_result_t status = BTC_OP_RESULT_FAIL;
-    uint8_t ret = FALSE;
-    uint8_t *p;
-    HC_BT_HDR *p_buf = NULL;
+    p_step->opcode = opcode;
+    p_step->len = len;
+    (void)memcpy_s(p_step->param, sizeof(p_step->param), p_param, len);
+}
 
-    /* Ask a new buffer to hold WRITE_SCO_PCM_INT_PARAM command */
-    if (bt_vendor_cbacks) {
-        p_buf = (HC_BT_HDR *)bt_vendor_cbacks->alloc(BT_HC_HDR_SIZE
-            + HCI_CMD_PREAMBLE_SIZE + SCO_PCM_PARAM_SIZE);
-    }
-    if (p_buf) {
-        p_buf->event = MSG_STACK_TO_HC_HCI_CMD;
-        p_buf->offset = 0;
-        p_buf->layer_specific = 0;
-        p_buf->len = HCI_CMD_PREAMBLE_SIZE + SCO_PCM_PARAM_SIZE;
-        p = (uint8_t *)(p_buf + 1);
+/*******************************************************************************
+**
+** Function         hw_sco_build_seq
+**
+** Description      Precompute the command sequence of each codec on the
+**                  configured bus. Must be called with hw_sco_lock held.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_sco_build_seq(void)
+{
+    const uint8_t wbs_off[1] = {0};
+    const uint8_t wbs_on[SCO_CODEC_PARAM_SIZE] = {1, (uint8_t)SCO_CODEC_MSBC, (uint8_t)(SCO_CODEC_MSBC >> 8)};
+    uint8_t i2spcm[SCO_I2SPCM_PARAM_SIZE];
+    uint8_t sco[SCO_PCM_PARAM_SIZE];
+    uint8_t idx;
+
+    (void)memset_s(hw_sco_cb.seq, sizeof(hw_sco_cb.seq), 0, sizeof(hw_sco_cb.seq));
+
+    for (idx = 0; idx < HW_SCO_SEQ_NUM; idx++) {
+        hw_sco_step_t *p_seq = hw_sco_cb.seq[idx];
+
+        (void)memcpy_s(i2spcm, sizeof(i2spcm), bt_sco_i2spcm_param, sizeof(bt_sco_i2spcm_param));
+        (void)memcpy_s(sco, sizeof(sco), bt_sco_param, sizeof(bt_sco_param));
+        if (idx == HW_SCO_SEQ_MSBC) {
+            hw_sco_set_step(&p_seq[HW_SCO_STEP_WBS], HCI_VSC_ENABLE_WBS, wbs_on, sizeof(wbs_on));
+            i2spcm[SCO_I2SPCM_PARAM_IF_SAMPLE_RATE] = (uint8_t)wbs_sample_rate; /* 16K */
+            i2spcm[SCO_I2SPCM_PARAM_IF_CLOCK_RATE] = sco_bus_wbs_clock_rate;
+            sco[SCO_PCM_PARAM_IF_CLOCK_RATE] = sco_bus_wbs_clock_rate;
+        } else {
+            hw_sco_set_step(&p_seq[HW_SCO_STEP_WBS], HCI_VSC_ENABLE_WBS, wbs_off, sizeof(wbs_off));
+            i2spcm[SCO_I2SPCM_PARAM_IF_SAMPLE_RATE] = 0; /* 8K */
+            i2spcm[SCO_I2SPCM_PARAM_IF_CLOCK_RATE] = sco_bus_clock_rate;
+            sco[SCO_PCM_PARAM_IF_CLOCK_RATE] = sco_bus_clock_rate;
+        }
 
-        /* do we need this VSC for I2S??? */
-        UINT16_TO_STREAM(p, HCI_VSC_WRITE_SCO_PCM_INT_PARAM);
-        *p++ = SCO_PCM_PARAM_SIZE;
-        memcpy_s(p, &bt_sco_param, SCO_PCM_PARAM_SIZE);
-        ret = bt_vendor_cbacks->xmit_cb(HCI_VSC_WRITE_SCO_PCM_INT_PARAM, p_buf);
-        bt_vendor_cbacks->dealloc(p_buf);
-        if (ret) {
-            return;
+        hw_sco_set_step(&p_seq[HW_SCO_STEP_I2SPCM], HCI_VSC_WRITE_I2SPCM_INTERFACE_PARAM, i2spcm,
+            SCO_I2SPCM_PARAM_SIZE);
+        if (sco_bus_interface == SCO_INTERFACE_PCM) {
+            hw_sco_set_step(&p_seq[HW_SCO_STEP_PCM_INT], HCI_VSC_WRITE_SCO_PCM_INT_PARAM, sco, SCO_PCM_PARAM_SIZE);
+            hw_sco_set_step(&p_seq[HW_SCO_STEP_PCM_FMT], HCI_VSC_WRITE_PCM_DATA_FORMAT_PARAM, bt_pcm_data_fmt_param,
+                PCM_DATA_FORMAT_PARAM_SIZE);
         }
     }
-    status = BTC_OP_RESULT_FAIL;
 
-    HILOGI("sco I2S/PCM config interface result %d [0-Success, 1-Fail]", status);
+    HILOGI("I2SPCM config {0x%x, 0x%x}, clock rate nbs %u wbs %u", bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_IF_MODE],
+        bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_IF_ROLE], sco_bus_clock_rate, sco_bus_wbs_clock_rate);
 }
 
-static void hw_sco_i2spcm_proc_int_param(void)
+static void hw_sco_cmpl_cback(void *p_mem);
+
+/*******************************************************************************
+**
+** Function         hw_sco_apply
+**
+** Description      Queue the commands of a sequence whose parameters differ
+**                  from the controller settings. They all go out at once and
+**                  the scheduler pipelines them within the command credits.
+**                  Must be called with hw_sco_lock held.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_sco_apply(uint8_t idx, uint64_t start_us)
 {
-    bt_op_result_t status = BTC_OP_RESULT_FAIL;
-    uint8_t ret = FALSE;
-    uint8_t *p;
-    HC_BT_HDR *p_buf = NULL;
-    
-    /* Ask a new buffer to hold WRITE_PCM_DATA_FORMAT_PARAM command */
-    if (bt_vendor_cbacks)
-        p_buf = (HC_BT_HDR *)bt_vendor_cbacks->alloc(
-            BT_HC_HDR_SIZE + HCI_CMD_PREAMBLE_SIZE + PCM_DATA_FORMAT_PARAM_SIZE);
-    if (p_buf) {
-        p_buf->event = MSG_STACK_TO_HC_HCI_CMD;
-        p_buf->offset = 0;
-        p_buf->layer_specific = 0;
-        p_buf->len = HCI_CMD_PREAMBLE_SIZE + PCM_DATA_FORMAT_PARAM_SIZE;
+    const hw_sco_step_t *p_seq = hw_sco_cb.seq[idx];
+    uint8_t step;
 
-        p = (uint8_t *)(p_buf + 1);
-        UINT16_TO_STREAM(p, HCI_VSC_WRITE_PCM_DATA_FORMAT_PARAM);
-        *p++ = PCM_DATA_FORMAT_PARAM_SIZE;
-        memcpy_s(p, &bt_pcm_data_fmt_param, PCM_DATA_FORMAT_PARAM_SIZE);
+    hw_sco_cb.active = idx;
+    hw_sco_cb.start_us = start_us;
+    hw_sco_cb.failed = FALSE;
+    hw_sco_cb.pending = 0;
+
+    for (step = 0; step < HW_SCO_STEP_NUM; step++) {
+        const hw_sco_step_t *p_ctrl = &hw_sco_cb.ctrl[step];
+
+        if (p_seq[step].len == 0) {
+            continue;
+        }
+        if ((p_ctrl->len == p_seq[step].len) && (memcmp(p_ctrl->param, p_seq[step].param, p_ctrl->len) == 0)) {
+            hw_sco_cb.skipped++;
+            continue;
+        }
+
+        if (cmd_sched_send(p_seq[step].opcode, p_seq[step].param, p_seq[step].len, CMD_SCHED_PRIO_AUDIO,
+            hw_sco_cmpl_cback)) {
+            hw_sco_cb.pending |= (uint8_t)(1U << step);
+            hw_sco_cb.cmds++;
+        } else {
+            hw_sco_cb.ctrl[step].len = 0;
+            hw_sco_cb.failed = TRUE;
+        }
+    }
+}
+
+/*******************************************************************************
+**
+** Function         hw_sco_done
+**
+** Description      Report the switch latency of the active sequence and start
+**                  the one requested meanwhile. Must be called with
+**                  hw_sco_lock held.
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_sco_done(void)
+{
+    uint32_t elapsed_us = (uint32_t)(get_monotonic_time_us() - hw_sco_cb.start_us);
+    uint8_t next;
+
+    hw_sco_cb.switches++;
+    hw_sco_cb.last_us = elapsed_us;
+    if (elapsed_us > hw_sco_cb.max_us) {
+        hw_sco_cb.max_us = elapsed_us;
+    }
+    HILOGI("sco %s path %s in %u us", (hw_sco_cb.active == HW_SCO_SEQ_MSBC) ? "mSBC" : "CVSD",
+        hw_sco_cb.failed ? "failed" : "set", elapsed_us);
+
+    if (hw_sco_cb.next != HW_SCO_SEQ_NUM) {
+        next = hw_sco_cb.next;
+        hw_sco_cb.next = HW_SCO_SEQ_NUM;
+        hw_sco_apply(next, hw_sco_cb.next_us);
+        if (hw_sco_cb.pending == 0) {
+            hw_sco_done();
+        }
+    }
+}
 
-        ret = bt_vendor_cbacks->xmit_cb(HCI_VSC_WRITE_PCM_DATA_FORMAT_PARAM, p_buf);
-        bt_vendor_cbacks->dealloc(p_buf);
-        if (ret) {
+/*******************************************************************************
+**
+** Function         hw_sco_cmpl_cback
+**
+** Description      Command complete of a SCO reconfiguration command, NULL
+**                  when the scheduler gave the command up
+**
+** Returns          None
+**
+*******************************************************************************/
+static void hw_sco_cmpl_cback(void *p_mem)
+{
+    HC_BT_HDR *p_evt_buf = (HC_BT_HDR *)p_mem;
+    const hw_sco_step_t *p_seq;
+    uint8_t *p;
+    uint16_t opcode;
+    uint8_t step;
+
+    pthread_mutex_lock(&hw_sco_lock);
+    p_seq = hw_sco_cb.seq[hw_sco_cb.active];
+    if (p_evt_buf == NULL) {
+        /* the lost command is not known, forget every pending setting */
+        for (step = 0; step < HW_SCO_STEP_NUM; step++) {
+            if (hw_sco_cb.pending & (1U << step)) {
+                hw_sco_cb.ctrl[step].len = 0;
+            }
+        }
+        hw_sco_cb.pending = 0;
+        hw_sco_cb.failed = TRUE;
+    } else {
+        p = (uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_OPCODE;
+        STREAM_TO_UINT16(opcode, p);
+        for (step = 0; step < HW_SCO_STEP_NUM; step++) {
+            if ((hw_sco_cb.pending & (1U << step)) && (p_seq[step].opcode == opcode)) {
+                break;
+            }
+        }
+        if (step == HW_SCO_STEP_NUM) {
+            pthread_mutex_unlock(&hw_sco_lock);
             return;
         }
+
+        hw_sco_cb.pending &= (uint8_t)~(1U << step);
+        if (*((uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_STATUS_RET_BYTE) == 0) {
+            hw_sco_cb.ctrl[step] = p_seq[step];
+        } else {
+            HILOGE("sco command 0x%04x failed", opcode);
+            hw_sco_cb.ctrl[step].len = 0;
+            hw_sco_cb.failed = TRUE;
+        }
     }
-    status = BTC_OP_RESULT_FAIL;
-    
-    HILOGI("sco I2S/PCM config int result %d [0-Success, 1-Fail]", status);
+
+    if (hw_sco_cb.pending == 0) {
+        hw_sco_done();
+    }
+    pthread_mutex_unlock(&hw_sco_lock);
 }
 
 /*******************************************************************************
 **
-** Function         hw_sco_i2spcm_cfg_cback
+** Function         hw_sco_switch
 **
-** Description      Callback function for SCO I2S/PCM configuration request
+** Description      Move the SCO path to a codec. A request made while a
+**                  switch is in flight is applied once it completes, the
+**                  newest request wins.
 **
-** Returns          None
+** Returns          0 : Success
+**                  -1 : Nothing could be sent
 **
 *******************************************************************************/
-static void hw_sco_i2spcm_cfg_cback(void *p_mem)
+static int hw_sco_switch(uint16_t codec)
 {
-    HC_BT_HDR *p_evt_buf = (HC_BT_HDR *)p_mem;
-    uint8_t *p;
-    uint16_t opcode;
-    HC_BT_HDR *p_buf = NULL;
-    bt_op_result_t status = BTC_OP_RESULT_FAIL;
-
-    p = (uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_OPCODE;
-    STREAM_TO_UINT16(opcode, p);
+    uint8_t idx = (codec == SCO_CODEC_MSBC) ? HW_SCO_SEQ_MSBC : HW_SCO_SEQ_CVSD;
+    uint64_t now_us = get_monotonic_time_us();
+    int ret = 0;
 
-    if (*((uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_STATUS_RET_BYTE) == 0) {
-        status = BTC_OP_RESULT_SUCCESS;
+    if ((codec != SCO_CODEC_MSBC) && (codec != SCO_CODEC_CVSD) && (codec != SCO_CODEC_NONE)) {
+        HILOGW("SCO codec setting is wrong: codec: 0x%x", codec);
     }
 
-    /* Free the RX event buffer */
-    if (bt_vendor_cbacks) {
-        // bt_vendor_cbacks->dealloc(p_evt_buf);
+    pthread_mutex_lock(&hw_sco_lock);
+    if (hw_sco_cb.pending != 0) {
+        if (hw_sco_cb.next == HW_SCO_SEQ_NUM) {
+            hw_sco_cb.next_us = now_us;
+        }
+        hw_sco_cb.next = idx;
+    } else {
+        hw_sco_apply(idx, now_us);
+        if (hw_sco_cb.pending == 0) {
+            ret = hw_sco_cb.failed ? -1 : 0;
+            hw_sco_done();
+        }
     }
+    pthread_mutex_unlock(&hw_sco_lock);
 
-    if (status != BTC_OP_RESULT_SUCCESS) {
-        return;
-    }
-    
-    if ((opcode == HCI_VSC_WRITE_I2SPCM_INTERFACE_PARAM) &&
-        (sco_bus_interface == SCO_INTERFACE_PCM)) {
-        hw_sco_i2spcm_proc_interface_param();
-    } else if ((opcode == HCI_VSC_WRITE_SCO_PCM_INT_PARAM) &&
-             (sco_bus_interface == SCO_INTERFACE_PCM)) {
-        hw_sco_i2spcm_proc_int_param();
-    }
+    return ret;
 }
 
 /*******************************************************************************
 **
-** Function         hw_set_MSBC_codec_cback
+** Function         hw_sco_dump
 **
-** Description      Callback function for setting WBS codec
+** Description      Log the SCO reconfiguration statistics
 **
 ** Returns          None
 **
 *******************************************************************************/
-static void hw_set_MSBC_codec_cback(void *p_mem)
+static void hw_sco_dump(void)
 {
-    /* whenever update the codec enable/disable, need to update I2SPCM */
-    HILOGI("SCO I2S interface change the sample rate to 16K");
-    hw_sco_i2spcm_config_from_command(p_mem, SCO_CODEC_MSBC);
+    pthread_mutex_lock(&hw_sco_lock);
+    if (hw_sco_cb.switches > 0) {
+        HILOGI("sco: %u switches, %u commands sent, %u skipped, last %u us, max %u us", hw_sco_cb.switches,
+            hw_sco_cb.cmds, hw_sco_cb.skipped, hw_sco_cb.last_us, hw_sco_cb.max_us);
+    }
+    pthread_mutex_unlock(&hw_sco_lock);
 }
 
 /*******************************************************************************
 **
-** Function         hw_set_CVSD_codec_cback
+** Function         hw_sco_forget
 **
-** Description      Callback function for setting NBS codec
+** Description      The I2S/PCM port was reprogrammed outside the SCO path
+**                  (A2DP offload routing), send the bus settings again with
+**                  the next switch
 **
 ** Returns          None
 **
 *******************************************************************************/
-static void hw_set_CVSD_codec_cback(void *p_mem)
+void hw_sco_forget(void)
 {
-    /* whenever update the codec enable/disable, need to update I2SPCM */
-    HILOGI("SCO I2S interface change the sample rate to 8K");
-    hw_sco_i2spcm_config_from_command(p_mem, SCO_CODEC_CVSD);
+    pthread_mutex_lock(&hw_sco_lock);
+    hw_sco_cb.ctrl[HW_SCO_STEP_I2SPCM].len = 0;
+    hw_sco_cb.ctrl[HW_SCO_STEP_PCM_INT].len = 0;
+    hw_sco_cb.ctrl[HW_SCO_STEP_PCM_FMT].len = 0;
+    pthread_mutex_unlock(&hw_sco_lock);
 }
 
 #endif // SCO_CFG_INCLUDED
@@ -1044,45 +2872,67 @@ static void hw_set_CVSD_codec_cback(void *p_mem)
 **   Hardware Configuration Interface Functions
 *****************************************************************************/
 
+/* Command Complete handlers of the configuration sequence, the commands sent
+ * through the scheduler carry their own callback
+ */
+static const cmd_sched_handler_t hw_evt_handlers[] = {
+    {HCI_RESET, hw_config_cback},
+    {HCI_VSC_WRITE_UART_CLOCK_SETTING, hw_config_cback},
+    {HCI_VSC_UPDATE_BAUDRATE, hw_config_cback},
+    {HCI_READ_LOCAL_NAME, hw_config_cback},
+    {HCI_VSC_DOWNLOAD_MINIDRV, hw_config_cback},
+    {HCI_VSC_WRITE_FIRMWARE, hw_config_cback},
+    {HCI_VSC_LAUNCH_RAM, hw_config_cback},
+    {HCI_VSC_WRITE_BD_ADDR, hw_config_cback},
+#if (USE_CONTROLLER_BDADDR == TRUE)
+    {HCI_READ_LOCAL_BDADDR, hw_config_cback},
+#endif
+    {HCI_READ_LOCAL_VERSION_INFO, hw_config_cback},
+};
+
 /*******************************************************************************
 **
-** Function        hw_config_start
+** Function        hw_config_begin
 **
-** Description     Kick off controller initialization process
+** Description     Run the controller configuration from its first HCI_RESET
 **
 ** Returns         None
 **
 *******************************************************************************/
-void hw_config_start(void)
+static void hw_config_begin(void)
 {
     HC_BT_HDR *p_buf = NULL;
-    uint8_t *p;
 
-    hw_cfg_cb.state = 0;
-    hw_cfg_cb.fw_fd = -1;
+    (void)vnd_tune_apply(VND_TUNE_AT_POWER);
+    cfg_trace_start();
+    cmd_sched_init(hw_evt_handlers, (uint8_t)(sizeof(hw_evt_handlers) / sizeof(hw_evt_handlers[0])));
+    hw_config_guard_stop();
+    hw_config_set_state(0);
     hw_cfg_cb.f_set_baud_2 = FALSE;
+    hw_uart_baud_init();
+
+    /* The patch of the chipset detected by the previous boot is normally
+     * prefetched since power-on, the detection stage confirms it later.
+     */
+    if (!hw_config_prefetch_wait()) {
+        hw_config_prefetch_patch();
+    }
 
     // bt_vendor_cbacks->init_cb(BTC_OP_RESULT_SUCCESS);
     //    Start from sending HCI_RESET
 
     if (bt_vendor_cbacks) {
-        p_buf = (HC_BT_HDR *)bt_vendor_cbacks->alloc(BT_HC_HDR_SIZE +
-                                                     HCI_CMD_PREAMBLE_SIZE);
+        p_buf = vnd_cmd_build(HCI_RESET, NULL, 0);
     }
 
     if (p_buf) {
-        p_buf->event = MSG_STACK_TO_HC_HCI_CMD;
-        p_buf->offset = 0;
-        p_buf->layer_specific = 0;
-        p_buf->len = HCI_CMD_PREAMBLE_SIZE;
-
-        p = (uint8_t *)(p_buf + 1);
-        UINT16_TO_STREAM(p, HCI_RESET);
-        *p = 0;
+        hw_config_set_state(HW_CFG_START);
+        hw_xmit(HCI_RESET, p_buf);
+        vnd_cmd_put(p_buf);
 
-        hw_cfg_cb.state = HW_CFG_START;
-        bt_vendor_cbacks->xmit_cb(HCI_RESET, p_buf);
-        bt_vendor_cbacks->dealloc(p_buf);
+        /* the controller might have been left at its working baud rate */
+        (void)hw_probe_start(HW_PROBE_START, FW_START_PROBE_TIMEOUT_MS);
+        hw_config_guard_timeout();
     } else {
         if (bt_vendor_cbacks) {
             HILOGE("vendor lib fw conf aborted [no buffer]");
@@ -1091,6 +2941,79 @@ void hw_config_start(void)
     }
 }
 
+/*******************************************************************************
+**
+** Function        hw_config_start
+**
+** Description     Kick off controller initialization process
+**
+** Returns         None
+**
+*******************************************************************************/
+void hw_config_start(void)
+{
+    pthread_mutex_lock(&hw_cfg_lock);
+    hw_recov_cb.restarts = 0;
+    hw_config_begin();
+    pthread_mutex_unlock(&hw_cfg_lock);
+}
+
+/*******************************************************************************
+**
+** Function        hw_cleanup
+**
+** Description     Release the timers of the configuration, readiness probe
+**                 and UART monitor, and log the command scheduler, buffer
+**                 pool and SCO switch statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void hw_cleanup(void)
+{
+#if (HOST_WAKE_MONITOR == TRUE)
+    host_wake_stop();
+#endif
+
+    pthread_mutex_lock(&hw_probe_lock);
+    hw_probe_cb.phase = HW_PROBE_IDLE;
+    vnd_timer_free(hw_probe_cb.p_timer);
+    hw_probe_cb.p_timer = NULL;
+    pthread_mutex_unlock(&hw_probe_lock);
+
+    vnd_timer_free(hw_uart_cb.p_timer);
+    hw_uart_cb.p_timer = NULL;
+
+    vnd_timer_free(fwcfg_timer);
+    fwcfg_timer = NULL;
+
+    pthread_mutex_lock(&hw_cfg_lock);
+    vnd_timer_free(hw_recov_cb.p_timer);
+    hw_recov_cb.p_timer = NULL;
+    hw_recov_cb.armed = FALSE;
+    hw_recov_cb.due_us = 0;
+    hw_recov_cb.backoff = FALSE;
+    if (hw_recov_cb.timeouts + hw_recov_cb.errors > 0) {
+        HILOGI("fwcfg recovery: %u timeouts, %u errors, %u resends, %u resumes, %u power cycles, %u failures",
+            hw_recov_cb.timeouts, hw_recov_cb.errors, hw_recov_cb.resends, hw_recov_cb.resumes,
+            hw_recov_cb.power_cycles, hw_recov_cb.failures);
+    }
+    pthread_mutex_unlock(&hw_cfg_lock);
+
+    cmd_sched_cleanup();
+    vnd_cmd_dump();
+#if (SCO_CFG_INCLUDED == TRUE)
+    hw_sco_dump();
+#endif
+
+#if (LPM_ADAPTIVE_IDLE == TRUE)
+    if (lpm_enabled) {
+        lpm_adapt_dump();
+        lpm_enabled = FALSE;
+    }
+#endif
+}
+
 /*******************************************************************************
 **
 ** Function        hw_lpm_enable
@@ -1104,34 +3027,37 @@ uint8_t hw_lpm_enable(uint8_t turn_on)
 {
     HILOGD("entering hw_lpm_enable11");
     HC_BT_HDR *p_buf = NULL;
-    uint8_t *p;
     uint8_t ret = FALSE;
 
-    if (bt_vendor_cbacks)
-        p_buf = (HC_BT_HDR *)bt_vendor_cbacks->alloc(BT_HC_HDR_SIZE +
-                                                     HCI_CMD_PREAMBLE_SIZE +
-                                                     LPM_CMD_PARAM_SIZE);
-
-    if (p_buf) {
-        p_buf->event = MSG_STACK_TO_HC_HCI_CMD;
-        p_buf->offset = 0;
-        p_buf->layer_specific = 0;
-        p_buf->len = HCI_CMD_PREAMBLE_SIZE + LPM_CMD_PARAM_SIZE;
+    (void)vnd_tune_apply(VND_TUNE_AT_LPM);
+    lpm_ctx_param = lpm_param;
+#if (LPM_ADAPTIVE_IDLE == TRUE)
+    if (turn_on && !lpm_enabled) {
+        lpm_adapt_init(lpm_idle_min_ms, (lpm_idle_max_ms > 0) ? lpm_idle_max_ms : hw_lpm_fixed_idle_timeout(),
+            hw_lpm_fixed_idle_timeout());
+        lpm_idle_threshold = 0;
+    } else if (!turn_on && lpm_enabled) {
+        lpm_adapt_dump();
+    }
+    lpm_enabled = turn_on;
+    if (lpm_idle_threshold != 0) {
+        lpm_ctx_param.host_stack_idle_threshold = lpm_idle_threshold;
+        lpm_ctx_param.host_controller_idle_threshold = lpm_idle_threshold;
+    }
+#endif
 
-        p = (uint8_t *)(p_buf + 1);
-        UINT16_TO_STREAM(p, HCI_VSC_WRITE_SLEEP_MODE);
-        *p++ = LPM_CMD_PARAM_SIZE; /* parameter length */
+    if (bt_vendor_cbacks) {
+        upio_set(UPIO_LPM_MODE, turn_on ? UPIO_ASSERT : UPIO_DEASSERT, 0);
 
+        ret = cmd_sched_send(HCI_VSC_WRITE_SLEEP_MODE, turn_on ? (const uint8_t *)&lpm_ctx_param : NULL,
+            LPM_CMD_PARAM_SIZE, CMD_SCHED_PRIO_CTRL, hw_lpm_ctrl_cback);
+#if (HOST_WAKE_MONITOR == TRUE)
         if (turn_on) {
-            memcpy(p, &lpm_param, LPM_CMD_PARAM_SIZE);
-            upio_set(UPIO_LPM_MODE, UPIO_ASSERT, 0);
+            (void)host_wake_start(lpm_ctx_param.host_wake_polarity, hw_lpm_host_wake);
         } else {
-            memset(p, 0, LPM_CMD_PARAM_SIZE);
-            upio_set(UPIO_LPM_MODE, UPIO_DEASSERT, 0);
+            host_wake_stop();
         }
-
-        ret = bt_vendor_cbacks->xmit_cb(HCI_VSC_WRITE_SLEEP_MODE, p_buf);
-        bt_vendor_cbacks->dealloc(p_buf);
+#endif
     }
 
     if ((ret <= 0) && bt_vendor_cbacks) {
@@ -1145,22 +3071,107 @@ uint8_t hw_lpm_enable(uint8_t turn_on)
 **
 ** Function        hw_lpm_get_idle_timeout
 **
-** Description     Calculate idle time based on host stack idle threshold
+** Description     Calculate idle time based on host stack idle threshold,
+**                 or the adapted idle time once traffic was observed
 **
 ** Returns         idle timeout value
 **
 *******************************************************************************/
 uint32_t hw_lpm_get_idle_timeout(void)
 {
-    uint32_t timeout_ms;
+#if (LPM_ADAPTIVE_IDLE == TRUE)
+    if (lpm_enabled) {
+        return lpm_adapt_timeout();
+    }
+#endif
 
-    /* set idle time to be LPM_IDLE_TIMEOUT_MULTIPLE times of
-     * host stack idle threshold (in 300ms/25ms)
-     */
-    timeout_ms = (uint32_t)lpm_param.host_stack_idle_threshold * LPM_IDLE_TIMEOUT_MULTIPLE;
-    timeout_ms *= BT_VENDOR_LDM_DEFAULT_IDLE;
-    return timeout_ms;
+    return hw_lpm_fixed_idle_timeout();
+}
+
+#if (LPM_ADAPTIVE_IDLE == TRUE)
+/*******************************************************************************
+**
+** Function        hw_lpm_send_idle_threshold
+**
+** Description     Send the sleep mode parameters again with new idle
+**                 thresholds. Only the command is queued: the LPM mode line,
+**                 the HOST_WAKE monitor and the tunables are left alone, so
+**                 this is safe on the BT_WAKE path.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void hw_lpm_send_idle_threshold(uint8_t threshold)
+{
+    lpm_ctx_param.host_stack_idle_threshold = threshold;
+    lpm_ctx_param.host_controller_idle_threshold = threshold;
+
+    if (bt_vendor_cbacks) {
+        (void)cmd_sched_send(HCI_VSC_WRITE_SLEEP_MODE, (const uint8_t *)&lpm_ctx_param, LPM_CMD_PARAM_SIZE,
+            CMD_SCHED_PRIO_CTRL, hw_lpm_ctrl_cback);
+    }
+}
+
+/*******************************************************************************
+**
+** Function        hw_lpm_sync_idle_threshold
+**
+** Description     Follow an adapted idle timeout with the idle thresholds of
+**                 the controller. They count in the same unit as the fixed
+**                 timeout, so they only move when the timeout goes past
+**                 LPM_IDLE_TIMEOUT_MULTIPLE units, and never below the
+**                 configured threshold.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void hw_lpm_sync_idle_threshold(void)
+{
+    uint32_t unit_ms = LPM_IDLE_TIMEOUT_MULTIPLE * BT_VENDOR_LDM_DEFAULT_IDLE;
+    uint32_t threshold = (lpm_adapt_timeout() + unit_ms - 1) / unit_ms;
+
+    if (threshold < lpm_param.host_stack_idle_threshold) {
+        threshold = lpm_param.host_stack_idle_threshold;
+    } else if (threshold > UINT8_MAX) {
+        threshold = UINT8_MAX;
+    }
+
+    if (threshold == lpm_ctx_param.host_stack_idle_threshold) {
+        return;
+    }
+
+    lpm_idle_threshold = (uint8_t)threshold;
+    HILOGI("lpm idle thresholds -> %u", threshold);
+    hw_lpm_send_idle_threshold(lpm_idle_threshold);
+}
+
+/*******************************************************************************
+**
+** Function        hw_set_lpm_idle_bound
+**
+** Description     Set the lower (param 0) or upper (param 1) bound of the
+**                 adaptive idle timeout from the conf file
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int hw_set_lpm_idle_bound(char *p_conf_name, char *p_conf_value, int param)
+{
+    int value = atoi(p_conf_value);
+
+    if (value < 0) {
+        return -1;
+    }
+
+    if (param == 0) {
+        lpm_idle_min_ms = (uint32_t)value;
+    } else {
+        lpm_idle_max_ms = (uint32_t)value;
+    }
+    return 0;
 }
+#endif
 
 /*******************************************************************************
 **
@@ -1176,7 +3187,44 @@ void hw_lpm_set_wake_state(uint8_t wake_assert)
     uint8_t state = (wake_assert) ? UPIO_ASSERT : UPIO_DEASSERT;
 
     upio_set(UPIO_BT_WAKE, state, lpm_param.bt_wake_polarity);
+    hw_uart_cb.bt_wake = wake_assert ? TRUE : FALSE;
+
+#if (LPM_ADAPTIVE_IDLE == TRUE)
+    if (lpm_enabled && lpm_adapt_wake(wake_assert)) {
+        hw_lpm_sync_idle_threshold();
+    }
+#endif
+#if (HOST_WAKE_MONITOR == TRUE)
+    if (wake_assert) {
+        hw_uart_monitor_resume();
+    }
+#endif
+}
+
+#if (HOST_WAKE_MONITOR == TRUE)
+/*******************************************************************************
+**
+** Function        hw_lpm_host_wake
+**
+** Description     HOST_WAKE transition: traffic from the controller ends an
+**                 idle gap like a BT_WAKE assertion does, and re-arms the
+**                 UART monitor paused on the idle link
+**
+** Returns         None
+**
+*******************************************************************************/
+static void hw_lpm_host_wake(uint8_t asserted, uint64_t edge_us)
+{
+#if (LPM_ADAPTIVE_IDLE == TRUE)
+    if (lpm_enabled && lpm_adapt_host_wake(asserted, edge_us)) {
+        hw_lpm_sync_idle_threshold();
+    }
+#endif
+    if (asserted) {
+        hw_uart_monitor_resume();
+    }
 }
+#endif
 
 #if (SCO_CFG_INCLUDED == TRUE)
 /*******************************************************************************
@@ -1220,94 +3268,25 @@ void hw_sco_config(void)
      *  and FM on the same PCM pins, we defer Bluetooth audio (SCO/eSCO)
      *  configuration till SCO/eSCO is being established;
      *  i.e. in hw_set_audio_state() call.
-     *  When configured as I2S only, Bluetooth audio configuration is executed
-     *  immediately with SCO_CODEC_CVSD by default.
+     *  The command sequences of both codecs are computed here once, the
+     *  CVSD path is set up right away. The controller comes out of
+     *  HCI_RESET with WBS disabled, the I2S/PCM settings are not known.
      */
+    pthread_mutex_lock(&hw_sco_lock);
+    hw_sco_build_seq();
+    (void)memset_s(hw_sco_cb.ctrl, sizeof(hw_sco_cb.ctrl), 0, sizeof(hw_sco_cb.ctrl));
+    hw_sco_cb.ctrl[HW_SCO_STEP_WBS] = hw_sco_cb.seq[HW_SCO_SEQ_CVSD][HW_SCO_STEP_WBS];
+    hw_sco_cb.pending = 0;
+    hw_sco_cb.next = HW_SCO_SEQ_NUM;
+    pthread_mutex_unlock(&hw_sco_lock);
 
-    if (sco_bus_interface == SCO_INTERFACE_I2S) {
-        hw_sco_i2spcm_config(SCO_CODEC_CVSD);
-    } else {
-        hw_sco_i2spcm_config(SCO_CODEC_NONE);
-    }
+    (void)hw_sco_switch(SCO_CODEC_CVSD);
 
     if (bt_vendor_cbacks) {
         // bt_vendor_cbacks->scocfg_cb(BT_VND_OP_RESULT_SUCCESS);
     }
 }
 
-static void hw_sco_i2spcm_config_from_command(void *p_mem, uint16_t codec)
-{
-    HC_BT_HDR *p_evt_buf = (HC_BT_HDR *)p_mem;
-    bool command_success = *((uint8_t *)(p_evt_buf + 1) + HCI_EVT_CMD_CMPL_STATUS_RET_BYTE) == 0;
-
-    /* Free the RX event buffer */
-    if (bt_vendor_cbacks) {
-        // bt_vendor_cbacks->dealloc(p_evt_buf);
-    }
-
-    if (command_success) {
-        hw_sco_i2spcm_config(codec);
-    } else if (bt_vendor_cbacks) {
-        // bt_vendor_cbacks->audio_state_cb(BT_VND_OP_RESULT_FAIL);
-    }
-}
-
-/*******************************************************************************
-**
-** Function         hw_sco_i2spcm_config
-**
-** Description      Configure SCO over I2S or PCM
-**
-** Returns          None
-**
-*******************************************************************************/
-static void hw_sco_i2spcm_config(uint16_t codec)
-{
-    HC_BT_HDR *p_buf = NULL;
-    uint8_t *p, ret;
-    uint16_t cmd_u16 = HCI_CMD_PREAMBLE_SIZE + SCO_I2SPCM_PARAM_SIZE;
-
-    if (bt_vendor_cbacks) {
-        p_buf = (HC_BT_HDR *)bt_vendor_cbacks->alloc(BT_HC_HDR_SIZE + cmd_u16);
-    }
-
-    if (p_buf) {
-        p_buf->event = MSG_STACK_TO_HC_HCI_CMD;
-        p_buf->offset = 0;
-        p_buf->layer_specific = 0;
-        p_buf->len = cmd_u16;
-
-        p = (uint8_t *)(p_buf + 1);
-
-        UINT16_TO_STREAM(p, HCI_VSC_WRITE_I2SPCM_INTERFACE_PARAM);
-        *p++ = SCO_I2SPCM_PARAM_SIZE;
-        if (codec == SCO_CODEC_CVSD) {
-            bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_IF_SAMPLE_RATE] = 0; /* SCO_I2SPCM_IF_SAMPLE_RATE  8k */
-            bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_IF_CLOCK_RATE] =
-                bt_sco_param[SCO_PCM_PARAM_IF_CLOCK_RATE] = sco_bus_clock_rate;
-        } else if (codec == SCO_CODEC_MSBC) {
-            bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_IF_SAMPLE_RATE] = wbs_sample_rate; /* SCO_I2SPCM_IF_SAMPLE_RATE 16K */
-            bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_IF_CLOCK_RATE] =
-                bt_sco_param[SCO_PCM_PARAM_IF_CLOCK_RATE] = sco_bus_wbs_clock_rate;
-        } else {
-            bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_IF_SAMPLE_RATE] = 0; /* SCO_I2SPCM_IF_SAMPLE_RATE  8k */
-            bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_IF_CLOCK_RATE] =
-                bt_sco_param[SCO_PCM_PARAM_IF_CLOCK_RATE] = sco_bus_clock_rate;
-            HILOGE("wrong codec is use in hw_sco_i2spcm_config, goes default NBS");
-        }
-        memcpy_s(p, &bt_sco_i2spcm_param, SCO_I2SPCM_PARAM_SIZE);
-        cmd_u16 = HCI_VSC_WRITE_I2SPCM_INTERFACE_PARAM;
-        HILOGI("I2SPCM config {0x%x, 0x%x, 0x%x, 0x%x}",
-            bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_IF_MODE], bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_IF_ROLE],
-            bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_IF_SAMPLE_RATE],
-            bt_sco_i2spcm_param[SCO_I2SPCM_PARAM_IF_CLOCK_RATE]);
-
-        bt_vendor_cbacks->xmit_cb(cmd_u16, p_buf);
-        bt_vendor_cbacks->dealloc(p_buf);
-    }
-    // bt_vendor_cbacks->audio_state_cb(BT_VND_OP_RESULT_FAIL);
-}
-
 /*******************************************************************************
 **
 ** Function         hw_set_SCO_codec
@@ -1321,11 +3300,9 @@ static void hw_sco_i2spcm_config(uint16_t codec)
 *******************************************************************************/
 static int hw_set_SCO_codec(uint16_t codec)
 {
-    HC_BT_HDR *p_buf = NULL;
-    uint8_t *p;
-    uint8_t ret;
-    int ret_val = 0;
-    return ret_val;
+    BTHWDBG("hw_set_SCO_codec 0x%x", codec);
+
+    return hw_sco_switch(codec);
 }
 
 /*******************************************************************************
@@ -1405,6 +3382,55 @@ int hw_set_patch_settlement_delay(char *p_conf_name, char *p_conf_value, int par
 }
 #endif // VENDOR_LIB_RUNTIME_TUNING_ENABLED
 
+/*******************************************************************************
+**
+** Function        hw_set_patch_download_window
+**
+** Description     Give the number of firmware records kept in flight during
+**                 patch download, 1 selects stop-and-wait
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int hw_set_patch_download_window(char *p_conf_name, char *p_conf_value, int param)
+{
+    int window = atoi(p_conf_value);
+
+    if (window < 1) {
+        return -1;
+    }
+
+    fw_patch_dl_window = (uint32_t)window;
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function        hw_tune_init
+**
+** Description     Take the defaults of the board profile and register the
+**                 hardware tunables before the conf file is read
+**
+** Returns         None
+**
+*******************************************************************************/
+void hw_tune_init(void)
+{
+    const vnd_board_profile_t *p_board = vnd_board_get();
+    uint8_t id;
+
+    for (id = 0; id < VND_MAX_CONTROLLERS; id++) {
+        hw_ctxs[id].lpm_cfg = p_board->lpm;
+        hw_ctxs[id].target_baud = p_board->max_baud;
+    }
+    if ((p_board->p_patch_name != NULL) &&
+        (strcpy_s(fw_patchfile_name, sizeof(fw_patchfile_name), p_board->p_patch_name) != 0)) {
+        HILOGW("board patch name %s too long", p_board->p_patch_name);
+    }
+    vnd_tune_register(hw_tunes, (uint32_t)(sizeof(hw_tunes) / sizeof(hw_tunes[0])));
+}
+
 /*****************************************************************************
 **   Sample Codes Section
 *****************************************************************************/
@@ -1452,74 +3478,38 @@ void hw_epilog_cback(void *p_mem)
 *******************************************************************************/
 void hw_epilog_process(void)
 {
-    HC_BT_HDR *p_buf = NULL;
-    uint8_t *p;
-
     BTHWDBG("hw_epilog_process");
 
     /* Sending a HCI_RESET */
-    if (bt_vendor_cbacks) {
-        /* Must allocate command buffer via HC's alloc API */
-        p_buf = (HC_BT_HDR *)bt_vendor_cbacks->alloc(BT_HC_HDR_SIZE +
-                                                     HCI_CMD_PREAMBLE_SIZE);
-    }
-
-    if (p_buf) {
-        p_buf->event = MSG_STACK_TO_HC_HCI_CMD;
-        p_buf->offset = 0;
-        p_buf->layer_specific = 0;
-        p_buf->len = HCI_CMD_PREAMBLE_SIZE;
-
-        p = (uint8_t *)(p_buf + 1);
-        UINT16_TO_STREAM(p, HCI_RESET);
-        *p = 0; /* parameter length */
-
-        /* Send command via HC's xmit_cb API */
-        bt_vendor_cbacks->xmit_cb(HCI_RESET, p_buf);
-        bt_vendor_cbacks->dealloc(p_buf);
-    } else {
-        if (bt_vendor_cbacks) {
-            HILOGE("vendor lib epilog process aborted [no buffer]");
-        }
+    if (bt_vendor_cbacks && (hw_send_cmd(HCI_RESET, NULL, 0) == 0)) {
+        HILOGE("vendor lib epilog process aborted [no buffer]");
     }
 }
 #endif // (HW_END_WITH_HCI_RESET == TRUE)
 
+/*******************************************************************************
+**
+** Function         hw_process_event
+**
+** Description      Hand a Command Complete event to the scheduled command
+**                  waiting for it, or to the handler of its opcode in
+**                  hw_evt_handlers
+**
+** Returns          None
+**
+*******************************************************************************/
 void hw_process_event(HC_BT_HDR *p_buf)
 {
     uint16_t opcode;
     uint8_t *p = (uint8_t *)(p_buf + 1) + HCI_EVT_CMD_CMPL_OPCODE;
     STREAM_TO_UINT16(opcode, p);
 
-    HILOGI("%s, opcode:0x%04x", __FUNCTION__, opcode);
-    switch (opcode) {
-        case HCI_VSC_WRITE_BD_ADDR:
-#if (USE_CONTROLLER_BDADDR == TRUE)
-        case HCI_READ_LOCAL_BDADDR:
+#if (HCI_SNOOP_INCLUDED == TRUE)
+    hci_snoop_evt(p_buf);
 #endif
-        case HCI_READ_LOCAL_NAME:
-        case HCI_VSC_DOWNLOAD_MINIDRV:
-        case HCI_VSC_WRITE_FIRMWARE:
-        case HCI_VSC_LAUNCH_RAM:
-        case HCI_RESET:
-        case HCI_VSC_WRITE_UART_CLOCK_SETTING:
-        case HCI_VSC_UPDATE_BAUDRATE:
-            hw_config_cback(p_buf);
-            break;
-
-        case HCI_VSC_WRITE_SCO_PCM_INT_PARAM:
-        case HCI_VSC_WRITE_PCM_DATA_FORMAT_PARAM:
-        case HCI_VSC_WRITE_I2SPCM_INTERFACE_PARAM:
-            hw_sco_i2spcm_cfg_cback(p_buf);
-            break;
-
-        case HCI_VSC_WRITE_SLEEP_MODE:
-            hw_lpm_ctrl_cback(p_buf);
-            break;
-
-        case HCI_VSC_ENABLE_WBS:
-            break;
-    }
+    VNDEVTTRACE("%s, opcode:0x%04x", __FUNCTION__, opcode);
+    cfg_trace_cmpl(opcode, *((uint8_t *)(p_buf + 1) + HCI_EVT_CMD_CMPL_STATUS_RET_BYTE));
+    (void)cmd_sched_complete(p_buf);
 
-    HILOGI("%s, Complete", __FUNCTION__);
+    VNDEVTTRACE("%s, Complete", __FUNCTION__);
 }
@@ -0,0 +1,515 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      hcd_patch.c
+ *
+ *  Description:   Contains the firmware patch download engine. The whole
+ *                 .hcd file is mapped once and parsed into a record index,
+ *                 records are then fed to the controller straight out of
+ *                 memory without any per-record file I/O.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_hcd_patch"
+
+#include <utils/Log.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "bt_vendor_brcm.h"
+#include "hcd_patch.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+#ifndef HCDPATCH_DBG
+#define HCDPATCH_DBG FALSE
+#endif
+
+#if (HCDPATCH_DBG == TRUE)
+#define HCDPATCHDBG(param, ...)     \
+{                               \
+    HILOGD(param, ##__VA_ARGS__); \
+}
+#else
+#define HCDPATCHDBG(param, ...)     \
+{                               \
+}
+#endif
+
+/* Sanity limit, patch files are a few hundred KB at most */
+#define HCD_PATCH_MAX_SIZE (4 * 1024 * 1024)
+
+/* Fault the whole image in at map time where supported */
+#ifdef MAP_POPULATE
+#define HCD_MAP_POPULATE MAP_POPULATE
+#else
+#define HCD_MAP_POPULATE 0
+#endif
+
+/* 64-bit FNV-1a parameters */
+#define HCD_DIGEST_OFFSET_BASIS 0xCBF29CE484222325ULL
+#define HCD_DIGEST_PRIME 0x100000001B3ULL
+
+/*****************************************************************************
+**   Helper Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        hcd_patch_map
+**
+** Description     Map the patch file into memory and populate it, fall back
+**                 to a single read into a heap buffer if the file system does
+**                 not support mmap
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+static int hcd_patch_map(hcd_patch_t *p_img, const char *p_path)
+{
+    struct stat st;
+    void *p_map;
+    ssize_t sz;
+    size_t total = 0;
+    int fd;
+
+    if ((fd = open(p_path, O_RDONLY | O_CLOEXEC)) == -1) {
+        HILOGE("hcd patch: open(%s) failed: %s (%d)", p_path, strerror(errno), errno);
+        return -1;
+    }
+
+    if ((fstat(fd, &st) != 0) || (st.st_size <= 0) || (st.st_size > HCD_PATCH_MAX_SIZE)) {
+        HILOGE("hcd patch: %s has invalid size", p_path);
+        close(fd);
+        return -1;
+    }
+
+    p_img->size = (size_t)st.st_size;
+
+    /* start the storage read before the pages are faulted in */
+    (void)posix_fadvise(fd, 0, (off_t)p_img->size, POSIX_FADV_WILLNEED);
+    p_map = mmap(NULL, p_img->size, PROT_READ, MAP_PRIVATE | HCD_MAP_POPULATE, fd, 0);
+    if (p_map != MAP_FAILED) {
+        p_img->p_data = (uint8_t *)p_map;
+        p_img->mapped = TRUE;
+        close(fd);
+        return 0;
+    }
+
+    HILOGW("hcd patch: mmap failed (%d), reading %zu bytes once", errno, p_img->size);
+    if ((p_img->p_data = (uint8_t *)malloc(p_img->size)) == NULL) {
+        close(fd);
+        return -1;
+    }
+    p_img->mapped = FALSE;
+
+    while (total < p_img->size) {
+        sz = read(fd, p_img->p_data + total, p_img->size - total);
+        if (sz < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sz <= 0) {
+            break;
+        }
+        total += (size_t)sz;
+    }
+    close(fd);
+
+    if (total != p_img->size) {
+        HILOGE("hcd patch: short read %zu/%zu", total, p_img->size);
+        return -1;
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function        hcd_patch_index
+**
+** Description     Walk the image, validate every record and build the index.
+**                 Records after HCI_VSC_LAUNCH_RAM are never sent and are
+**                 left out of the index.
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+static int hcd_patch_index(hcd_patch_t *p_img)
+{
+    size_t pos = 0;
+    uint32_t count = 0;
+    uint32_t idx;
+    uint16_t opcode;
+    uint8_t plen;
+    uint8_t launch = FALSE;
+
+    /* first pass: validate and count */
+    while (pos < p_img->size) {
+        if (pos + HCD_REC_HDR_SIZE > p_img->size) {
+            HILOGE("hcd patch: truncated record header at offset %zu", pos);
+            return -1;
+        }
+
+        opcode = (uint16_t)(p_img->p_data[pos] | (p_img->p_data[pos + 1] << 8));
+        plen = p_img->p_data[pos + 2];
+
+        if ((opcode & HCD_OPCODE_VSC_MASK) != HCD_OPCODE_VSC_MASK) {
+            HILOGE("hcd patch: unexpected opcode 0x%04x at offset %zu", opcode, pos);
+            return -1;
+        }
+
+        if (pos + HCD_REC_HDR_SIZE + plen > p_img->size) {
+            HILOGE("hcd patch: record at offset %zu exceeds image", pos);
+            return -1;
+        }
+
+        count++;
+        pos += HCD_REC_HDR_SIZE + plen;
+
+        if (opcode == HCD_OPCODE_LAUNCH_RAM) {
+            launch = TRUE;
+            break;
+        }
+    }
+
+    if (count == 0) {
+        HILOGE("hcd patch: no records");
+        return -1;
+    }
+
+    if (launch == FALSE) {
+        HILOGW("hcd patch: no launch RAM record, firmware patch file might be altered!");
+    } else if (pos < p_img->size) {
+        HILOGW("hcd patch: %zu trailing bytes after launch RAM ignored", p_img->size - pos);
+    }
+
+    p_img->p_rec = (hcd_record_t *)calloc(count, sizeof(hcd_record_t));
+    if (p_img->p_rec == NULL) {
+        return -1;
+    }
+
+    /* second pass: fill the index */
+    pos = 0;
+    for (idx = 0; idx < count; idx++) {
+        p_img->p_rec[idx].offset = (uint32_t)pos;
+        p_img->p_rec[idx].opcode = (uint16_t)(p_img->p_data[pos] | (p_img->p_data[pos + 1] << 8));
+        p_img->p_rec[idx].plen = p_img->p_data[pos + 2];
+        pos += HCD_REC_HDR_SIZE + p_img->p_rec[idx].plen;
+    }
+    p_img->rec_count = count;
+
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function        hcd_patch_digest
+**
+** Description     Digest the whole image, used to tell whether the patch a
+**                 controller runs was built from this very file
+**
+** Returns         64-bit FNV-1a digest
+**
+*******************************************************************************/
+static uint64_t hcd_patch_digest(const hcd_patch_t *p_img)
+{
+    uint64_t digest = HCD_DIGEST_OFFSET_BASIS;
+    size_t pos;
+
+    for (pos = 0; pos < p_img->size; pos++) {
+        digest ^= p_img->p_data[pos];
+        digest *= HCD_DIGEST_PRIME;
+    }
+
+    return digest;
+}
+
+/*****************************************************************************
+**   HCD Patch Interface Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        hcd_patch_load
+**
+** Description     Map (or read once) the patch file and build its record
+**                 index. The image is validated before it is accepted.
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int hcd_patch_load(hcd_patch_t *p_img, const char *p_path)
+{
+    uint64_t start = get_monotonic_time_us();
+
+    hcd_patch_unload(p_img);
+
+    if ((hcd_patch_map(p_img, p_path) != 0) || (hcd_patch_index(p_img) != 0)) {
+        hcd_patch_unload(p_img);
+        return -1;
+    }
+
+    p_img->digest = hcd_patch_digest(p_img);
+    p_img->load_us = get_monotonic_time_us() - start;
+    HILOGI("hcd patch: %s loaded (%zu bytes, %u records, %s, digest %016llx) in %llu us", p_path, p_img->size,
+        p_img->rec_count, p_img->mapped ? "mmap" : "read", (unsigned long long)p_img->digest,
+        (unsigned long long)p_img->load_us);
+
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function        hcd_patch_unload
+**
+** Description     Release the image and its record index
+**
+** Returns         None
+**
+*******************************************************************************/
+void hcd_patch_unload(hcd_patch_t *p_img)
+{
+    if (p_img->p_data != NULL) {
+        if (p_img->mapped) {
+            munmap(p_img->p_data, p_img->size);
+        } else {
+            free(p_img->p_data);
+        }
+    }
+
+    if (p_img->p_rec != NULL) {
+        free(p_img->p_rec);
+    }
+
+    (void)memset_s(p_img, sizeof(hcd_patch_t), 0, sizeof(hcd_patch_t));
+}
+
+/*******************************************************************************
+**
+** Function        hcd_patch_is_loaded
+**
+** Description     Check whether an image is ready for download
+**
+** Returns         TRUE/FALSE
+**
+*******************************************************************************/
+uint8_t hcd_patch_is_loaded(const hcd_patch_t *p_img)
+{
+    return (p_img->p_rec != NULL) ? TRUE : FALSE;
+}
+
+/*******************************************************************************
+**
+** Function        hcd_patch_rewind
+**
+** Description     Restart the download from the first record
+**
+** Returns         None
+**
+*******************************************************************************/
+void hcd_patch_rewind(hcd_patch_t *p_img)
+{
+    p_img->next = 0;
+    p_img->acked = 0;
+    p_img->sent = 0;
+    p_img->bytes_sent = 0;
+    p_img->max_in_flight = 0;
+    p_img->dl_start_us = 0;
+    p_img->dl_end_us = 0;
+}
+
+/*******************************************************************************
+**
+** Function        hcd_patch_resume
+**
+** Description     Resume the download at the oldest record not acknowledged,
+**                 the records in flight are sent again without adding to
+**                 bytes_sent
+**
+** Returns         Number of records to be sent again
+**
+*******************************************************************************/
+uint32_t hcd_patch_resume(hcd_patch_t *p_img)
+{
+    uint32_t lost = p_img->next - p_img->acked;
+
+    p_img->next = p_img->acked;
+    return lost;
+}
+
+/*******************************************************************************
+**
+** Function        hcd_patch_in_flight
+**
+** Description     Number of records sent but not acknowledged yet
+**
+** Returns         Records in flight
+**
+*******************************************************************************/
+uint32_t hcd_patch_in_flight(const hcd_patch_t *p_img)
+{
+    return p_img->next - p_img->acked;
+}
+
+/*******************************************************************************
+**
+** Function        hcd_patch_peek_opcode
+**
+** Description     Opcode of the next record to be sent
+**
+** Returns         HCI opcode, 0 if the image is exhausted
+**
+*******************************************************************************/
+uint16_t hcd_patch_peek_opcode(const hcd_patch_t *p_img)
+{
+    if ((p_img->p_rec == NULL) || (p_img->next >= p_img->rec_count)) {
+        return 0;
+    }
+
+    return p_img->p_rec[p_img->next].opcode;
+}
+
+/*******************************************************************************
+**
+** Function        hcd_patch_fill_next
+**
+** Description     Copy the next record into an HCI command buffer and mark it
+**                 as sent
+**
+** Returns         Length of the command copied into p_cmd, 0 if the image is
+**                 exhausted
+**
+*******************************************************************************/
+uint16_t hcd_patch_fill_next(hcd_patch_t *p_img, uint8_t *p_cmd, uint16_t max_len, uint16_t *p_opcode)
+{
+    hcd_record_t *p_rec;
+    uint16_t len;
+    uint64_t now;
+
+    if ((p_img->p_rec == NULL) || (p_img->next >= p_img->rec_count)) {
+        return 0;
+    }
+
+    p_rec = &p_img->p_rec[p_img->next];
+    len = HCD_REC_HDR_SIZE + p_rec->plen;
+    if (len > max_len) {
+        HILOGE("hcd patch: record %u too long (%u)", p_img->next, len);
+        return 0;
+    }
+
+    if (memcpy_s(p_cmd, max_len, p_img->p_data + p_rec->offset, len) != 0) {
+        return 0;
+    }
+
+    now = get_monotonic_time_us();
+    if (p_img->next == 0) {
+        p_img->dl_start_us = now;
+    }
+    p_rec->tx_us = (uint32_t)(now - p_img->dl_start_us);
+
+    *p_opcode = p_rec->opcode;
+    p_img->next++;
+    if (p_img->next > p_img->sent) {
+        /* records resent after hcd_patch_resume were counted already */
+        p_img->sent = p_img->next;
+        p_img->bytes_sent += len;
+    }
+    if (p_img->next - p_img->acked > p_img->max_in_flight) {
+        p_img->max_in_flight = p_img->next - p_img->acked;
+    }
+
+    return len;
+}
+
+/*******************************************************************************
+**
+** Function        hcd_patch_record_acked
+**
+** Description     Account the command complete of the oldest record in flight
+**
+** Returns         None
+**
+*******************************************************************************/
+void hcd_patch_record_acked(hcd_patch_t *p_img)
+{
+    hcd_record_t *p_rec;
+    uint32_t now;
+
+    if ((p_img->p_rec == NULL) || (p_img->acked >= p_img->next)) {
+        return;
+    }
+
+    p_img->dl_end_us = get_monotonic_time_us();
+    now = (uint32_t)(p_img->dl_end_us - p_img->dl_start_us);
+
+    p_rec = &p_img->p_rec[p_img->acked];
+    p_rec->rtt_us = now - p_rec->tx_us;
+
+    HCDPATCHDBG("hcd patch: record %u opcode 0x%04x len %u rtt %u us", p_img->acked, p_rec->opcode,
+        p_rec->plen, p_rec->rtt_us);
+
+    p_img->acked++;
+}
+
+/*******************************************************************************
+**
+** Function        hcd_patch_report
+**
+** Description     Log per-record and total download timing
+**
+** Returns         None
+**
+*******************************************************************************/
+void hcd_patch_report(const hcd_patch_t *p_img)
+{
+    uint32_t idx;
+    uint32_t rtt_min = UINT32_MAX;
+    uint32_t rtt_max = 0;
+    uint64_t rtt_sum = 0;
+
+    if ((p_img->p_rec == NULL) || (p_img->acked == 0)) {
+        return;
+    }
+
+    for (idx = 0; idx < p_img->acked; idx++) {
+        rtt_sum += p_img->p_rec[idx].rtt_us;
+        if (p_img->p_rec[idx].rtt_us < rtt_min) {
+            rtt_min = p_img->p_rec[idx].rtt_us;
+        }
+        if (p_img->p_rec[idx].rtt_us > rtt_max) {
+            rtt_max = p_img->p_rec[idx].rtt_us;
+        }
+    }
+
+    HILOGI("hcd patch: %u/%u records, %u bytes in %llu us (load %llu us), record rtt min/avg/max %u/%llu/%u us, "
+        "max in flight %u", p_img->acked, p_img->rec_count, p_img->bytes_sent,
+        (unsigned long long)(p_img->dl_end_us - p_img->dl_start_us), (unsigned long long)p_img->load_us,
+        rtt_min, (unsigned long long)(rtt_sum / p_img->acked), rtt_max, p_img->max_in_flight);
+}
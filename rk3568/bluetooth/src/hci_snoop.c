@@ -0,0 +1,804 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      hci_snoop.c
+ *
+ *  Description:   Contains the HCI snoop ring. Writers claim a slot with an
+ *                 atomic increment and publish it with a per-slot sequence
+ *                 number, so recording takes no lock and costs a timestamp
+ *                 and a short copy. Readers copy the ring and drop the
+ *                 slots rewritten under them. A dump is triggered by a
+ *                 signal (HciSnoopSignal), by the conf file (HciSnoopDump)
+ *                 or by calling hci_snoop_dump.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_hci_snoop"
+
+#include <utils/Log.h>
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "bt_vendor_brcm.h"
+#include "hci_snoop.h"
+
+#if (HCI_SNOOP_INCLUDED == TRUE)
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+#if (HCI_SNOOP_RING_SIZE & (HCI_SNOOP_RING_SIZE - 1)) != 0
+#error "HCI_SNOOP_RING_SIZE must be a power of two"
+#endif
+#define HCI_SNOOP_RING_MASK (HCI_SNOOP_RING_SIZE - 1)
+
+#define HCI_SNOOP_H4_CMD 0x01
+#define HCI_SNOOP_H4_EVT 0x04
+
+#define HCI_SNOOP_EVT_CMD_COMPLETE 0x0E
+#define HCI_SNOOP_EVT_CMD_STATUS 0x0F
+
+/* btsnoop file format */
+#define HCI_SNOOP_BTSNOOP_VERSION 1
+#define HCI_SNOOP_BTSNOOP_DATALINK_H4 1002
+#define HCI_SNOOP_BTSNOOP_FLAG_RECEIVED 0x01
+#define HCI_SNOOP_BTSNOOP_FLAG_CMD_EVT 0x02
+/* microseconds from 0000-01-01 to the unix epoch */
+#define HCI_SNOOP_BTSNOOP_EPOCH_DELTA 0x00dcddb30f2f8000ULL
+
+#define HCI_SNOOP_HIST_LINE_LEN 160
+
+/* Commands of one opcode awaiting their answer, the oldest is dropped */
+#define HCI_SNOOP_LAT_PENDING 8
+
+/******************************************************************************
+**  Local type definitions
+******************************************************************************/
+
+/* One recorded packet */
+typedef struct {
+    uint32_t seq;  /* record number + 1, 0 while written */
+    uint16_t len;  /* original length, without the H4 type */
+    uint8_t type;  /* H4 packet type */
+    uint8_t dir;   /* HCI_SNOOP_DIR_xxx */
+    uint8_t ctx;   /* controller the packet went to or came from */
+    uint16_t inflight; /* commands unanswered, the one a Command Complete/Status answers included */
+    uint64_t t_us; /* monotonic */
+    uint8_t data[HCI_SNOOP_DATA_LEN];
+} hci_snoop_rec_t;
+
+typedef void (*hci_snoop_walk_cback_t)(const hci_snoop_rec_t *p_rec, void *p_data);
+
+/* Dump trigger control block */
+typedef struct {
+    char path[HCI_SNOOP_PATH_LEN];
+    int signo;             /* HciSnoopSignal, 0: none */
+    uint8_t dump_on_close; /* HciSnoopDump close */
+    uint8_t armed;         /* signal handler and dump thread running */
+    volatile sig_atomic_t stop;
+    sem_t sem;
+    pthread_t thread;
+    struct sigaction old_action;
+} hci_snoop_cb_t;
+
+/* Latency computation state */
+typedef struct {
+    uint8_t id; /* controller whose packets are paired */
+    hci_snoop_lat_t *p_lat;
+    uint32_t max;
+    uint32_t num;
+    uint32_t orphans; /* answers to commands older than the ring, skipped */
+    uint8_t started;
+    /* unanswered commands per opcode, oldest first: a download window
+     * keeps several of the same opcode in flight
+     */
+    uint64_t sent_us[HCI_SNOOP_MAX_OPCODES][HCI_SNOOP_LAT_PENDING];
+    uint8_t first[HCI_SNOOP_MAX_OPCODES];
+    uint8_t pending[HCI_SNOOP_MAX_OPCODES];
+} hci_snoop_lat_ctx_t;
+
+/* btsnoop writer state */
+typedef struct {
+    uint8_t id; /* controller whose packets are written */
+    FILE *p_file;
+    uint64_t offset_us; /* monotonic to btsnoop time */
+    int written;
+    int failed;
+} hci_snoop_file_ctx_t;
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+static hci_snoop_rec_t hci_snoop_ring[HCI_SNOOP_RING_SIZE];
+static uint32_t hci_snoop_head;     /* records ever claimed */
+static int32_t hci_snoop_inflight[VND_MAX_CONTROLLERS]; /* commands sent and not answered yet */
+static hci_snoop_cb_t hci_snoop_cb = {
+    .path = HCI_SNOOP_FILE,
+};
+static pthread_mutex_t hci_snoop_dump_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*****************************************************************************
+**   Helper Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        hci_snoop_walk
+**
+** Description     Hand a consistent copy of every recorded packet still in
+**                 the ring to p_cback, oldest first
+**
+** Returns         Number of packets rewritten while they were read
+**
+*******************************************************************************/
+static uint32_t hci_snoop_walk(hci_snoop_walk_cback_t p_cback, void *p_data)
+{
+    hci_snoop_rec_t rec;
+    const hci_snoop_rec_t *p_slot;
+    uint32_t head = __atomic_load_n(&hci_snoop_head, __ATOMIC_ACQUIRE);
+    uint32_t n = (head > HCI_SNOOP_RING_SIZE) ? head - HCI_SNOOP_RING_SIZE : 0;
+    uint32_t torn = 0;
+
+    for (; n != head; n++) {
+        p_slot = &hci_snoop_ring[n & HCI_SNOOP_RING_MASK];
+        if (__atomic_load_n(&p_slot->seq, __ATOMIC_ACQUIRE) != n + 1) {
+            torn++;
+            continue;
+        }
+        (void)memcpy_s(&rec, sizeof(rec), p_slot, sizeof(rec));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&p_slot->seq, __ATOMIC_RELAXED) != n + 1) {
+            torn++;
+            continue;
+        }
+        p_cback(&rec, p_data);
+    }
+
+    return torn;
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_opcode
+**
+** Description     Opcode of a command, or of the command a Command
+**                 Complete/Status answers
+**
+** Returns         Opcode, 0 for other packets and credit-only events
+**
+*******************************************************************************/
+static uint16_t hci_snoop_opcode(uint8_t type, const uint8_t *p, uint16_t len)
+{
+    if ((type == HCI_SNOOP_H4_CMD) && (len >= 2)) {
+        return (uint16_t)(p[0] | (p[1] << 8));
+    }
+    if ((type == HCI_SNOOP_H4_EVT) && (p[0] == HCI_SNOOP_EVT_CMD_COMPLETE) && (len >= 5)) {
+        return (uint16_t)(p[3] | (p[4] << 8));
+    }
+    if ((type == HCI_SNOOP_H4_EVT) && (p[0] == HCI_SNOOP_EVT_CMD_STATUS) && (len >= 6)) {
+        return (uint16_t)(p[4] | (p[5] << 8));
+    }
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_lat_add
+**
+** Description     Walk callback pairing commands with their answers
+**
+** Returns         None
+**
+*******************************************************************************/
+static void hci_snoop_lat_add(const hci_snoop_rec_t *p_rec, void *p_data)
+{
+    hci_snoop_lat_ctx_t *p_ctx = (hci_snoop_lat_ctx_t *)p_data;
+    hci_snoop_lat_t *p_lat = NULL;
+    uint16_t opcode = hci_snoop_opcode(p_rec->type, p_rec->data, p_rec->len);
+    uint32_t lat_us;
+    uint32_t bucket = 0;
+    uint32_t i;
+
+    if (p_rec->ctx != p_ctx->id) {
+        return;
+    }
+
+    if (!p_ctx->started) {
+        /* commands sent before the oldest packet kept: their answers must
+         * not be paired with the commands sent after them
+         */
+        p_ctx->started = TRUE;
+        p_ctx->orphans = p_rec->inflight;
+        if ((p_rec->type == HCI_SNOOP_H4_CMD) && (p_ctx->orphans > 0)) {
+            p_ctx->orphans--;
+        }
+    }
+
+    if (opcode == 0) {
+        return;
+    }
+
+    if ((p_rec->type != HCI_SNOOP_H4_CMD) && (p_ctx->orphans > 0)) {
+        p_ctx->orphans--;
+        return;
+    }
+
+    for (i = 0; i < p_ctx->num; i++) {
+        if (p_ctx->p_lat[i].opcode == opcode) {
+            p_lat = &p_ctx->p_lat[i];
+            break;
+        }
+    }
+
+    if (p_rec->type == HCI_SNOOP_H4_CMD) {
+        if ((p_lat == NULL) && (p_ctx->num < p_ctx->max)) {
+            i = p_ctx->num++;
+            p_lat = &p_ctx->p_lat[i];
+            (void)memset_s(p_lat, sizeof(*p_lat), 0, sizeof(*p_lat));
+            p_lat->opcode = opcode;
+            p_lat->min_us = UINT32_MAX;
+        }
+        if (p_lat == NULL) {
+            return;
+        }
+        if (p_ctx->pending[i] == HCI_SNOOP_LAT_PENDING) {
+            /* never answered */
+            p_ctx->first[i] = (p_ctx->first[i] + 1) % HCI_SNOOP_LAT_PENDING;
+            p_ctx->pending[i]--;
+        }
+        p_ctx->sent_us[i][(p_ctx->first[i] + p_ctx->pending[i]) % HCI_SNOOP_LAT_PENDING] = p_rec->t_us;
+        p_ctx->pending[i]++;
+        return;
+    }
+
+    if ((p_lat == NULL) || (p_ctx->pending[i] == 0)) {
+        return;
+    }
+
+    lat_us = (uint32_t)(p_rec->t_us - p_ctx->sent_us[i][p_ctx->first[i]]);
+    p_ctx->first[i] = (p_ctx->first[i] + 1) % HCI_SNOOP_LAT_PENDING;
+    p_ctx->pending[i]--;
+    while ((bucket < HCI_SNOOP_LAT_BUCKETS - 1) && (lat_us >= (HCI_SNOOP_LAT_BASE_US << bucket))) {
+        bucket++;
+    }
+    p_lat->hist[bucket]++;
+    p_lat->count++;
+    p_lat->total_us += lat_us;
+    p_lat->min_us = (lat_us < p_lat->min_us) ? lat_us : p_lat->min_us;
+    p_lat->max_us = (lat_us > p_lat->max_us) ? lat_us : p_lat->max_us;
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_put_be
+**
+** Description     Store a value big endian
+**
+** Returns         Pointer past the value
+**
+*******************************************************************************/
+static uint8_t *hci_snoop_put_be(uint8_t *p, uint64_t value, uint8_t bytes)
+{
+    while (bytes-- > 0) {
+        *p++ = (uint8_t)(value >> (bytes * 8));
+    }
+    return p;
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_write_rec
+**
+** Description     Walk callback writing a btsnoop packet record
+**
+** Returns         None
+**
+*******************************************************************************/
+static void hci_snoop_write_rec(const hci_snoop_rec_t *p_rec, void *p_data)
+{
+    hci_snoop_file_ctx_t *p_ctx = (hci_snoop_file_ctx_t *)p_data;
+    uint8_t hdr[24];
+    uint8_t *p = hdr;
+    uint16_t incl = (p_rec->len < HCI_SNOOP_DATA_LEN) ? p_rec->len : HCI_SNOOP_DATA_LEN;
+    uint32_t flags = (p_rec->dir == HCI_SNOOP_DIR_RECEIVED) ? HCI_SNOOP_BTSNOOP_FLAG_RECEIVED : 0;
+
+    if (p_rec->ctx != p_ctx->id) {
+        return;
+    }
+
+    if ((p_rec->type == HCI_SNOOP_H4_CMD) || (p_rec->type == HCI_SNOOP_H4_EVT)) {
+        flags |= HCI_SNOOP_BTSNOOP_FLAG_CMD_EVT;
+    }
+
+    p = hci_snoop_put_be(p, (uint64_t)p_rec->len + 1, sizeof(uint32_t)); /* original length, H4 type included */
+    p = hci_snoop_put_be(p, (uint64_t)incl + 1, sizeof(uint32_t));
+    p = hci_snoop_put_be(p, flags, sizeof(uint32_t));
+    p = hci_snoop_put_be(p, 0, sizeof(uint32_t)); /* cumulative drops */
+    (void)hci_snoop_put_be(p, p_rec->t_us + p_ctx->offset_us, sizeof(uint64_t));
+
+    if ((fwrite(hdr, sizeof(hdr), 1, p_ctx->p_file) != 1) || (fputc(p_rec->type, p_ctx->p_file) == EOF) ||
+        (fwrite(p_rec->data, 1, incl, p_ctx->p_file) != incl)) {
+        p_ctx->failed = TRUE;
+        return;
+    }
+    p_ctx->written++;
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_latency_of
+**
+** Description     Compute the per-opcode command latency histograms of one
+**                 controller
+**
+** Returns         Number of opcodes filled in p_lat
+**
+*******************************************************************************/
+static uint32_t hci_snoop_latency_of(uint8_t id, hci_snoop_lat_t *p_lat, uint32_t max)
+{
+    hci_snoop_lat_ctx_t ctx;
+
+    (void)memset_s(&ctx, sizeof(ctx), 0, sizeof(ctx));
+    ctx.id = id;
+    ctx.p_lat = p_lat;
+    ctx.max = (max < HCI_SNOOP_MAX_OPCODES) ? max : HCI_SNOOP_MAX_OPCODES;
+    (void)hci_snoop_walk(hci_snoop_lat_add, &ctx);
+    return ctx.num;
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_log_latency
+**
+** Description     Log the per-opcode latency histograms of one controller
+**
+** Returns         None
+**
+*******************************************************************************/
+static void hci_snoop_log_latency(uint8_t id)
+{
+    hci_snoop_lat_t lat[HCI_SNOOP_MAX_OPCODES];
+    char line[HCI_SNOOP_HIST_LINE_LEN];
+    uint32_t num = hci_snoop_latency_of(id, lat, HCI_SNOOP_MAX_OPCODES);
+    uint32_t i;
+    uint32_t b;
+    int pos;
+    int ret;
+
+    for (i = 0; i < num; i++) {
+        if (lat[i].count == 0) {
+            continue;
+        }
+        pos = 0;
+        for (b = 0; b < HCI_SNOOP_LAT_BUCKETS; b++) {
+            ret = snprintf_s(line + pos, sizeof(line) - pos, sizeof(line) - pos - 1, "%s%u", b ? " " : "",
+                lat[i].hist[b]);
+            if (ret < 0) {
+                break;
+            }
+            pos += ret;
+        }
+        HILOGI("snoop %u 0x%04x: %u cmds, min/avg/max %u/%u/%u us, <64us..>=256ms [%s]", id, lat[i].opcode,
+            lat[i].count, lat[i].min_us, (uint32_t)(lat[i].total_us / lat[i].count), lat[i].max_us, line);
+    }
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_sig_handler
+**
+** Description     HciSnoopSignal handler, wakes the dump thread
+**
+** Returns         None
+**
+*******************************************************************************/
+static void hci_snoop_sig_handler(int signo)
+{
+    (void)sem_post(&hci_snoop_cb.sem);
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_thread
+**
+** Description     Dump the ring each time HciSnoopSignal is received. File
+**                 I/O is not allowed in the signal handler.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void *hci_snoop_thread(void *arg)
+{
+    while (!hci_snoop_cb.stop) {
+        if ((sem_wait(&hci_snoop_cb.sem) != 0) || hci_snoop_cb.stop) {
+            continue;
+        }
+        (void)hci_snoop_dump(NULL);
+    }
+    return NULL;
+}
+
+/*****************************************************************************
+**   Snoop Interface Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        hci_snoop_init
+**
+** Description     Start a session of the calling thread's controller and
+**                 arm the HciSnoopSignal dump trigger. Recording needs no
+**                 initialisation and runs from the first packet on.
+**
+** Returns         None
+**
+*******************************************************************************/
+void hci_snoop_init(void)
+{
+    struct sigaction action;
+
+    /* a new controller session, nothing is outstanding */
+    __atomic_store_n(&hci_snoop_inflight[vnd_ctx_id()], 0, __ATOMIC_RELAXED);
+
+    if ((hci_snoop_cb.signo <= 0) || hci_snoop_cb.armed) {
+        return;
+    }
+
+    if (sem_init(&hci_snoop_cb.sem, 0, 0) != 0) {
+        HILOGE("snoop: sem_init failed (%s)", strerror(errno));
+        return;
+    }
+
+    hci_snoop_cb.stop = FALSE;
+    if (pthread_create(&hci_snoop_cb.thread, NULL, hci_snoop_thread, NULL) != 0) {
+        HILOGE("snoop: no dump thread");
+        (void)sem_destroy(&hci_snoop_cb.sem);
+        return;
+    }
+
+    (void)memset_s(&action, sizeof(action), 0, sizeof(action));
+    action.sa_handler = hci_snoop_sig_handler;
+    action.sa_flags = SA_RESTART;
+    (void)sigemptyset(&action.sa_mask);
+    if (sigaction(hci_snoop_cb.signo, &action, &hci_snoop_cb.old_action) != 0) {
+        HILOGE("snoop: signal %d not usable (%s)", hci_snoop_cb.signo, strerror(errno));
+        hci_snoop_cb.stop = TRUE;
+        (void)sem_post(&hci_snoop_cb.sem);
+        (void)pthread_join(hci_snoop_cb.thread, NULL);
+        (void)sem_destroy(&hci_snoop_cb.sem);
+        return;
+    }
+
+    hci_snoop_cb.armed = TRUE;
+    HILOGI("snoop: signal %d dumps to %s", hci_snoop_cb.signo, hci_snoop_cb.path);
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_record
+**
+** Description     Record a packet of the calling thread's controller, H4
+**                 type first. Lock-free, safe from any thread.
+**
+** Returns         None
+**
+*******************************************************************************/
+void hci_snoop_record(uint8_t type, uint8_t dir, const uint8_t *p_data, uint16_t len)
+{
+    uint32_t n = __atomic_fetch_add(&hci_snoop_head, 1, __ATOMIC_RELAXED);
+    hci_snoop_rec_t *p_slot = &hci_snoop_ring[n & HCI_SNOOP_RING_MASK];
+    uint16_t incl = (len < HCI_SNOOP_DATA_LEN) ? len : HCI_SNOOP_DATA_LEN;
+    uint8_t id = vnd_ctx_id();
+    int32_t inflight;
+
+    if (type == HCI_SNOOP_H4_CMD) {
+        inflight = __atomic_add_fetch(&hci_snoop_inflight[id], 1, __ATOMIC_RELAXED);
+    } else if ((type == HCI_SNOOP_H4_EVT) && (hci_snoop_opcode(type, p_data, len) != 0)) {
+        inflight = __atomic_fetch_sub(&hci_snoop_inflight[id], 1, __ATOMIC_RELAXED);
+        if (inflight <= 0) {
+            /* answer to a command sent before init */
+            __atomic_add_fetch(&hci_snoop_inflight[id], 1, __ATOMIC_RELAXED);
+            inflight = 0;
+        }
+    } else {
+        inflight = __atomic_load_n(&hci_snoop_inflight[id], __ATOMIC_RELAXED);
+    }
+
+    __atomic_store_n(&p_slot->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    p_slot->type = type;
+    p_slot->inflight = (inflight > UINT16_MAX) ? UINT16_MAX : (uint16_t)inflight;
+    p_slot->dir = dir;
+    p_slot->ctx = id;
+    p_slot->len = len;
+    p_slot->t_us = get_monotonic_time_us();
+    if (incl > 0) {
+        (void)memcpy_s(p_slot->data, HCI_SNOOP_DATA_LEN, p_data, incl);
+    }
+    __atomic_store_n(&p_slot->seq, n + 1, __ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_cmd
+**
+** Description     Record an HCI command handed to xmit_cb
+**
+** Returns         None
+**
+*******************************************************************************/
+void hci_snoop_cmd(const HC_BT_HDR *p_buf)
+{
+    hci_snoop_record(HCI_SNOOP_H4_CMD, HCI_SNOOP_DIR_SENT, (const uint8_t *)(p_buf + 1) + p_buf->offset, p_buf->len);
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_evt
+**
+** Description     Record an HCI event received through hw_process_event
+**
+** Returns         None
+**
+*******************************************************************************/
+void hci_snoop_evt(const HC_BT_HDR *p_buf)
+{
+    hci_snoop_record(HCI_SNOOP_H4_EVT, HCI_SNOOP_DIR_RECEIVED, (const uint8_t *)(p_buf + 1) + p_buf->offset,
+        p_buf->len);
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_latency
+**
+** Description     Compute the per-opcode command latency histograms of the
+**                 calling thread's controller from the packets in the ring
+**
+** Returns         Number of opcodes filled in p_lat
+**
+*******************************************************************************/
+uint32_t hci_snoop_latency(hci_snoop_lat_t *p_lat, uint32_t max)
+{
+    return hci_snoop_latency_of(vnd_ctx_id(), p_lat, max);
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_dump_ctx
+**
+** Description     Write the packets of one controller to a btsnoop file.
+**                 Must be called with hci_snoop_dump_lock held.
+**
+** Returns         Number of packets written, -1 on failure
+**
+*******************************************************************************/
+static int hci_snoop_dump_ctx(uint8_t id, const char *p_path)
+{
+    hci_snoop_file_ctx_t ctx;
+    char tmp_path[HCI_SNOOP_PATH_LEN + 4];
+    uint8_t hdr[16];
+    uint8_t *p = hdr;
+    struct timespec ts;
+    uint32_t torn;
+    uint32_t head;
+
+    if (snprintf_s(tmp_path, sizeof(tmp_path), sizeof(tmp_path) - 1, "%s.tmp", p_path) < 0) {
+        return -1;
+    }
+
+    (void)memset_s(&ctx, sizeof(ctx), 0, sizeof(ctx));
+    ctx.id = id;
+    if ((ctx.p_file = fopen(tmp_path, "wb")) == NULL) {
+        HILOGE("snoop: cannot open %s (%s)", tmp_path, strerror(errno));
+        return -1;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ctx.offset_us = (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000 - get_monotonic_time_us() +
+        HCI_SNOOP_BTSNOOP_EPOCH_DELTA;
+
+    (void)memcpy_s(p, sizeof(hdr), "btsnoop", 8);
+    p += 8;
+    p = hci_snoop_put_be(p, HCI_SNOOP_BTSNOOP_VERSION, sizeof(uint32_t));
+    (void)hci_snoop_put_be(p, HCI_SNOOP_BTSNOOP_DATALINK_H4, sizeof(uint32_t));
+    ctx.failed = (fwrite(hdr, sizeof(hdr), 1, ctx.p_file) != 1);
+
+    head = __atomic_load_n(&hci_snoop_head, __ATOMIC_ACQUIRE);
+    torn = ctx.failed ? 0 : hci_snoop_walk(hci_snoop_write_rec, &ctx);
+
+    if ((fclose(ctx.p_file) != 0) || ctx.failed) {
+        HILOGE("snoop: writing %s failed (%s)", p_path, strerror(errno));
+        (void)unlink(tmp_path);
+        return -1;
+    }
+
+    /* the other controllers only get a file once they carried traffic */
+    if ((id > 0) && (ctx.written == 0)) {
+        (void)unlink(tmp_path);
+        return 0;
+    }
+
+    if (rename(tmp_path, p_path) != 0) {
+        HILOGE("snoop: writing %s failed (%s)", p_path, strerror(errno));
+        (void)unlink(tmp_path);
+        return -1;
+    }
+
+    HILOGI("snoop: %d packets dumped to %s, %u overwritten, %u rewritten while read", ctx.written, p_path,
+        (head > HCI_SNOOP_RING_SIZE) ? head - HCI_SNOOP_RING_SIZE : 0, torn);
+    hci_snoop_log_latency(id);
+    return ctx.written;
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_dump
+**
+** Description     Write the ring to btsnoop files (H4 datalink), one per
+**                 controller, and log the per-opcode latency histograms.
+**                 NULL p_path uses HciSnoopFile; controller n > 0 gets the
+**                 path suffixed with .<n>. Each file is written aside and
+**                 renamed so a reader never sees a partial dump.
+**
+** Returns         Number of packets written, -1 on failure
+**
+*******************************************************************************/
+int hci_snoop_dump(const char *p_path)
+{
+    char path[HCI_SNOOP_PATH_LEN + 4];
+    int written = 0;
+    int ret = 0;
+    uint8_t id;
+
+    pthread_mutex_lock(&hci_snoop_dump_lock);
+    if (p_path == NULL) {
+        p_path = hci_snoop_cb.path;
+    }
+    for (id = 0; id < VND_MAX_CONTROLLERS; id++) {
+        if (id == 0) {
+            ret = (strcpy_s(path, sizeof(path), p_path) == 0) ? 0 : -1;
+        } else {
+            ret = snprintf_s(path, sizeof(path), sizeof(path) - 1, "%s.%u", p_path, id);
+        }
+        if ((ret < 0) || ((ret = hci_snoop_dump_ctx(id, path)) < 0)) {
+            ret = -1;
+            break;
+        }
+        written += ret;
+    }
+    pthread_mutex_unlock(&hci_snoop_dump_lock);
+
+    return (ret < 0) ? -1 : written;
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_cleanup
+**
+** Description     Dump the ring if HciSnoopDump asks for it on close and
+**                 disarm the signal trigger. The ring itself is kept.
+**
+** Returns         None
+**
+*******************************************************************************/
+void hci_snoop_cleanup(void)
+{
+    if (hci_snoop_cb.dump_on_close) {
+        (void)hci_snoop_dump(NULL);
+    }
+
+    if (!hci_snoop_cb.armed) {
+        return;
+    }
+
+    (void)sigaction(hci_snoop_cb.signo, &hci_snoop_cb.old_action, NULL);
+    hci_snoop_cb.stop = TRUE;
+    (void)sem_post(&hci_snoop_cb.sem);
+    (void)pthread_join(hci_snoop_cb.thread, NULL);
+    (void)sem_destroy(&hci_snoop_cb.sem);
+    hci_snoop_cb.armed = FALSE;
+}
+
+/*****************************************************************************
+**   Snoop Configuration Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        hci_snoop_set_file
+**
+** Description     Conf action for HciSnoopFile
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int hci_snoop_set_file(char *p_conf_name, char *p_conf_value, int param)
+{
+    int ret;
+
+    pthread_mutex_lock(&hci_snoop_dump_lock);
+    ret = strcpy_s(hci_snoop_cb.path, sizeof(hci_snoop_cb.path), p_conf_value);
+    pthread_mutex_unlock(&hci_snoop_dump_lock);
+    return ret;
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_set_signal
+**
+** Description     Conf action for HciSnoopSignal, the signal number that
+**                 dumps the ring (e.g. 10 for SIGUSR1), 0 for none. Taken
+**                 into account at the next init.
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int hci_snoop_set_signal(char *p_conf_name, char *p_conf_value, int param)
+{
+    int signo = atoi(p_conf_value);
+
+    if ((signo < 0) || (signo >= NSIG) || (signo == SIGKILL) || (signo == SIGSTOP)) {
+        HILOGE("snoop: invalid %s %s", p_conf_name, p_conf_value);
+        return -1;
+    }
+    hci_snoop_cb.signo = signo;
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function        hci_snoop_set_dump
+**
+** Description     Conf action for HciSnoopDump: "now" dumps the ring when
+**                 the entry is read, "close" on every vendor library
+**                 cleanup, "off" never
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int hci_snoop_set_dump(char *p_conf_name, char *p_conf_value, int param)
+{
+    if (strcmp(p_conf_value, "now") == 0) {
+        return (hci_snoop_dump(NULL) < 0) ? -1 : 0;
+    }
+    if (strcmp(p_conf_value, "close") == 0) {
+        hci_snoop_cb.dump_on_close = TRUE;
+        return 0;
+    }
+    if (strcmp(p_conf_value, "off") == 0) {
+        hci_snoop_cb.dump_on_close = FALSE;
+        return 0;
+    }
+    HILOGE("snoop: invalid %s %s", p_conf_name, p_conf_value);
+    return -1;
+}
+
+#endif // HCI_SNOOP_INCLUDED
@@ -0,0 +1,491 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      host_wake.c
+ *
+ *  Description:   Contains the HOST_WAKE monitor. The line is requested from
+ *                 its GPIO character device with both edges enabled, so the
+ *                 kernel time stamps every transition and queues it on the
+ *                 line fd; a thread sleeping in epoll picks the edges up
+ *                 without polling. An assertion takes a wakelock so the
+ *                 host stays up for the inbound traffic, dropped
+ *                 HOST_WAKE_HOLD_MS after the controller releases the line.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_host_wake"
+
+#include <utils/Log.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/gpio.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include "bt_vendor_brcm.h"
+#include "host_wake.h"
+#include "vnd_board.h"
+#include "vnd_timer.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+#define HOST_WAKE_LOCK_NODE "/sys/power/wake_lock"
+#define HOST_WAKE_UNLOCK_NODE "/sys/power/wake_unlock"
+
+#define HOST_WAKE_GPIO_LEN 64     /* "<gpiochip>:<offset>" */
+#define HOST_WAKE_PATH_LEN 80
+#define HOST_WAKE_LOCK_NAME_LEN 32
+#define HOST_WAKE_EVENT_BATCH 16  /* edges read at once */
+
+/******************************************************************************
+**  Local type definitions
+******************************************************************************/
+
+/* HOST_WAKE monitor control block */
+typedef struct {
+    char gpio[HOST_WAKE_GPIO_LEN]; /* line set in the conf file, empty: board profile */
+    uint8_t running;
+    uint8_t polarity;
+    uint8_t asserted;
+    uint64_t assert_us;            /* edge asserting the line */
+    int line_fd;
+    int epoll_fd;
+    int stop_fd;                   /* eventfd waking the monitor up for exit */
+    pthread_t thread;
+    host_wake_cback_t p_cback;
+    int lock_fd;                   /* wakelock nodes, -1: no wakelock support */
+    int unlock_fd;
+    char lock_name[HOST_WAKE_LOCK_NAME_LEN];
+    uint8_t locked;
+    uint64_t lock_us;
+    vnd_timer_t *p_timer;          /* delayed wakelock release */
+    host_wake_stats_t stats;
+} host_wake_cb_t;
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+static host_wake_cb_t host_wake_cbs[VND_MAX_CONTROLLERS] = {
+    [0 ... VND_MAX_CONTROLLERS - 1] = {
+        .line_fd = -1,
+        .epoll_fd = -1,
+        .stop_fd = -1,
+        .lock_fd = -1,
+        .unlock_fd = -1,
+    }
+};
+static pthread_mutex_t host_wake_locks[VND_MAX_CONTROLLERS] = {
+    [0 ... VND_MAX_CONTROLLERS - 1] = PTHREAD_MUTEX_INITIALIZER
+};
+
+/* control block of the calling thread's controller */
+#define host_wake_cb (host_wake_cbs[vnd_ctx_id()])
+#define host_wake_lock (host_wake_locks[vnd_ctx_id()])
+
+/*****************************************************************************
+**   Helper Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        host_wake_request_line
+**
+** Description     Request the "<gpiochip>:<offset>" line as an input
+**                 reporting both edges, and read its current level
+**
+** Returns         Line fd, -1 if it cannot be requested
+**
+*******************************************************************************/
+static int host_wake_request_line(const char *p_spec, uint8_t *p_level)
+{
+#ifdef GPIO_V2_GET_LINE_IOCTL
+    struct gpio_v2_line_request req;
+    struct gpio_v2_line_values values;
+    char path[HOST_WAKE_PATH_LEN];
+    const char *p_sep = strrchr(p_spec, ':');
+    char *p_end = NULL;
+    unsigned long offset;
+    int chip_fd;
+
+    if ((p_sep == NULL) || (p_sep == p_spec)) {
+        HILOGE("host wake: bad line %s, <gpiochip>:<offset> expected", p_spec);
+        return -1;
+    }
+    offset = strtoul(p_sep + 1, &p_end, 10); /* 10: decimal */
+    if ((p_end == p_sep + 1) || (*p_end != '\0')) {
+        HILOGE("host wake: bad line offset in %s", p_spec);
+        return -1;
+    }
+    if (snprintf_s(path, sizeof(path), sizeof(path) - 1, "%s%.*s", (p_spec[0] == '/') ? "" : "/dev/",
+        (int)(p_sep - p_spec), p_spec) < 0) {
+        return -1;
+    }
+
+    if ((chip_fd = open(path, O_RDONLY | O_CLOEXEC)) < 0) {
+        HILOGE("host wake: cannot open %s: %s (%d)", path, strerror(errno), errno);
+        return -1;
+    }
+
+    memset_s(&req, sizeof(req), 0, sizeof(req));
+    req.offsets[0] = (uint32_t)offset;
+    req.num_lines = 1;
+    req.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING | GPIO_V2_LINE_FLAG_EDGE_FALLING;
+    (void)strcpy_s(req.consumer, sizeof(req.consumer), HOST_WAKE_LOCK_NAME);
+    if (ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &req) < 0) {
+        /* EBUSY: a kernel driver (rfkill-bt) owns the line */
+        HILOGE("host wake: cannot request %s line %lu: %s (%d)", path, offset, strerror(errno), errno);
+        close(chip_fd);
+        return -1;
+    }
+    close(chip_fd);
+
+    memset_s(&values, sizeof(values), 0, sizeof(values));
+    values.mask = 1;
+    if (ioctl(req.fd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) < 0) {
+        HILOGE("host wake: cannot read %s line %lu: %s (%d)", path, offset, strerror(errno), errno);
+        close(req.fd);
+        return -1;
+    }
+    *p_level = (uint8_t)(values.bits & 1);
+
+    return req.fd;
+#else
+    HILOGE("host wake: GPIO character device v2 not supported, %s not followed", p_spec);
+    return -1;
+#endif
+}
+
+/*******************************************************************************
+**
+** Function        host_wake_wakelock
+**
+** Description     Take or drop the wakelock. Must be called with
+**                 host_wake_lock held.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void host_wake_wakelock(uint8_t acquire)
+{
+    int fd = acquire ? host_wake_cb.lock_fd : host_wake_cb.unlock_fd;
+    size_t len = strlen(host_wake_cb.lock_name);
+    uint64_t now;
+
+    if ((acquire == host_wake_cb.locked) || (fd < 0)) {
+        return;
+    }
+
+    if (write(fd, host_wake_cb.lock_name, len) != (ssize_t)len) {
+        HILOGE("host wake: wakelock %s failed: %s (%d)", host_wake_cb.lock_name, strerror(errno), errno);
+        return;
+    }
+
+    now = get_monotonic_time_us();
+    host_wake_cb.locked = acquire;
+    if (acquire) {
+        host_wake_cb.lock_us = now;
+        host_wake_cb.stats.locks++;
+    } else {
+        host_wake_cb.stats.locked_ms += (now - host_wake_cb.lock_us) / BT_VENDOR_TIME_RAIDX;
+    }
+}
+
+/*******************************************************************************
+**
+** Function        host_wake_release
+**
+** Description     Hold time after the line dropped is over: let the host
+**                 suspend
+**
+** Returns         None
+**
+*******************************************************************************/
+static void host_wake_release(void *p_data)
+{
+    pthread_mutex_lock(&host_wake_lock);
+    if (host_wake_cb.running && !host_wake_cb.asserted) {
+        host_wake_wakelock(FALSE);
+    }
+    pthread_mutex_unlock(&host_wake_lock);
+}
+
+/*******************************************************************************
+**
+** Function        host_wake_edge
+**
+** Description     Handle a transition of the line to level at edge_us
+**
+** Returns         None
+**
+*******************************************************************************/
+static void host_wake_edge(uint8_t level, uint64_t edge_us)
+{
+    host_wake_stats_t *p_stats = &host_wake_cb.stats;
+    uint8_t asserted = (level == host_wake_cb.polarity);
+    uint64_t now = get_monotonic_time_us();
+    uint32_t lat_us;
+
+    pthread_mutex_lock(&host_wake_lock);
+    if (asserted == host_wake_cb.asserted) {
+        /* glitch, or a pulse shorter than the edge queue could tell apart */
+        p_stats->spurious++;
+        pthread_mutex_unlock(&host_wake_lock);
+        return;
+    }
+
+    host_wake_cb.asserted = asserted;
+    if (asserted) {
+        p_stats->wakes++;
+        lat_us = (now > edge_us) ? (uint32_t)(now - edge_us) : 0;
+        p_stats->lat_sum_us += lat_us;
+        if (lat_us > p_stats->lat_max_us) {
+            p_stats->lat_max_us = lat_us;
+        }
+        host_wake_cb.assert_us = edge_us;
+        vnd_timer_stop(host_wake_cb.p_timer);
+        host_wake_wakelock(TRUE);
+    } else {
+        p_stats->asserted_ms += (edge_us - host_wake_cb.assert_us) / BT_VENDOR_TIME_RAIDX;
+        if ((HOST_WAKE_HOLD_MS == 0) || (host_wake_cb.p_timer == NULL) ||
+            (vnd_timer_start(host_wake_cb.p_timer, HOST_WAKE_HOLD_MS, FALSE) != 0)) {
+            host_wake_wakelock(FALSE);
+        }
+    }
+    pthread_mutex_unlock(&host_wake_lock);
+
+    host_wake_cb.p_cback(asserted, edge_us);
+}
+
+/*******************************************************************************
+**
+** Function        host_wake_thread
+**
+** Description     Monitor thread: sleep until the line reports edges or the
+**                 monitor is stopped
+**
+** Returns         NULL
+**
+*******************************************************************************/
+static void *host_wake_thread(void *arg)
+{
+#ifdef GPIO_V2_GET_LINE_IOCTL
+    struct gpio_v2_line_event events[HOST_WAKE_EVENT_BATCH];
+    struct epoll_event ev;
+    ssize_t len;
+    size_t i;
+
+    vnd_ctx_bind_thread(arg);
+    for (;;) {
+        if (epoll_wait(host_wake_cb.epoll_fd, &ev, 1, -1) <= 0) {
+            continue;
+        }
+
+        if (ev.data.fd == host_wake_cb.stop_fd) {
+            break;
+        }
+
+        len = read(host_wake_cb.line_fd, events, sizeof(events));
+        if (len <= 0) {
+            if ((len < 0) && ((errno == EINTR) || (errno == EAGAIN))) {
+                continue;
+            }
+            HILOGE("host wake: read failed: %s (%d)", strerror(errno), errno);
+            break;
+        }
+
+        for (i = 0; i < (size_t)len / sizeof(events[0]); i++) {
+            host_wake_edge(events[i].id == GPIO_V2_LINE_EVENT_RISING_EDGE,
+                events[i].timestamp_ns / BT_VENDOR_TIME_RAIDX);
+        }
+    }
+#endif
+
+    return NULL;
+}
+
+/*******************************************************************************
+**
+** Function        host_wake_close
+**
+** Description     Release the descriptors of the monitor
+**
+** Returns         None
+**
+*******************************************************************************/
+static void host_wake_close(void)
+{
+    int *p_fds[] = {&host_wake_cb.line_fd, &host_wake_cb.epoll_fd, &host_wake_cb.stop_fd,
+        &host_wake_cb.lock_fd, &host_wake_cb.unlock_fd};
+    size_t i;
+
+    for (i = 0; i < sizeof(p_fds) / sizeof(p_fds[0]); i++) {
+        if (*p_fds[i] >= 0) {
+            close(*p_fds[i]);
+            *p_fds[i] = -1;
+        }
+    }
+    if (host_wake_cb.p_timer != NULL) {
+        vnd_timer_free(host_wake_cb.p_timer);
+        host_wake_cb.p_timer = NULL;
+    }
+}
+
+/*****************************************************************************
+**   HOST_WAKE Monitor Interface Functions
+*****************************************************************************/
+
+int host_wake_start(uint8_t polarity, host_wake_cback_t p_cback)
+{
+    const char *p_spec = host_wake_cb.gpio;
+    struct epoll_event ev;
+    uint8_t level = 0;
+
+    if (host_wake_cb.running) {
+        return 0;
+    }
+
+    if (p_spec[0] == '\0') {
+        p_spec = vnd_board_get()->p_host_wake;
+    }
+    if (p_spec == NULL) {
+        HILOGI("host wake: no line configured, not followed");
+        return -1;
+    }
+
+    if ((host_wake_cb.line_fd = host_wake_request_line(p_spec, &level)) < 0) {
+        return -1;
+    }
+
+    host_wake_cb.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    host_wake_cb.stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if ((host_wake_cb.epoll_fd < 0) || (host_wake_cb.stop_fd < 0)) {
+        HILOGE("host wake: epoll/eventfd failed: %s (%d)", strerror(errno), errno);
+        goto fail;
+    }
+
+    memset_s(&ev, sizeof(ev), 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = host_wake_cb.stop_fd;
+    if (epoll_ctl(host_wake_cb.epoll_fd, EPOLL_CTL_ADD, host_wake_cb.stop_fd, &ev) != 0) {
+        goto fail;
+    }
+
+    /* EPOLLWAKEUP keeps the host awake from the edge until the wakelock is taken */
+    ev.events = EPOLLIN | EPOLLWAKEUP;
+    ev.data.fd = host_wake_cb.line_fd;
+    if (epoll_ctl(host_wake_cb.epoll_fd, EPOLL_CTL_ADD, host_wake_cb.line_fd, &ev) != 0) {
+        HILOGE("host wake: cannot poll line: %s (%d)", strerror(errno), errno);
+        goto fail;
+    }
+
+    host_wake_cb.lock_fd = open(HOST_WAKE_LOCK_NODE, O_WRONLY | O_CLOEXEC);
+    host_wake_cb.unlock_fd = open(HOST_WAKE_UNLOCK_NODE, O_WRONLY | O_CLOEXEC);
+    if ((host_wake_cb.lock_fd < 0) || (host_wake_cb.unlock_fd < 0)) {
+        HILOGW("host wake: no wakelock support: %s (%d)", strerror(errno), errno);
+    }
+    (void)vnd_ctx_name(HOST_WAKE_LOCK_NAME, host_wake_cb.lock_name, sizeof(host_wake_cb.lock_name));
+    host_wake_cb.p_timer = vnd_timer_alloc(host_wake_release, NULL);
+
+    memset_s(&host_wake_cb.stats, sizeof(host_wake_cb.stats), 0, sizeof(host_wake_cb.stats));
+    host_wake_cb.polarity = polarity;
+    host_wake_cb.p_cback = p_cback;
+    host_wake_cb.asserted = FALSE;
+    host_wake_cb.locked = FALSE;
+    host_wake_cb.running = TRUE;
+
+    if (pthread_create(&host_wake_cb.thread, NULL, host_wake_thread, VND_CTX_THREAD_ARG()) != 0) {
+        HILOGE("host wake: pthread_create failed");
+        host_wake_cb.running = FALSE;
+        goto fail;
+    }
+
+    HILOGI("host wake: following %s, active %s", p_spec, polarity ? "high" : "low");
+    /* the controller may hold the line already */
+    if (level == polarity) {
+        host_wake_edge(level, get_monotonic_time_us());
+    }
+    return 0;
+
+fail:
+    host_wake_close();
+    return -1;
+}
+
+void host_wake_stop(void)
+{
+    host_wake_stats_t *p_stats = &host_wake_cb.stats;
+    uint64_t one = 1;
+
+    if (!host_wake_cb.running) {
+        return;
+    }
+
+    if (write(host_wake_cb.stop_fd, &one, sizeof(one)) < 0) {
+        HILOGE("host wake: stop signal failed: %s (%d)", strerror(errno), errno);
+    }
+    pthread_join(host_wake_cb.thread, NULL);
+
+    pthread_mutex_lock(&host_wake_lock);
+    host_wake_cb.running = FALSE;
+    host_wake_wakelock(FALSE);
+    host_wake_close();
+    pthread_mutex_unlock(&host_wake_lock);
+
+    HILOGI("host wake: %u wakes (%u spurious), asserted %llu ms, %u wakelocks held %llu ms, "
+        "latency avg %llu us max %u us", p_stats->wakes, p_stats->spurious,
+        (unsigned long long)p_stats->asserted_ms, p_stats->locks, (unsigned long long)p_stats->locked_ms,
+        (unsigned long long)((p_stats->wakes > 0) ? p_stats->lat_sum_us / p_stats->wakes : 0),
+        p_stats->lat_max_us);
+}
+
+uint8_t host_wake_is_running(void)
+{
+    return host_wake_cb.running;
+}
+
+void host_wake_get_stats(host_wake_stats_t *p_stats)
+{
+    pthread_mutex_lock(&host_wake_lock);
+    (void)memcpy_s(p_stats, sizeof(*p_stats), &host_wake_cb.stats, sizeof(host_wake_cb.stats));
+    pthread_mutex_unlock(&host_wake_lock);
+}
+
+/*******************************************************************************
+**
+** Function        host_wake_set_gpio
+**
+** Description     Configure the HOST_WAKE line as "<gpiochip>:<offset>",
+**                 used over the one of the board profile
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int host_wake_set_gpio(char *p_conf_name, char *p_conf_value, int param)
+{
+    return (strcpy_s(host_wake_cb.gpio, sizeof(host_wake_cb.gpio), p_conf_value) != 0) ? -1 : 0;
+}
@@ -0,0 +1,329 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      lpm_adapt.c
+ *
+ *  Description:   Contains the adaptive LPM idle timeout. The gaps between
+ *                 the end of a traffic burst (BT_OP_WAKEUP_UNLOCK) and the
+ *                 start of the next one (BT_OP_WAKEUP_LOCK, or HOST_WAKE for
+ *                 traffic from the controller) are binned; the
+ *                 timeout is set to cover most of the gaps of an active link,
+ *                 so bursty links stay awake across their gaps while links
+ *                 going quiet fall asleep early.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_lpm_adapt"
+
+#include <utils/Log.h>
+#include <pthread.h>
+#include <string.h>
+#include "bt_vendor_brcm.h"
+#include "lpm_adapt.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* Gaps collected before the timeout is first adapted, then between updates */
+#ifndef LPM_ADAPT_SAMPLES
+#define LPM_ADAPT_SAMPLES 32
+#endif
+
+/* The history is halved after this many gaps so it follows traffic changes */
+#ifndef LPM_ADAPT_DECAY_SAMPLES
+#define LPM_ADAPT_DECAY_SAMPLES 256
+#endif
+
+/* Share of the active gaps (shorter than the maximum timeout) to cover */
+#ifndef LPM_ADAPT_COVER_PCT
+#define LPM_ADAPT_COVER_PCT 90
+#endif
+
+/******************************************************************************
+**  Local type definitions
+******************************************************************************/
+
+/* Adaptive idle timeout control block */
+typedef struct {
+    lpm_adapt_stats_t stats;
+    uint32_t decay_hist[LPM_ADAPT_BUCKETS + 1]; /* decayed history driving the timeout */
+    uint32_t pending;                           /* gaps since the last update */
+    uint32_t since_decay;
+    uint64_t unlock_us;                         /* end of the last burst, 0 if awake */
+    uint8_t bt_wake;                            /* the stack holds the link awake */
+    uint8_t host_wake;                          /* the controller holds the link awake */
+} lpm_adapt_cb_t;
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+static lpm_adapt_cb_t lpm_adapt_cbs[VND_MAX_CONTROLLERS];
+static pthread_mutex_t lpm_adapt_locks[VND_MAX_CONTROLLERS] = {
+    [0 ... VND_MAX_CONTROLLERS - 1] = PTHREAD_MUTEX_INITIALIZER
+};
+
+/* control block of the calling thread's controller */
+#define lpm_adapt_cb (lpm_adapt_cbs[vnd_ctx_id()])
+#define lpm_adapt_lock (lpm_adapt_locks[vnd_ctx_id()])
+
+/*****************************************************************************
+**   Helper Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        lpm_adapt_bucket
+**
+** Description     Histogram bucket of a gap
+**
+** Returns         Bucket index, LPM_ADAPT_BUCKETS for the longest gaps
+**
+*******************************************************************************/
+static uint32_t lpm_adapt_bucket(uint32_t gap_ms)
+{
+    uint32_t i;
+    uint32_t bound = LPM_ADAPT_BUCKET_BASE_MS;
+
+    for (i = 0; i < LPM_ADAPT_BUCKETS; i++) {
+        if (gap_ms < bound) {
+            return i;
+        }
+        bound <<= 1;
+    }
+
+    return LPM_ADAPT_BUCKETS;
+}
+
+/*******************************************************************************
+**
+** Function        lpm_adapt_update
+**
+** Description     Pick the timeout covering LPM_ADAPT_COVER_PCT of the active
+**                 gaps. Must be called with lpm_adapt_lock held.
+**
+** Returns         TRUE if the idle timeout changed
+**
+*******************************************************************************/
+static uint8_t lpm_adapt_update(void)
+{
+    lpm_adapt_stats_t *p_stats = &lpm_adapt_cb.stats;
+    uint32_t active = 0;
+    uint32_t covered = 0;
+    uint32_t bound = LPM_ADAPT_BUCKET_BASE_MS;
+    uint32_t timeout = p_stats->max_ms;
+    uint32_t i;
+
+    /* gaps beyond the maximum are idle periods, not part of the traffic */
+    for (i = 0; i < LPM_ADAPT_BUCKETS; i++, bound <<= 1) {
+        if (bound > p_stats->max_ms) {
+            break;
+        }
+        active += lpm_adapt_cb.decay_hist[i];
+    }
+
+    if (active == 0) {
+        timeout = p_stats->min_ms;
+    } else {
+        bound = LPM_ADAPT_BUCKET_BASE_MS;
+        for (i = 0; i < LPM_ADAPT_BUCKETS; i++, bound <<= 1) {
+            covered += lpm_adapt_cb.decay_hist[i];
+            if (covered * 100 >= active * LPM_ADAPT_COVER_PCT) { /* 100: percent */
+                timeout = bound;
+                break;
+            }
+        }
+    }
+
+    if (timeout < p_stats->min_ms) {
+        timeout = p_stats->min_ms;
+    } else if (timeout > p_stats->max_ms) {
+        timeout = p_stats->max_ms;
+    }
+
+    if (timeout == p_stats->timeout_ms) {
+        return FALSE;
+    }
+
+    HILOGI("lpm idle timeout %u -> %u ms (%u active gaps)", p_stats->timeout_ms, timeout, active);
+    p_stats->timeout_ms = timeout;
+    p_stats->updates++;
+    return TRUE;
+}
+
+/*******************************************************************************
+**
+** Function        lpm_adapt_link
+**
+** Description     Account a transition of one of the wake signals. The link
+**                 goes idle once neither side holds it awake; the gap ends
+**                 on the first assertion. Must be called with
+**                 lpm_adapt_lock held.
+**
+** Returns         TRUE if the idle timeout changed
+**
+*******************************************************************************/
+static uint8_t lpm_adapt_link(uint8_t *p_signal, uint8_t asserted, uint64_t now)
+{
+    lpm_adapt_stats_t *p_stats = &lpm_adapt_cb.stats;
+    uint32_t gap_ms;
+    uint32_t i;
+
+    *p_signal = asserted;
+    if (!asserted) {
+        if (!lpm_adapt_cb.bt_wake && !lpm_adapt_cb.host_wake && (lpm_adapt_cb.unlock_us == 0)) {
+            lpm_adapt_cb.unlock_us = now;
+        }
+        return FALSE;
+    }
+
+    if (lpm_adapt_cb.unlock_us == 0) {
+        /* still awake, or the first burst */
+        return FALSE;
+    }
+
+    /* an edge time stamped before the unlock was handled ends an empty gap */
+    gap_ms = (now > lpm_adapt_cb.unlock_us) ? (uint32_t)((now - lpm_adapt_cb.unlock_us) / BT_VENDOR_TIME_RAIDX) : 0;
+    lpm_adapt_cb.unlock_us = 0;
+
+    p_stats->gaps++;
+    p_stats->hist[lpm_adapt_bucket(gap_ms)]++;
+    lpm_adapt_cb.decay_hist[lpm_adapt_bucket(gap_ms)]++;
+
+    /* a gap longer than the timeout lets the controller sleep and wake up */
+    if (gap_ms > p_stats->timeout_ms) {
+        p_stats->transitions++;
+        p_stats->idle_awake_ms += p_stats->timeout_ms;
+    } else {
+        p_stats->idle_awake_ms += gap_ms;
+    }
+    if (gap_ms > p_stats->fixed_ms) {
+        p_stats->transitions_fixed++;
+        p_stats->idle_awake_fixed_ms += p_stats->fixed_ms;
+    } else {
+        p_stats->idle_awake_fixed_ms += gap_ms;
+    }
+
+    if (++lpm_adapt_cb.since_decay >= LPM_ADAPT_DECAY_SAMPLES) {
+        for (i = 0; i <= LPM_ADAPT_BUCKETS; i++) {
+            lpm_adapt_cb.decay_hist[i] >>= 1;
+        }
+        lpm_adapt_cb.since_decay = 0;
+    }
+
+    if (++lpm_adapt_cb.pending >= LPM_ADAPT_SAMPLES) {
+        lpm_adapt_cb.pending = 0;
+        return lpm_adapt_update();
+    }
+
+    return FALSE;
+}
+
+/*****************************************************************************
+**   Adaptive Idle Timeout Interface Functions
+*****************************************************************************/
+
+void lpm_adapt_init(uint32_t min_ms, uint32_t max_ms, uint32_t fixed_ms)
+{
+    pthread_mutex_lock(&lpm_adapt_lock);
+    (void)memset_s(&lpm_adapt_cb, sizeof(lpm_adapt_cb), 0, sizeof(lpm_adapt_cb));
+    if (max_ms < min_ms) {
+        max_ms = min_ms;
+    }
+    lpm_adapt_cb.stats.min_ms = min_ms;
+    lpm_adapt_cb.stats.max_ms = max_ms;
+    lpm_adapt_cb.stats.fixed_ms = fixed_ms;
+    lpm_adapt_cb.stats.timeout_ms = (fixed_ms < min_ms) ? min_ms : ((fixed_ms > max_ms) ? max_ms : fixed_ms);
+    pthread_mutex_unlock(&lpm_adapt_lock);
+}
+
+uint8_t lpm_adapt_wake(uint8_t asserted)
+{
+    uint64_t now = get_monotonic_time_us();
+    uint8_t changed;
+
+    pthread_mutex_lock(&lpm_adapt_lock);
+    changed = lpm_adapt_link(&lpm_adapt_cb.bt_wake, asserted, now);
+    pthread_mutex_unlock(&lpm_adapt_lock);
+
+    return changed;
+}
+
+uint8_t lpm_adapt_host_wake(uint8_t asserted, uint64_t edge_us)
+{
+    uint8_t changed;
+
+    pthread_mutex_lock(&lpm_adapt_lock);
+    if (asserted && (lpm_adapt_cb.unlock_us != 0)) {
+        lpm_adapt_cb.stats.host_wakes++;
+    }
+    changed = lpm_adapt_link(&lpm_adapt_cb.host_wake, asserted, edge_us);
+    pthread_mutex_unlock(&lpm_adapt_lock);
+
+    return changed;
+}
+
+uint32_t lpm_adapt_timeout(void)
+{
+    uint32_t timeout_ms;
+
+    pthread_mutex_lock(&lpm_adapt_lock);
+    timeout_ms = lpm_adapt_cb.stats.timeout_ms;
+    pthread_mutex_unlock(&lpm_adapt_lock);
+
+    return timeout_ms;
+}
+
+void lpm_adapt_get_stats(lpm_adapt_stats_t *p_stats)
+{
+    pthread_mutex_lock(&lpm_adapt_lock);
+    (void)memcpy_s(p_stats, sizeof(*p_stats), &lpm_adapt_cb.stats, sizeof(lpm_adapt_cb.stats));
+    pthread_mutex_unlock(&lpm_adapt_lock);
+}
+
+void lpm_adapt_dump(void)
+{
+    lpm_adapt_stats_t stats;
+    uint32_t bound = LPM_ADAPT_BUCKET_BASE_MS;
+    uint32_t i;
+
+    lpm_adapt_get_stats(&stats);
+    if (stats.gaps == 0) {
+        return;
+    }
+
+    HILOGI("lpm idle: timeout %u ms [%u..%u], fixed %u ms, %u gaps, %u updates", stats.timeout_ms, stats.min_ms,
+        stats.max_ms, stats.fixed_ms, stats.gaps, stats.updates);
+    HILOGI("lpm idle: %u gaps ended by HOST_WAKE", stats.host_wakes);
+    HILOGI("lpm idle: %u wake transitions (fixed %u), %llu ms awake idle (fixed %llu)", stats.transitions,
+        stats.transitions_fixed, (unsigned long long)stats.idle_awake_ms,
+        (unsigned long long)stats.idle_awake_fixed_ms);
+    for (i = 0; i <= LPM_ADAPT_BUCKETS; i++, bound <<= 1) {
+        if (stats.hist[i] == 0) {
+            continue;
+        }
+        if (i < LPM_ADAPT_BUCKETS) {
+            HILOGI("lpm idle: gaps < %5u ms: %u", bound, stats.hist[i]);
+        } else {
+            HILOGI("lpm idle: gaps longer: %u", stats.hist[i]);
+        }
+    }
+}
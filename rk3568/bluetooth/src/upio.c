@@ -30,14 +30,19 @@
 
 #include <fcntl.h>
 #include <errno.h>
+#include <dirent.h>
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <time.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
 #include <utils/Log.h>
 #include "bt_vendor_brcm.h"
 #include "userial_vendor.h"
 #include "upio.h"
+#include "vnd_timer.h"
 
 /******************************************************************************
 **  Constants & Macros
@@ -84,25 +89,97 @@
 #define PROC_BTWRITE_TIMER_TIMEOUT_MS 8000
 #endif
 
+/*
+ * Repeated btwrite kicks closer than this are coalesced into the first one.
+ * The holding timer is only re-armed by real writes, so the bluesleep timeout
+ * still runs from the last kick the kernel saw.
+ */
+#ifndef PROC_BTWRITE_HOLD_MS
+#define PROC_BTWRITE_HOLD_MS 100
+#endif
+
+#define PROC_BTWRITE_HOLD_MAX_MS 1000
+
+#define PROC_NODE_PATH_LEN 64
+
+/* proc fs node kept open for the library lifetime */
+typedef struct {
+    char path[PROC_NODE_PATH_LEN]; /* controller n > 0 uses the node suffixed with .<n> */
+    int fd;
+    char last;        /* last value written, 0 if unknown */
+    uint64_t last_us; /* time of the last write */
+} vnd_proc_node_t;
+
+/* lpm proc I/O counters */
+typedef struct {
+    uint32_t writes;    /* writes through the persistent fds */
+    uint32_t coalesced; /* redundant kicks absorbed by the hold window */
+    uint32_t reopens;   /* fds reopened after a failed write */
+    uint32_t errors;    /* writes lost */
+} vnd_proc_stats_t;
+
 /* lpm proc control block */
 typedef struct {
     uint8_t btwrite_active;
-    uint8_t timer_created;
-    timer_t timer_id;
+    vnd_timer_t *p_timer;
     uint32_t timeout_ms;
+    uint32_t hold_ms;
+    vnd_proc_node_t lpm_node;
+    vnd_proc_node_t btwrite_node;
+    vnd_proc_stats_t stats;
 } vnd_lpm_proc_cb_t;
 
-static vnd_lpm_proc_cb_t lpm_proc_cb;
+static vnd_lpm_proc_cb_t lpm_proc_cbs[VND_MAX_CONTROLLERS];
+#define lpm_proc_cb (lpm_proc_cbs[vnd_ctx_id()])
 #endif
 
+/* sysfs class holding the rfkill switches */
+#ifndef VENDOR_RFKILL_CLASS_DIR
+#define VENDOR_RFKILL_CLASS_DIR "/sys/class/rfkill"
+#endif
+
+/* persisted index of the Bluetooth switch, suffixed with .<n> for controller n > 0 */
+#define RFKILL_STATE_KEY "RfkillId"
+#define RFKILL_STATE_KEY_LEN 32
+
+/* Bluetooth switches a class directory listing considers */
+#define RFKILL_SCAN_MAX 16
+
+#define RFKILL_UEVENT_BUF_SIZE 2048
+
+/* rfkill control block */
+typedef struct {
+    int id;             /* index of the Bluetooth switch, -1 if not resolved */
+    int state_fd;       /* state node, kept open while resolved */
+    int uevent_fd;      /* kobject uevent socket, -1 if not available */
+    int power;          /* last state read or written, -1 if unknown */
+    uint8_t missing;    /* no switch found, wait for a hotplug before scanning */
+    uint32_t scans;     /* class directory listings */
+    uint32_t hotplugs;  /* rfkill add/remove uevents seen */
+    uint32_t switches;  /* power transitions written */
+    uint32_t skipped;   /* requests for the state already in place */
+    uint64_t last_us;   /* duration of the last transition */
+    uint64_t max_us;    /* longest transition */
+} vnd_rfkill_cb_t;
+
 /******************************************************************************
 **  Static variables
 ******************************************************************************/
 
-static uint8_t upio_state[UPIO_MAX_COUNT];
-static int rfkill_id = -1;
+static uint8_t upio_states[VND_MAX_CONTROLLERS][UPIO_MAX_COUNT];
 static int bt_emul_enable = 0;
-static char rfkill_state_path[128];
+static vnd_rfkill_cb_t rfkill_cbs[VND_MAX_CONTROLLERS] = {
+    [0 ... VND_MAX_CONTROLLERS - 1] = {
+        .id = -1,
+        .state_fd = -1,
+        .uevent_fd = -1,
+        .power = -1,
+    }
+};
+
+/* control blocks of the calling thread's controller */
+#define upio_state (upio_states[vnd_ctx_id()])
+#define rfkill_cb (rfkill_cbs[vnd_ctx_id()])
 
 /******************************************************************************
 **  Static functions
@@ -134,37 +211,280 @@ static int is_rfkill_disabled(void)
     return UPIO_BT_POWER_OFF;
 }
 
-static int init_rfkill(void)
+/*******************************************************************************
+**
+** Function        rfkill_is_bluetooth
+**
+** Description     Check the type of an rfkill switch
+**
+** Returns         TRUE if rfkill<id> switches the Bluetooth radio
+**
+*******************************************************************************/
+static uint8_t rfkill_is_bluetooth(int id)
 {
     char path[64];
     char buf[16];
-    int fd, sz, id;
+    int fd, sz;
+
+    if (snprintf_s(path, sizeof(path), sizeof(path) - 1, VENDOR_RFKILL_CLASS_DIR "/rfkill%d/type", id) < 0) {
+        return FALSE;
+    }
 
-    for (id = 0;; id++) {
-        if (snprintf_s(path, sizeof(path), sizeof(path), "/sys/class/rfkill/rfkill%d/type", id) < 0) {
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return FALSE;
+    }
+
+    sz = read(fd, buf, sizeof(buf));
+    close(fd);
+
+    return ((sz >= (int)strlen("bluetooth")) && (memcmp(buf, "bluetooth", strlen("bluetooth")) == 0));
+}
+
+/*******************************************************************************
+**
+** Function        rfkill_read_state
+**
+** Description     Read the current state of the resolved switch
+**
+** Returns         UPIO_BT_POWER_ON, UPIO_BT_POWER_OFF or -1 if unknown
+**
+*******************************************************************************/
+static int rfkill_read_state(void)
+{
+    char buf[4];
+
+    if (pread(rfkill_cb.state_fd, buf, sizeof(buf), 0) <= 0) {
+        return -1;
+    }
+
+    /* 0: soft blocked, 1: unblocked, 2: hard blocked */
+    switch (buf[0]) {
+        case '1':
+            return UPIO_BT_POWER_ON;
+        case '0':
+        case '2':
+            return UPIO_BT_POWER_OFF;
+        default:
             return -1;
+    }
+}
+
+/*******************************************************************************
+**
+** Function        rfkill_release
+**
+** Description     Drop the resolved switch, it is looked up again on the
+**                 next power request
+**
+** Returns         None
+**
+*******************************************************************************/
+static void rfkill_release(void)
+{
+    if (rfkill_cb.state_fd >= 0) {
+        close(rfkill_cb.state_fd);
+    }
+
+    rfkill_cb.state_fd = -1;
+    rfkill_cb.id = -1;
+    rfkill_cb.power = -1;
+}
+
+/*******************************************************************************
+**
+** Function        rfkill_scan
+**
+** Description     List the class directory for the Bluetooth switch of the
+**                 calling thread's controller: controller n gets the n-th
+**                 Bluetooth switch in index order
+**
+** Returns         Switch index, -1 if there is none
+**
+*******************************************************************************/
+static int rfkill_scan(void)
+{
+    int ids[RFKILL_SCAN_MAX];
+    int count = 0;
+    DIR *p_dir = NULL;
+    struct dirent *p_ent = NULL;
+    int id, i;
+
+    rfkill_cb.scans++;
+    p_dir = opendir(VENDOR_RFKILL_CLASS_DIR);
+    if (p_dir == NULL) {
+        return -1;
+    }
+
+    while (((p_ent = readdir(p_dir)) != NULL) && (count < RFKILL_SCAN_MAX)) {
+        if ((strncmp(p_ent->d_name, "rfkill", strlen("rfkill")) != 0)) {
+            continue;
         }
-        
-        fd = open(path, O_RDONLY);
-        if (fd < 0) {
-            HILOGE("init_rfkill : open(%s) failed: %s (%d)\n",
-                path, strerror(errno), errno);
-            return -1;
+        id = atoi(p_ent->d_name + strlen("rfkill"));
+        if (!rfkill_is_bluetooth(id)) {
+            continue;
         }
+        /* keep the list sorted, the directory order is arbitrary */
+        for (i = count; (i > 0) && (ids[i - 1] > id); i--) {
+            ids[i] = ids[i - 1];
+        }
+        ids[i] = id;
+        count++;
+    }
+    closedir(p_dir);
 
-        sz = read(fd, &buf, sizeof(buf));
-        close(fd);
+    return (vnd_ctx_id() < count) ? ids[vnd_ctx_id()] : -1;
+}
 
-        if (sz >= (int)strlen("bluetooth") && memcmp(buf, "bluetooth", strlen("bluetooth")) == 0) {
-            rfkill_id = id;
-            break;
+/*******************************************************************************
+**
+** Function        rfkill_resolve
+**
+** Description     Find the Bluetooth rfkill switch and open its state node.
+**                 The index found last time is checked first, the class
+**                 directory is only listed when it no longer matches.
+**
+** Returns         0  : switch ready
+**                 <0 : no Bluetooth switch
+**
+*******************************************************************************/
+static int rfkill_resolve(void)
+{
+    char key[RFKILL_STATE_KEY_LEN];
+    char path[64];
+    int id;
+
+    if (rfkill_cb.state_fd >= 0) {
+        return 0;
+    }
+
+    /* nothing changed since the last fruitless scan */
+    if (rfkill_cb.missing) {
+        return -1;
+    }
+
+    (void)vnd_ctx_name(RFKILL_STATE_KEY, key, sizeof(key));
+    id = vnd_state_get_int(key, -1);
+    if ((id < 0) || !rfkill_is_bluetooth(id)) {
+        id = rfkill_scan();
+        if (id < 0) {
+            HILOGE("rfkill_resolve : no bluetooth switch %u in %s", vnd_ctx_id(), VENDOR_RFKILL_CLASS_DIR);
+            rfkill_cb.missing = TRUE;
+            return -1;
         }
+
+        (void)vnd_state_set_int(key, id);
+    }
+
+    if (snprintf_s(path, sizeof(path), sizeof(path) - 1, VENDOR_RFKILL_CLASS_DIR "/rfkill%d/state", id) < 0) {
+        return -1;
+    }
+
+    rfkill_cb.state_fd = open(path, O_RDWR | O_CLOEXEC);
+    if (rfkill_cb.state_fd < 0) {
+        HILOGE("rfkill_resolve : open(%s) failed: %s (%d)", path, strerror(errno), errno);
+        return -1;
     }
 
-    (void)sprintf_s(rfkill_state_path, sizeof(rfkill_state_path), "/sys/class/rfkill/rfkill%d/state", rfkill_id);
+    rfkill_cb.id = id;
+    rfkill_cb.power = rfkill_read_state();
+    HILOGI("rfkill%d is the bluetooth switch, power %d", id, rfkill_cb.power);
+
     return 0;
 }
 
+/*******************************************************************************
+**
+** Function        rfkill_uevent_open
+**
+** Description     Subscribe to kernel uevents so that a switch which goes
+**                 away or shows up is noticed before the next power request
+**
+** Returns         None
+**
+*******************************************************************************/
+static void rfkill_uevent_open(void)
+{
+    struct sockaddr_nl addr;
+
+    if (rfkill_cb.uevent_fd >= 0) {
+        return;
+    }
+
+    rfkill_cb.uevent_fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT);
+    if (rfkill_cb.uevent_fd < 0) {
+        HILOGW("rfkill uevent socket failed: %s (%d), relying on write errors", strerror(errno), errno);
+        return;
+    }
+
+    memset_s(&addr, sizeof(addr), 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = 1; /* kernel uevent multicast group */
+    if (bind(rfkill_cb.uevent_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        HILOGW("rfkill uevent bind failed: %s (%d), relying on write errors", strerror(errno), errno);
+        close(rfkill_cb.uevent_fd);
+        rfkill_cb.uevent_fd = -1;
+    }
+}
+
+/*******************************************************************************
+**
+** Function        rfkill_uevent_drain
+**
+** Description     Consume the queued uevents. Power requests are rare and
+**                 the switch only matters while one runs, so the queue is
+**                 read right before use instead of from a listener thread.
+**                 Only add and remove events of the rfkill subsystem drop
+**                 the cached switch, the change events our own writes
+**                 raise are ignored.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void rfkill_uevent_drain(void)
+{
+    char buf[RFKILL_UEVENT_BUF_SIZE];
+    ssize_t len;
+    ssize_t off;
+    uint8_t is_rfkill, is_hotplug;
+
+    if (rfkill_cb.uevent_fd < 0) {
+        return;
+    }
+
+    for (;;) {
+        len = recv(rfkill_cb.uevent_fd, buf, sizeof(buf) - 1, MSG_DONTWAIT);
+        if (len < 0) {
+            if (errno == ENOBUFS) {
+                /* the socket overflowed, a hotplug may be among the lost */
+                HILOGW("rfkill uevents lost, looking up the switch again");
+                rfkill_release();
+                rfkill_cb.missing = FALSE;
+                continue;
+            }
+            break;
+        }
+
+        buf[len] = '\0';
+        is_rfkill = FALSE;
+        is_hotplug = FALSE;
+        for (off = 0; off < len; off += (ssize_t)strlen(buf + off) + 1) {
+            if (strcmp(buf + off, "SUBSYSTEM=rfkill") == 0) {
+                is_rfkill = TRUE;
+            } else if ((strcmp(buf + off, "ACTION=add") == 0) || (strcmp(buf + off, "ACTION=remove") == 0)) {
+                is_hotplug = TRUE;
+            }
+        }
+
+        if (is_rfkill && is_hotplug) {
+            HILOGI("rfkill hotplug: %s", buf);
+            rfkill_release();
+            rfkill_cb.missing = FALSE;
+            rfkill_cb.hotplugs++;
+        }
+    }
+}
+
 /*****************************************************************************
 **   LPM Static Functions
 *****************************************************************************/
@@ -174,12 +494,12 @@ static int init_rfkill(void)
 **
 ** Function        proc_btwrite_timeout
 **
-** Description     Timeout thread of proc/.../btwrite assertion holding timer
+** Description     Timeout of proc/.../btwrite assertion holding timer
 **
 ** Returns         None
 **
 *******************************************************************************/
-static void proc_btwrite_timeout(union sigval arg)
+static void proc_btwrite_timeout(void *p_data)
 {
     UPIODBG("..%s..", __FUNCTION__);
     lpm_proc_cb.btwrite_active = FALSE;
@@ -187,6 +507,117 @@ static void proc_btwrite_timeout(union sigval arg)
     upio_set(UPIO_BT_WAKE, UPIO_DEASSERT, 1);
 }
 
+/*******************************************************************************
+**
+** Function        upio_proc_open
+**
+** Description     Open a proc node for the library lifetime
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+static int upio_proc_open(vnd_proc_node_t *p_node)
+{
+    p_node->fd = open(p_node->path, O_WRONLY | O_CLOEXEC);
+    if (p_node->fd < 0) {
+        HILOGE("upio_proc_open : open(%s) for write failed: %s (%d)", p_node->path, strerror(errno), errno);
+        return -1;
+    }
+
+    p_node->last = 0;
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function        upio_proc_close
+**
+** Description     Close a proc node
+**
+** Returns         None
+**
+*******************************************************************************/
+static void upio_proc_close(vnd_proc_node_t *p_node)
+{
+    if (p_node->fd >= 0) {
+        close(p_node->fd);
+    }
+    p_node->fd = -1;
+    p_node->last = 0;
+}
+
+/*******************************************************************************
+**
+** Function        upio_proc_write
+**
+** Description     Write one value to a proc node through its persistent fd.
+**                 A write repeating the last value within hold_ms is
+**                 absorbed. A failed write reopens the node and is retried
+**                 once.
+**
+** Returns         1 : Written
+**                 0 : Coalesced
+**                 -1 : Fail
+**
+*******************************************************************************/
+static int upio_proc_write(vnd_proc_node_t *p_node, char value, uint32_t hold_ms)
+{
+    uint64_t now = get_monotonic_time_us();
+    int retry;
+
+    if ((hold_ms > 0) && (p_node->last == value) && (now - p_node->last_us < (uint64_t)hold_ms * 1000)) {
+        lpm_proc_cb.stats.coalesced++;
+        return 0;
+    }
+
+    for (retry = 0; retry < 2; retry++) { /* 2: first attempt and one retry */
+        if ((p_node->fd < 0) && (upio_proc_open(p_node) != 0)) {
+            break;
+        }
+
+        if (write(p_node->fd, &value, 1) == 1) {
+            lpm_proc_cb.stats.writes++;
+            p_node->last = value;
+            p_node->last_us = now;
+            return 1;
+        }
+
+        HILOGE("upio_proc_write : write(%s) failed: %s (%d)", p_node->path, strerror(errno), errno);
+        upio_proc_close(p_node);
+        if (retry == 0) {
+            lpm_proc_cb.stats.reopens++;
+        }
+    }
+
+    lpm_proc_cb.stats.errors++;
+    return -1;
+}
+
+/*******************************************************************************
+**
+** Function        upio_set_btwrite_hold_window
+**
+** Description     Set the btwrite coalescing window from the conf file
+**
+** Returns         0 : Success
+**
+*******************************************************************************/
+int upio_set_btwrite_hold_window(char *p_conf_name, char *p_conf_value, int param)
+{
+    int hold_ms = atoi(p_conf_value);
+
+    if (hold_ms < 0) {
+        hold_ms = 0;
+    } else if (hold_ms > PROC_BTWRITE_HOLD_MAX_MS) {
+        hold_ms = PROC_BTWRITE_HOLD_MAX_MS;
+    }
+
+    lpm_proc_cb.hold_ms = (uint32_t)hold_ms;
+    HILOGI("btwrite hold window %u ms", lpm_proc_cb.hold_ms);
+    return 0;
+}
+
 /******************************************************************************
  **
  ** Function      upio_start_stop_timer
@@ -198,26 +629,14 @@ static void proc_btwrite_timeout(union sigval arg)
  *****************************************************************************/
 void upio_start_stop_timer(int action)
 {
-    struct itimerspec ts;
-
     if (action == UPIO_ASSERT) {
         lpm_proc_cb.btwrite_active = TRUE;
-        if (lpm_proc_cb.timer_created == TRUE) {
-            ts.it_value.tv_sec = PROC_BTWRITE_TIMER_TIMEOUT_MS / BT_VENDOR_TIME_RAIDX;
-            ts.it_value.tv_nsec = BT_VENDOR_TIME_RAIDX * BT_VENDOR_TIME_RAIDX *
-                (PROC_BTWRITE_TIMER_TIMEOUT_MS % BT_VENDOR_TIME_RAIDX);
-            ts.it_interval.tv_sec = 0;
-            ts.it_interval.tv_nsec = 0;
+        if (vnd_timer_start(lpm_proc_cb.p_timer, PROC_BTWRITE_TIMER_TIMEOUT_MS, FALSE) == 0) {
+            UPIODBG("%s : timer armed", __FUNCTION__);
         }
     } else {
         /* unarm timer if writing 0 to lpm; reduce unnecessary user space wakeup */
-        (void)memset_s(&ts, sizeof(ts), 0, sizeof(ts));
-    }
-
-    if (timer_settime(lpm_proc_cb.timer_id, 0, &ts, 0) == 0) {
-        UPIODBG("%s : timer_settime success", __FUNCTION__);
-    } else {
-        UPIODBG("%s : timer_settime failed", __FUNCTION__);
+        vnd_timer_stop(lpm_proc_cb.p_timer);
     }
 }
 #endif
@@ -237,9 +656,17 @@ void upio_start_stop_timer(int action)
 *******************************************************************************/
 void upio_init(void)
 {
-    memset_s(upio_state, sizeof(upio_state), UPIO_UNKNOWN, UPIO_MAX_COUNT);
+    memset_s(upio_state, UPIO_MAX_COUNT, UPIO_UNKNOWN, UPIO_MAX_COUNT);
+    rfkill_uevent_open();
 #if (BT_WAKE_VIA_PROC == TRUE)
     memset_s(&lpm_proc_cb, sizeof(vnd_lpm_proc_cb_t), 0, sizeof(vnd_lpm_proc_cb_t));
+    lpm_proc_cb.hold_ms = PROC_BTWRITE_HOLD_MS;
+    (void)vnd_ctx_name(VENDOR_LPM_PROC_NODE, lpm_proc_cb.lpm_node.path, PROC_NODE_PATH_LEN);
+    (void)vnd_ctx_name(VENDOR_BTWRITE_PROC_NODE, lpm_proc_cb.btwrite_node.path, PROC_NODE_PATH_LEN);
+
+    /* a node failing here is opened again on its first write */
+    (void)upio_proc_open(&lpm_proc_cb.lpm_node);
+    (void)upio_proc_open(&lpm_proc_cb.btwrite_node);
 #endif
 }
 
@@ -254,11 +681,28 @@ void upio_init(void)
 *******************************************************************************/
 void upio_cleanup(void)
 {
+    HILOGI("rfkill: %u switches (last %llu us, max %llu us), %u skipped, %u scans, %u hotplugs",
+        rfkill_cb.switches, (unsigned long long)rfkill_cb.last_us, (unsigned long long)rfkill_cb.max_us,
+        rfkill_cb.skipped, rfkill_cb.scans, rfkill_cb.hotplugs);
+
+    rfkill_release();
+    rfkill_cb.missing = FALSE;
+    if (rfkill_cb.uevent_fd >= 0) {
+        close(rfkill_cb.uevent_fd);
+        rfkill_cb.uevent_fd = -1;
+    }
+
 #if (BT_WAKE_VIA_PROC == TRUE)
-    if (lpm_proc_cb.timer_created == TRUE)
-        timer_delete(lpm_proc_cb.timer_id);
+    vnd_timer_free(lpm_proc_cb.p_timer);
+    lpm_proc_cb.p_timer = NULL;
+
+    /* each write saved an open and a close, each coalesced kick all three */
+    HILOGI("lpm proc io: %u writes, %u coalesced, %u reopens, %u errors, %u syscalls avoided",
+        lpm_proc_cb.stats.writes, lpm_proc_cb.stats.coalesced, lpm_proc_cb.stats.reopens, lpm_proc_cb.stats.errors,
+        lpm_proc_cb.stats.writes * 2 + lpm_proc_cb.stats.coalesced * 3); /* 2, 3: syscalls per write */
 
-    lpm_proc_cb.timer_created = FALSE;
+    upio_proc_close(&lpm_proc_cb.lpm_node);
+    upio_proc_close(&lpm_proc_cb.btwrite_node);
 #endif
 }
 
@@ -267,7 +711,8 @@ void upio_cleanup(void)
 ** Function        upio_set_bluetooth_power
 **
 ** Description     Interact with low layer driver to set Bluetooth power
-**                 on/off.
+**                 on/off. Nothing is written when the switch is already
+**                 in the requested state.
 **
 ** Returns         0  : SUCCESS or Not-Applicable
 **                 <0 : ERROR
@@ -275,8 +720,8 @@ void upio_cleanup(void)
 *******************************************************************************/
 int upio_set_bluetooth_power(int on)
 {
-    int sz;
-    int fd = -1;
+    ssize_t sz;
+    uint64_t start_us;
     int ret = -1;
     char buffer = '0';
 
@@ -308,32 +753,49 @@ int upio_set_bluetooth_power(int on)
         return 0;
     }
 
-    if (rfkill_id == -1) {
-        if (init_rfkill()) {
-            return ret;
-        }
+    rfkill_uevent_drain();
+    if (rfkill_resolve() != 0) {
+        return ret;
     }
 
-    fd = open(rfkill_state_path, O_WRONLY);
-    if (fd < 0) {
-        HILOGE("set_bluetooth_power : open(%s) for write failed: %s (%d)",
-            rfkill_state_path, strerror(errno), errno);
-        return ret;
+    /* the switch may have been flipped behind our back, ask the node */
+    rfkill_cb.power = rfkill_read_state();
+    if (rfkill_cb.power == on) {
+        UPIODBG("set_bluetooth_power : rfkill%d already %d", rfkill_cb.id, on);
+        rfkill_cb.skipped++;
+        return 0;
+    }
+
+    start_us = get_monotonic_time_us();
+    sz = pwrite(rfkill_cb.state_fd, &buffer, 1, 0);
+    if ((sz < 0) && ((errno == ENODEV) || (errno == ENOENT))) {
+        /* the switch went away without a uevent reaching us */
+        HILOGW("set_bluetooth_power : rfkill%d is gone, looking it up again", rfkill_cb.id);
+        rfkill_release();
+        rfkill_cb.missing = FALSE;
+        if (rfkill_resolve() != 0) {
+            return ret;
+        }
+        start_us = get_monotonic_time_us();
+        sz = pwrite(rfkill_cb.state_fd, &buffer, 1, 0);
     }
 
-    sz = write(fd, &buffer, 1);
     if (sz < 0) {
-        HILOGE("set_bluetooth_power : write(%s) failed: %s (%d)",
-            rfkill_state_path, strerror(errno), errno);
-    } else {
-        ret = 0;
+        HILOGE("set_bluetooth_power : write(rfkill%d) failed: %s (%d)", rfkill_cb.id, strerror(errno), errno);
+        rfkill_cb.power = -1;
+        return ret;
     }
 
-    if (fd >= 0) {
-        close(fd);
+    rfkill_cb.last_us = get_monotonic_time_us() - start_us;
+    if (rfkill_cb.last_us > rfkill_cb.max_us) {
+        rfkill_cb.max_us = rfkill_cb.last_us;
     }
+    rfkill_cb.power = on;
+    rfkill_cb.switches++;
+    HILOGI("set_bluetooth_power : rfkill%d %s in %llu us", rfkill_cb.id, (on == UPIO_BT_POWER_ON) ? "on" : "off",
+        (unsigned long long)rfkill_cb.last_us);
 
-    return ret;
+    return 0;
 }
 
 /*******************************************************************************
@@ -349,7 +811,6 @@ void upio_set(uint8_t pio, uint8_t action, uint8_t polarity)
 {
     int rc;
 #if (BT_WAKE_VIA_PROC == TRUE)
-    int fd = -1;
     char buffer;
 #endif
 
@@ -364,53 +825,29 @@ void upio_set(uint8_t pio, uint8_t action, uint8_t polarity)
             upio_state[UPIO_LPM_MODE] = action;
 
 #if (BT_WAKE_VIA_PROC == TRUE)
-            fd = open(VENDOR_LPM_PROC_NODE, O_WRONLY);
-            if (fd < 0) {
-                LOGE("upio_set : open(%s) for write failed: %s (%d)",
-                VENDOR_LPM_PROC_NODE, strerror(errno), errno);
-                return;
-            }
-
             if (action == UPIO_ASSERT) {
                 buffer = '1';
             } else {
                 buffer = '0';
 
-                // delete btwrite assertion holding timer
-                if (lpm_proc_cb.timer_created == TRUE) {
-                    timer_delete(lpm_proc_cb.timer_id);
-                    lpm_proc_cb.timer_created = FALSE;
-                }
+                // disarm btwrite assertion holding timer, the handle is kept
+                vnd_timer_stop(lpm_proc_cb.p_timer);
             }
 
-            if (write(fd, &buffer, 1) < 0) {
-                LOGE("upio_set : write(%s) failed: %s (%d)",
-                VENDOR_LPM_PROC_NODE, strerror(errno),errno);
+            /* the next btwrite kick must reach the new LPM mode */
+            lpm_proc_cb.btwrite_node.last = 0;
+
+            if (upio_proc_write(&lpm_proc_cb.lpm_node, buffer, 0) < 0) {
+                return;
             }
 #if (PROC_BTWRITE_TIMER_TIMEOUT_MS != 0)
-            else {
-                if (action == UPIO_ASSERT) {
-                    // create btwrite assertion holding timer
-                    if (lpm_proc_cb.timer_created == FALSE) {
-                        int status;
-                        struct sigevent se;
-
-                        se.sigev_notify = SIGEV_THREAD;
-                        se.sigev_value.sival_ptr = &lpm_proc_cb.timer_id;
-                        se.sigev_notify_function = proc_btwrite_timeout;
-                        se.sigev_notify_attributes = NULL;
-
-                        status = timer_create(CLOCK_MONOTONIC, &se,
-                                              &lpm_proc_cb.timer_id);
-                        if (status == 0)
-                            lpm_proc_cb.timer_created = TRUE;
-                    }
+            if (action == UPIO_ASSERT) {
+                // create btwrite assertion holding timer once
+                if (lpm_proc_cb.p_timer == NULL) {
+                    lpm_proc_cb.p_timer = vnd_timer_alloc(proc_btwrite_timeout, NULL);
                 }
             }
 #endif
-
-            if (fd >= 0)
-                close(fd);
 #endif
             break;
             
@@ -419,16 +856,17 @@ void upio_set(uint8_t pio, uint8_t action, uint8_t polarity)
                 UPIODBG("BT_WAKE is %s already", lpm_state[action]);
 
 #if (BT_WAKE_VIA_PROC == TRUE)
-                if (lpm_proc_cb.btwrite_active == TRUE)
-                    /*
-                     * The proc btwrite node could have not been updated for
-                     * certain time already due to heavy downstream path flow.
-                     * In this case, we want to explicity touch proc btwrite
-                     * node to keep the bt_wake assertion in the LPM kernel
-                     * driver. The current kernel bluesleep LPM code starts
-                     * a 10sec internal in-activity timeout timer before it
-                     * attempts to deassert BT_WAKE line.
-                     */
+                /*
+                 * The proc btwrite node could have not been updated for
+                 * certain time already due to heavy downstream path flow.
+                 * In this case, we want to explicity touch proc btwrite
+                 * node to keep the bt_wake assertion in the LPM kernel
+                 * driver. The current kernel bluesleep LPM code starts
+                 * a 10sec internal in-activity timeout timer before it
+                 * attempts to deassert BT_WAKE line. Kicks within the hold
+                 * window are coalesced by upio_proc_write.
+                 */
+                if ((lpm_proc_cb.btwrite_active != TRUE) || (action != UPIO_ASSERT))
                     return;
 #else
                 return;
@@ -452,12 +890,6 @@ void upio_set(uint8_t pio, uint8_t action, uint8_t polarity)
             if (action == UPIO_DEASSERT)
                 return;
 #endif
-            fd = open(VENDOR_BTWRITE_PROC_NODE, O_WRONLY);
-            if (fd < 0) {
-                LOGE("upio_set : open(%s) for write failed: %s (%d)",
-                VENDOR_BTWRITE_PROC_NODE, strerror(errno), errno);
-                return;
-            }
 #if (BT_WAKE_VIA_PROC_NOTIFY_DEASSERT == TRUE)
             if (action == UPIO_DEASSERT)
                 buffer = '0';
@@ -465,12 +897,9 @@ void upio_set(uint8_t pio, uint8_t action, uint8_t polarity)
 #endif
                 buffer = '1';
 
-            if (write(fd, &buffer, 1) < 0) {
-                LOGE("upio_set : write(%s) failed: %s (%d)",
-                VENDOR_BTWRITE_PROC_NODE, strerror(errno), errno);
-            }
+            rc = upio_proc_write(&lpm_proc_cb.btwrite_node, buffer, lpm_proc_cb.hold_ms);
 #if (PROC_BTWRITE_TIMER_TIMEOUT_MS != 0)
-            else {
+            if (rc > 0) {
                 /* arm user space timer based on action */
                 upio_start_stop_timer(action);
             }
@@ -480,11 +909,8 @@ void upio_set(uint8_t pio, uint8_t action, uint8_t polarity)
             lpm_proc_cb.btwrite_active = TRUE;
 #endif
 
-            UPIODBG("%s: proc btwrite assertion, buffer: %c, timer_armed %d %d",
-                    __FUNCTION__, buffer, lpm_proc_cb.btwrite_active, lpm_proc_cb.timer_created);
-
-            if (fd >= 0)
-                close(fd);
+            UPIODBG("%s: proc btwrite assertion, buffer: %c, written %d, timer_armed %d %d",
+                    __FUNCTION__, buffer, rc, lpm_proc_cb.btwrite_active, (lpm_proc_cb.p_timer != NULL));
 #endif
 
             break;
@@ -30,12 +30,22 @@
 #include <fcntl.h>
 #include <errno.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 #include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <linux/serial.h>
 #include <utils/Log.h>
 #include "bt_vendor_brcm.h"
+#include "bt_hci_bdroid.h"
 #include "userial.h"
 #include "userial_vendor.h"
+#include "vnd_tune.h"
+#include "vnd_board.h"
 
 /******************************************************************************
 **  Constants & Macros
@@ -59,22 +69,141 @@
 
 #define VND_PORT_NAME_MAXLEN 256
 
+/* largest tty read of the receive engine */
+#define USERIAL_RX_CHUNK_SIZE 4096
+
 /******************************************************************************
 **  Local type definitions
 ******************************************************************************/
 
+/* UART latency/throughput profile */
+typedef struct {
+    const char *name;
+    uint8_t vmin;        /* VMIN, bytes a read waits for */
+    uint8_t vtime;       /* VTIME, inter-byte timer in 1/10 s, 0: none */
+    uint8_t low_latency; /* ask the driver for ASYNC_LOW_LATENCY */
+    uint8_t flow_ctrl;   /* RTS/CTS hardware flow control */
+    uint16_t rx_chunk;   /* receive engine read size */
+} vnd_userial_profile_t;
+
 /* vendor serial control block */
 typedef struct {
     int fd;                 /* fd to Bluetooth device */
     struct termios termios; /* serial terminal of BT port */
     char port_name[VND_PORT_NAME_MAXLEN];
+    const vnd_userial_profile_t *p_profile;
+    uint8_t rx_lat_probe;   /* measure the RX interrupt to user space delay */
 } vnd_userial_cb_t;
 
+#if (USERIAL_RX_ENGINE == TRUE)
+
+/* Longest H4 header (ACL) */
+#define USERIAL_RX_HDR_MAX 4
+
+/* RX latency probe: receive counter poll period and marks kept */
+#define USERIAL_RX_LAT_POLL_US 100
+#define USERIAL_RX_LAT_MARKS 64
+
+/* receive engine parser state */
+enum {
+    USERIAL_RX_TYPE,    /* waiting for the H4 indicator */
+    USERIAL_RX_HDR,     /* collecting the HCI header */
+    USERIAL_RX_PAYLOAD, /* filling the slot */
+    USERIAL_RX_SKIP     /* discarding a dropped packet */
+};
+
+/* Preallocated packet slot, the packet descriptor comes first */
+typedef struct {
+    userial_rx_pkt_t pkt;
+    uint8_t busy; /* being filled or held by a consumer */
+    uint8_t data[HCI_MAX_FRAME_SIZE];
+} userial_rx_slot_t;
+
+typedef struct {
+    userial_rx_cback_t p_cback;
+    void *p_data;
+} userial_rx_consumer_t;
+
+/* Time the driver's receive counter was seen reaching a value */
+typedef struct {
+    uint64_t t_us;
+    uint32_t rx;
+} userial_rx_mark_t;
+
+/* receive engine control block */
+typedef struct {
+    uint8_t running;
+    uint8_t stop;            /* read through userial_rx_stopping */
+    int epoll_fd;
+    int stop_fd;             /* eventfd waking the reader up for exit */
+    pthread_t thread;
+    userial_rx_consumer_t consumer[USERIAL_H4_TYPES];
+    userial_rx_slot_t slot[USERIAL_RX_SLOTS];
+    uint32_t head;           /* next slot handed out */
+    userial_rx_slot_t *p_cur; /* slot being filled */
+    uint8_t state;
+    uint8_t type;
+    uint8_t hdr[USERIAL_RX_HDR_MAX];
+    uint8_t hdr_len;
+    uint8_t hdr_got;
+    uint16_t need;           /* payload bytes still expected */
+    uint8_t lat_probe;       /* latency probe thread running */
+    pthread_t lat_thread;
+    uint32_t lat_rx_base;    /* driver receive count matching lat_read 0 */
+    uint32_t lat_read;       /* bytes read since the probe started */
+    userial_rx_mark_t mark[USERIAL_RX_LAT_MARKS];
+    uint32_t mark_head;
+    uint32_t mark_tail;
+    userial_rx_stats_t stats;
+} userial_rx_cb_t;
+#endif
+
 /******************************************************************************
 **  Static variables
 ******************************************************************************/
 
-static vnd_userial_cb_t vnd_userial;
+/*
+ * "default" keeps the plain raw mode settings. "low_latency" is meant for
+ * SCO voice and HID, "bulk" lets the line discipline gather bytes for
+ * large transfers at the cost of up to one VTIME of added delay.
+ */
+static const vnd_userial_profile_t vnd_userial_profiles[] = {
+    {"default", 1, 0, FALSE, TRUE, USERIAL_RX_CHUNK_SIZE},
+    {"low_latency", 1, 0, TRUE, TRUE, USERIAL_RX_CHUNK_SIZE / 4},
+    {"bulk", 64, 1, FALSE, TRUE, USERIAL_RX_CHUNK_SIZE},
+};
+
+static vnd_userial_cb_t vnd_userials[VND_MAX_CONTROLLERS];
+static uint32_t userial_set_baud_delay_us = USERIAL_VENDOR_SET_BAUD_DELAY_US;
+
+static const vnd_tune_t userial_tunes[] = {
+    {"UartSetBaudDelayUs", VND_TUNE_U32, 1, VND_TUNE_AT_POWER, 0, 1000000, &userial_set_baud_delay_us, 0},
+};
+
+#if (USERIAL_RX_ENGINE == TRUE)
+static userial_rx_cb_t userial_rxs[VND_MAX_CONTROLLERS] = {
+    [0 ... VND_MAX_CONTROLLERS - 1] = {
+        .epoll_fd = -1,
+        .stop_fd = -1,
+    }
+};
+static pthread_mutex_t userial_rx_locks[VND_MAX_CONTROLLERS] = {
+    [0 ... VND_MAX_CONTROLLERS - 1] = PTHREAD_MUTEX_INITIALIZER
+};
+static pthread_cond_t userial_rx_conds[VND_MAX_CONTROLLERS] = {
+    [0 ... VND_MAX_CONTROLLERS - 1] = PTHREAD_COND_INITIALIZER
+};
+#endif
+
+/* control blocks of the calling thread's controller */
+#define vnd_userial (vnd_userials[vnd_ctx_id()])
+#if (USERIAL_RX_ENGINE == TRUE)
+#define userial_rx (userial_rxs[vnd_ctx_id()])
+#define userial_rx_lock (userial_rx_locks[vnd_ctx_id()])
+#define userial_rx_cond (userial_rx_conds[vnd_ctx_id()])
+/* stop is set by userial_vendor_rx_stop on another thread */
+#define userial_rx_stopping() __atomic_load_n(&userial_rx.stop, __ATOMIC_ACQUIRE)
+#endif
 
 /*****************************************************************************
 **   Helper Functions
@@ -163,6 +292,44 @@ void userial_ioctl_init_bt_wake(int fd)
 }
 #endif // (BT_WAKE_VIA_USERIAL_IOCTL==TRUE)
 
+/*******************************************************************************
+**
+** Function        userial_set_low_latency
+**
+** Description     Set or clear ASYNC_LOW_LATENCY, so the driver pushes
+**                 received bytes to the line discipline right from the
+**                 interrupt instead of from a work item. Drivers without
+**                 TIOCSSERIAL keep their default.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void userial_set_low_latency(int fd, uint8_t on)
+{
+#ifdef ASYNC_LOW_LATENCY
+    struct serial_struct ss;
+
+    if (ioctl(fd, TIOCGSERIAL, &ss) != 0) {
+        VNDUSERIALDBG("userial_set_low_latency: TIOCGSERIAL not supported");
+        return;
+    }
+
+    if (((ss.flags & ASYNC_LOW_LATENCY) != 0) == (on != 0)) {
+        return;
+    }
+
+    if (on) {
+        ss.flags |= ASYNC_LOW_LATENCY;
+    } else {
+        ss.flags &= ~ASYNC_LOW_LATENCY;
+    }
+
+    if (ioctl(fd, TIOCSSERIAL, &ss) != 0) {
+        HILOGW("userial_set_low_latency: TIOCSSERIAL failed: %s (%d)", strerror(errno), errno);
+    }
+#endif
+}
+
 /*****************************************************************************
 **   Userial Vendor API Functions
 *****************************************************************************/
@@ -179,8 +346,14 @@ void userial_ioctl_init_bt_wake(int fd)
 void userial_vendor_init(void)
 {
     vnd_userial.fd = -1;
-    (void)snprintf_s(vnd_userial.port_name, VND_PORT_NAME_MAXLEN, VND_PORT_NAME_MAXLEN, "%s",
-        BLUETOOTH_UART_DEVICE_PORT);
+    /* the board UART is the first controller's, the others are named by UartPort.<n> */
+    vnd_userial.port_name[0] = 0;
+    if (vnd_ctx_id() == 0) {
+        (void)snprintf_s(vnd_userial.port_name, VND_PORT_NAME_MAXLEN, VND_PORT_NAME_MAXLEN, "%s",
+            vnd_board_get()->p_uart_port);
+    }
+    vnd_userial.p_profile = &vnd_userial_profiles[0];
+    vnd_userial.rx_lat_probe = FALSE;
 }
 
 /*******************************************************************************
@@ -194,10 +367,12 @@ void userial_vendor_init(void)
 *******************************************************************************/
 int userial_vendor_open(tUSERIAL_CFG *p_cfg)
 {
+    const vnd_userial_profile_t *p_profile = vnd_userial.p_profile;
     uint32_t baud;
     uint8_t data_bits;
     uint16_t parity;
     uint8_t stop_bits;
+    uint8_t id;
 
     vnd_userial.fd = -1;
 
@@ -226,28 +401,43 @@ int userial_vendor_open(tUSERIAL_CFG *p_cfg)
     else if (p_cfg->fmt & USERIAL_STOPBITS_2)
         stop_bits = CSTOPB;
     
+    if (vnd_userial.port_name[0] == 0) {
+        HILOGE("userial vendor open: no UART for controller %u, set UartPort.%u", vnd_ctx_id(), vnd_ctx_id());
+        return -1;
+    }
+    for (id = 0; id < VND_MAX_CONTROLLERS; id++) {
+        if ((id != vnd_ctx_id()) && (vnd_userials[id].fd >= 0) &&
+            (strcmp(vnd_userials[id].port_name, vnd_userial.port_name) == 0)) {
+            HILOGE("userial vendor open: %s is controller %u's, set UartPort.%u", vnd_userial.port_name, id,
+                vnd_ctx_id());
+            return -1;
+        }
+    }
+
     HILOGI("userial vendor open: opening %s", vnd_userial.port_name);
 
     if ((vnd_userial.fd = open(vnd_userial.port_name, O_RDWR)) == -1) {
         return -1;
     }
 
-    tcflush(vnd_userial.fd, TCIOFLUSH);
-
+    /* build the whole line setup first and hand it to the driver once */
     tcgetattr(vnd_userial.fd, &vnd_userial.termios);
     cfmakeraw(&vnd_userial.termios);
-    vnd_userial.termios.c_cflag |= (CRTSCTS | stop_bits);
-    tcsetattr(vnd_userial.fd, TCSANOW, &vnd_userial.termios);
-    tcflush(vnd_userial.fd, TCIOFLUSH);
-
-    tcsetattr(vnd_userial.fd, TCSANOW, &vnd_userial.termios);
-    tcflush(vnd_userial.fd, TCIOFLUSH);
-    tcflush(vnd_userial.fd, TCIOFLUSH);
-
-    /* set input/output baudrate */
+    vnd_userial.termios.c_cflag |= stop_bits;
+    if (p_profile->flow_ctrl) {
+        vnd_userial.termios.c_cflag |= CRTSCTS;
+    } else {
+        vnd_userial.termios.c_cflag &= ~CRTSCTS;
+    }
     cfsetospeed(&vnd_userial.termios, baud);
     cfsetispeed(&vnd_userial.termios, baud);
     tcsetattr(vnd_userial.fd, TCSANOW, &vnd_userial.termios);
+    tcflush(vnd_userial.fd, TCIOFLUSH);
+
+    /* VMIN/VTIME batching waits for userial_vendor_apply_profile */
+    userial_set_low_latency(vnd_userial.fd, p_profile->low_latency);
+    HILOGI("userial vendor open: profile %s, rts/cts %s, low latency %s", p_profile->name,
+        p_profile->flow_ctrl ? "on" : "off", p_profile->low_latency ? "on" : "off");
 
 #if (BT_WAKE_VIA_USERIAL_IOCTL == TRUE)
     userial_ioctl_init_bt_wake(vnd_userial.fd);
@@ -279,6 +469,10 @@ void userial_vendor_close(void)
     ioctl(vnd_userial.fd, USERIAL_IOCTL_BT_WAKE_DEASSERT, NULL);
 #endif
 
+#if (USERIAL_RX_ENGINE == TRUE)
+    userial_vendor_rx_stop();
+#endif
+
     HILOGI("device fd = %d close", vnd_userial.fd);
     // flush Tx before close to make sure no chars in buffer
     tcflush(vnd_userial.fd, TCIOFLUSH);
@@ -302,8 +496,8 @@ void userial_vendor_set_baud(uint8_t userial_baud)
 {
     uint32_t tcio_baud;
 
-    if (USERIAL_VENDOR_SET_BAUD_DELAY_US > 0) {
-        usleep(USERIAL_VENDOR_SET_BAUD_DELAY_US);
+    if (userial_set_baud_delay_us > 0) {
+        usleep(userial_set_baud_delay_us);
     }
 
     userial_to_tcio_baud(userial_baud, &tcio_baud);
@@ -313,6 +507,61 @@ void userial_vendor_set_baud(uint8_t userial_baud)
     tcsetattr(vnd_userial.fd, TCSANOW, &vnd_userial.termios);
 }
 
+/*******************************************************************************
+**
+** Function        userial_vendor_apply_profile
+**
+** Description     Switch on the read batching of the selected profile. The
+**                 controller configuration runs before this with plain raw
+**                 reads, as every command there waits for a short event
+**                 and would otherwise pay one VTIME each.
+**
+** Returns         None
+**
+*******************************************************************************/
+void userial_vendor_apply_profile(void)
+{
+    const vnd_userial_profile_t *p_profile = vnd_userial.p_profile;
+
+    if ((vnd_userial.fd == -1) || ((vnd_userial.termios.c_cc[VMIN] == p_profile->vmin) &&
+        (vnd_userial.termios.c_cc[VTIME] == p_profile->vtime))) {
+        return;
+    }
+
+    vnd_userial.termios.c_cc[VMIN] = p_profile->vmin;
+    vnd_userial.termios.c_cc[VTIME] = p_profile->vtime;
+    tcsetattr(vnd_userial.fd, TCSANOW, &vnd_userial.termios);
+    HILOGI("userial profile %s: vmin %u vtime %u", p_profile->name, p_profile->vmin, p_profile->vtime);
+}
+
+/*******************************************************************************
+**
+** Function        userial_vendor_get_icount
+**
+** Description     Read the UART driver's line error and receive counters
+**
+** Returns         0 : Success
+**                 Otherwise : Fail (e.g. not supported by the driver)
+**
+*******************************************************************************/
+int userial_vendor_get_icount(uint32_t *p_frame, uint32_t *p_overrun, uint32_t *p_rx)
+{
+#ifdef TIOCGICOUNT
+    struct serial_icounter_struct icount;
+
+    if ((vnd_userial.fd == -1) || (ioctl(vnd_userial.fd, TIOCGICOUNT, &icount) != 0)) {
+        return -1;
+    }
+
+    *p_frame = (uint32_t)icount.frame;
+    *p_overrun = (uint32_t)(icount.overrun + icount.buf_overrun);
+    *p_rx = (uint32_t)icount.rx;
+    return 0;
+#else
+    return -1;
+#endif
+}
+
 /*******************************************************************************
 **
 ** Function        userial_vendor_ioctl
@@ -346,6 +595,620 @@ void userial_vendor_ioctl(userial_vendor_ioctl_op_t op, void *p_data)
     }
 }
 
+#if (USERIAL_RX_ENGINE == TRUE)
+/*****************************************************************************
+**   Receive Engine Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        userial_rx_hdr_len
+**
+** Description     HCI header length of an H4 packet type
+**
+** Returns         Header length, 0 for an unknown indicator
+**
+*******************************************************************************/
+static uint8_t userial_rx_hdr_len(uint8_t type)
+{
+    switch (type) {
+        case USERIAL_H4_ACL:
+            return 4; /* handle(2) length(2) */
+        case USERIAL_H4_CMD:
+        case USERIAL_H4_SCO:
+            return 3; /* opcode or handle(2) length(1) */
+        case USERIAL_H4_EVT:
+            return 2; /* event code(1) length(1) */
+        default:
+            return 0;
+    }
+}
+
+/*******************************************************************************
+**
+** Function        userial_rx_get_slot
+**
+** Description     Take the next slot of the ring. While it is still held by
+**                 a consumer the reader waits, which leaves the data in the
+**                 tty buffer and lets RTS/CTS throttle the controller.
+**
+** Returns         Slot, NULL when the engine is stopping
+**
+*******************************************************************************/
+static userial_rx_slot_t *userial_rx_get_slot(void)
+{
+    userial_rx_slot_t *p_slot;
+
+    pthread_mutex_lock(&userial_rx_lock);
+    p_slot = &userial_rx.slot[userial_rx.head];
+    if (p_slot->busy) {
+        userial_rx.stats.stalls++;
+    }
+    while (p_slot->busy && !userial_rx_stopping()) {
+        pthread_cond_wait(&userial_rx_cond, &userial_rx_lock);
+    }
+
+    if (userial_rx_stopping()) {
+        p_slot = NULL;
+    } else {
+        p_slot->busy = TRUE;
+        userial_rx.head = (userial_rx.head + 1) % USERIAL_RX_SLOTS;
+        if (++userial_rx.stats.depth > userial_rx.stats.depth_max) {
+            userial_rx.stats.depth_max = userial_rx.stats.depth;
+        }
+    }
+    pthread_mutex_unlock(&userial_rx_lock);
+
+    return p_slot;
+}
+
+/*******************************************************************************
+**
+** Function        userial_rx_hdr_done
+**
+** Description     Header complete, pick where the payload goes
+**
+** Returns         None
+**
+*******************************************************************************/
+static void userial_rx_hdr_done(void)
+{
+    userial_rx_slot_t *p_slot;
+
+    if (userial_rx.type == USERIAL_H4_ACL) {
+        userial_rx.need = (uint16_t)(userial_rx.hdr[2] | (userial_rx.hdr[3] << 8)); /* 2, 3: length */
+    } else {
+        userial_rx.need = userial_rx.hdr[userial_rx.hdr_len - 1];
+    }
+
+    if (userial_rx.consumer[userial_rx.type].p_cback == NULL) {
+        userial_rx.stats.unclaimed++;
+        userial_rx.state = USERIAL_RX_SKIP;
+    } else if (userial_rx.hdr_len + userial_rx.need > HCI_MAX_FRAME_SIZE) {
+        userial_rx.stats.oversize++;
+        userial_rx.state = USERIAL_RX_SKIP;
+    } else if ((p_slot = userial_rx_get_slot()) == NULL) {
+        userial_rx.state = USERIAL_RX_SKIP;
+    } else {
+        p_slot->pkt.type = userial_rx.type;
+        p_slot->pkt.p_data = p_slot->data;
+        (void)memcpy_s(p_slot->data, sizeof(p_slot->data), userial_rx.hdr, userial_rx.hdr_len);
+        p_slot->pkt.len = userial_rx.hdr_len;
+        userial_rx.p_cur = p_slot;
+        userial_rx.state = USERIAL_RX_PAYLOAD;
+    }
+}
+
+/*******************************************************************************
+**
+** Function        userial_rx_deliver
+**
+** Description     Hand the filled slot to the consumer of its channel
+**
+** Returns         None
+**
+*******************************************************************************/
+static void userial_rx_deliver(void)
+{
+    userial_rx_slot_t *p_slot = userial_rx.p_cur;
+    userial_rx_consumer_t *p_consumer = &userial_rx.consumer[p_slot->pkt.type];
+
+    userial_rx.p_cur = NULL;
+    userial_rx.state = USERIAL_RX_TYPE;
+    userial_rx.stats.packets[p_slot->pkt.type]++;
+    p_slot->pkt.rx_us = get_monotonic_time_us();
+    p_consumer->p_cback(p_consumer->p_data, &p_slot->pkt);
+}
+
+/*******************************************************************************
+**
+** Function        userial_rx_payload
+**
+** Description     Account n payload bytes placed in the slot being filled
+**
+** Returns         None
+**
+*******************************************************************************/
+static void userial_rx_payload(size_t n)
+{
+    userial_rx.p_cur->pkt.len += n;
+    userial_rx.need -= n;
+    if (userial_rx.need == 0) {
+        userial_rx_deliver();
+    }
+}
+
+/*******************************************************************************
+**
+** Function        userial_rx_parse
+**
+** Description     Split a chunk read from the tty on H4 packet boundaries.
+**                 Payload bytes found in the chunk are copied once into the
+**                 slot the consumer receives.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void userial_rx_parse(const uint8_t *p, size_t len)
+{
+    size_t n;
+
+    while ((len > 0) && !userial_rx_stopping()) {
+        switch (userial_rx.state) {
+            case USERIAL_RX_TYPE:
+                userial_rx.type = *p++;
+                len--;
+                userial_rx.hdr_len = userial_rx_hdr_len(userial_rx.type);
+                if (userial_rx.hdr_len == 0) {
+                    userial_rx.stats.resync++;
+                } else {
+                    userial_rx.hdr_got = 0;
+                    userial_rx.state = USERIAL_RX_HDR;
+                }
+                break;
+
+            case USERIAL_RX_HDR:
+                n = userial_rx.hdr_len - userial_rx.hdr_got;
+                n = (n < len) ? n : len;
+                (void)memcpy_s(&userial_rx.hdr[userial_rx.hdr_got], USERIAL_RX_HDR_MAX - userial_rx.hdr_got, p, n);
+                userial_rx.hdr_got += n;
+                p += n;
+                len -= n;
+                if (userial_rx.hdr_got == userial_rx.hdr_len) {
+                    userial_rx_hdr_done();
+                    if ((userial_rx.state == USERIAL_RX_PAYLOAD) && (userial_rx.need == 0)) {
+                        userial_rx_deliver();
+                    }
+                }
+                break;
+
+            case USERIAL_RX_PAYLOAD:
+                n = (userial_rx.need < len) ? userial_rx.need : len;
+                (void)memcpy_s(&userial_rx.p_cur->data[userial_rx.p_cur->pkt.len],
+                    HCI_MAX_FRAME_SIZE - userial_rx.p_cur->pkt.len, p, n);
+                p += n;
+                len -= n;
+                userial_rx_payload(n);
+                break;
+
+            default: /* USERIAL_RX_SKIP */
+                n = (userial_rx.need < len) ? userial_rx.need : len;
+                userial_rx.need -= n;
+                p += n;
+                len -= n;
+                if (userial_rx.need == 0) {
+                    userial_rx.state = USERIAL_RX_TYPE;
+                }
+                break;
+        }
+    }
+}
+
+/*******************************************************************************
+**
+** Function        userial_rx_lat_thread
+**
+** Description     RX latency probe sampler. User space cannot see the
+**                 interrupt itself, so the driver's receive counter
+**                 (TIOCGICOUNT, bumped in the interrupt handler) is polled
+**                 and the time each new value shows up is recorded.
+**
+** Returns         NULL
+**
+*******************************************************************************/
+static void *userial_rx_lat_thread(void *arg)
+{
+    uint32_t frame, overrun, rx;
+    uint32_t last;
+
+    vnd_ctx_bind_thread(arg);
+    last = userial_rx.lat_rx_base;
+    while (!userial_rx_stopping()) {
+        if ((userial_vendor_get_icount(&frame, &overrun, &rx) == 0) && (rx != last)) {
+            last = rx;
+            pthread_mutex_lock(&userial_rx_lock);
+            userial_rx.mark[userial_rx.mark_head % USERIAL_RX_LAT_MARKS].t_us = get_monotonic_time_us();
+            userial_rx.mark[userial_rx.mark_head % USERIAL_RX_LAT_MARKS].rx = last;
+            userial_rx.mark_head++;
+            if (userial_rx.mark_head - userial_rx.mark_tail > USERIAL_RX_LAT_MARKS) {
+                userial_rx.mark_tail = userial_rx.mark_head - USERIAL_RX_LAT_MARKS;
+            }
+            pthread_mutex_unlock(&userial_rx_lock);
+        }
+        usleep(USERIAL_RX_LAT_POLL_US);
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+**
+** Function        userial_rx_lat_record
+**
+** Description     Match a completed read against the receive counter marks.
+**                 The delay runs from the first mark that covers the last
+**                 byte read to the read returning; it is accurate to one
+**                 poll period.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void userial_rx_lat_record(uint64_t now_us, size_t len)
+{
+    userial_rx_mark_t *p_mark;
+    uint32_t target;
+    uint32_t delay;
+
+    userial_rx.lat_read += (uint32_t)len;
+    target = userial_rx.lat_rx_base + userial_rx.lat_read;
+
+    pthread_mutex_lock(&userial_rx_lock);
+    while (userial_rx.mark_tail != userial_rx.mark_head) {
+        p_mark = &userial_rx.mark[userial_rx.mark_tail % USERIAL_RX_LAT_MARKS];
+        if ((int32_t)(p_mark->rx - target) < 0) {
+            userial_rx.mark_tail++;
+            continue;
+        }
+
+        delay = (now_us > p_mark->t_us) ? (uint32_t)(now_us - p_mark->t_us) : 0;
+        if ((userial_rx.stats.lat_samples == 0) || (delay < userial_rx.stats.lat_min_us)) {
+            userial_rx.stats.lat_min_us = delay;
+        }
+        if (delay > userial_rx.stats.lat_max_us) {
+            userial_rx.stats.lat_max_us = delay;
+        }
+        userial_rx.stats.lat_sum_us += delay;
+        userial_rx.stats.lat_samples++;
+        break;
+    }
+    pthread_mutex_unlock(&userial_rx_lock);
+}
+
+/*******************************************************************************
+**
+** Function        userial_rx_lat_start
+**
+** Description     Start the RX latency probe if UartRxLatencyProbe asks for
+**                 it and the driver keeps receive counters
+**
+** Returns         None
+**
+*******************************************************************************/
+static void userial_rx_lat_start(void)
+{
+    uint32_t frame, overrun, rx;
+    int pending = 0;
+
+    userial_rx.lat_probe = FALSE;
+    if (!vnd_userial.rx_lat_probe) {
+        return;
+    }
+
+    if (userial_vendor_get_icount(&frame, &overrun, &rx) != 0) {
+        HILOGW("userial rx: latency probe needs TIOCGICOUNT, not supported by %s", vnd_userial.port_name);
+        return;
+    }
+
+    /* bytes already waiting were counted but are still to be read */
+    (void)ioctl(vnd_userial.fd, FIONREAD, &pending);
+    userial_rx.lat_rx_base = rx - (uint32_t)pending;
+    userial_rx.lat_read = 0;
+    userial_rx.mark_head = 0;
+    userial_rx.mark_tail = 0;
+
+    if (pthread_create(&userial_rx.lat_thread, NULL, userial_rx_lat_thread, VND_CTX_THREAD_ARG()) != 0) {
+        HILOGW("userial rx: latency probe thread failed");
+        return;
+    }
+    userial_rx.lat_probe = TRUE;
+}
+
+/*******************************************************************************
+**
+** Function        userial_rx_thread
+**
+** Description     Receive engine reader, one read per readiness wake-up.
+**                 The rest of a packet begun in an earlier read is scattered
+**                 straight into its slot, what follows lands in a chunk the
+**                 parser splits. Packets starting inside the chunk are still
+**                 copied once into their slot: reading their headers first
+**                 would cost two or three reads per packet instead of one
+**                 per burst.
+**
+** Returns         NULL
+**
+*******************************************************************************/
+static void *userial_rx_thread(void *arg)
+{
+    uint8_t buf[USERIAL_RX_CHUNK_SIZE];
+    struct iovec iov[2]; /* 2: rest of the current slot, then the chunk */
+    int iov_cnt;
+    size_t chunk;
+    size_t direct;
+    struct epoll_event ev;
+    ssize_t len;
+
+    vnd_ctx_bind_thread(arg);
+    chunk = vnd_userial.p_profile->rx_chunk;
+    while (!userial_rx_stopping()) {
+        if (epoll_wait(userial_rx.epoll_fd, &ev, 1, -1) <= 0) {
+            continue;
+        }
+
+        if (ev.data.fd == userial_rx.stop_fd) {
+            break;
+        }
+
+        iov_cnt = 0;
+        if (userial_rx.state == USERIAL_RX_PAYLOAD) {
+            iov[iov_cnt].iov_base = &userial_rx.p_cur->data[userial_rx.p_cur->pkt.len];
+            iov[iov_cnt++].iov_len = userial_rx.need;
+        }
+        iov[iov_cnt].iov_base = buf;
+        iov[iov_cnt++].iov_len = chunk;
+
+        len = readv(vnd_userial.fd, iov, iov_cnt);
+        if (len <= 0) {
+            if ((len < 0) && ((errno == EINTR) || (errno == EAGAIN))) {
+                continue;
+            }
+            HILOGE("userial rx: read failed: %s (%d)", strerror(errno), errno);
+            break;
+        }
+
+        if (userial_rx.lat_probe) {
+            userial_rx_lat_record(get_monotonic_time_us(), (size_t)len);
+        }
+
+        userial_rx.stats.reads++;
+        userial_rx.stats.bytes += (uint64_t)len;
+        direct = 0;
+        if (iov_cnt > 1) {
+            direct = ((size_t)len < iov[0].iov_len) ? (size_t)len : iov[0].iov_len;
+            userial_rx.stats.direct += (uint64_t)direct;
+            userial_rx_payload(direct);
+        }
+        userial_rx_parse(buf, (size_t)len - direct);
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+**
+** Function        userial_vendor_rx_register
+**
+** Description     Set the consumer of one H4 channel
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int userial_vendor_rx_register(uint8_t type, userial_rx_cback_t p_cback, void *p_data)
+{
+    if ((userial_rx_hdr_len(type) == 0) || userial_rx.running) {
+        return -1;
+    }
+
+    userial_rx.consumer[type].p_cback = p_cback;
+    userial_rx.consumer[type].p_data = p_data;
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function        userial_vendor_rx_start
+**
+** Description     Start reading the opened port on the engine thread
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int userial_vendor_rx_start(void)
+{
+    struct epoll_event ev;
+    int i;
+
+    if (userial_rx.running) {
+        return 0;
+    }
+
+    if (vnd_userial.fd == -1) {
+        return -1;
+    }
+
+    for (i = 0; i < USERIAL_RX_SLOTS; i++) {
+        userial_rx.slot[i].busy = FALSE;
+    }
+    userial_rx.head = 0;
+    userial_rx.p_cur = NULL;
+    userial_rx.state = USERIAL_RX_TYPE;
+    __atomic_store_n(&userial_rx.stop, FALSE, __ATOMIC_RELEASE);
+    memset_s(&userial_rx.stats, sizeof(userial_rx.stats), 0, sizeof(userial_rx.stats));
+
+    userial_rx.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    userial_rx.stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if ((userial_rx.epoll_fd < 0) || (userial_rx.stop_fd < 0)) {
+        HILOGE("userial rx: epoll/eventfd failed: %s (%d)", strerror(errno), errno);
+        goto fail;
+    }
+
+    memset_s(&ev, sizeof(ev), 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = userial_rx.stop_fd;
+    if (epoll_ctl(userial_rx.epoll_fd, EPOLL_CTL_ADD, userial_rx.stop_fd, &ev) != 0) {
+        goto fail;
+    }
+
+    ev.data.fd = vnd_userial.fd;
+    if (epoll_ctl(userial_rx.epoll_fd, EPOLL_CTL_ADD, vnd_userial.fd, &ev) != 0) {
+        HILOGE("userial rx: cannot poll fd %d: %s (%d)", vnd_userial.fd, strerror(errno), errno);
+        goto fail;
+    }
+
+    if (pthread_create(&userial_rx.thread, NULL, userial_rx_thread, VND_CTX_THREAD_ARG()) != 0) {
+        HILOGE("userial rx: pthread_create failed");
+        goto fail;
+    }
+
+    userial_rx.running = TRUE;
+    userial_rx_lat_start();
+    HILOGI("userial rx: engine started, %d slots of %d bytes", USERIAL_RX_SLOTS, HCI_MAX_FRAME_SIZE);
+    return 0;
+
+fail:
+    if (userial_rx.epoll_fd >= 0) {
+        close(userial_rx.epoll_fd);
+    }
+    if (userial_rx.stop_fd >= 0) {
+        close(userial_rx.stop_fd);
+    }
+    userial_rx.epoll_fd = -1;
+    userial_rx.stop_fd = -1;
+    return -1;
+}
+
+/*******************************************************************************
+**
+** Function        userial_vendor_rx_stop
+**
+** Description     Stop the receive engine and clear the consumers
+**
+** Returns         None
+**
+*******************************************************************************/
+void userial_vendor_rx_stop(void)
+{
+    uint64_t one = 1;
+    userial_rx_stats_t *p_stats = &userial_rx.stats;
+
+    if (!userial_rx.running) {
+        return;
+    }
+
+    pthread_mutex_lock(&userial_rx_lock);
+    __atomic_store_n(&userial_rx.stop, TRUE, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&userial_rx_cond);
+    pthread_mutex_unlock(&userial_rx_lock);
+
+    if (write(userial_rx.stop_fd, &one, sizeof(one)) < 0) {
+        HILOGE("userial rx: stop signal failed: %s (%d)", strerror(errno), errno);
+    }
+    pthread_join(userial_rx.thread, NULL);
+    if (userial_rx.lat_probe) {
+        pthread_join(userial_rx.lat_thread, NULL);
+        userial_rx.lat_probe = FALSE;
+    }
+
+    close(userial_rx.epoll_fd);
+    close(userial_rx.stop_fd);
+    userial_rx.epoll_fd = -1;
+    userial_rx.stop_fd = -1;
+    userial_rx.running = FALSE;
+    memset_s(userial_rx.consumer, sizeof(userial_rx.consumer), 0, sizeof(userial_rx.consumer));
+
+    HILOGI("userial rx: %u reads, %llu bytes (%llu into a slot), evt/acl/sco %u/%u/%u, dropped %u unclaimed "
+        "%u oversize, %u resync, %u stalls, depth %u (max %u)", p_stats->reads, (unsigned long long)p_stats->bytes,
+        (unsigned long long)p_stats->direct,
+        p_stats->packets[USERIAL_H4_EVT], p_stats->packets[USERIAL_H4_ACL], p_stats->packets[USERIAL_H4_SCO],
+        p_stats->unclaimed, p_stats->oversize, p_stats->resync, p_stats->stalls, p_stats->depth, p_stats->depth_max);
+    if (p_stats->lat_samples > 0) {
+        HILOGI("userial rx: irq to user space min/avg/max %u/%llu/%u us over %u reads (+-%d us)", p_stats->lat_min_us,
+            (unsigned long long)(p_stats->lat_sum_us / p_stats->lat_samples), p_stats->lat_max_us,
+            p_stats->lat_samples, USERIAL_RX_LAT_POLL_US);
+    }
+}
+
+/*******************************************************************************
+**
+** Function        userial_vendor_rx_release
+**
+** Description     Hand a delivered packet slot back to the engine of the
+**                 controller it was read from, whatever the calling thread
+**
+** Returns         None
+**
+*******************************************************************************/
+void userial_vendor_rx_release(userial_rx_pkt_t *p_pkt)
+{
+    userial_rx_slot_t *p_slot = (userial_rx_slot_t *)p_pkt;
+    uint8_t id;
+
+    if (p_pkt == NULL) {
+        return;
+    }
+
+    for (id = 0; id < VND_MAX_CONTROLLERS; id++) {
+        if ((p_slot >= userial_rxs[id].slot) && (p_slot < userial_rxs[id].slot + USERIAL_RX_SLOTS)) {
+            break;
+        }
+    }
+    if (id == VND_MAX_CONTROLLERS) {
+        HILOGE("userial rx: released packet not from a receive engine");
+        return;
+    }
+
+    pthread_mutex_lock(&userial_rx_locks[id]);
+    if (p_slot->busy) {
+        p_slot->busy = FALSE;
+        userial_rxs[id].stats.depth--;
+        pthread_cond_signal(&userial_rx_conds[id]);
+    }
+    pthread_mutex_unlock(&userial_rx_locks[id]);
+}
+
+/*******************************************************************************
+**
+** Function        userial_vendor_rx_get_stats
+**
+** Description     Read the receive engine counters
+**
+** Returns         None
+**
+*******************************************************************************/
+void userial_vendor_rx_get_stats(userial_rx_stats_t *p_stats)
+{
+    pthread_mutex_lock(&userial_rx_lock);
+    (void)memcpy_s(p_stats, sizeof(userial_rx_stats_t), &userial_rx.stats, sizeof(userial_rx_stats_t));
+    pthread_mutex_unlock(&userial_rx_lock);
+}
+#endif
+
+/*******************************************************************************
+**
+** Function        userial_tune_init
+**
+** Description     Register the UART tunables before the conf file is read
+**
+** Returns         None
+**
+*******************************************************************************/
+void userial_tune_init(void)
+{
+    vnd_tune_register(userial_tunes, (uint32_t)(sizeof(userial_tunes) / sizeof(userial_tunes[0])));
+}
+
 /*******************************************************************************
 **
 ** Function        userial_set_port
@@ -362,3 +1225,46 @@ int userial_set_port(char *p_conf_name, char *p_conf_value, int param)
 
     return 0;
 }
+
+/*******************************************************************************
+**
+** Function        userial_set_profile
+**
+** Description     Select the UART latency/throughput profile by name
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int userial_set_profile(char *p_conf_name, char *p_conf_value, int param)
+{
+    uint32_t i;
+
+    for (i = 0; i < sizeof(vnd_userial_profiles) / sizeof(vnd_userial_profiles[0]); i++) {
+        if (strcmp(vnd_userial_profiles[i].name, p_conf_value) == 0) {
+            vnd_userial.p_profile = &vnd_userial_profiles[i];
+            return 0;
+        }
+    }
+
+    HILOGW("%s: unknown profile %s, keeping %s", p_conf_name, p_conf_value, vnd_userial.p_profile->name);
+    return -1;
+}
+
+#if (USERIAL_RX_ENGINE == TRUE)
+/*******************************************************************************
+**
+** Function        userial_set_rx_latency_probe
+**
+** Description     Turn the receive engine latency measurement on or off
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int userial_set_rx_latency_probe(char *p_conf_name, char *p_conf_value, int param)
+{
+    vnd_userial.rx_lat_probe = (atoi(p_conf_value) != 0);
+    return 0;
+}
+#endif
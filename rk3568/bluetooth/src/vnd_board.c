@@ -0,0 +1,231 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      vnd_board.c
+ *
+ *  Description:   Contains the board profiles. The boards share one library
+ *                 build; the profile of the board it runs on is picked from
+ *                 the device tree at init, and the conf file still
+ *                 overrides any of its values.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_vnd_board"
+
+#include <utils/Log.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include "bt_vendor_brcm.h"
+#include "vnd_board.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+/* compatible property, a list of NUL terminated strings */
+#define VND_BOARD_COMPATIBLE_LEN 256
+
+/* Complete LPM parameter block built from the LPM_xxx settings */
+#define VND_BOARD_LPM_DEFAULT            \
+    {                                    \
+        LPM_SLEEP_MODE,                  \
+        LPM_IDLE_THRESHOLD,              \
+        LPM_HC_IDLE_THRESHOLD,           \
+        LPM_BT_WAKE_POLARITY,            \
+        LPM_HOST_WAKE_POLARITY,          \
+        LPM_ALLOW_HOST_SLEEP_DURING_SCO, \
+        LPM_COMBINE_SLEEP_MODE_AND_LPM,  \
+        LPM_ENABLE_UART_TXD_TRI_STATE,   \
+        0, /* not applicable */          \
+        0, /* not applicable */          \
+        0, /* not applicable */          \
+        LPM_PULSED_HOST_WAKE             \
+    }
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+/* Settle times recommended for chipsets fitted on both boards */
+static const vnd_board_settle_t vnd_board_settle[] = {
+    {"BCM43241", 200},
+    {"BCM43341", 100},
+    {NULL, 0}
+};
+
+static const vnd_board_profile_t vnd_board_profiles[] = {
+    {
+        .p_name = "rk3568",
+        .p_compatible = "rockchip,rk3568",
+        .p_uart_port = BLUETOOTH_UART_DEVICE_PORT,
+        .p_patch_name = NULL,
+        .max_baud = UART_TARGET_BAUD_RATE,
+        .p_settle = vnd_board_settle,
+        .p_host_wake = NULL,
+        .lpm = VND_BOARD_LPM_DEFAULT,
+    },
+    /* the dayu210 fork always loaded the BCM4362A2 patch its image ships;
+     * its UART ceiling and LPM_xxx settings were those of rk3568
+     */
+    {
+        .p_name = "dayu210",
+        .p_compatible = "rockchip,rk3588",
+        .p_uart_port = "/dev/ttyS9",
+        .p_patch_name = "BCM4362A2.hcd",
+        .max_baud = UART_TARGET_BAUD_RATE,
+        .p_settle = vnd_board_settle,
+        .p_host_wake = NULL,
+        .lpm = VND_BOARD_LPM_DEFAULT,
+    },
+};
+
+#define VND_BOARD_NUM (sizeof(vnd_board_profiles) / sizeof(vnd_board_profiles[0]))
+
+static const vnd_board_profile_t *p_vnd_board = &vnd_board_profiles[0];
+
+/*****************************************************************************
+**   Helper Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        vnd_board_find
+**
+** Description     Find a profile by name
+**
+** Returns         Profile, NULL if none
+**
+*******************************************************************************/
+static const vnd_board_profile_t *vnd_board_find(const char *p_name)
+{
+    uint32_t i;
+
+    for (i = 0; i < VND_BOARD_NUM; i++) {
+        if (strcmp(vnd_board_profiles[i].p_name, p_name) == 0) {
+            return &vnd_board_profiles[i];
+        }
+    }
+    return NULL;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_board_detect
+**
+** Description     Match the device tree compatible strings against the
+**                 profiles
+**
+** Returns         Profile, NULL if none matches
+**
+*******************************************************************************/
+static const vnd_board_profile_t *vnd_board_detect(void)
+{
+    char compatible[VND_BOARD_COMPATIBLE_LEN];
+    ssize_t len;
+    ssize_t pos;
+    uint32_t i;
+    int fd;
+
+    if ((fd = open(VND_BOARD_DT_COMPATIBLE, O_RDONLY | O_CLOEXEC)) < 0) {
+        return NULL;
+    }
+    len = read(fd, compatible, sizeof(compatible) - 1);
+    (void)close(fd);
+    if (len <= 0) {
+        return NULL;
+    }
+    compatible[len] = '\0';
+
+    for (pos = 0; pos < len; pos += (ssize_t)strlen(&compatible[pos]) + 1) {
+        for (i = 0; i < VND_BOARD_NUM; i++) {
+            if (strcmp(&compatible[pos], vnd_board_profiles[i].p_compatible) == 0) {
+                return &vnd_board_profiles[i];
+            }
+        }
+    }
+    return NULL;
+}
+
+/*****************************************************************************
+**   Board Profile Interface Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        vnd_board_init
+**
+** Description     Select the profile of the board running the library: the
+**                 one matching the device tree compatible strings, else
+**                 VND_BOARD_DEFAULT
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_board_init(void)
+{
+    const vnd_board_profile_t *p_board = vnd_board_detect();
+
+    if (p_board == NULL) {
+        p_board = vnd_board_find(VND_BOARD_DEFAULT);
+    }
+    if (p_board == NULL) {
+        HILOGE("board %s has no profile", VND_BOARD_DEFAULT);
+        p_board = &vnd_board_profiles[0];
+    }
+
+    p_vnd_board = p_board;
+    HILOGI("board profile %s, uart %s, max baud %u", p_board->p_name, p_board->p_uart_port, p_board->max_baud);
+}
+
+/*******************************************************************************
+**
+** Function        vnd_board_get
+**
+** Description     Profile of the board running the library
+**
+** Returns         Board profile
+**
+*******************************************************************************/
+const vnd_board_profile_t *vnd_board_get(void)
+{
+    return p_vnd_board;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_board_settle_time
+**
+** Description     Firmware settle time the profile expects on a chipset
+**
+** Returns         Settle time in milliseconds, 0 if not known
+**
+*******************************************************************************/
+uint32_t vnd_board_settle_time(const char *p_chip_name)
+{
+    const vnd_board_settle_t *p_entry = p_vnd_board->p_settle;
+
+    for (; (p_entry != NULL) && (p_entry->p_chip_name != NULL); p_entry++) {
+        if (strncmp(p_chip_name, p_entry->p_chip_name, strlen(p_entry->p_chip_name)) == 0) {
+            return p_entry->settle_ms;
+        }
+    }
+    return 0;
+}
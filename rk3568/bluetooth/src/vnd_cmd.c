@@ -0,0 +1,215 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      vnd_cmd.c
+ *
+ *  Description:   Contains the HCI command buffer pool. xmit_cb does not
+ *                 keep the buffer it is given, so every command can be
+ *                 built in a buffer of a small fixed pool and handed back
+ *                 right after transmission instead of going through the
+ *                 stack allocator, once per firmware record during patch
+ *                 download and once per LPM toggle.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_vnd_cmd"
+
+#include <utils/Log.h>
+#include <pthread.h>
+#include <string.h>
+#include "bt_vendor_brcm.h"
+#include "bt_hci_bdroid.h"
+#include "vnd_cmd.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+#if (VND_CMD_POOL_SIZE > 32)
+#error "VND_CMD_POOL_SIZE is limited by the 32 bit busy mask"
+#endif
+
+/******************************************************************************
+**  Local type definitions
+******************************************************************************/
+
+/* Pool buffer, kept in uint16_t units for the alignment of HC_BT_HDR */
+typedef struct {
+    uint16_t mem[(BT_HC_HDR_SIZE + HCI_CMD_MAX_LEN + 1) / 2];
+} vnd_cmd_buf_t;
+
+/* Command buffer pool control block */
+typedef struct {
+    vnd_cmd_buf_t buf[VND_CMD_POOL_SIZE];
+    uint32_t busy;          /* one bit per buffer handed out */
+    vnd_cmd_stats_t stats;
+} vnd_cmd_pool_t;
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+static vnd_cmd_pool_t vnd_cmd_pool;
+static pthread_mutex_t vnd_cmd_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*******************************************************************************
+**
+** Function        vnd_cmd_get
+**
+** Description     Take a command buffer able to hold HCI_CMD_MAX_LEN bytes
+**
+** Returns         Buffer, NULL if none is available
+**
+*******************************************************************************/
+HC_BT_HDR *vnd_cmd_get(void)
+{
+    HC_BT_HDR *p_buf = NULL;
+    uint32_t idx;
+
+    pthread_mutex_lock(&vnd_cmd_lock);
+    vnd_cmd_pool.stats.gets++;
+    if (vnd_cmd_pool.stats.in_use < VND_CMD_POOL_SIZE) {
+        idx = (uint32_t)__builtin_ctz(~vnd_cmd_pool.busy);
+        vnd_cmd_pool.busy |= (1U << idx);
+        if (++vnd_cmd_pool.stats.in_use > vnd_cmd_pool.stats.high_water) {
+            vnd_cmd_pool.stats.high_water = vnd_cmd_pool.stats.in_use;
+        }
+        p_buf = (HC_BT_HDR *)vnd_cmd_pool.buf[idx].mem;
+    } else {
+        vnd_cmd_pool.stats.fallbacks++;
+    }
+    pthread_mutex_unlock(&vnd_cmd_lock);
+
+    if ((p_buf == NULL) && (bt_vendor_cbacks != NULL)) {
+        p_buf = (HC_BT_HDR *)bt_vendor_cbacks->alloc(BT_HC_HDR_SIZE + HCI_CMD_MAX_LEN);
+    }
+
+    if (p_buf != NULL) {
+        p_buf->event = MSG_STACK_TO_HC_HCI_CMD;
+        p_buf->len = 0;
+        p_buf->offset = 0;
+        p_buf->layer_specific = 0;
+    }
+
+    return p_buf;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_cmd_build
+**
+** Description     Take a command buffer and fill in opcode and parameters
+**
+** Returns         Buffer, NULL if none is available
+**
+*******************************************************************************/
+HC_BT_HDR *vnd_cmd_build(uint16_t opcode, const uint8_t *p_param, uint8_t param_len)
+{
+    HC_BT_HDR *p_buf = vnd_cmd_get();
+    uint8_t *p;
+
+    if (p_buf == NULL) {
+        return NULL;
+    }
+
+    p = (uint8_t *)(p_buf + 1);
+    *p++ = (uint8_t)opcode;
+    *p++ = (uint8_t)(opcode >> 8);
+    *p++ = param_len;
+    if (p_param != NULL) {
+        (void)memcpy_s(p, HCI_CMD_MAX_LEN - HCI_CMD_PREAMBLE_SIZE, p_param, param_len);
+    } else {
+        (void)memset_s(p, HCI_CMD_MAX_LEN - HCI_CMD_PREAMBLE_SIZE, 0, param_len);
+    }
+    p_buf->len = HCI_CMD_PREAMBLE_SIZE + param_len;
+
+    return p_buf;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_cmd_put
+**
+** Description     Give back a command buffer
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_cmd_put(HC_BT_HDR *p_buf)
+{
+    uintptr_t addr = (uintptr_t)p_buf;
+    uintptr_t base = (uintptr_t)vnd_cmd_pool.buf;
+    uint32_t idx;
+
+    if (p_buf == NULL) {
+        return;
+    }
+
+    if ((addr < base) || (addr >= base + sizeof(vnd_cmd_pool.buf))) {
+        if (bt_vendor_cbacks != NULL) {
+            bt_vendor_cbacks->dealloc(p_buf);
+        }
+        return;
+    }
+
+    idx = (uint32_t)((addr - base) / sizeof(vnd_cmd_buf_t));
+    pthread_mutex_lock(&vnd_cmd_lock);
+    if (vnd_cmd_pool.busy & (1U << idx)) {
+        vnd_cmd_pool.busy &= ~(1U << idx);
+        vnd_cmd_pool.stats.in_use--;
+    } else {
+        HILOGE("vnd_cmd_put: buffer %u given back twice", idx);
+    }
+    pthread_mutex_unlock(&vnd_cmd_lock);
+}
+
+/*******************************************************************************
+**
+** Function        vnd_cmd_get_stats
+**
+** Description     Copy the pool statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_cmd_get_stats(vnd_cmd_stats_t *p_stats)
+{
+    pthread_mutex_lock(&vnd_cmd_lock);
+    (void)memcpy_s(p_stats, sizeof(vnd_cmd_stats_t), &vnd_cmd_pool.stats, sizeof(vnd_cmd_stats_t));
+    pthread_mutex_unlock(&vnd_cmd_lock);
+}
+
+/*******************************************************************************
+**
+** Function        vnd_cmd_dump
+**
+** Description     Log the pool statistics
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_cmd_dump(void)
+{
+    vnd_cmd_stats_t stats;
+
+    vnd_cmd_get_stats(&stats);
+    HILOGI("cmd pool: %u buffers, %u commands, high water %u, %u fallbacks, %u in use", VND_CMD_POOL_SIZE,
+        stats.gets, stats.high_water, stats.fallbacks, stats.in_use);
+}
@@ -0,0 +1,200 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      vnd_ctx.c
+ *
+ *  Description:   Contains the binding of threads to the controllers served
+ *                 by the library
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_vnd_ctx"
+
+#include <utils/Log.h>
+#include <pthread.h>
+#include "bt_vendor_brcm.h"
+#include "vnd_ctx.h"
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+#if (VND_MAX_CONTROLLERS > 1)
+static __thread uint8_t vnd_ctx_cur = VND_CTX_UNBOUND; /* controller of the calling thread */
+static __thread uint8_t vnd_ctx_warned;                /* unbound access logged */
+#else
+static __thread uint8_t vnd_ctx_cur; /* the only controller */
+#endif
+static uint32_t vnd_ctx_opened;      /* bit mask of the open controllers */
+static pthread_mutex_t vnd_ctx_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*****************************************************************************
+**   Controller Context Interface Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_id
+**
+** Description     Controller the calling thread is bound to. A thread never
+**                 bound has no controller state of its own: its access is
+**                 logged once and falls back to the first controller so it
+**                 stays within bounds.
+**
+** Returns         Controller index
+**
+*******************************************************************************/
+uint8_t vnd_ctx_id(void)
+{
+#if (VND_MAX_CONTROLLERS > 1)
+    if (vnd_ctx_cur == VND_CTX_UNBOUND) {
+        if (!vnd_ctx_warned) {
+            vnd_ctx_warned = TRUE;
+            HILOGE("vnd_ctx_id: thread bound to no controller reaches controller state, using controller 0");
+        }
+        return 0;
+    }
+#endif
+    return vnd_ctx_cur;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_binding
+**
+** Description     Binding of the calling thread, for handing it over to the
+**                 threads and timers started on its behalf
+**
+** Returns         Controller index, VND_CTX_UNBOUND if not bound
+**
+*******************************************************************************/
+uint8_t vnd_ctx_binding(void)
+{
+    return vnd_ctx_cur;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_bind
+**
+** Description     Bind the calling thread to a controller, or unbind it with
+**                 VND_CTX_UNBOUND
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_ctx_bind(uint8_t id)
+{
+#if (VND_MAX_CONTROLLERS == 1)
+    if (id == VND_CTX_UNBOUND) {
+        return;
+    }
+#endif
+    if ((id >= VND_MAX_CONTROLLERS) && (id != VND_CTX_UNBOUND)) {
+        HILOGE("vnd_ctx_bind: no controller %u", id);
+        return;
+    }
+    vnd_ctx_cur = id;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_bind_thread
+**
+** Description     Bind a thread started with VND_CTX_THREAD_ARG() to the
+**                 controller of its creator
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_ctx_bind_thread(void *arg)
+{
+    vnd_ctx_bind((uint8_t)(uintptr_t)arg);
+}
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_open
+**
+** Description     Mark the calling thread's controller open
+**
+** Returns         TRUE if no other controller is open
+**
+*******************************************************************************/
+uint8_t vnd_ctx_open(void)
+{
+    uint8_t first;
+
+    pthread_mutex_lock(&vnd_ctx_lock);
+    first = ((vnd_ctx_opened & ~(1u << vnd_ctx_id())) == 0);
+    vnd_ctx_opened |= (1u << vnd_ctx_id());
+    pthread_mutex_unlock(&vnd_ctx_lock);
+
+    return first;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_close
+**
+** Description     Mark the calling thread's controller closed
+**
+** Returns         TRUE if no other controller is still open
+**
+*******************************************************************************/
+uint8_t vnd_ctx_close(void)
+{
+    uint8_t last;
+
+    pthread_mutex_lock(&vnd_ctx_lock);
+    vnd_ctx_opened &= ~(1u << vnd_ctx_id());
+    last = (vnd_ctx_opened == 0);
+    pthread_mutex_unlock(&vnd_ctx_lock);
+
+    return last;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_ctx_name
+**
+** Description     Name of a value kept per controller: p_name itself for the
+**                 first controller, p_name.<n> for controller n
+**
+** Returns         p_buf
+**
+*******************************************************************************/
+const char *vnd_ctx_name(const char *p_name, char *p_buf, size_t len)
+{
+    int ret;
+
+    uint8_t id = vnd_ctx_id();
+
+    if (id == 0) {
+        ret = snprintf_s(p_buf, len, len - 1, "%s", p_name);
+    } else {
+        ret = snprintf_s(p_buf, len, len - 1, "%s.%u", p_name, id);
+    }
+    if (ret < 0) {
+        p_buf[0] = 0;
+    }
+
+    return p_buf;
+}
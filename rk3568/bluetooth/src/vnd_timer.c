@@ -0,0 +1,345 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      vnd_timer.c
+ *
+ *  Description:   Contains the vendor library timer service: one thread
+ *                 waiting on an epoll set of timerfds runs every deferred
+ *                 action, so arming a timer costs a single timerfd_settime
+ *                 and an expiry never spawns a thread
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_vnd_timer"
+
+#include <utils/Log.h>
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include "bt_vendor_brcm.h"
+#include "vnd_timer.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+#define VND_TIMER_MAX_EVENTS 4
+
+/* timer slots shared by all the controllers */
+#define VND_TIMER_SLOTS (VND_TIMER_MAX * VND_MAX_CONTROLLERS)
+
+/******************************************************************************
+**  Local type definitions
+******************************************************************************/
+
+struct vnd_timer {
+    int fd;                    /* timerfd, -1 if the slot is free */
+    vnd_timer_cback_t p_cback;
+    void *p_data;
+    uint8_t ctx;               /* controller the callback runs for */
+};
+
+/* Timer service control block */
+typedef struct {
+    int epoll_fd;
+    int stop_fd;               /* eventfd waking the thread up for exit */
+    pthread_t thread;
+    uint8_t running;
+    vnd_timer_t timers[VND_TIMER_SLOTS];
+} vnd_timer_cb_t;
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+static vnd_timer_cb_t vnd_timer_cb = {
+    .epoll_fd = -1,
+    .stop_fd = -1,
+};
+static pthread_mutex_t vnd_timer_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*****************************************************************************
+**   Helper Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        vnd_timer_thread
+**
+** Description     Timer service thread. Slots are static, so an expiry of a
+**                 timer freed (or freed and re-allocated) meanwhile only
+**                 finds nothing to read.
+**
+** Returns         NULL
+**
+*******************************************************************************/
+static void *vnd_timer_thread(void *arg)
+{
+    struct epoll_event events[VND_TIMER_MAX_EVENTS];
+    vnd_timer_t *p_timer;
+    vnd_timer_cback_t p_cback;
+    void *p_data;
+    uint64_t expirations;
+    int fd;
+    int n, i;
+
+    for (;;) {
+        n = epoll_wait(vnd_timer_cb.epoll_fd, events, VND_TIMER_MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            HILOGE("vnd_timer_thread: epoll_wait failed: %s", strerror(errno));
+            break;
+        }
+
+        for (i = 0; i < n; i++) {
+            p_timer = (vnd_timer_t *)events[i].data.ptr;
+            if (p_timer == NULL) {
+                return NULL;
+            }
+
+            pthread_mutex_lock(&vnd_timer_lock);
+            fd = p_timer->fd;
+            p_cback = p_timer->p_cback;
+            p_data = p_timer->p_data;
+            vnd_ctx_bind(p_timer->ctx);
+            /* a timer re-armed or stopped since has no expiration to read */
+            if ((fd < 0) || (read(fd, &expirations, sizeof(expirations)) != sizeof(expirations))) {
+                p_cback = NULL;
+            }
+            pthread_mutex_unlock(&vnd_timer_lock);
+
+            if (p_cback != NULL) {
+                p_cback(p_data);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_timer_service_start
+**
+** Description     Start the service thread. Must be called with
+**                 vnd_timer_lock held.
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+static int vnd_timer_service_start(void)
+{
+    struct epoll_event ev;
+
+    if (vnd_timer_cb.running) {
+        return 0;
+    }
+
+    vnd_timer_cb.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    vnd_timer_cb.stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if ((vnd_timer_cb.epoll_fd < 0) || (vnd_timer_cb.stop_fd < 0)) {
+        HILOGE("vnd_timer: cannot create the service fds: %s", strerror(errno));
+        goto err;
+    }
+
+    (void)memset_s(&ev, sizeof(ev), 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (epoll_ctl(vnd_timer_cb.epoll_fd, EPOLL_CTL_ADD, vnd_timer_cb.stop_fd, &ev) != 0) {
+        goto err;
+    }
+
+    if (pthread_create(&vnd_timer_cb.thread, NULL, vnd_timer_thread, NULL) != 0) {
+        HILOGE("vnd_timer: cannot create the service thread");
+        goto err;
+    }
+
+    vnd_timer_cb.running = TRUE;
+    return 0;
+
+err:
+    if (vnd_timer_cb.epoll_fd >= 0) {
+        close(vnd_timer_cb.epoll_fd);
+    }
+    if (vnd_timer_cb.stop_fd >= 0) {
+        close(vnd_timer_cb.stop_fd);
+    }
+    vnd_timer_cb.epoll_fd = -1;
+    vnd_timer_cb.stop_fd = -1;
+    return -1;
+}
+
+/*****************************************************************************
+**   Timer Service Interface Functions
+*****************************************************************************/
+
+vnd_timer_t *vnd_timer_alloc(vnd_timer_cback_t p_cback, void *p_data)
+{
+    struct epoll_event ev;
+    vnd_timer_t *p_timer = NULL;
+    int i;
+
+    pthread_mutex_lock(&vnd_timer_lock);
+    if (!vnd_timer_cb.running) {
+        /* slots are only valid once the service ran */
+        for (i = 0; i < VND_TIMER_SLOTS; i++) {
+            vnd_timer_cb.timers[i].fd = -1;
+        }
+        if (vnd_timer_service_start() != 0) {
+            pthread_mutex_unlock(&vnd_timer_lock);
+            return NULL;
+        }
+    }
+
+    for (i = 0; i < VND_TIMER_SLOTS; i++) {
+        if (vnd_timer_cb.timers[i].fd < 0) {
+            p_timer = &vnd_timer_cb.timers[i];
+            break;
+        }
+    }
+
+    if (p_timer == NULL) {
+        HILOGE("vnd_timer_alloc: no free timer");
+    } else if ((p_timer->fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) < 0) {
+        HILOGE("vnd_timer_alloc: timerfd_create failed: %s", strerror(errno));
+        p_timer = NULL;
+    } else {
+        p_timer->p_cback = p_cback;
+        p_timer->p_data = p_data;
+        p_timer->ctx = vnd_ctx_binding();
+
+        (void)memset_s(&ev, sizeof(ev), 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.ptr = p_timer;
+        if (epoll_ctl(vnd_timer_cb.epoll_fd, EPOLL_CTL_ADD, p_timer->fd, &ev) != 0) {
+            HILOGE("vnd_timer_alloc: epoll_ctl failed: %s", strerror(errno));
+            close(p_timer->fd);
+            p_timer->fd = -1;
+            p_timer = NULL;
+        }
+    }
+    pthread_mutex_unlock(&vnd_timer_lock);
+
+    return p_timer;
+}
+
+void vnd_timer_free(vnd_timer_t *p_timer)
+{
+    if (p_timer == NULL) {
+        return;
+    }
+
+    pthread_mutex_lock(&vnd_timer_lock);
+    if (p_timer->fd >= 0) {
+        (void)epoll_ctl(vnd_timer_cb.epoll_fd, EPOLL_CTL_DEL, p_timer->fd, NULL);
+        close(p_timer->fd);
+        p_timer->fd = -1;
+    }
+    p_timer->p_cback = NULL;
+    pthread_mutex_unlock(&vnd_timer_lock);
+}
+
+int vnd_timer_start(vnd_timer_t *p_timer, uint32_t msec, uint8_t periodic)
+{
+    struct itimerspec itval;
+
+    if ((p_timer == NULL) || (p_timer->fd < 0)) {
+        return -1;
+    }
+
+    /* a zero expiry would disarm the timer */
+    if (msec == 0) {
+        msec = 1;
+    }
+
+    itval.it_value.tv_sec = msec / BT_VENDOR_TIME_RAIDX;
+    itval.it_value.tv_nsec = (long)(msec % BT_VENDOR_TIME_RAIDX) * (BT_VENDOR_TIME_RAIDX * BT_VENDOR_TIME_RAIDX);
+    if (periodic) {
+        itval.it_interval = itval.it_value;
+    } else {
+        itval.it_interval.tv_sec = 0;
+        itval.it_interval.tv_nsec = 0;
+    }
+
+    if (timerfd_settime(p_timer->fd, 0, &itval, NULL) != 0) {
+        HILOGE("vnd_timer_start: timerfd_settime failed: %s", strerror(errno));
+        return -1;
+    }
+
+    return 0;
+}
+
+void vnd_timer_stop(vnd_timer_t *p_timer)
+{
+    struct itimerspec itval;
+
+    if ((p_timer == NULL) || (p_timer->fd < 0)) {
+        return;
+    }
+
+    (void)memset_s(&itval, sizeof(itval), 0, sizeof(itval));
+    (void)timerfd_settime(p_timer->fd, 0, &itval, NULL);
+}
+
+void vnd_timer_cleanup(void)
+{
+    uint64_t one = 1;
+    int i;
+
+    pthread_mutex_lock(&vnd_timer_lock);
+    if (!vnd_timer_cb.running) {
+        pthread_mutex_unlock(&vnd_timer_lock);
+        return;
+    }
+    vnd_timer_cb.running = FALSE;
+    pthread_mutex_unlock(&vnd_timer_lock);
+
+    if (write(vnd_timer_cb.stop_fd, &one, sizeof(one)) != sizeof(one)) {
+        HILOGW("vnd_timer_cleanup: cannot wake the service thread up");
+    }
+
+    if (pthread_equal(pthread_self(), vnd_timer_cb.thread)) {
+        /* called from a timer callback, the thread exits on its return */
+        pthread_detach(vnd_timer_cb.thread);
+    } else {
+        pthread_join(vnd_timer_cb.thread, NULL);
+    }
+
+    pthread_mutex_lock(&vnd_timer_lock);
+    for (i = 0; i < VND_TIMER_SLOTS; i++) {
+        if (vnd_timer_cb.timers[i].fd >= 0) {
+            close(vnd_timer_cb.timers[i].fd);
+            vnd_timer_cb.timers[i].fd = -1;
+        }
+        vnd_timer_cb.timers[i].p_cback = NULL;
+    }
+    close(vnd_timer_cb.epoll_fd);
+    close(vnd_timer_cb.stop_fd);
+    vnd_timer_cb.epoll_fd = -1;
+    vnd_timer_cb.stop_fd = -1;
+    pthread_mutex_unlock(&vnd_timer_lock);
+}
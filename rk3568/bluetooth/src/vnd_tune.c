@@ -0,0 +1,671 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      vnd_tune.c
+ *
+ *  Description:   Contains the run-time tunables. Conf file entries are
+ *                 found through an FNV-1a hash. Typed values are checked
+ *                 and staged when the file is read, and the owning module
+ *                 makes them effective at a point where it is safe: the
+ *                 next controller power cycle or LPM toggle. An inotify
+ *                 watch re-reads the conf file when it is rewritten, so a
+ *                 value is tuned without rebuilding the library.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_vnd_tune"
+
+#include <utils/Log.h>
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include "bt_vendor_brcm.h"
+#include "vnd_tune.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+#define VND_TUNE_HASH_MASK (VND_TUNE_HASH_SIZE - 1)
+#define VND_TUNE_FNV_OFFSET 2166136261u
+#define VND_TUNE_FNV_PRIME 16777619u
+
+/* longest formatted value: 8 elements of "255," */
+#define VND_TUNE_VALUE_LEN 40
+
+#define VND_TUNE_PATH_LEN 256
+
+/* longest name with its controller suffix */
+#define VND_TUNE_NAME_LEN 48
+
+/******************************************************************************
+**  Externs
+******************************************************************************/
+
+void vnd_reload_conf(const char *p_path);
+
+/******************************************************************************
+**  Local type definitions
+******************************************************************************/
+
+/* One indexed conf entry */
+typedef struct {
+    const char *p_name;          /* NULL: free slot */
+    const vnd_tune_t *p_tune;    /* typed tunable, NULL for an action */
+    vnd_tune_action_t *p_action;
+    int param;
+    uint8_t staged[VND_MAX_CONTROLLERS][VND_TUNE_MAX_BYTES]; /* one per controller if kept per controller */
+    uint8_t dirty[VND_MAX_CONTROLLERS]; /* staged value differs from the last one applied */
+} vnd_tune_slot_t;
+
+/* Conf file watch */
+typedef struct {
+    int inotify_fd;
+    int stop_fd;
+    pthread_t thread;
+    uint8_t running;
+    char path[VND_TUNE_PATH_LEN];
+    const char *p_base; /* file name within path */
+} vnd_tune_watch_t;
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+static vnd_tune_slot_t vnd_tune_slots[VND_TUNE_HASH_SIZE];
+static uint8_t vnd_tune_order[VND_TUNE_HASH_SIZE]; /* slots of the typed tunables in registration order */
+static uint32_t vnd_tune_count;
+static uint8_t vnd_tune_dumped; /* effective values written once */
+static pthread_mutex_t vnd_tune_lock = PTHREAD_MUTEX_INITIALIZER;
+static vnd_tune_watch_t vnd_tune_watch = {
+    .inotify_fd = -1,
+    .stop_fd = -1,
+};
+
+/*****************************************************************************
+**   Helper Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        vnd_tune_find
+**
+** Description     Find the slot of a name, or the free slot it goes to.
+**                 Must be called with vnd_tune_lock held.
+**
+** Returns         Slot, NULL if the table is full
+**
+*******************************************************************************/
+static vnd_tune_slot_t *vnd_tune_find(const char *p_name)
+{
+    uint32_t hash = VND_TUNE_FNV_OFFSET;
+    const char *p;
+    uint32_t i;
+    vnd_tune_slot_t *p_slot;
+
+    for (p = p_name; *p != '\0'; p++) {
+        hash = (hash ^ (uint8_t)*p) * VND_TUNE_FNV_PRIME;
+    }
+
+    for (i = 0; i < VND_TUNE_HASH_SIZE; i++) {
+        p_slot = &vnd_tune_slots[(hash + i) & VND_TUNE_HASH_MASK];
+        if ((p_slot->p_name == NULL) || (strcmp(p_slot->p_name, p_name) == 0)) {
+            return p_slot;
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_size
+**
+** Description     Size of a typed value
+**
+** Returns         Bytes
+**
+*******************************************************************************/
+static uint32_t vnd_tune_size(const vnd_tune_t *p_tune)
+{
+    switch (p_tune->type) {
+        case VND_TUNE_U16:
+            return sizeof(uint16_t);
+        case VND_TUNE_U32:
+            return sizeof(uint32_t);
+        case VND_TUNE_U8_ARRAY:
+            return p_tune->count;
+        default:
+            return sizeof(uint8_t);
+    }
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_ctxs
+**
+** Description     Number of values of a tunable
+**
+** Returns         VND_MAX_CONTROLLERS for a value kept per controller, else 1
+**
+*******************************************************************************/
+static uint8_t vnd_tune_ctxs(const vnd_tune_t *p_tune)
+{
+    return (p_tune->stride != 0) ? VND_MAX_CONTROLLERS : 1;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_value
+**
+** Description     Effective value of a tunable for controller id
+**
+** Returns         Pointer to the value
+**
+*******************************************************************************/
+static uint8_t *vnd_tune_value(const vnd_tune_t *p_tune, uint8_t id)
+{
+    return (uint8_t *)p_tune->p_value + (size_t)p_tune->stride * id;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_name
+**
+** Description     Conf file name of the value of controller id
+**
+** Returns         p_buf
+**
+*******************************************************************************/
+static const char *vnd_tune_name(const vnd_tune_slot_t *p_slot, uint8_t id, char *p_buf, size_t len)
+{
+    int ret;
+
+    if ((p_slot->p_tune->stride == 0) || (id == 0)) {
+        ret = snprintf_s(p_buf, len, len - 1, "%s", p_slot->p_name);
+    } else {
+        ret = snprintf_s(p_buf, len, len - 1, "%s.%u", p_slot->p_name, id);
+    }
+    if (ret < 0) {
+        p_buf[0] = 0;
+    }
+
+    return p_buf;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_parse
+**
+** Description     Convert and bound-check a conf value. Numbers are decimal
+**                 or 0x prefixed hexadecimal, array elements are comma
+**                 separated.
+**
+** Returns         0 : Success
+**                 Otherwise : Invalid value
+**
+*******************************************************************************/
+static int vnd_tune_parse(const vnd_tune_t *p_tune, const char *p_str, uint8_t *p_out)
+{
+    uint32_t num = (p_tune->type == VND_TUNE_U8_ARRAY) ? p_tune->count : 1;
+    unsigned long value;
+    char *p_end;
+    uint32_t i;
+    uint16_t u16;
+    uint32_t u32;
+
+    for (i = 0; i < num; i++) {
+        errno = 0;
+        value = strtoul(p_str, &p_end, 0);
+        if ((p_end == p_str) || (errno != 0) || (value < p_tune->min) || (value > p_tune->max)) {
+            return -1;
+        }
+        if (*p_end != ((i + 1 < num) ? ',' : '\0')) {
+            return -1;
+        }
+        p_str = p_end + 1;
+
+        if (p_tune->type == VND_TUNE_U16) {
+            u16 = (uint16_t)value;
+            (void)memcpy_s(p_out, VND_TUNE_MAX_BYTES, &u16, sizeof(u16));
+        } else if (p_tune->type == VND_TUNE_U32) {
+            u32 = (uint32_t)value;
+            (void)memcpy_s(p_out, VND_TUNE_MAX_BYTES, &u32, sizeof(u32));
+        } else {
+            p_out[i] = (uint8_t)value;
+        }
+    }
+
+    return 0;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_format
+**
+** Description     Print a typed value the way vnd_tune_parse reads it
+**
+** Returns         None
+**
+*******************************************************************************/
+static void vnd_tune_format(const vnd_tune_t *p_tune, const uint8_t *p_val, char *p_buf, size_t len)
+{
+    uint16_t u16;
+    uint32_t u32;
+    uint32_t i;
+    int pos = 0;
+    int ret;
+
+    p_buf[0] = '\0';
+    if (p_tune->type == VND_TUNE_U16) {
+        (void)memcpy_s(&u16, sizeof(u16), p_val, sizeof(u16));
+        (void)snprintf_s(p_buf, len, len - 1, "%u", u16);
+    } else if (p_tune->type == VND_TUNE_U32) {
+        (void)memcpy_s(&u32, sizeof(u32), p_val, sizeof(u32));
+        (void)snprintf_s(p_buf, len, len - 1, "%u", u32);
+    } else if (p_tune->type == VND_TUNE_U8_ARRAY) {
+        for (i = 0; i < p_tune->count; i++) {
+            ret = snprintf_s(p_buf + pos, len - pos, len - pos - 1, "%s%u", i ? "," : "", p_val[i]);
+            if (ret < 0) {
+                break;
+            }
+            pos += ret;
+        }
+    } else {
+        (void)snprintf_s(p_buf, len, len - 1, "%u", p_val[0]);
+    }
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_watch_thread
+**
+** Description     Re-read the conf file each time it is closed after a
+**                 write or renamed into place
+**
+** Returns         None
+**
+*******************************************************************************/
+static void *vnd_tune_watch_thread(void *arg)
+{
+    char buf[sizeof(struct inotify_event) + NAME_MAX + 1] __attribute__((aligned(__alignof__(struct inotify_event))));
+    struct pollfd pfd[2];
+    const struct inotify_event *p_evt;
+    ssize_t len;
+    ssize_t pos;
+    uint8_t changed;
+
+    pfd[0].fd = vnd_tune_watch.inotify_fd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = vnd_tune_watch.stop_fd;
+    pfd[1].events = POLLIN;
+
+    for (;;) {
+        if (poll(pfd, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            HILOGE("tune: poll failed (%s)", strerror(errno));
+            break;
+        }
+        if (pfd[1].revents != 0) {
+            break;
+        }
+
+        changed = FALSE;
+        while ((len = read(vnd_tune_watch.inotify_fd, buf, sizeof(buf))) > 0) {
+            for (pos = 0; pos < len; pos += (ssize_t)(sizeof(struct inotify_event) + p_evt->len)) {
+                p_evt = (const struct inotify_event *)&buf[pos];
+                if ((p_evt->len > 0) && (strcmp(p_evt->name, vnd_tune_watch.p_base) == 0)) {
+                    changed = TRUE;
+                }
+            }
+        }
+
+        if (changed) {
+            HILOGI("tune: %s changed, reloading", vnd_tune_watch.path);
+            vnd_reload_conf(vnd_tune_watch.path);
+            (void)vnd_tune_dump(NULL);
+        }
+    }
+
+    return NULL;
+}
+
+/*****************************************************************************
+**   Tunables Interface Functions
+*****************************************************************************/
+
+/*******************************************************************************
+**
+** Function        vnd_tune_register
+**
+** Description     Index typed tunables. Registering a table again is a no-op.
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_tune_register(const vnd_tune_t *p_tunes, uint32_t num)
+{
+    vnd_tune_slot_t *p_slot;
+    uint32_t i;
+    uint8_t id;
+
+    pthread_mutex_lock(&vnd_tune_lock);
+    for (i = 0; i < num; i++) {
+        p_slot = vnd_tune_find(p_tunes[i].p_name);
+        if ((p_slot == NULL) || (p_slot->p_name != NULL) || (vnd_tune_size(&p_tunes[i]) > VND_TUNE_MAX_BYTES)) {
+            if ((p_slot == NULL) || (p_slot->p_tune != &p_tunes[i])) {
+                HILOGE("tune: cannot register %s", p_tunes[i].p_name);
+            }
+            continue;
+        }
+
+        p_slot->p_name = p_tunes[i].p_name;
+        p_slot->p_tune = &p_tunes[i];
+        /* nothing staged: the compiled default */
+        for (id = 0; id < vnd_tune_ctxs(&p_tunes[i]); id++) {
+            (void)memcpy_s(p_slot->staged[id], VND_TUNE_MAX_BYTES, vnd_tune_value(&p_tunes[i], id),
+                vnd_tune_size(&p_tunes[i]));
+        }
+        vnd_tune_order[vnd_tune_count++] = (uint8_t)(p_slot - vnd_tune_slots);
+    }
+    pthread_mutex_unlock(&vnd_tune_lock);
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_register_action
+**
+** Description     Index a conf entry handled by an action function
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_tune_register_action(const char *p_name, vnd_tune_action_t *p_action, int param)
+{
+    vnd_tune_slot_t *p_slot;
+
+    pthread_mutex_lock(&vnd_tune_lock);
+    p_slot = vnd_tune_find(p_name);
+    if ((p_slot != NULL) && (p_slot->p_name == NULL)) {
+        p_slot->p_name = p_name;
+        p_slot->p_action = p_action;
+        p_slot->param = param;
+    } else if ((p_slot == NULL) || (p_slot->p_action != p_action) || (p_slot->param != param)) {
+        HILOGE("tune: cannot register %s", p_name);
+    }
+    pthread_mutex_unlock(&vnd_tune_lock);
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_set
+**
+** Description     Handle a conf file entry: run its action, or check and
+**                 stage a typed value for the calling thread's controller.
+**                 Actions only run when reload is FALSE, they are not safe
+**                 while the stack is up.
+**
+** Returns         0 : Success
+**                 Otherwise : Unknown entry or invalid value
+**
+*******************************************************************************/
+int vnd_tune_set(char *p_name, char *p_value, uint8_t reload)
+{
+    vnd_tune_slot_t *p_slot;
+    vnd_tune_action_t *p_action = NULL;
+    uint8_t value[VND_TUNE_MAX_BYTES];
+    uint8_t id;
+    int param = 0;
+    int ret = 0;
+
+    pthread_mutex_lock(&vnd_tune_lock);
+    p_slot = vnd_tune_find(p_name);
+    if ((p_slot == NULL) || (p_slot->p_name == NULL)) {
+        ret = -1;
+    } else if (p_slot->p_tune == NULL) {
+        p_action = reload ? NULL : p_slot->p_action;
+        param = p_slot->param;
+    } else if (vnd_tune_parse(p_slot->p_tune, p_value, value) != 0) {
+        HILOGW("tune: invalid %s %s", p_name, p_value);
+        ret = -1;
+    } else {
+        id = (p_slot->p_tune->stride != 0) ? vnd_ctx_id() : 0;
+        if (memcmp(value, p_slot->staged[id], vnd_tune_size(p_slot->p_tune)) != 0) {
+            (void)memcpy_s(p_slot->staged[id], VND_TUNE_MAX_BYTES, value, vnd_tune_size(p_slot->p_tune));
+            p_slot->dirty[id] = TRUE;
+        }
+    }
+    pthread_mutex_unlock(&vnd_tune_lock);
+
+    if (p_action != NULL) {
+        ret = p_action(p_name, p_value, param);
+    }
+    return ret;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_apply
+**
+** Description     Make the staged values of the tunables taking effect at
+**                 this point effective for the calling thread's controller.
+**                 The effective values are written to VENDOR_LIB_TUNE_FILE
+**                 when they change.
+**
+** Returns         Number of values changed
+**
+*******************************************************************************/
+uint32_t vnd_tune_apply(uint8_t when)
+{
+    char name[VND_TUNE_NAME_LEN];
+    char old_str[VND_TUNE_VALUE_LEN];
+    char new_str[VND_TUNE_VALUE_LEN];
+    vnd_tune_slot_t *p_slot;
+    uint8_t *p_value;
+    uint32_t changed = 0;
+    uint32_t size;
+    uint8_t dump;
+    uint8_t id;
+    uint32_t i;
+
+    pthread_mutex_lock(&vnd_tune_lock);
+    for (i = 0; i < vnd_tune_count; i++) {
+        p_slot = &vnd_tune_slots[vnd_tune_order[i]];
+        id = (p_slot->p_tune->stride != 0) ? vnd_ctx_id() : 0;
+        if (!p_slot->dirty[id] || ((p_slot->p_tune->when & when) == 0)) {
+            continue;
+        }
+
+        p_slot->dirty[id] = FALSE;
+        size = vnd_tune_size(p_slot->p_tune);
+        p_value = vnd_tune_value(p_slot->p_tune, id);
+        if (memcmp(p_value, p_slot->staged[id], size) == 0) {
+            continue;
+        }
+
+        vnd_tune_format(p_slot->p_tune, p_value, old_str, sizeof(old_str));
+        vnd_tune_format(p_slot->p_tune, p_slot->staged[id], new_str, sizeof(new_str));
+        HILOGI("tune: %s %s -> %s", vnd_tune_name(p_slot, id, name, sizeof(name)), old_str, new_str);
+        (void)memcpy_s(p_value, size, p_slot->staged[id], size);
+        changed++;
+    }
+    dump = (changed > 0) || (!vnd_tune_dumped && (when & VND_TUNE_AT_POWER));
+    vnd_tune_dumped = vnd_tune_dumped || dump;
+    pthread_mutex_unlock(&vnd_tune_lock);
+
+    if (dump) {
+        (void)vnd_tune_dump(VENDOR_LIB_TUNE_FILE);
+    }
+    return changed;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_dump
+**
+** Description     Write the effective values in conf file syntax to p_path,
+**                 or to the log when p_path is NULL. Values staged but not
+**                 applied yet are shown as pending.
+**
+** Returns         0 : Success
+**                 Otherwise : Fail
+**
+*******************************************************************************/
+int vnd_tune_dump(const char *p_path)
+{
+    char name[VND_TUNE_NAME_LEN];
+    char value[VND_TUNE_VALUE_LEN];
+    char staged[VND_TUNE_VALUE_LEN];
+    const vnd_tune_slot_t *p_slot;
+    FILE *p_file = NULL;
+    char tmp_path[VND_TUNE_PATH_LEN + 4];
+    uint32_t i;
+    uint8_t id;
+    int ret = 0;
+
+    if (p_path != NULL) {
+        if ((snprintf_s(tmp_path, sizeof(tmp_path), sizeof(tmp_path) - 1, "%s.tmp", p_path) < 0) ||
+            ((p_file = fopen(tmp_path, "w")) == NULL)) {
+            HILOGW("tune: cannot write %s", p_path);
+            return -1;
+        }
+        fprintf(p_file, "# Effective vendor library tunables\n");
+    }
+
+    pthread_mutex_lock(&vnd_tune_lock);
+    for (i = 0; i < vnd_tune_count; i++) {
+        p_slot = &vnd_tune_slots[vnd_tune_order[i]];
+        for (id = 0; id < vnd_tune_ctxs(p_slot->p_tune); id++) {
+            (void)vnd_tune_name(p_slot, id, name, sizeof(name));
+            vnd_tune_format(p_slot->p_tune, vnd_tune_value(p_slot->p_tune, id), value, sizeof(value));
+            vnd_tune_format(p_slot->p_tune, p_slot->staged[id], staged, sizeof(staged));
+            if (p_file != NULL) {
+                fprintf(p_file, "%s = %s\n", name, value);
+                if (p_slot->dirty[id]) {
+                    fprintf(p_file, "# %s pending %s\n", name, staged);
+                }
+            } else {
+                HILOGI("tune: %s = %s%s%s", name, value, p_slot->dirty[id] ? ", pending " : "",
+                    p_slot->dirty[id] ? staged : "");
+            }
+        }
+    }
+    pthread_mutex_unlock(&vnd_tune_lock);
+
+    if (p_file != NULL) {
+        if ((fclose(p_file) != 0) || (rename(tmp_path, p_path) != 0)) {
+            HILOGW("tune: cannot update %s", p_path);
+            (void)unlink(tmp_path);
+            ret = -1;
+        }
+    }
+    return ret;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_watch_start
+**
+** Description     Reload p_path whenever it is rewritten. The directory is
+**                 watched so that editors replacing the file are seen too.
+**                 The new values are staged, they apply at the next power
+**                 cycle or LPM toggle.
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_tune_watch_start(const char *p_path)
+{
+    char dir[VND_TUNE_PATH_LEN];
+    char *p_sep;
+
+    if (vnd_tune_watch.running) {
+        return;
+    }
+
+    if ((strcpy_s(vnd_tune_watch.path, sizeof(vnd_tune_watch.path), p_path) != 0) ||
+        (strcpy_s(dir, sizeof(dir), p_path) != 0)) {
+        return;
+    }
+    p_sep = strrchr(dir, '/');
+    if (p_sep == NULL) {
+        (void)strcpy_s(dir, sizeof(dir), ".");
+        vnd_tune_watch.p_base = vnd_tune_watch.path;
+    } else {
+        *p_sep = '\0';
+        vnd_tune_watch.p_base = vnd_tune_watch.path + (p_sep - dir) + 1;
+    }
+
+    vnd_tune_watch.inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    vnd_tune_watch.stop_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if ((vnd_tune_watch.inotify_fd < 0) || (vnd_tune_watch.stop_fd < 0) ||
+        (inotify_add_watch(vnd_tune_watch.inotify_fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0)) {
+        HILOGW("tune: no watch on %s (%s), conf changes need a restart", dir, strerror(errno));
+        vnd_tune_watch_stop();
+        return;
+    }
+
+    if (pthread_create(&vnd_tune_watch.thread, NULL, vnd_tune_watch_thread, NULL) != 0) {
+        HILOGW("tune: no watch thread");
+        vnd_tune_watch_stop();
+        return;
+    }
+    vnd_tune_watch.running = TRUE;
+}
+
+/*******************************************************************************
+**
+** Function        vnd_tune_watch_stop
+**
+** Description     Stop watching the conf file
+**
+** Returns         None
+**
+*******************************************************************************/
+void vnd_tune_watch_stop(void)
+{
+    uint64_t one = 1;
+
+    if (vnd_tune_watch.running) {
+        if (write(vnd_tune_watch.stop_fd, &one, sizeof(one)) != sizeof(one)) {
+            HILOGW("tune: cannot stop the watch (%s)", strerror(errno));
+        }
+        (void)pthread_join(vnd_tune_watch.thread, NULL);
+        vnd_tune_watch.running = FALSE;
+    }
+
+    if (vnd_tune_watch.inotify_fd >= 0) {
+        (void)close(vnd_tune_watch.inotify_fd);
+        vnd_tune_watch.inotify_fd = -1;
+    }
+    if (vnd_tune_watch.stop_fd >= 0) {
+        (void)close(vnd_tune_watch.stop_fd);
+        vnd_tune_watch.stop_fd = -1;
+    }
+}
@@ -0,0 +1,883 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      bt_vendor_bench.c
+ *
+ *  Description:   Benchmark driver for libbt_vendor. Plays the role of the
+ *                 Bluetooth stack: loads the vendor library, points it at
+ *                 the hci_emulator pty and measures controller bring-up time
+ *                 and raw H4 throughput. A second controller on another
+ *                 pty can be brought up side by side with the first.
+ *
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <errno.h>
+#include <getopt.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#include "bt_vendor_lib.h"
+#include "bt_vendor_brcm_a2dp.h"
+#include "hci_emulator.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+#define BENCH_DEFAULT_LIB "libbt_vendor.z.so"
+#define BENCH_RX_BUF_SIZE 8192
+#define BENCH_INIT_TIMEOUT_MS 10000
+#define BENCH_ACL_PAYLOAD 1021
+#define BENCH_ACL_HANDLE 0x0001
+#define BENCH_CODEC_CVSD 0x0001
+#define BENCH_CODEC_MSBC 0x0002
+#define BENCH_CODEC_SWITCH_GAP_US 20000
+#define BENCH_MAX_CTL 2 /* controllers brought up side by side */
+
+/* SBC 44.1 kHz joint stereo bitpool 53: 5 frames of 119 bytes per media
+ * packet, one packet every 5 * 128 samples
+ */
+#define BENCH_A2DP_PKT_US 14512
+#define BENCH_A2DP_SBC_LEN (1 + 5 * 119)
+#define BENCH_A2DP_RTP_LEN 12
+#define BENCH_A2DP_L2CAP_LEN 4
+#define BENCH_A2DP_LCID 0x0041
+#define BENCH_A2DP_RCID 0x0042
+#define BENCH_A2DP_MTU 895
+#define BENCH_A2DP_TIMEOUT_MS 5000
+
+/******************************************************************************
+**  Local type definitions
+******************************************************************************/
+
+typedef int (*conf_action_t)(char *p_conf_name, char *p_conf_value, int param);
+
+/* vnd_ctx_bind of vnd_ctx.h */
+typedef void (*bench_ctx_bind_t)(uint8_t id);
+
+/* mirrors userial_rx_pkt_t of userial_vendor.h */
+typedef struct {
+    uint8_t type;
+    uint16_t len;
+    uint8_t *p_data;
+    uint64_t rx_us;
+} bench_rx_pkt_t;
+
+typedef void (*bench_rx_cback_t)(void *p_data, bench_rx_pkt_t *p_pkt);
+
+/* mirrors bt_vendor_op_audio_state_t of bt_vendor_brcm.h */
+typedef struct {
+    uint16_t handle;
+    uint16_t peer_codec;
+    uint16_t state;
+} bench_audio_state_t;
+
+typedef int (*bench_set_audio_state_t)(bench_audio_state_t *p_state);
+
+/* A2DP offload entry points, resolved when -o is given */
+typedef struct {
+    int (*p_start)(const brcm_vnd_a2dp_offload_t *p_offload, brcm_vnd_a2dp_cback_t p_cback);
+    int (*p_stop)(uint16_t lcid);
+} bench_a2dp_if_t;
+
+/* receive engine entry points, resolved when -r is given */
+typedef struct {
+    int (*p_register)(uint8_t type, bench_rx_cback_t p_cback, void *p_data);
+    int (*p_start)(void);
+    void (*p_release)(bench_rx_pkt_t *p_pkt);
+} bench_rx_if_t;
+
+/* One controller, driven through its own vendor interface */
+typedef struct {
+    const bt_vendor_interface_t *p_if;
+    const char *p_pty;
+    int fd;
+    volatile int reader_stop;
+    pthread_t reader;
+    int init_done;
+    bt_op_result_t init_result;
+    uint64_t init_done_us;
+    uint32_t cmds;
+    uint32_t evts;
+} bench_ctl_t;
+
+typedef struct {
+    bench_ctl_t ctl[BENCH_MAX_CTL]; /* the ACL, SCO and A2DP tests run on the first one */
+    uint32_t num_ctl;
+    bench_rx_if_t rx;
+    int use_rx_engine;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint64_t acl_rx_bytes;
+    int a2dp_done;
+    uint8_t a2dp_status;
+} bench_cb_t;
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+static bench_cb_t bench;
+
+/*****************************************************************************
+**   Helper Functions
+*****************************************************************************/
+
+static uint64_t bench_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static int bench_write(int fd, const uint8_t *p, size_t len)
+{
+    ssize_t ret;
+
+    while (len > 0) {
+        ret = write(fd, p, len);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return -1;
+        }
+        p += ret;
+        len -= (size_t)ret;
+    }
+    return 0;
+}
+
+/*****************************************************************************
+**   Vendor Library Callbacks
+*****************************************************************************/
+
+static void bench_init_done(bench_ctl_t *p_ctl, bt_op_result_t result)
+{
+    pthread_mutex_lock(&bench.lock);
+    p_ctl->init_done = 1;
+    p_ctl->init_result = result;
+    p_ctl->init_done_us = bench_now_us();
+    pthread_cond_signal(&bench.cond);
+    pthread_mutex_unlock(&bench.lock);
+}
+
+static void *bench_alloc(int size)
+{
+    return malloc((size_t)size);
+}
+
+static void bench_dealloc(void *p_buf)
+{
+    free(p_buf);
+}
+
+static size_t bench_xmit(bench_ctl_t *p_ctl, uint16_t opcode, void *p_buf)
+{
+    HC_BT_HDR *p_hdr = (HC_BT_HDR *)p_buf;
+    uint8_t pkt[BENCH_RX_BUF_SIZE];
+
+    if (p_hdr->len + 1 > sizeof(pkt)) {
+        return 0;
+    }
+
+    pkt[0] = EMU_H4_CMD;
+    memcpy(&pkt[1], p_hdr->data + p_hdr->offset, p_hdr->len);
+    if (bench_write(p_ctl->fd, pkt, p_hdr->len + 1) != 0) {
+        return 0;
+    }
+
+    __atomic_add_fetch(&p_ctl->cmds, 1, __ATOMIC_RELAXED);
+    return p_hdr->len;
+}
+
+/* The callbacks carry no context: each controller gets its own table */
+#define BENCH_CALLBACKS(n)                                          \
+    static void bench_init_cb_##n(bt_op_result_t result)            \
+    {                                                               \
+        bench_init_done(&bench.ctl[n], result);                     \
+    }                                                               \
+    static size_t bench_xmit_cb_##n(uint16_t opcode, void *p_buf)   \
+    {                                                               \
+        return bench_xmit(&bench.ctl[n], opcode, p_buf);            \
+    }                                                               \
+    static const bt_vendor_callbacks_t bench_callbacks_##n = {      \
+        sizeof(bt_vendor_callbacks_t),                              \
+        bench_init_cb_##n,                                          \
+        bench_alloc,                                                \
+        bench_dealloc,                                              \
+        bench_xmit_cb_##n                                           \
+    };
+
+BENCH_CALLBACKS(0)
+BENCH_CALLBACKS(1)
+
+static const bt_vendor_callbacks_t *const bench_callbacks[BENCH_MAX_CTL] = {
+    &bench_callbacks_0,
+    &bench_callbacks_1
+};
+
+/* Vendor interface of each controller */
+static const char *const bench_if_names[BENCH_MAX_CTL] = {
+    "BLUETOOTH_VENDOR_LIB_INTERFACE",
+    "BLUETOOTH_VENDOR_LIB_INTERFACE_1"
+};
+
+/*******************************************************************************
+**
+** Function        bench_reader
+**
+** Description     Stack side H4 receiver of one controller. Events are
+**                 handed to the vendor library through BT_OP_EVENT_CALLBACK,
+**                 ACL is counted.
+**
+** Returns         NULL
+**
+*******************************************************************************/
+static void *bench_reader(void *arg)
+{
+    bench_ctl_t *p_ctl = (bench_ctl_t *)arg;
+    uint8_t buf[BENCH_RX_BUF_SIZE];
+    size_t len = 0;
+    struct pollfd pfd;
+    ssize_t sz;
+
+    pfd.fd = p_ctl->fd;
+    pfd.events = POLLIN;
+
+    while (!p_ctl->reader_stop) {
+        size_t pos = 0;
+
+        if (poll(&pfd, 1, 20) <= 0 || !(pfd.revents & POLLIN)) {
+            continue;
+        }
+
+        sz = read(p_ctl->fd, &buf[len], sizeof(buf) - len);
+        if (sz <= 0) {
+            continue;
+        }
+        len += (size_t)sz;
+
+        while (pos < len) {
+            size_t avail = len - pos;
+            size_t need;
+
+            if (buf[pos] == EMU_H4_EVT) {
+                if (avail < 3 || avail < (size_t)(3 + buf[pos + 2])) {
+                    break;
+                }
+                need = 3 + buf[pos + 2];
+
+                HC_BT_HDR *p_evt = (HC_BT_HDR *)malloc(sizeof(HC_BT_HDR) + need - 1);
+                p_evt->event = 0x1000; /* MSG_HC_TO_STACK_HCI_EVT */
+                p_evt->len = (uint16_t)(need - 1);
+                p_evt->offset = 0;
+                p_evt->layer_specific = 0;
+                memcpy(p_evt->data, &buf[pos + 1], need - 1);
+                p_ctl->evts++;
+                p_ctl->p_if->op(BT_OP_EVENT_CALLBACK, p_evt);
+                free(p_evt);
+            } else if (buf[pos] == EMU_H4_ACL) {
+                if (avail < 5) {
+                    break;
+                }
+                need = 5 + (size_t)(buf[pos + 3] | (buf[pos + 4] << 8));
+                if (avail < need) {
+                    break;
+                }
+                __atomic_add_fetch(&bench.acl_rx_bytes, need - 5, __ATOMIC_RELAXED);
+            } else {
+                need = 1;
+            }
+            pos += need;
+        }
+
+        memmove(buf, &buf[pos], len - pos);
+        len -= pos;
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+**
+** Function        bench_rx_evt
+**
+** Description     Receive engine event consumer, the slot is handed to the
+**                 vendor library behind an HC_BT_HDR
+**
+** Returns         None
+**
+*******************************************************************************/
+static void bench_rx_evt(void *p_data, bench_rx_pkt_t *p_pkt)
+{
+    HC_BT_HDR *p_evt = (HC_BT_HDR *)malloc(sizeof(HC_BT_HDR) + p_pkt->len);
+
+    if (p_evt != NULL) {
+        p_evt->event = 0x1000; /* MSG_HC_TO_STACK_HCI_EVT */
+        p_evt->len = p_pkt->len;
+        p_evt->offset = 0;
+        p_evt->layer_specific = 0;
+        memcpy(p_evt->data, p_pkt->p_data, p_pkt->len);
+        bench.ctl[0].evts++;
+        bench.ctl[0].p_if->op(BT_OP_EVENT_CALLBACK, p_evt);
+        free(p_evt);
+    }
+    bench.rx.p_release(p_pkt);
+}
+
+/*******************************************************************************
+**
+** Function        bench_rx_acl
+**
+** Description     Receive engine ACL consumer, counts the payload
+**
+** Returns         None
+**
+*******************************************************************************/
+static void bench_rx_acl(void *p_data, bench_rx_pkt_t *p_pkt)
+{
+    __atomic_add_fetch(&bench.acl_rx_bytes, p_pkt->len - 4, __ATOMIC_RELAXED); /* 4: ACL header */
+    bench.rx.p_release(p_pkt);
+}
+
+/*******************************************************************************
+**
+** Function        bench_wait_init
+**
+** Description     Wait for init_cb of every controller
+**
+** Returns         0 : init_cb received
+**                 Otherwise : Timed out
+**
+*******************************************************************************/
+static int bench_wait_init(void)
+{
+    struct timespec ts;
+    uint32_t done = 0;
+    uint32_t c;
+    int ret = 0;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += BENCH_INIT_TIMEOUT_MS / 1000;
+
+    pthread_mutex_lock(&bench.lock);
+    while (ret == 0) {
+        for (c = 0, done = 0; c < bench.num_ctl; c++) {
+            done += (bench.ctl[c].init_done != 0);
+        }
+        if (done == bench.num_ctl) {
+            break;
+        }
+        ret = pthread_cond_timedwait(&bench.cond, &bench.lock, &ts);
+    }
+    pthread_mutex_unlock(&bench.lock);
+
+    return (done == bench.num_ctl) ? 0 : -1;
+}
+
+/*******************************************************************************
+**
+** Function        bench_acl_throughput
+**
+** Description     Push ACL packets through the opened UART and count what the
+**                 emulator loops back (needs hci_emulator -a)
+**
+** Returns         None
+**
+*******************************************************************************/
+static void bench_acl_throughput(uint32_t total_kb)
+{
+    uint8_t pkt[5 + BENCH_ACL_PAYLOAD];
+    uint64_t target = (uint64_t)total_kb * 1024;
+    uint64_t sent = 0;
+    uint64_t start;
+    uint64_t elapsed;
+    int i;
+
+    memset(pkt, 0x5A, sizeof(pkt));
+    pkt[0] = EMU_H4_ACL;
+    pkt[1] = (uint8_t)BENCH_ACL_HANDLE;
+    pkt[2] = (uint8_t)(BENCH_ACL_HANDLE >> 8);
+    pkt[3] = (uint8_t)BENCH_ACL_PAYLOAD;
+    pkt[4] = (uint8_t)(BENCH_ACL_PAYLOAD >> 8);
+
+    bench.acl_rx_bytes = 0;
+    start = bench_now_us();
+    while (sent < target) {
+        if (bench_write(bench.ctl[0].fd, pkt, sizeof(pkt)) != 0) {
+            break;
+        }
+        sent += BENCH_ACL_PAYLOAD;
+    }
+
+    for (i = 0; i < 500 && bench.acl_rx_bytes < sent; i++) {
+        usleep(1000);
+    }
+    elapsed = bench_now_us() - start;
+
+    printf("acl: sent %llu bytes, looped back %llu bytes in %llu us (%.2f Mbit/s)\n",
+        (unsigned long long)sent, (unsigned long long)bench.acl_rx_bytes, (unsigned long long)elapsed,
+        elapsed ? (double)bench.acl_rx_bytes * 8 / (double)elapsed : 0.0);
+}
+
+/*******************************************************************************
+**
+** Function        bench_codec_switch
+**
+** Description     Alternate the SCO path between mSBC and CVSD, the library
+**                 logs the latency of each switch
+**
+** Returns         None
+**
+*******************************************************************************/
+static void bench_codec_switch(bench_set_audio_state_t set_audio_state, uint32_t switches)
+{
+    bench_audio_state_t state;
+    uint32_t i;
+
+    memset(&state, 0, sizeof(state));
+    for (i = 0; i < switches; i++) {
+        state.peer_codec = (i & 1) ? BENCH_CODEC_CVSD : BENCH_CODEC_MSBC;
+        if (set_audio_state(&state) != 0) {
+            fprintf(stderr, "codec switch %u failed\n", i);
+        }
+        usleep(BENCH_CODEC_SWITCH_GAP_US);
+    }
+    printf("sco: %u codec switches requested\n", switches);
+}
+
+/*******************************************************************************
+**
+** Function        bench_a2dp_cback
+**
+** Description     Result of an A2DP offload request
+**
+** Returns         None
+**
+*******************************************************************************/
+static void bench_a2dp_cback(uint8_t req, uint8_t status, uint16_t lcid)
+{
+    pthread_mutex_lock(&bench.lock);
+    bench.a2dp_status = status;
+    bench.a2dp_done = 1;
+    pthread_cond_signal(&bench.cond);
+    pthread_mutex_unlock(&bench.lock);
+}
+
+/*******************************************************************************
+**
+** Function        bench_a2dp_wait
+**
+** Description     Wait for the result of an A2DP offload request
+**
+** Returns         0 if the controller accepted the request
+**
+*******************************************************************************/
+static int bench_a2dp_wait(void)
+{
+    struct timespec ts;
+    int done;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += BENCH_A2DP_TIMEOUT_MS / 1000;
+
+    pthread_mutex_lock(&bench.lock);
+    while (!bench.a2dp_done) {
+        if (pthread_cond_timedwait(&bench.cond, &bench.lock, &ts) == ETIMEDOUT) {
+            break;
+        }
+    }
+    done = bench.a2dp_done && (bench.a2dp_status == BTC_OP_RESULT_SUCCESS);
+    bench.a2dp_done = 0;
+    pthread_mutex_unlock(&bench.lock);
+
+    return done ? 0 : -1;
+}
+
+/*******************************************************************************
+**
+** Function        bench_a2dp_run
+**
+** Description     Stream for a number of seconds and print the host CPU time
+**                 and context switches it cost. With p_pkt the host sends
+**                 every media packet over ACL, without it the controller
+**                 does and the host only sleeps.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void bench_a2dp_run(const char *p_label, uint32_t seconds, const uint8_t *p_pkt, size_t len)
+{
+    struct rusage before;
+    struct rusage after;
+    struct timespec next;
+    uint64_t cpu_us;
+    uint32_t pkts = 0;
+    uint32_t total = (uint32_t)((uint64_t)seconds * 1000000 / BENCH_A2DP_PKT_US);
+
+    getrusage(RUSAGE_SELF, &before);
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    if (p_pkt == NULL) {
+        sleep(seconds);
+    } else {
+        for (pkts = 0; pkts < total; pkts++) {
+            next.tv_nsec += BENCH_A2DP_PKT_US * 1000L;
+            if (next.tv_nsec >= 1000000000L) {
+                next.tv_nsec -= 1000000000L;
+                next.tv_sec++;
+            }
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+            if (bench_write(bench.ctl[0].fd, p_pkt, len) != 0) {
+                break;
+            }
+        }
+    }
+    getrusage(RUSAGE_SELF, &after);
+
+    cpu_us = (uint64_t)(after.ru_utime.tv_sec - before.ru_utime.tv_sec) * 1000000 +
+        (after.ru_utime.tv_usec - before.ru_utime.tv_usec) +
+        (uint64_t)(after.ru_stime.tv_sec - before.ru_stime.tv_sec) * 1000000 +
+        (after.ru_stime.tv_usec - before.ru_stime.tv_usec);
+    printf("a2dp %s: %u s, %u media packets, cpu %llu us (%.3f%%), %ld voluntary / %ld involuntary switches\n",
+        p_label, seconds, pkts, (unsigned long long)cpu_us, (double)cpu_us / ((double)seconds * 10000.0),
+        after.ru_nvcsw - before.ru_nvcsw, after.ru_nivcsw - before.ru_nivcsw);
+}
+
+/*******************************************************************************
+**
+** Function        bench_a2dp
+**
+** Description     Compare an SBC stream sent by the host over ACL with the
+**                 same stream offloaded to the controller. The host path
+**                 runs no encoder, its cost is a lower bound.
+**
+** Returns         None
+**
+*******************************************************************************/
+static void bench_a2dp(const bench_a2dp_if_t *p_a2dp, uint32_t seconds)
+{
+    uint8_t pkt[5 + BENCH_A2DP_L2CAP_LEN + BENCH_A2DP_RTP_LEN + BENCH_A2DP_SBC_LEN];
+    uint16_t acl_len = sizeof(pkt) - 5;
+    uint16_t l2cap_len = acl_len - BENCH_A2DP_L2CAP_LEN;
+    brcm_vnd_a2dp_offload_t offload;
+    uint64_t start;
+
+    memset(pkt, 0, sizeof(pkt));
+    pkt[0] = EMU_H4_ACL;
+    pkt[1] = (uint8_t)BENCH_ACL_HANDLE;
+    pkt[2] = (uint8_t)(BENCH_ACL_HANDLE >> 8);
+    pkt[3] = (uint8_t)acl_len;
+    pkt[4] = (uint8_t)(acl_len >> 8);
+    pkt[5] = (uint8_t)l2cap_len;
+    pkt[6] = (uint8_t)(l2cap_len >> 8);
+    pkt[7] = (uint8_t)BENCH_A2DP_RCID;
+    pkt[8] = (uint8_t)(BENCH_A2DP_RCID >> 8);
+    pkt[9] = 0x80; /* RTP version 2 */
+    pkt[10] = 0x60;
+    pkt[9 + BENCH_A2DP_RTP_LEN] = 5; /* SBC frames */
+    bench_a2dp_run("host", seconds, pkt, sizeof(pkt));
+
+    memset(&offload, 0, sizeof(offload));
+    offload.lm_handle = BENCH_ACL_HANDLE;
+    offload.local_cid = BENCH_A2DP_LCID;
+    offload.remote_cid = BENCH_A2DP_RCID;
+    offload.stream_mtu = BENCH_A2DP_MTU;
+    offload.acl_data_size = BENCH_ACL_PAYLOAD;
+    offload.xmit_quota = 4;
+    offload.is_flushable = TRUE;
+    offload.stream_source = 1;
+    offload.codec_type = AUDIO_CODEC_SBC_ENC;
+    offload.codec_info.sbc.sampling_freq = CODEC_INFO_SBC_SF_44K;
+    offload.codec_info.sbc.channel_mode = CODEC_INFO_SBC_CH_JS;
+    offload.codec_info.sbc.block_length = CODEC_INFO_SBC_BLOCK_16;
+    offload.codec_info.sbc.num_subbands = CODEC_INFO_SBC_SUBBAND_8;
+    offload.codec_info.sbc.alloc_method = CODEC_INFO_SBC_ALLOC_LOUDNESS;
+    offload.codec_info.sbc.bitpool_size = 53;
+    offload.sample_rate = AUDIO_ROUTE_SF_44_1K;
+
+    start = bench_now_us();
+    if (p_a2dp->p_start(&offload, bench_a2dp_cback) != 0 || bench_a2dp_wait() != 0) {
+        fprintf(stderr, "a2dp offload start failed\n");
+        return;
+    }
+    printf("a2dp offload: started in %llu us\n", (unsigned long long)(bench_now_us() - start));
+    bench_a2dp_run("offload", seconds, NULL, 0);
+
+    if (p_a2dp->p_stop(BENCH_A2DP_LCID) != 0 || bench_a2dp_wait() != 0) {
+        fprintf(stderr, "a2dp offload stop failed\n");
+    }
+}
+
+static void bench_usage(const char *p_prog)
+{
+    fprintf(stderr,
+        "usage: %s -p <pty> [options]\n"
+        "  -P <pty>  second controller, brought up in parallel with the first\n"
+        "  -L <lib>  vendor library (default %s)\n"
+        "  -f <dir>  firmware patch directory\n"
+        "  -w <n>    firmware patch download window (FwPatchDownloadWindow)\n"
+        "  -n <n>    bring-up iterations (default 1)\n"
+        "  -t <kb>   ACL throughput test size in KB (0 = off)\n"
+        "  -r        receive through the library H4 engine instead of the bench reader\n"
+        "  -s <n>    mSBC/CVSD codec switches after each bring-up (0 = off)\n"
+        "  -o <sec>  A2DP host vs offload comparison of this length (0 = off)\n",
+        p_prog, BENCH_DEFAULT_LIB);
+}
+
+/*****************************************************************************
+**   Main
+*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    const char *p_lib = BENCH_DEFAULT_LIB;
+    bench_ctl_t *p_ctl;
+    char *p_fw_dir = NULL;
+    char *p_dl_window = NULL;
+    unsigned char bdaddr[6] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66};
+    int fds[HCI_MAX_CHANNEL];
+    uint32_t iterations = 1;
+    uint32_t acl_kb = 0;
+    uint32_t switches = 0;
+    uint32_t a2dp_sec = 0;
+    uint64_t start;
+    uint64_t total = 0;
+    uint64_t best = UINT64_MAX;
+    uint64_t worst = 0;
+    conf_action_t set_port;
+    conf_action_t set_patch_path;
+    conf_action_t set_dl_window;
+    bench_ctx_bind_t ctx_bind;
+    bench_set_audio_state_t set_audio_state = NULL;
+    bench_a2dp_if_t a2dp;
+    void *p_dl;
+    uint32_t cmds = 0;
+    uint32_t evts = 0;
+    uint32_t it;
+    uint32_t c;
+    int opt;
+    int ok;
+    int failed = 0;
+
+    while ((opt = getopt(argc, argv, "L:p:P:f:w:n:t:s:o:rh")) != -1) {
+        switch (opt) {
+            case 'L': p_lib = optarg; break;
+            case 'p': bench.ctl[0].p_pty = optarg; break;
+            case 'P': bench.ctl[1].p_pty = optarg; break;
+            case 'f': p_fw_dir = optarg; break;
+            case 'w': p_dl_window = optarg; break;
+            case 'n': iterations = (uint32_t)atoi(optarg); break;
+            case 't': acl_kb = (uint32_t)atoi(optarg); break;
+            case 's': switches = (uint32_t)atoi(optarg); break;
+            case 'o': a2dp_sec = (uint32_t)atoi(optarg); break;
+            case 'r': bench.use_rx_engine = 1; break;
+            default:
+                bench_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (bench.ctl[0].p_pty == NULL) {
+        bench_usage(argv[0]);
+        return 1;
+    }
+    bench.num_ctl = (bench.ctl[1].p_pty != NULL) ? 2 : 1;
+
+    if ((p_dl = dlopen(p_lib, RTLD_NOW)) == NULL) {
+        fprintf(stderr, "dlopen(%s): %s\n", p_lib, dlerror());
+        return 1;
+    }
+
+    for (c = 0; c < bench.num_ctl; c++) {
+        bench.ctl[c].p_if = (const bt_vendor_interface_t *)dlsym(p_dl, bench_if_names[c]);
+        if (bench.ctl[c].p_if == NULL) {
+            fprintf(stderr, "%s has no %s\n", p_lib, bench_if_names[c]);
+            return 1;
+        }
+    }
+    set_port = (conf_action_t)dlsym(p_dl, "userial_set_port");
+    set_patch_path = (conf_action_t)dlsym(p_dl, "hw_set_patch_file_path");
+    set_dl_window = (conf_action_t)dlsym(p_dl, "hw_set_patch_download_window");
+    *(void **)&ctx_bind = dlsym(p_dl, "vnd_ctx_bind");
+    if (set_port == NULL || (bench.num_ctl > 1 && ctx_bind == NULL)) {
+        fprintf(stderr, "%s is not a bt vendor library\n", p_lib);
+        return 1;
+    }
+
+    if (bench.use_rx_engine) {
+        *(void **)&bench.rx.p_register = dlsym(p_dl, "userial_vendor_rx_register");
+        *(void **)&bench.rx.p_start = dlsym(p_dl, "userial_vendor_rx_start");
+        *(void **)&bench.rx.p_release = dlsym(p_dl, "userial_vendor_rx_release");
+        if (bench.rx.p_register == NULL || bench.rx.p_start == NULL || bench.rx.p_release == NULL) {
+            fprintf(stderr, "%s has no receive engine\n", p_lib);
+            return 1;
+        }
+    }
+
+    if (switches > 0) {
+        *(void **)&set_audio_state = dlsym(p_dl, "hw_set_audio_state");
+        if (set_audio_state == NULL) {
+            fprintf(stderr, "%s has no SCO configuration\n", p_lib);
+            return 1;
+        }
+    }
+
+    if (a2dp_sec > 0) {
+        *(void **)&a2dp.p_start = dlsym(p_dl, "brcm_vnd_a2dp_start");
+        *(void **)&a2dp.p_stop = dlsym(p_dl, "brcm_vnd_a2dp_stop");
+        if (a2dp.p_start == NULL || a2dp.p_stop == NULL) {
+            fprintf(stderr, "%s has no A2DP offload\n", p_lib);
+            return 1;
+        }
+    }
+
+    pthread_mutex_init(&bench.lock, NULL);
+    pthread_cond_init(&bench.cond, NULL);
+
+    for (it = 0; it < iterations; it++) {
+        uint64_t elapsed;
+
+        for (c = 0; c < bench.num_ctl; c++) {
+            p_ctl = &bench.ctl[c];
+            bdaddr[5] = (unsigned char)(0x66 + c);
+            if (p_ctl->p_if->init(bench_callbacks[c], bdaddr) != 0) {
+                fprintf(stderr, "vendor init of controller %u failed\n", c);
+                return 1;
+            }
+
+            /* override the conf file values through the regular conf actions,
+             * they apply to the controller the calling thread is bound to
+             */
+            if (ctx_bind != NULL) {
+                ctx_bind((uint8_t)c);
+            }
+            set_port("UartPort", (char *)p_ctl->p_pty, 0);
+            if (p_fw_dir != NULL && set_patch_path != NULL) {
+                set_patch_path("FwPatchFilePath", p_fw_dir, 0);
+            }
+            if (p_dl_window != NULL && set_dl_window != NULL) {
+                set_dl_window("FwPatchDownloadWindow", p_dl_window, 0);
+            }
+            p_ctl->init_done = 0;
+        }
+
+        start = bench_now_us();
+        for (c = 0; c < bench.num_ctl; c++) {
+            p_ctl = &bench.ctl[c];
+            p_ctl->p_if->op(BT_OP_POWER_ON, NULL);
+            if (p_ctl->p_if->op(BT_OP_HCI_CHANNEL_OPEN, &fds) <= 0) {
+                fprintf(stderr, "channel open of controller %u failed\n", c);
+                return 1;
+            }
+            p_ctl->fd = fds[HCI_CMD];
+            p_ctl->reader_stop = 0;
+            if (bench.use_rx_engine && (c == 0)) {
+                bench.rx.p_register(EMU_H4_EVT, bench_rx_evt, NULL);
+                bench.rx.p_register(EMU_H4_ACL, bench_rx_acl, NULL);
+                if (bench.rx.p_start() != 0) {
+                    fprintf(stderr, "receive engine start failed\n");
+                    return 1;
+                }
+            } else {
+                pthread_create(&p_ctl->reader, NULL, bench_reader, p_ctl);
+            }
+        }
+
+        /* the configurations run side by side */
+        for (c = 0; c < bench.num_ctl; c++) {
+            bench.ctl[c].p_if->op(BT_OP_INIT, NULL);
+        }
+
+        ok = (bench_wait_init() == 0);
+        elapsed = 0;
+        for (c = 0; c < bench.num_ctl; c++) {
+            p_ctl = &bench.ctl[c];
+            if (!p_ctl->init_done || p_ctl->init_result != BTC_OP_RESULT_SUCCESS) {
+                fprintf(stderr, "iteration %u: controller %u init %s\n", it, c,
+                    p_ctl->init_done ? "failed" : "timed out");
+                ok = 0;
+            } else if (bench.num_ctl > 1) {
+                printf("iteration %u: controller %u up in %llu us\n", it, c,
+                    (unsigned long long)(p_ctl->init_done_us - start));
+            }
+            if (p_ctl->init_done && (p_ctl->init_done_us - start > elapsed)) {
+                elapsed = p_ctl->init_done_us - start;
+            }
+        }
+        if (!ok) {
+            failed++;
+        } else {
+            total += elapsed;
+            best = (elapsed < best) ? elapsed : best;
+            worst = (elapsed > worst) ? elapsed : worst;
+            printf("iteration %u: bring-up %llu us\n", it, (unsigned long long)elapsed);
+        }
+
+        /* the library entry points below serve the first controller */
+        if (ctx_bind != NULL) {
+            ctx_bind(0);
+        }
+        ok = bench.ctl[0].init_done && bench.ctl[0].init_result == BTC_OP_RESULT_SUCCESS;
+        if (switches > 0 && ok) {
+            bench_codec_switch(set_audio_state, switches);
+        }
+
+        if (acl_kb > 0 && it == iterations - 1) {
+            bench_acl_throughput(acl_kb);
+        }
+
+        if (a2dp_sec > 0 && it == iterations - 1 && ok) {
+            bench_a2dp(&a2dp, a2dp_sec);
+        }
+
+        for (c = 0; c < bench.num_ctl; c++) {
+            p_ctl = &bench.ctl[c];
+            if (!bench.use_rx_engine || (c > 0)) {
+                p_ctl->reader_stop = 1;
+                pthread_join(p_ctl->reader, NULL);
+            }
+            p_ctl->p_if->op(BT_OP_HCI_CHANNEL_CLOSE, NULL);
+            p_ctl->p_if->op(BT_OP_POWER_OFF, NULL);
+            p_ctl->p_if->close();
+        }
+    }
+
+    for (c = 0; c < bench.num_ctl; c++) {
+        cmds += bench.ctl[c].cmds;
+        evts += bench.ctl[c].evts;
+    }
+    if (iterations > (uint32_t)failed) {
+        printf("bring-up: %u ok, %d failed, min/avg/max %llu/%llu/%llu us, %u cmds, %u evts\n",
+            iterations - failed, failed, (unsigned long long)best,
+            (unsigned long long)(total / (iterations - failed)), (unsigned long long)worst, cmds, evts);
+    }
+
+    dlclose(p_dl);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,559 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      hci_emulator.c
+ *
+ *  Description:   Host side emulation of a Broadcom Bluetooth controller.
+ *                 Speaks H4 over a pseudo-terminal so that libbt_vendor can
+ *                 be pointed at it through the UartPort setting.
+ *
+ ******************************************************************************/
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "hci_emulator.h"
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+#define EMU_RX_BUF_SIZE 4096
+#define EMU_QUEUE_SIZE 64
+#define EMU_EVT_MAX_LEN 260
+#define EMU_LOCAL_NAME_LEN 248
+
+/******************************************************************************
+**  Local type definitions
+******************************************************************************/
+
+/* A command waiting for its command complete */
+typedef struct {
+    uint64_t due_us;
+    uint8_t lost;   /* executed, but the answer never makes it to the host */
+    uint16_t opcode;
+    uint8_t plen;
+    uint8_t param[EMU_EVT_MAX_LEN];
+} emu_cmd_t;
+
+typedef struct {
+    int master_fd;
+    emu_cfg_t cfg;
+    uint8_t rx_buf[EMU_RX_BUF_SIZE];
+    size_t rx_len;
+    emu_cmd_t queue[EMU_QUEUE_SIZE];
+    uint32_t q_head;
+    uint32_t q_count;
+    uint64_t busy_until_us; /* controller is deaf until then (reboot) */
+    uint64_t last_due_us;
+    uint8_t minidrv;        /* in download mode */
+    uint8_t patched;        /* patch RAM launched */
+    uint32_t baud;
+    uint8_t sleep_mode;
+    emu_stats_t stats;
+} emu_cb_t;
+
+/******************************************************************************
+**  Static variables
+******************************************************************************/
+
+static emu_cb_t emu;
+static volatile sig_atomic_t emu_stop = 0;
+
+/*****************************************************************************
+**   Helper Functions
+*****************************************************************************/
+
+static uint64_t emu_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static void emu_write(const uint8_t *p, size_t len)
+{
+    ssize_t ret;
+
+    while (len > 0) {
+        ret = write(emu.master_fd, p, len);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            return;
+        }
+        p += ret;
+        len -= (size_t)ret;
+    }
+}
+
+/*******************************************************************************
+**
+** Function        emu_send_cmd_complete
+**
+** Description     Build and write an HCI Command Complete event
+**
+** Returns         None
+**
+*******************************************************************************/
+static void emu_send_cmd_complete(uint16_t opcode, const uint8_t *p_ret, uint8_t ret_len)
+{
+    uint8_t evt[EMU_EVT_MAX_LEN];
+    uint8_t *p = evt;
+
+    *p++ = EMU_H4_EVT;
+    *p++ = EMU_EVT_CMD_COMPLETE;
+    *p++ = (uint8_t)(3 + ret_len);
+    *p++ = emu.cfg.credits;
+    *p++ = (uint8_t)opcode;
+    *p++ = (uint8_t)(opcode >> 8);
+    memcpy(p, p_ret, ret_len);
+    p += ret_len;
+
+    emu_write(evt, (size_t)(p - evt));
+    emu.stats.events++;
+}
+
+/*******************************************************************************
+**
+** Function        emu_uipc
+**
+** Description     Answer a UIPC message, the response opcode follows the
+**                 request one and the controller accepts everything
+**
+** Returns         Return parameter length
+**
+*******************************************************************************/
+static uint8_t emu_uipc(const emu_cmd_t *p_cmd, uint8_t *p_ret)
+{
+    const uint8_t *p_msg = &p_cmd->param[2];
+    uint16_t uipc_class;
+    uint8_t *p = &p_ret[4];
+
+    if (p_cmd->plen < 3) {
+        p_ret[0] = 0x12; /* invalid parameters */
+        return 1;
+    }
+
+    emu.stats.uipc_msgs++;
+    uipc_class = (uint16_t)(p_cmd->param[0] | (p_cmd->param[1] << 8));
+    p_ret[1] = p_cmd->param[0];
+    p_ret[2] = p_cmd->param[1];
+    p_ret[3] = (uint8_t)(p_msg[0] + 1);
+
+    if (uipc_class == EMU_UIPC_MGMT) {
+        if (p_msg[0] == EMU_UIPC_OPEN_REQ) {
+            *p++ = 0;          /* status */
+            *p++ = 1; *p++ = 0; /* version 1.0 */
+            *p++ = 0; *p++ = 0;
+            *p++ = 1;          /* streams */
+        }
+    } else if (uipc_class == EMU_UIPC_L2C) {
+        *p++ = 0; *p++ = 0; /* unacked */
+        *p++ = 1;           /* streams */
+        if ((p_msg[0] == EMU_UIPC_L2C_SYNC_REQ) && (p_cmd->plen >= 2 + 13)) {
+            *p++ = p_msg[11];
+            *p++ = p_msg[12];
+        } else if ((p_msg[0] == EMU_UIPC_L2C_REMOVE_REQ) && (p_cmd->plen >= 2 + 6)) {
+            *p++ = p_msg[4];
+            *p++ = p_msg[5];
+        } else {
+            *p++ = 0; *p++ = 0;
+        }
+        *p++ = 0;           /* status */
+    } else if ((uipc_class == EMU_UIPC_BTM) && ((p_msg[0] == EMU_UIPC_A2DP_START_REQ) ||
+        (p_msg[0] == EMU_UIPC_A2DP_STOP_REQ) || (p_msg[0] == EMU_UIPC_A2DP_SUSPEND_REQ))) {
+        *p++ = (p_cmd->plen >= 2 + 3) ? p_msg[1] : 0;
+        *p++ = (p_cmd->plen >= 2 + 3) ? p_msg[2] : 0;
+    } else {
+        *p++ = 0;           /* AVDT sync, codec and route config status */
+    }
+
+    return (uint8_t)(p - p_ret);
+}
+
+/*******************************************************************************
+**
+** Function        emu_complete
+**
+** Description     Execute a queued command and answer it
+**
+** Returns         None
+**
+*******************************************************************************/
+static void emu_complete(const emu_cmd_t *p_cmd)
+{
+    uint8_t ret[EMU_EVT_MAX_LEN];
+    uint8_t len = 1;
+    uint16_t subver;
+
+    memset(ret, 0, sizeof(ret));
+    ret[0] = 0; /* status */
+
+    switch (p_cmd->opcode) {
+        case EMU_HCI_RESET:
+            emu.minidrv = FALSE;
+            break;
+
+        case EMU_HCI_READ_LOCAL_NAME:
+            snprintf((char *)&ret[1], EMU_LOCAL_NAME_LEN, "%s", emu.cfg.local_name);
+            len = 1 + EMU_LOCAL_NAME_LEN;
+            break;
+
+        case EMU_HCI_READ_LOCAL_VERSION:
+            subver = emu.patched ? emu.cfg.patched_subver : emu.cfg.rom_subver;
+            ret[1] = 0x09;                           /* HCI version */
+            ret[2] = (uint8_t)(emu.patched ? emu.cfg.patch_build : 0);
+            ret[3] = (uint8_t)((emu.patched ? emu.cfg.patch_build : 0) >> 8);
+            ret[4] = 0x09;                           /* LMP version */
+            ret[5] = 0x0F;                           /* Broadcom */
+            ret[6] = 0x00;
+            ret[7] = (uint8_t)subver;
+            ret[8] = (uint8_t)(subver >> 8);
+            len = 9;
+            break;
+
+        case EMU_HCI_READ_LOCAL_BDADDR:
+            memcpy(&ret[1], emu.cfg.bdaddr, 6);
+            len = 7;
+            break;
+
+        case EMU_HCI_VSC_DOWNLOAD_MINIDRV:
+            emu.minidrv = TRUE;
+            emu.busy_until_us = emu_now_us() + (uint64_t)emu.cfg.minidrv_settle_ms * 1000;
+            break;
+
+        case EMU_HCI_VSC_WRITE_FIRMWARE:
+            if (!emu.minidrv) {
+                ret[0] = 0x01; /* unknown command outside download mode */
+            }
+            emu.stats.fw_records++;
+            emu.stats.fw_bytes += p_cmd->plen;
+            break;
+
+        case EMU_HCI_VSC_LAUNCH_RAM:
+            emu.minidrv = FALSE;
+            emu.patched = TRUE;
+            emu.baud = 115200;
+            emu.busy_until_us = emu_now_us() + (uint64_t)emu.cfg.launch_settle_ms * 1000;
+            break;
+
+        case EMU_HCI_VSC_UPDATE_BAUDRATE:
+            if (p_cmd->plen >= 6) {
+                emu.baud = (uint32_t)p_cmd->param[2] | ((uint32_t)p_cmd->param[3] << 8) |
+                    ((uint32_t)p_cmd->param[4] << 16) | ((uint32_t)p_cmd->param[5] << 24);
+            }
+            break;
+
+        case EMU_HCI_VSC_WRITE_SLEEP_MODE:
+            emu.sleep_mode = (p_cmd->plen > 0) ? p_cmd->param[0] : 0;
+            break;
+
+        case EMU_HCI_VSC_UIPC_OVER_HCI:
+            len = emu_uipc(p_cmd, ret);
+            break;
+
+        default:
+            /* WRITE_UART_CLOCK, WRITE_BD_ADDR, SCO/PCM and other VSCs */
+            break;
+    }
+
+    if (p_cmd->lost) {
+        emu.stats.lost++;
+        return;
+    }
+    emu_send_cmd_complete(p_cmd->opcode, ret, len);
+}
+
+/*******************************************************************************
+**
+** Function        emu_queue_cmd
+**
+** Description     Queue a received command for completion after the
+**                 configured latency
+**
+** Returns         None
+**
+*******************************************************************************/
+static void emu_queue_cmd(uint16_t opcode, const uint8_t *p_param, uint8_t plen)
+{
+    emu_cmd_t *p_cmd;
+    uint64_t now = emu_now_us();
+    uint32_t latency = emu.cfg.cmd_latency_us;
+
+    emu.stats.commands++;
+
+    if ((emu.cfg.max_baud > 0) && (emu.baud > emu.cfg.max_baud)) {
+        /* the wiring does not carry this rate, only a power cycle and
+         * HCI_RESET at 115200 bring the controller back
+         */
+        emu.stats.dropped++;
+        if (opcode == EMU_HCI_RESET) {
+            emu.baud = 115200;
+        }
+        return;
+    }
+
+    if (now < emu.busy_until_us) {
+        /* rebooting or entering download mode: the command is lost */
+        emu.stats.dropped++;
+        return;
+    }
+
+    if (emu.q_count >= EMU_QUEUE_SIZE) {
+        emu.stats.dropped++;
+        return;
+    }
+
+    if (opcode == EMU_HCI_VSC_WRITE_FIRMWARE) {
+        latency = emu.cfg.fw_latency_us;
+    }
+
+    /* time the command spent on the wire, 10 bits per byte */
+    if (emu.cfg.line_rate > 0) {
+        latency += (uint32_t)((uint64_t)(4 + plen) * 10 * 1000000ULL / emu.cfg.line_rate);
+    }
+
+    p_cmd = &emu.queue[(emu.q_head + emu.q_count) % EMU_QUEUE_SIZE];
+    p_cmd->opcode = opcode;
+    p_cmd->plen = plen;
+    p_cmd->lost = (emu.cfg.lose_every > 0) && (emu.stats.commands % emu.cfg.lose_every == 0);
+    memcpy(p_cmd->param, p_param, plen);
+
+    /* commands are executed one after another */
+    p_cmd->due_us = ((emu.last_due_us > now) ? emu.last_due_us : now) + latency;
+    emu.last_due_us = p_cmd->due_us;
+    emu.q_count++;
+}
+
+/*******************************************************************************
+**
+** Function        emu_parse_rx
+**
+** Description     Split the received byte stream into H4 packets
+**
+** Returns         None
+**
+*******************************************************************************/
+static void emu_parse_rx(void)
+{
+    size_t pos = 0;
+    size_t need;
+    uint16_t len;
+
+    while (pos < emu.rx_len) {
+        uint8_t *p = &emu.rx_buf[pos];
+        size_t avail = emu.rx_len - pos;
+
+        switch (p[0]) {
+            case EMU_H4_CMD:
+                if (avail < 4) {
+                    goto out;
+                }
+                need = 4 + p[3];
+                if (avail < need) {
+                    goto out;
+                }
+                emu_queue_cmd((uint16_t)(p[1] | (p[2] << 8)), &p[4], p[3]);
+                break;
+
+            case EMU_H4_ACL:
+                if (avail < 5) {
+                    goto out;
+                }
+                len = (uint16_t)(p[3] | (p[4] << 8));
+                need = 5 + len;
+                if (avail < need) {
+                    goto out;
+                }
+                emu.stats.acl_bytes += len;
+                if (emu.cfg.acl_loopback) {
+                    emu_write(p, need);
+                }
+                break;
+
+            default:
+                /* resync on garbage, one byte at a time */
+                emu.stats.garbage++;
+                need = 1;
+                break;
+        }
+        pos += need;
+    }
+
+out:
+    if (pos > 0) {
+        memmove(emu.rx_buf, &emu.rx_buf[pos], emu.rx_len - pos);
+        emu.rx_len -= pos;
+    }
+}
+
+static void emu_sig_handler(int sig)
+{
+    emu_stop = 1;
+}
+
+static void emu_usage(const char *p_prog)
+{
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  -l <us>   command latency (default %u)\n"
+        "  -f <us>   firmware record latency (default %u)\n"
+        "  -m <ms>   minidriver settle time (default %u)\n"
+        "  -s <ms>   patch launch settle time (default %u)\n"
+        "  -c <n>    Num_HCI_Command_Packets credits (default %u)\n"
+        "  -r <bps>  emulated line rate, 0 for none (default %u)\n"
+        "  -n <str>  local name (default %s)\n"
+        "  -w        start already patched (warm restart)\n"
+        "  -a        loop ACL data back to the host\n"
+        "  -B <bps>  highest baud rate the wiring carries\n"
+        "  -g <n>    lose the answer of every n-th command\n"
+        "  -p <file> write the pty slave path to <file>\n",
+        p_prog, EMU_DEFAULT_CMD_LATENCY_US, EMU_DEFAULT_FW_LATENCY_US, EMU_DEFAULT_MINIDRV_SETTLE_MS,
+        EMU_DEFAULT_LAUNCH_SETTLE_MS, EMU_DEFAULT_CREDITS, EMU_DEFAULT_LINE_RATE,
+        EMU_DEFAULT_LOCAL_NAME);
+}
+
+/*****************************************************************************
+**   Main
+*****************************************************************************/
+
+int main(int argc, char *argv[])
+{
+    const char *p_pty_file = NULL;
+    struct termios tio;
+    struct pollfd pfd;
+    char *p_slave;
+    FILE *p_file;
+    int opt;
+    int timeout;
+    ssize_t sz;
+
+    memset(&emu, 0, sizeof(emu));
+    emu.cfg.cmd_latency_us = EMU_DEFAULT_CMD_LATENCY_US;
+    emu.cfg.fw_latency_us = EMU_DEFAULT_FW_LATENCY_US;
+    emu.cfg.minidrv_settle_ms = EMU_DEFAULT_MINIDRV_SETTLE_MS;
+    emu.cfg.launch_settle_ms = EMU_DEFAULT_LAUNCH_SETTLE_MS;
+    emu.cfg.credits = EMU_DEFAULT_CREDITS;
+    emu.cfg.line_rate = EMU_DEFAULT_LINE_RATE;
+    emu.cfg.rom_subver = EMU_DEFAULT_ROM_SUBVER;
+    emu.cfg.patched_subver = EMU_DEFAULT_ROM_SUBVER;
+    emu.cfg.patch_build = EMU_DEFAULT_PATCH_BUILD;
+    snprintf(emu.cfg.local_name, sizeof(emu.cfg.local_name), "%s", EMU_DEFAULT_LOCAL_NAME);
+    memcpy(emu.cfg.bdaddr, (const uint8_t[]){0x66, 0x55, 0x44, 0x33, 0x22, 0x11}, 6);
+    emu.baud = 115200;
+
+    while ((opt = getopt(argc, argv, "l:f:m:s:c:r:n:wap:B:g:h")) != -1) {
+        switch (opt) {
+            case 'l': emu.cfg.cmd_latency_us = (uint32_t)atoi(optarg); break;
+            case 'f': emu.cfg.fw_latency_us = (uint32_t)atoi(optarg); break;
+            case 'm': emu.cfg.minidrv_settle_ms = (uint32_t)atoi(optarg); break;
+            case 's': emu.cfg.launch_settle_ms = (uint32_t)atoi(optarg); break;
+            case 'c': emu.cfg.credits = (uint8_t)atoi(optarg); break;
+            case 'r': emu.cfg.line_rate = (uint32_t)atoi(optarg); break;
+            case 'n': snprintf(emu.cfg.local_name, sizeof(emu.cfg.local_name), "%s", optarg); break;
+            case 'w': emu.patched = TRUE; break;
+            case 'a': emu.cfg.acl_loopback = TRUE; break;
+            case 'p': p_pty_file = optarg; break;
+            case 'B': emu.cfg.max_baud = (uint32_t)atoi(optarg); break;
+            case 'g': emu.cfg.lose_every = (uint32_t)atoi(optarg); break;
+            default:
+                emu_usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if ((emu.master_fd = posix_openpt(O_RDWR | O_NOCTTY)) < 0 || grantpt(emu.master_fd) != 0 ||
+        unlockpt(emu.master_fd) != 0 || (p_slave = ptsname(emu.master_fd)) == NULL) {
+        perror("pty");
+        return 1;
+    }
+
+    /* raw byte pipe, no line discipline processing on the master side */
+    tcgetattr(emu.master_fd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(emu.master_fd, TCSANOW, &tio);
+
+    printf("%s\n", p_slave);
+    fflush(stdout);
+    if (p_pty_file != NULL && (p_file = fopen(p_pty_file, "w")) != NULL) {
+        fprintf(p_file, "%s\n", p_slave);
+        fclose(p_file);
+    }
+
+    signal(SIGINT, emu_sig_handler);
+    signal(SIGTERM, emu_sig_handler);
+
+    pfd.fd = emu.master_fd;
+    pfd.events = POLLIN;
+
+    while (!emu_stop) {
+        uint64_t now = emu_now_us();
+
+        while (emu.q_count > 0 && emu.queue[emu.q_head].due_us <= now) {
+            emu_complete(&emu.queue[emu.q_head]);
+            emu.q_head = (emu.q_head + 1) % EMU_QUEUE_SIZE;
+            emu.q_count--;
+        }
+
+        timeout = -1;
+        if (emu.q_count > 0) {
+            timeout = (int)((emu.queue[emu.q_head].due_us - now + 999) / 1000);
+        }
+
+        if (poll(&pfd, 1, timeout) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        if (pfd.revents & POLLIN) {
+            sz = read(emu.master_fd, &emu.rx_buf[emu.rx_len], sizeof(emu.rx_buf) - emu.rx_len);
+            if (sz > 0) {
+                emu.rx_len += (size_t)sz;
+                emu_parse_rx();
+            }
+        } else if (pfd.revents & POLLHUP) {
+            /* no slave attached yet */
+            usleep(1000);
+        }
+    }
+
+    fprintf(stderr, "hci_emulator: %u commands, %u events, %u dropped, %u lost, %u fw records (%u bytes), "
+        "%llu acl bytes, %u uipc messages\n", emu.stats.commands, emu.stats.events, emu.stats.dropped,
+        emu.stats.lost, emu.stats.fw_records,
+        emu.stats.fw_bytes, (unsigned long long)emu.stats.acl_bytes, emu.stats.uipc_msgs);
+
+    close(emu.master_fd);
+    return 0;
+}
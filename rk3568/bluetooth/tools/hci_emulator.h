@@ -0,0 +1,123 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      hci_emulator.h
+ *
+ *  Description:   Contains definitions shared by the host side controller
+ *                 emulator and the vendor library benchmark driver
+ *
+ ******************************************************************************/
+
+#ifndef HCI_EMULATOR_H
+#define HCI_EMULATOR_H
+
+#include <stdint.h>
+
+/******************************************************************************
+**  Constants & Macros
+******************************************************************************/
+
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#ifndef TRUE
+#define TRUE (!FALSE)
+#endif
+
+/* H4 packet indicators */
+#define EMU_H4_CMD 0x01
+#define EMU_H4_ACL 0x02
+#define EMU_H4_SCO 0x03
+#define EMU_H4_EVT 0x04
+
+#define EMU_EVT_CMD_COMPLETE 0x0E
+
+#define EMU_HCI_RESET 0x0C03
+#define EMU_HCI_READ_LOCAL_NAME 0x0C14
+#define EMU_HCI_READ_LOCAL_VERSION 0x1001
+#define EMU_HCI_READ_LOCAL_BDADDR 0x1009
+#define EMU_HCI_VSC_WRITE_BD_ADDR 0xFC01
+#define EMU_HCI_VSC_UPDATE_BAUDRATE 0xFC18
+#define EMU_HCI_VSC_WRITE_SLEEP_MODE 0xFC27
+#define EMU_HCI_VSC_DOWNLOAD_MINIDRV 0xFC2E
+#define EMU_HCI_VSC_WRITE_UART_CLOCK_SETTING 0xFC45
+#define EMU_HCI_VSC_WRITE_FIRMWARE 0xFC4C
+#define EMU_HCI_VSC_LAUNCH_RAM 0xFC4E
+#define EMU_HCI_VSC_UIPC_OVER_HCI 0xFC8B
+
+/* UIPC message classes and the requests answered with more than a status */
+#define EMU_UIPC_L2C 0x9003
+#define EMU_UIPC_BTM 0x9005
+#define EMU_UIPC_AVDT 0x9006
+#define EMU_UIPC_MGMT 0x9008
+#define EMU_UIPC_OPEN_REQ 0x00
+#define EMU_UIPC_L2C_SYNC_REQ 0x00
+#define EMU_UIPC_L2C_REMOVE_REQ 0x02
+#define EMU_UIPC_A2DP_START_REQ 11
+#define EMU_UIPC_A2DP_STOP_REQ 13
+#define EMU_UIPC_A2DP_SUSPEND_REQ 17
+
+#define EMU_DEFAULT_CMD_LATENCY_US 300
+#define EMU_DEFAULT_FW_LATENCY_US 400
+#define EMU_DEFAULT_MINIDRV_SETTLE_MS 10
+#define EMU_DEFAULT_LAUNCH_SETTLE_MS 40
+#define EMU_DEFAULT_CREDITS 1
+#define EMU_DEFAULT_LINE_RATE 3000000
+#define EMU_DEFAULT_LOCAL_NAME "BCM4362A2 AP6275"
+#define EMU_DEFAULT_ROM_SUBVER 0x2209
+#define EMU_DEFAULT_PATCH_BUILD 0x0123
+
+/******************************************************************************
+**  Type definitions
+******************************************************************************/
+
+/* Emulated controller behaviour */
+typedef struct {
+    uint32_t cmd_latency_us;    /* command execution time */
+    uint32_t fw_latency_us;     /* WRITE_RAM record execution time */
+    uint32_t minidrv_settle_ms; /* deaf time after DOWNLOAD_MINIDRV */
+    uint32_t launch_settle_ms;  /* deaf time after LAUNCH_RAM */
+    uint8_t credits;            /* advertised Num_HCI_Command_Packets */
+    uint32_t line_rate;         /* emulated UART rate for wire time */
+    uint8_t acl_loopback;       /* echo ACL data back to the host */
+    uint32_t max_baud;      /* commands are garbled above this rate, 0: no limit */
+    uint32_t lose_every;    /* the answer of every n-th command is lost, 0: none */
+    uint16_t rom_subver;
+    uint16_t patched_subver;
+    uint16_t patch_build;
+    char local_name[64];
+    uint8_t bdaddr[6];
+} emu_cfg_t;
+
+/* Emulator counters */
+typedef struct {
+    uint32_t commands;
+    uint32_t events;
+    uint32_t dropped;
+    uint32_t lost;
+    uint32_t garbage;
+    uint32_t fw_records;
+    uint32_t fw_bytes;
+    uint64_t acl_bytes;
+    uint32_t uipc_msgs;
+} emu_stats_t;
+
+#endif /* HCI_EMULATOR_H */
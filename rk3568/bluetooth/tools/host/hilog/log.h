@@ -0,0 +1,51 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      log.h
+ *
+ *  Description:   Host build stand-in for the hilog native interface, see
+ *                 host_shim.c
+ *
+ ******************************************************************************/
+
+#ifndef HOST_HILOG_LOG_H
+#define HOST_HILOG_LOG_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define LOG_CORE 0
+
+#define LOG_DEBUG 3
+#define LOG_INFO 4
+#define LOG_WARN 5
+#define LOG_ERROR 6
+#define LOG_FATAL 7
+
+#ifndef LOG_DOMAIN
+#define LOG_DOMAIN 0xD000100
+#endif
+
+int HiLogPrint(int type, int level, unsigned int domain, const char *tag, const char *fmt, ...)
+    __attribute__((format(printf, 5, 6)));
+
+#endif /* HOST_HILOG_LOG_H */
@@ -0,0 +1,143 @@
+/******************************************************************************
+ *
+ *  Copyright (C) 2026 HiHope Open Source Organization.
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  Filename:      host_shim.c
+ *
+ *  Description:   Minimal hilog and securec replacements so that libbt_vendor
+ *                 can be built and benchmarked on a Linux build machine.
+ *                 Not part of the device build.
+ *
+ ******************************************************************************/
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hilog/log.h"
+
+/* hilog levels below this are dropped when BTV_QUIET is set */
+#define HOST_QUIET_LEVEL LOG_WARN
+
+/* securec refuses any buffer size above this, like the device library */
+#define HOST_SECUREC_MEM_MAX_LEN 0x7fffffffUL
+
+int HiLogPrint(int type, int level, unsigned int domain, const char *tag, const char *fmt, ...)
+{
+    static const char level_char[] = "???DIWEF";
+    va_list ap;
+
+    if ((getenv("BTV_QUIET") != NULL) && (level < HOST_QUIET_LEVEL)) {
+        return 0;
+    }
+
+    va_start(ap, fmt);
+    fprintf(stderr, "[%c] ", ((level >= 0) && (level < (int)sizeof(level_char) - 1)) ? level_char[level] : '?');
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+
+    return 0;
+}
+
+int memset_s(void *dest, size_t dest_max, int c, size_t count)
+{
+    if ((dest == NULL) || (dest_max > HOST_SECUREC_MEM_MAX_LEN) || (count > dest_max)) {
+        return -1;
+    }
+    memset(dest, c, count);
+    return 0;
+}
+
+int memcpy_s(void *dest, size_t dest_max, const void *src, size_t count)
+{
+    if ((dest == NULL) || (src == NULL) || (dest_max > HOST_SECUREC_MEM_MAX_LEN) || (count > dest_max)) {
+        return -1;
+    }
+    memcpy(dest, src, count);
+    return 0;
+}
+
+int memmove_s(void *dest, size_t dest_max, const void *src, size_t count)
+{
+    if ((dest == NULL) || (src == NULL) || (dest_max > HOST_SECUREC_MEM_MAX_LEN) || (count > dest_max)) {
+        return -1;
+    }
+    memmove(dest, src, count);
+    return 0;
+}
+
+int strcpy_s(char *dest, size_t dest_max, const char *src)
+{
+    if ((dest == NULL) || (src == NULL) || (strlen(src) >= dest_max)) {
+        return -1;
+    }
+    strcpy(dest, src);
+    return 0;
+}
+
+int strncpy_s(char *dest, size_t dest_max, const char *src, size_t count)
+{
+    size_t len;
+
+    if ((dest == NULL) || (src == NULL)) {
+        return -1;
+    }
+    len = strnlen(src, count);
+    if (len >= dest_max) {
+        return -1;
+    }
+    memcpy(dest, src, len);
+    dest[len] = '\0';
+    return 0;
+}
+
+int strcat_s(char *dest, size_t dest_max, const char *src)
+{
+    if ((dest == NULL) || (src == NULL) || (strlen(dest) + strlen(src) >= dest_max)) {
+        return -1;
+    }
+    strcat(dest, src);
+    return 0;
+}
+
+int snprintf_s(char *dest, size_t dest_max, size_t count, const char *format, ...)
+{
+    va_list ap;
+    int ret;
+
+    va_start(ap, format);
+    ret = vsnprintf(dest, dest_max, format, ap);
+    va_end(ap);
+
+    return ((ret < 0) || (ret >= (int)dest_max)) ? -1 : ret;
+}
+
+int sprintf_s(char *dest, size_t dest_max, const char *format, ...)
+{
+    va_list ap;
+    int ret;
+
+    va_start(ap, format);
+    ret = vsnprintf(dest, dest_max, format, ap);
+    va_end(ap);
+
+    return ((ret < 0) || (ret >= (int)dest_max)) ? -1 : ret;
+}